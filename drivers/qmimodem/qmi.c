@@ -37,6 +37,8 @@
 
 #include <ofono/log.h>
 
+#include "gattrace.h"
+
 #include "qmi.h"
 #include "ctl.h"
 
@@ -73,6 +75,7 @@ struct qmi_device {
 	void *shutdown_user_data;
 	qmi_destroy_func_t shutdown_destroy;
 	guint shutdown_source;
+	uint16_t trace_id;
 };
 
 struct qmi_service {
@@ -643,7 +646,9 @@ static gboolean can_write_data(GIOChannel *channel, GIOCondition cond,
 	if (bytes_written < 0)
 		return FALSE;
 
-	__hexdump('>', req->buf, bytes_written,
+	if (!g_at_trace_record(G_AT_TRACE_TRANSPORT_QMI, device->trace_id,
+					FALSE, req->buf, bytes_written))
+		__hexdump('>', req->buf, bytes_written,
 				device->debug_func, device->debug_data);
 
 	__debug_msg(' ', req->buf, bytes_written,
@@ -833,7 +838,9 @@ static gboolean received_data(GIOChannel *channel, GIOCondition cond,
 	if (bytes_read < 0)
 		return TRUE;
 
-	__hexdump('<', buf, bytes_read,
+	if (!g_at_trace_record(G_AT_TRACE_TRANSPORT_QMI, device->trace_id,
+					TRUE, buf, bytes_read))
+		__hexdump('<', buf, bytes_read,
 				device->debug_func, device->debug_data);
 
 	offset = 0;
@@ -915,6 +922,7 @@ struct qmi_device *qmi_device_new(int fd)
 
 	device->fd = fd;
 	device->close_on_unref = false;
+	device->trace_id = g_at_trace_new_id();
 
 	flags = fcntl(device->fd, F_GETFL, NULL);
 	if (flags < 0) {
@@ -35,6 +35,7 @@
 #include "ringbuffer.h"
 #include "gatchat.h"
 #include "gatio.h"
+#include "gatutil.h"
 
 /* #define WRITE_SCHEDULER_DEBUG 1 */
 
@@ -806,6 +807,8 @@ static gboolean wakeup_no_response(gpointer user_data)
 	if (chat->debugf)
 		chat->debugf("Wakeup got no response\n", chat->debug_data);
 
+	g_at_util_stats.wakeup_timeouts += 1;
+
 	if (cmd == NULL)
 		return FALSE;
 
@@ -1040,6 +1043,7 @@ static guint at_chat_send_common(struct at_chat *chat, guint gid,
 	c->id = chat->next_cmd_id++;
 
 	g_queue_push_tail(chat->command_queue, c);
+	g_at_util_stats.commands += 1;
 
 	if (g_queue_get_length(chat->command_queue) == 1)
 		chat_wakeup_writer(chat);
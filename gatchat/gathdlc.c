@@ -37,6 +37,7 @@
 #include "gatio.h"
 #include "gatutil.h"
 #include "gathdlc.h"
+#include "gattrace.h"
 
 #define BUFFER_SIZE	(2 * 2048)
 #define MAX_BUFFERS	64	/* Maximum number of in-flight write buffers */
@@ -89,7 +90,9 @@ static inline void hdlc_record(GAtHDLC *hdlc, gboolean in,
 	unsigned char id;
 	int err;
 
-	g_at_util_debug_hexdump(in, data, length,
+	/* The raw bytes are in the binary trace of the GAtIO already */
+	if (!g_at_trace_is_enabled())
+		g_at_util_debug_hexdump(in, data, length,
 					hdlc->debugf, hdlc->debug_data);
 
 	if (hdlc->record_fd < 0)
@@ -292,8 +295,16 @@ static void new_bytes(struct ring_buffer *rbuf, gpointer user_data)
 		} else if (*buf == HDLC_ESCAPE) {
 			hdlc->decode_escape = TRUE;
 		} else if (*buf == HDLC_FLAG) {
+			if (hdlc->decode_offset > 2 &&
+					hdlc->decode_fcs != HDLC_GOODFCS)
+				g_at_util_stats.hdlc_fcs_errors += 1;
+
 			if (hdlc->receive_func && hdlc->decode_offset > 2 &&
 					hdlc->decode_fcs == HDLC_GOODFCS) {
+				g_at_util_stats.hdlc_rx_frames += 1;
+				g_at_util_stats.hdlc_rx_bytes +=
+						hdlc->decode_offset - 2;
+
 				hdlc->receive_func(hdlc->decode_buffer,
 							hdlc->decode_offset - 2,
 							hdlc->receive_data);
@@ -637,6 +648,9 @@ gboolean g_at_hdlc_send(GAtHDLC *hdlc, const unsigned char *data, gsize size)
 
 	ring_buffer_write_advance(write_buffer, pos);
 
+	g_at_util_stats.hdlc_tx_frames += 1;
+	g_at_util_stats.hdlc_tx_bytes += size;
+
 	g_at_io_set_write_handler(hdlc->io, can_write_data, hdlc);
 
 	return TRUE;
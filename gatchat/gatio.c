@@ -35,6 +35,7 @@
 #include "ringbuffer.h"
 #include "gatio.h"
 #include "gatutil.h"
+#include "gattrace.h"
 
 struct _GAtIO {
 	gint ref_count;				/* Ref count */
@@ -55,6 +56,7 @@ struct _GAtIO {
 	GAtDisconnectFunc write_done_func;	/* tx empty notifier */
 	gpointer write_done_data;		/* tx empty data */
 	gboolean destroyed;			/* Re-entrancy guard */
+	guint16 trace_id;			/* Binary trace instance */
 };
 
 static void read_watcher_destroy_notify(gpointer user_data)
@@ -105,6 +107,8 @@ static gboolean received_data(GIOChannel *channel, GIOCondition cond,
 
 		status = g_io_channel_read_chars(channel, (char *) buf,
 							toread, &rbytes, NULL);
+		g_at_trace_record(G_AT_TRACE_TRANSPORT_IO, io->trace_id,
+					TRUE, buf, rbytes);
 		g_at_util_debug_chat(TRUE, (char *)buf, rbytes,
 					io->debugf, io->debug_data);
 
@@ -147,6 +151,8 @@ gsize g_at_io_write(GAtIO *io, const gchar *data, gsize count)
 		return 0;
 	}
 
+	g_at_trace_record(G_AT_TRACE_TRANSPORT_IO, io->trace_id,
+				FALSE, data, bytes_written);
 	g_at_util_debug_chat(FALSE, data, bytes_written,
 				io->debugf, io->debug_data);
 
@@ -195,6 +201,7 @@ static GAtIO *create_io(GIOChannel *channel, GIOFlags flags)
 
 	io->ref_count = 1;
 	io->debugf = NULL;
+	io->trace_id = g_at_trace_new_id();
 
 	if (flags & G_IO_FLAG_NONBLOCK) {
 		io->max_read_attempts = 3;
@@ -0,0 +1,201 @@
+/*
+ *
+ *  AT chat library with GLib integration
+ *
+ *  Copyright (C) 2008-2011  Intel Corporation. All rights reserved.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 2 as
+ *  published by the Free Software Foundation.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <glib.h>
+
+#include "gattrace.h"
+
+#define TRACE_ALIGN(len) \
+	(((len) + G_AT_TRACE_ALIGN - 1) & ~(G_AT_TRACE_ALIGN - 1))
+
+#define TRACE_MIN_SIZE	(16 * (sizeof(struct g_at_trace_record) + \
+				G_AT_TRACE_MAX_PAYLOAD))
+
+static struct g_at_trace_header *trace_header;
+static unsigned char *trace_data;
+static guint64 trace_size;
+static size_t trace_map_size;
+static guint16 trace_next_id;
+
+static unsigned char *trace_ptr(guint64 offset)
+{
+	return trace_data + offset % trace_size;
+}
+
+static guint64 trace_record_size(const struct g_at_trace_record *rec)
+{
+	return sizeof(*rec) + TRACE_ALIGN(GUINT16_FROM_LE(rec->length));
+}
+
+/* Drops the oldest records until size more bytes fit after head */
+static void trace_make_room(guint64 head, guint64 size)
+{
+	guint64 tail = GUINT64_FROM_LE(trace_header->tail);
+
+	while (head + size - tail > trace_size) {
+		const struct g_at_trace_record *rec = (const void *)
+							trace_ptr(tail);
+
+		tail += trace_record_size(rec);
+	}
+
+	trace_header->tail = GUINT64_TO_LE(tail);
+}
+
+static guint64 trace_write(guint64 head, guint8 transport, guint16 id,
+				guint8 flags, const void *data,
+				guint16 length, gsize orig_length)
+{
+	struct g_at_trace_record *rec;
+	guint64 size = sizeof(*rec) + TRACE_ALIGN(length);
+
+	trace_make_room(head, size);
+
+	rec = (void *) trace_ptr(head);
+	rec->timestamp = GUINT64_TO_LE(g_get_real_time());
+	rec->length = GUINT16_TO_LE(length);
+	rec->orig_length = GUINT16_TO_LE(MIN(orig_length, G_MAXUINT16));
+	rec->transport = transport;
+	rec->flags = flags;
+	rec->id = GUINT16_TO_LE(id);
+
+	if (data)
+		memcpy(rec + 1, data, length);
+
+	return head + size;
+}
+
+gboolean g_at_trace_record(GAtTraceTransport transport, guint16 id,
+				gboolean in, const void *data, gsize len)
+{
+	guint64 head;
+	guint64 space;
+	guint16 length;
+
+	if (trace_header == NULL || len == 0)
+		return FALSE;
+
+	length = MIN(len, G_AT_TRACE_MAX_PAYLOAD);
+	head = GUINT64_FROM_LE(trace_header->head);
+
+	/* Records are kept contiguous, pad up to the end if needed */
+	space = trace_size - head % trace_size;
+
+	if (space < sizeof(struct g_at_trace_record) + TRACE_ALIGN(length))
+		head = trace_write(head, 0, 0, G_AT_TRACE_FLAG_PAD, NULL,
+				space - sizeof(struct g_at_trace_record), 0);
+
+	head = trace_write(head, transport, id, in ? G_AT_TRACE_FLAG_IN : 0,
+				data, length, len);
+
+	trace_header->head = GUINT64_TO_LE(head);
+
+	return TRUE;
+}
+
+gboolean g_at_trace_is_enabled(void)
+{
+	return trace_header != NULL;
+}
+
+guint16 g_at_trace_new_id(void)
+{
+	return ++trace_next_id;
+}
+
+/*
+ * Starts recording into filename, using size bytes for the records.  A
+ * trace left over by a previous run is kept as filename.old, so that it
+ * can still be looked at after the daemon has been restarted.
+ */
+gboolean g_at_trace_open(const char *filename, gsize size)
+{
+	struct g_at_trace_header *header;
+	char *old;
+	void *map;
+	size_t map_size;
+	int fd;
+
+	g_at_trace_close();
+
+	size = MAX(TRACE_ALIGN(size), TRACE_MIN_SIZE);
+	map_size = sizeof(*header) + size;
+
+	old = g_strconcat(filename, ".old", NULL);
+	rename(filename, old);
+	g_free(old);
+
+	fd = open(filename, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC,
+					S_IRUSR | S_IWUSR);
+	if (fd < 0)
+		return FALSE;
+
+	if (ftruncate(fd, map_size) < 0) {
+		close(fd);
+		return FALSE;
+	}
+
+	map = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (map == MAP_FAILED)
+		return FALSE;
+
+	header = map;
+	memcpy(header->magic, G_AT_TRACE_MAGIC, sizeof(header->magic));
+	header->version = GUINT32_TO_LE(G_AT_TRACE_VERSION);
+	header->header_size = GUINT32_TO_LE(sizeof(*header));
+	header->data_size = GUINT64_TO_LE(size);
+	header->head = 0;
+	header->tail = 0;
+
+	trace_header = header;
+	trace_data = (unsigned char *) map + sizeof(*header);
+	trace_size = size;
+	trace_map_size = map_size;
+
+	return TRUE;
+}
+
+void g_at_trace_close(void)
+{
+	if (trace_header == NULL)
+		return;
+
+	munmap(trace_header, trace_map_size);
+
+	trace_header = NULL;
+	trace_data = NULL;
+	trace_size = 0;
+	trace_map_size = 0;
+}
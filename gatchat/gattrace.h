@@ -0,0 +1,97 @@
+/*
+ *
+ *  AT chat library with GLib integration
+ *
+ *  Copyright (C) 2008-2011  Intel Corporation. All rights reserved.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 2 as
+ *  published by the Free Software Foundation.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifndef __GATTRACE_H
+#define __GATTRACE_H
+
+#include "gat.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Binary trace of the raw bytes exchanged with modems.  Records are kept
+ * in a memory mapped ring buffer file, so the trace survives a crash of
+ * the daemon and can be decoded offline with tools/trace-decode.
+ *
+ * File layout, all integers little endian:
+ *
+ *   struct g_at_trace_header
+ *   data_size bytes of records
+ *
+ * Each record is a struct g_at_trace_record followed by length payload
+ * bytes, padded to G_AT_TRACE_ALIGN.  Records never wrap around the end
+ * of the data area, the space left at the end is filled with a record
+ * flagged G_AT_TRACE_FLAG_PAD instead.  head and tail are the number of
+ * bytes written so far and the start of the oldest complete record, the
+ * record offsets in the data area are these modulo data_size.
+ */
+
+#define G_AT_TRACE_MAGIC	"OFNTRACE"
+#define G_AT_TRACE_VERSION	1
+#define G_AT_TRACE_ALIGN	16
+#define G_AT_TRACE_MAX_PAYLOAD	4096
+
+#define G_AT_TRACE_FLAG_IN	0x01	/* Received from the modem */
+#define G_AT_TRACE_FLAG_PAD	0x80	/* Filler up to the end */
+
+enum _GAtTraceTransport {
+	G_AT_TRACE_TRANSPORT_IO = 1,	/* GAtIO: AT, PPP and MUX */
+	G_AT_TRACE_TRANSPORT_RIL = 2,
+	G_AT_TRACE_TRANSPORT_QMI = 3,
+};
+
+typedef enum _GAtTraceTransport GAtTraceTransport;
+
+struct g_at_trace_header {
+	char magic[8];
+	guint32 version;
+	guint32 header_size;
+	guint64 data_size;
+	guint64 head;
+	guint64 tail;
+	guint8 reserved[24];
+} __attribute__ ((packed));
+
+struct g_at_trace_record {
+	guint64 timestamp;	/* Microseconds since the epoch */
+	guint16 length;		/* Payload bytes stored */
+	guint16 orig_length;	/* Payload bytes transferred, capped */
+	guint8 transport;
+	guint8 flags;
+	guint16 id;		/* Transport instance */
+} __attribute__ ((packed));
+
+gboolean g_at_trace_open(const char *filename, gsize size);
+void g_at_trace_close(void);
+gboolean g_at_trace_is_enabled(void);
+
+guint16 g_at_trace_new_id(void);
+
+gboolean g_at_trace_record(GAtTraceTransport transport, guint16 id,
+				gboolean in, const void *data, gsize len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GATTRACE_H */
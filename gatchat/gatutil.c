@@ -31,6 +31,13 @@
 
 #include "gatutil.h"
 
+GAtStats g_at_util_stats;
+
+const GAtStats *g_at_util_get_stats(void)
+{
+	return &g_at_util_stats;
+}
+
 void g_at_util_debug_chat(gboolean in, const char *str, gsize len,
 				GAtDebugFunc debugf, gpointer user_data)
 {
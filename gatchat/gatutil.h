@@ -39,6 +39,26 @@ void g_at_util_debug_hexdump(gboolean in, const unsigned char *buf, gsize len,
 
 gboolean g_at_util_setup_io(GIOChannel *io, GIOFlags flags);
 
+/*
+ * Process wide counters, updated by the AT, HDLC and PPP code.  All of
+ * it runs in the main loop, so no locking is needed.
+ */
+struct _GAtStats {
+	guint64 commands;
+	guint64 wakeup_timeouts;
+	guint64 hdlc_rx_frames;
+	guint64 hdlc_rx_bytes;
+	guint64 hdlc_tx_frames;
+	guint64 hdlc_tx_bytes;
+	guint64 hdlc_fcs_errors;
+};
+
+typedef struct _GAtStats GAtStats;
+
+extern GAtStats g_at_util_stats;
+
+const GAtStats *g_at_util_get_stats(void);
+
 #ifdef __cplusplus
 }
 #endif
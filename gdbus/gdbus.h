@@ -227,6 +227,8 @@ gboolean g_dbus_register_interface(DBusConnection *connection,
 					GDBusDestroyFunction destroy);
 gboolean g_dbus_unregister_interface(DBusConnection *connection,
 					const char *path, const char *name);
+gboolean g_dbus_interface_is_registered(DBusConnection *connection,
+					const char *path, const char *name);
 
 gboolean g_dbus_register_security(const GDBusSecurityTable *security);
 gboolean g_dbus_unregister_security(const GDBusSecurityTable *security);
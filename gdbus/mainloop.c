@@ -79,8 +79,13 @@ static gboolean message_dispatch(void *data)
 static inline void queue_dispatch(DBusConnection *conn,
 						DBusDispatchStatus status)
 {
+	/*
+	 * Dispatch alongside the modem I/O, otherwise method calls wait
+	 * for a busy data path, e.g. a PPP session, to go quiet
+	 */
 	if (status == DBUS_DISPATCH_DATA_REMAINS)
-		g_idle_add(message_dispatch, dbus_connection_ref(conn));
+		g_idle_add_full(G_PRIORITY_DEFAULT, message_dispatch,
+					dbus_connection_ref(conn), NULL);
 }
 
 static gboolean watch_func(GIOChannel *chan, GIOCondition cond, gpointer data)
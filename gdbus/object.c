@@ -1390,6 +1390,24 @@ gboolean g_dbus_unregister_interface(DBusConnection *connection,
 	return TRUE;
 }
 
+gboolean g_dbus_interface_is_registered(DBusConnection *connection,
+					const char *path, const char *name)
+{
+	struct generic_data *data = NULL;
+
+	if (path == NULL)
+		return FALSE;
+
+	if (dbus_connection_get_object_path_data(connection, path,
+						(void *) &data) == FALSE)
+		return FALSE;
+
+	if (data == NULL)
+		return FALSE;
+
+	return find_interface(data->interfaces, name) != NULL;
+}
+
 gboolean g_dbus_register_security(const GDBusSecurityTable *security)
 {
 	if (security_table != NULL)
@@ -33,6 +33,7 @@
 #include <glib.h>
 
 #include "ringbuffer.h"
+#include "gattrace.h"
 #include "grilio.h"
 #include "grilutil.h"
 
@@ -55,6 +56,7 @@ struct _GRilIO {
 	GRilDisconnectFunc write_done_func;	/* tx empty notifier */
 	gpointer write_done_data;		/* tx empty data */
 	gboolean destroyed;			/* Re-entrancy guard */
+	guint16 trace_id;			/* Binary trace instance */
 };
 
 static void read_watcher_destroy_notify(gpointer user_data)
@@ -106,7 +108,9 @@ static gboolean received_data(GIOChannel *channel, GIOCondition cond,
 		status = g_io_channel_read_chars(channel, (char *) buf,
 							toread, &rbytes, NULL);
 
-		g_ril_util_debug_hexdump(TRUE, (guchar *) buf, rbytes,
+		if (!g_at_trace_record(G_AT_TRACE_TRANSPORT_RIL, io->trace_id,
+						TRUE, buf, rbytes))
+			g_ril_util_debug_hexdump(TRUE, (guchar *) buf, rbytes,
 						io->debugf, io->debug_data);
 
 		read_count++;
@@ -148,8 +152,10 @@ gsize g_ril_io_write(GRilIO *io, const gchar *data, gsize count)
 		return 0;
 	}
 
-	g_ril_util_debug_hexdump(FALSE, (guchar *) data, bytes_written,
-				io->debugf, io->debug_data);
+	if (!g_at_trace_record(G_AT_TRACE_TRANSPORT_RIL, io->trace_id,
+					FALSE, data, bytes_written))
+		g_ril_util_debug_hexdump(FALSE, (guchar *) data, bytes_written,
+					io->debugf, io->debug_data);
 
 	return bytes_written;
 }
@@ -196,6 +202,7 @@ static GRilIO *create_io(GIOChannel *channel, GIOFlags flags)
 
 	io->ref_count = 1;
 	io->debugf = NULL;
+	io->trace_id = g_at_trace_new_id();
 
 	if (flags & G_IO_FLAG_NONBLOCK) {
 		io->max_read_attempts = 3;
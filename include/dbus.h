@@ -32,6 +32,7 @@ extern "C" {
 #define OFONO_MANAGER_INTERFACE "org.ofono.Manager"
 #define OFONO_MANAGER_PATH "/"
 #define OFONO_MODEM_INTERFACE "org.ofono.Modem"
+#define OFONO_METRICS_INTERFACE OFONO_SERVICE ".Metrics"
 #define OFONO_CALL_BARRING_INTERFACE "org.ofono.CallBarring"
 #define OFONO_CALL_FORWARDING_INTERFACE "org.ofono.CallForwarding"
 #define OFONO_CALL_METER_INTERFACE "org.ofono.CallMeter"
@@ -23,6 +23,7 @@
 #include <config.h>
 #endif
 
+#include <stdio.h>
 #include <errno.h>
 #include <ctype.h>
 #include <stdlib.h>
@@ -50,7 +51,7 @@ struct modem_info {
 	char *model;
 	enum modem_type type;
 	union {
-		GSList *devices;
+		GPtrArray *devices;
 		struct serial_device_info* serial;
 	};
 	struct ofono_modem *modem;
@@ -78,12 +79,12 @@ static gboolean setup_isi(struct modem_info *modem)
 {
 	const char *node = NULL;
 	int addr = 0;
-	GSList *list;
+	unsigned int i;
 
 	DBG("%s", modem->syspath);
 
-	for (list = modem->devices; list; list = list->next) {
-		struct device_info *info = list->data;
+	for (i = 0; i < modem->devices->len; i++) {
+		struct device_info *info = g_ptr_array_index(modem->devices, i);
 
 		DBG("%s %s %s %s %s", info->devnode, info->interface,
 				info->number, info->label, info->sysattr);
@@ -110,12 +111,12 @@ static gboolean setup_isi(struct modem_info *modem)
 static gboolean setup_mbm(struct modem_info *modem)
 {
 	const char *mdm = NULL, *app = NULL, *network = NULL, *gps = NULL;
-	GSList *list;
+	unsigned int i;
 
 	DBG("%s", modem->syspath);
 
-	for (list = modem->devices; list; list = list->next) {
-		struct device_info *info = list->data;
+	for (i = 0; i < modem->devices->len; i++) {
+		struct device_info *info = g_ptr_array_index(modem->devices, i);
 
 		DBG("%s %s %s %s %s", info->devnode, info->interface,
 				info->number, info->label, info->sysattr);
@@ -158,12 +159,12 @@ static gboolean setup_mbm(struct modem_info *modem)
 static gboolean setup_hso(struct modem_info *modem)
 {
 	const char *ctl = NULL, *app = NULL, *mdm = NULL, *net = NULL;
-	GSList *list;
+	unsigned int i;
 
 	DBG("%s", modem->syspath);
 
-	for (list = modem->devices; list; list = list->next) {
-		struct device_info *info = list->data;
+	for (i = 0; i < modem->devices->len; i++) {
+		struct device_info *info = g_ptr_array_index(modem->devices, i);
 
 		DBG("%s %s %s %s %s", info->devnode, info->interface,
 				info->number, info->label, info->sysattr);
@@ -197,12 +198,12 @@ static gboolean setup_gobi(struct modem_info *modem)
 {
 	const char *qmi = NULL, *mdm = NULL, *net = NULL;
 	const char *gps = NULL, *diag = NULL;
-	GSList *list;
+	unsigned int i;
 
 	DBG("%s", modem->syspath);
 
-	for (list = modem->devices; list; list = list->next) {
-		struct device_info *info = list->data;
+	for (i = 0; i < modem->devices->len; i++) {
+		struct device_info *info = g_ptr_array_index(modem->devices, i);
 
 		DBG("%s %s %s %s", info->devnode, info->interface,
 						info->number, info->label);
@@ -237,12 +238,12 @@ static gboolean setup_gobi(struct modem_info *modem)
 static gboolean setup_sierra(struct modem_info *modem)
 {
 	const char *mdm = NULL, *app = NULL, *net = NULL, *diag = NULL, *qmi = NULL;
-	GSList *list;
+	unsigned int i;
 
 	DBG("%s", modem->syspath);
 
-	for (list = modem->devices; list; list = list->next) {
-		struct device_info *info = list->data;
+	for (i = 0; i < modem->devices->len; i++) {
+		struct device_info *info = g_ptr_array_index(modem->devices, i);
 
 		DBG("%s %s %s %s %s", info->devnode, info->interface,
 				info->number, info->label, info->subsystem);
@@ -290,12 +291,12 @@ static gboolean setup_huawei(struct modem_info *modem)
 {
 	const char *qmi = NULL, *mdm = NULL, *net = NULL;
 	const char *pcui = NULL, *diag = NULL;
-	GSList *list;
+	unsigned int i;
 
 	DBG("%s", modem->syspath);
 
-	for (list = modem->devices; list; list = list->next) {
-		struct device_info *info = list->data;
+	for (i = 0; i < modem->devices->len; i++) {
+		struct device_info *info = g_ptr_array_index(modem->devices, i);
 
 		DBG("%s %s %s %s", info->devnode, info->interface,
 						info->number, info->label);
@@ -361,12 +362,12 @@ done:
 static gboolean setup_speedup(struct modem_info *modem)
 {
 	const char *aux = NULL, *mdm = NULL;
-	GSList *list;
+	unsigned int i;
 
 	DBG("%s", modem->syspath);
 
-	for (list = modem->devices; list; list = list->next) {
-		struct device_info *info = list->data;
+	for (i = 0; i < modem->devices->len; i++) {
+		struct device_info *info = g_ptr_array_index(modem->devices, i);
 
 		DBG("%s %s %s %s", info->devnode, info->interface,
 						info->number, info->label);
@@ -396,12 +397,12 @@ static gboolean setup_speedup(struct modem_info *modem)
 static gboolean setup_linktop(struct modem_info *modem)
 {
 	const char *aux = NULL, *mdm = NULL;
-	GSList *list;
+	unsigned int i;
 
 	DBG("%s", modem->syspath);
 
-	for (list = modem->devices; list; list = list->next) {
-		struct device_info *info = list->data;
+	for (i = 0; i < modem->devices->len; i++) {
+		struct device_info *info = g_ptr_array_index(modem->devices, i);
 
 		DBG("%s %s %s %s", info->devnode, info->interface,
 						info->number, info->label);
@@ -428,12 +429,12 @@ static gboolean setup_linktop(struct modem_info *modem)
 static gboolean setup_icera(struct modem_info *modem)
 {
 	const char *aux = NULL, *mdm = NULL, *net = NULL;
-	GSList *list;
+	unsigned int i;
 
 	DBG("%s", modem->syspath);
 
-	for (list = modem->devices; list; list = list->next) {
-		struct device_info *info = list->data;
+	for (i = 0; i < modem->devices->len; i++) {
+		struct device_info *info = g_ptr_array_index(modem->devices, i);
 
 		DBG("%s %s %s %s", info->devnode, info->interface,
 						info->number, info->label);
@@ -472,12 +473,12 @@ static gboolean setup_icera(struct modem_info *modem)
 static gboolean setup_alcatel(struct modem_info *modem)
 {
 	const char *aux = NULL, *mdm = NULL;
-	GSList *list;
+	unsigned int i;
 
 	DBG("%s", modem->syspath);
 
-	for (list = modem->devices; list; list = list->next) {
-		struct device_info *info = list->data;
+	for (i = 0; i < modem->devices->len; i++) {
+		struct device_info *info = g_ptr_array_index(modem->devices, i);
 
 		DBG("%s %s %s %s", info->devnode, info->interface,
 						info->number, info->label);
@@ -512,12 +513,12 @@ static gboolean setup_alcatel(struct modem_info *modem)
 static gboolean setup_novatel(struct modem_info *modem)
 {
 	const char *aux = NULL, *mdm = NULL;
-	GSList *list;
+	unsigned int i;
 
 	DBG("%s", modem->syspath);
 
-	for (list = modem->devices; list; list = list->next) {
-		struct device_info *info = list->data;
+	for (i = 0; i < modem->devices->len; i++) {
+		struct device_info *info = g_ptr_array_index(modem->devices, i);
 
 		DBG("%s %s %s %s", info->devnode, info->interface,
 						info->number, info->label);
@@ -552,12 +553,12 @@ static gboolean setup_novatel(struct modem_info *modem)
 static gboolean setup_nokia(struct modem_info *modem)
 {
 	const char *aux = NULL, *mdm = NULL;
-	GSList *list;
+	unsigned int i;
 
 	DBG("%s", modem->syspath);
 
-	for (list = modem->devices; list; list = list->next) {
-		struct device_info *info = list->data;
+	for (i = 0; i < modem->devices->len; i++) {
+		struct device_info *info = g_ptr_array_index(modem->devices, i);
 
 		DBG("%s %s %s %s", info->devnode, info->interface,
 						info->number, info->label);
@@ -592,12 +593,12 @@ static gboolean setup_nokia(struct modem_info *modem)
 static gboolean setup_telit(struct modem_info *modem)
 {
 	const char *mdm = NULL, *aux = NULL, *gps = NULL, *net = NULL;
-	GSList *list;
+	unsigned int i;
 
 	DBG("%s", modem->syspath);
 
-	for (list = modem->devices; list; list = list->next) {
-		struct device_info *info = list->data;
+	for (i = 0; i < modem->devices->len; i++) {
+		struct device_info *info = g_ptr_array_index(modem->devices, i);
 
 		DBG("%s %s %s %s", info->devnode, info->interface,
 						info->number, info->label);
@@ -648,12 +649,12 @@ static gboolean setup_telit(struct modem_info *modem)
 static gboolean setup_telitqmi(struct modem_info *modem)
 {
 	const char *qmi = NULL, *net = NULL;
-	GSList *list;
+	unsigned int i;
 
 	DBG("%s", modem->syspath);
 
-	for (list = modem->devices; list; list = list->next) {
-		struct device_info *info = list->data;
+	for (i = 0; i < modem->devices->len; i++) {
+		struct device_info *info = g_ptr_array_index(modem->devices, i);
 
 		DBG("%s %s %s %s %s", info->devnode, info->interface,
 				info->number, info->label, info->subsystem);
@@ -685,12 +686,12 @@ static gboolean setup_telitqmi(struct modem_info *modem)
 static gboolean setup_simcom(struct modem_info *modem)
 {
 	const char *mdm = NULL, *aux = NULL, *gps = NULL, *diag = NULL;
-	GSList *list;
+	unsigned int i;
 
 	DBG("%s", modem->syspath);
 
-	for (list = modem->devices; list; list = list->next) {
-		struct device_info *info = list->data;
+	for (i = 0; i < modem->devices->len; i++) {
+		struct device_info *info = g_ptr_array_index(modem->devices, i);
 
 		DBG("%s %s %s %s", info->devnode, info->interface,
 						info->number, info->label);
@@ -731,7 +732,7 @@ static gboolean setup_zte(struct modem_info *modem)
 {
 	const char *aux = NULL, *mdm = NULL, *qcdm = NULL;
 	const char *modem_intf;
-	GSList *list;
+	unsigned int i;
 
 	DBG("%s", modem->syspath);
 
@@ -742,8 +743,8 @@ static gboolean setup_zte(struct modem_info *modem)
 	else
 		modem_intf = "03";
 
-	for (list = modem->devices; list; list = list->next) {
-		struct device_info *info = list->data;
+	for (i = 0; i < modem->devices->len; i++) {
+		struct device_info *info = g_ptr_array_index(modem->devices, i);
 
 		DBG("%s %s %s %s", info->devnode, info->interface,
 						info->number, info->label);
@@ -780,12 +781,12 @@ static gboolean setup_zte(struct modem_info *modem)
 static gboolean setup_samsung(struct modem_info *modem)
 {
 	const char *control = NULL, *network = NULL;
-	GSList *list;
+	unsigned int i;
 
 	DBG("%s", modem->syspath);
 
-	for (list = modem->devices; list; list = list->next) {
-		struct device_info *info = list->data;
+	for (i = 0; i < modem->devices->len; i++) {
+		struct device_info *info = g_ptr_array_index(modem->devices, i);
 
 		DBG("%s %s %s %s", info->devnode, info->interface,
 						info->number, info->label);
@@ -810,12 +811,12 @@ static gboolean setup_samsung(struct modem_info *modem)
 static gboolean setup_quectel(struct modem_info *modem)
 {
 	const char *aux = NULL, *mdm = NULL;
-	GSList *list;
+	unsigned int i;
 
 	DBG("%s", modem->syspath);
 
-	for (list = modem->devices; list; list = list->next) {
-		struct device_info *info = list->data;
+	for (i = 0; i < modem->devices->len; i++) {
+		struct device_info *info = g_ptr_array_index(modem->devices, i);
 
 		DBG("%s %s %s %s", info->devnode, info->interface,
 						info->number, info->label);
@@ -850,12 +851,12 @@ static gboolean setup_quectel(struct modem_info *modem)
 static gboolean setup_quectelqmi(struct modem_info *modem)
 {
 	const char *qmi = NULL, *net = NULL, *gps = NULL;
-	GSList *list;
+	unsigned int i;
 
 	DBG("%s", modem->syspath);
 
-	for (list = modem->devices; list; list = g_slist_next(list)) {
-		struct device_info *info = list->data;
+	for (i = 0; i < modem->devices->len; i++) {
+		struct device_info *info = g_ptr_array_index(modem->devices, i);
 
 		DBG("%s %s %s %s %s", info->devnode, info->interface,
 				info->number, info->label, info->subsystem);
@@ -987,12 +988,12 @@ static gboolean setup_isi_serial(struct modem_info* modem)
 static gboolean setup_ublox(struct modem_info *modem)
 {
 	const char *aux = NULL, *mdm = NULL, *net = NULL;
-	GSList *list;
+	unsigned int i;
 
 	DBG("%s", modem->syspath);
 
-	for (list = modem->devices; list; list = list->next) {
-		struct device_info *info = list->data;
+	for (i = 0; i < modem->devices->len; i++) {
+		struct device_info *info = g_ptr_array_index(modem->devices, i);
 
 		DBG("%s %s %s %s", info->devnode, info->interface,
 					info->number, info->label);
@@ -1048,12 +1049,12 @@ static gboolean setup_gemalto(struct modem_info* modem)
 	const char *app = NULL, *gps = NULL, *mdm = NULL,
 		*net = NULL, *qmi = NULL;
 
-	GSList *list;
+	unsigned int i;
 
 	DBG("%s", modem->syspath);
 
-	for (list = modem->devices; list; list = list->next) {
-		struct device_info *info = list->data;
+	for (i = 0; i < modem->devices->len; i++) {
+		struct device_info *info = g_ptr_array_index(modem->devices, i);
 
 		DBG("%s %s %s %s %s", info->devnode, info->interface,
 				info->number, info->label, info->subsystem);
@@ -1129,6 +1130,8 @@ static struct {
 };
 
 static GHashTable *modem_list;
+static GHashTable *device_index;	/* devpath -> struct modem_info */
+static GHashTable *vendor_index;	/* drv:vid:pid -> vendor_list index */
 
 static const char *get_sysattr(const char *driver)
 {
@@ -1166,7 +1169,7 @@ static void serial_device_info_free(struct serial_device_info* info)
 static void destroy_modem(gpointer data)
 {
 	struct modem_info *modem = data;
-	GSList *list;
+	unsigned int i;
 
 	DBG("%s", modem->syspath);
 
@@ -1174,14 +1177,19 @@ static void destroy_modem(gpointer data)
 
 	switch (modem->type) {
 	case MODEM_TYPE_USB:
-		for (list = modem->devices; list; list = list->next) {
-			struct device_info *info = list->data;
+		if (modem->devices == NULL)
+			break;
+
+		for (i = 0; i < modem->devices->len; i++) {
+			struct device_info *info =
+					g_ptr_array_index(modem->devices, i);
 
 			DBG("%s", info->devnode);
+			g_hash_table_remove(device_index, info->devpath);
 			device_info_free(info);
 		}
 
-		g_slist_free(modem->devices);
+		g_ptr_array_free(modem->devices, TRUE);
 		break;
 	case MODEM_TYPE_SERIAL:
 		serial_device_info_free(modem->serial);
@@ -1196,25 +1204,10 @@ static void destroy_modem(gpointer data)
 	g_free(modem);
 }
 
-static gboolean check_remove(gpointer key, gpointer value, gpointer user_data)
-{
-	struct modem_info *modem = value;
-	const char *devpath = user_data;
-	GSList *list;
-
-	for (list = modem->devices; list; list = list->next) {
-		struct device_info *info = list->data;
-
-		if (g_strcmp0(info->devpath, devpath) == 0)
-			return TRUE;
-	}
-
-	return FALSE;
-}
-
 static void remove_device(struct udev_device *device)
 {
 	const char *syspath;
+	struct modem_info *modem;
 
 	syspath = udev_device_get_syspath(device);
 	if (syspath == NULL)
@@ -1222,8 +1215,11 @@ static void remove_device(struct udev_device *device)
 
 	DBG("%s", syspath);
 
-	g_hash_table_foreach_remove(modem_list, check_remove,
-						(char *) syspath);
+	modem = g_hash_table_lookup(device_index, syspath);
+	if (modem == NULL)
+		return;
+
+	g_hash_table_remove(modem_list, modem->syspath);
 }
 
 static gint compare_device(gconstpointer a, gconstpointer b)
@@ -1234,6 +1230,30 @@ static gint compare_device(gconstpointer a, gconstpointer b)
 	return g_strcmp0(info1->number, info2->number);
 }
 
+/*
+ * Keeps the devices sorted by interface number, devices with the same
+ * number stay in the order they have been added in.  Interfaces mostly
+ * show up in ascending order, so this rarely moves anything.
+ */
+static void insert_device(struct modem_info *modem, struct device_info *info)
+{
+	unsigned int i;
+
+	if (modem->devices == NULL)
+		modem->devices = g_ptr_array_new();
+
+	i = modem->devices->len;
+	g_ptr_array_add(modem->devices, info);
+
+	while (i > 0 && compare_device(modem->devices->pdata[i - 1],
+								info) > 0) {
+		modem->devices->pdata[i] = modem->devices->pdata[i - 1];
+		i--;
+	}
+
+	modem->devices->pdata[i] = info;
+}
+
 /*
  * Here we try to find the "modem device".
  *
@@ -1323,7 +1343,10 @@ static void add_serial_device(struct udev_device *dev)
 	info->subsystem = g_strdup(subsystem);
 	info->dev = udev_device_ref(dev);
 
-	modem->devices = g_slist_append(modem->devices, info);
+	if (modem->serial)
+		serial_device_info_free(modem->serial);
+
+	modem->serial = info;
 }
 
 static void add_device(const char *syspath, const char *devname,
@@ -1353,6 +1376,10 @@ static void add_device(const char *syspath, const char *devname,
 	if (usb_interface == NULL)
 		return;
 
+	/* Already known, e.g. seen by both the enumeration and the monitor */
+	if (g_hash_table_lookup(device_index, devpath) != NULL)
+		return;
+
 	modem = g_hash_table_lookup(modem_list, syspath);
 	if (modem == NULL) {
 		modem = g_try_new0(struct modem_info, 1);
@@ -1415,8 +1442,8 @@ static void add_device(const char *syspath, const char *devname,
 	info->sysattr = g_strdup(sysattr);
 	info->subsystem = g_strdup(subsystem);
 
-	modem->devices = g_slist_insert_sorted(modem->devices, info,
-							compare_device);
+	insert_device(modem, info);
+	g_hash_table_insert(device_index, info->devpath, modem);
 }
 
 static struct {
@@ -1493,6 +1520,69 @@ static struct {
 	{ }
 };
 
+static void vendor_index_create(void)
+{
+	unsigned int i;
+
+	vendor_index = g_hash_table_new_full(g_str_hash, g_str_equal,
+							g_free, NULL);
+
+	/* Store the position, so that the last matching entry still wins */
+	for (i = 0; vendor_list[i].driver; i++) {
+		const char *vid = vendor_list[i].vid;
+		const char *pid = vendor_list[i].pid;
+		char *key;
+
+		key = g_strdup_printf("%s:%s:%s", vendor_list[i].drv,
+					vid ? vid : "", pid ? pid : "");
+
+		g_hash_table_replace(vendor_index, key,
+						GUINT_TO_POINTER(i + 1));
+	}
+}
+
+static unsigned int vendor_index_find(const char *drv, const char *vendor,
+							const char *model)
+{
+	char key[128];
+
+	snprintf(key, sizeof(key), "%s:%s:%s", drv, vendor ? vendor : "",
+						model ? model : "");
+
+	return GPOINTER_TO_UINT(g_hash_table_lookup(vendor_index, key));
+}
+
+/*
+ * Looks up the driver for a kernel driver, vendor and product id.  Entries
+ * without product id match all products of the vendor, entries without
+ * vendor id match all devices bound to the kernel driver.  Of all matching
+ * entries the last one in vendor_list wins, like the linear scan did.
+ */
+static const char *vendor_index_lookup(const char *drv, const char *vendor,
+							const char *model)
+{
+	unsigned int found = 0;
+	unsigned int i;
+
+	if (vendor && model) {
+		i = vendor_index_find(drv, vendor, model);
+		found = MAX(found, i);
+	}
+
+	if (vendor) {
+		i = vendor_index_find(drv, vendor, NULL);
+		found = MAX(found, i);
+	}
+
+	i = vendor_index_find(drv, NULL, NULL);
+	found = MAX(found, i);
+
+	if (found == 0)
+		return NULL;
+
+	return vendor_list[found - 1].driver;
+}
+
 static void check_usb_device(struct udev_device *device)
 {
 	struct udev_device *usb_device;
@@ -1528,7 +1618,6 @@ static void check_usb_device(struct udev_device *device)
 
 	if (driver == NULL) {
 		const char *drv;
-		unsigned int i;
 
 		drv = udev_device_get_property_value(device, "ID_USB_DRIVER");
 		if (drv == NULL) {
@@ -1549,23 +1638,7 @@ static void check_usb_device(struct udev_device *device)
 
 		DBG("%s [%s:%s]", drv, vendor, model);
 
-		for (i = 0; vendor_list[i].driver; i++) {
-			if (g_str_equal(vendor_list[i].drv, drv) == FALSE)
-				continue;
-
-			if (vendor_list[i].vid) {
-				if (!g_str_equal(vendor_list[i].vid, vendor))
-					continue;
-			}
-
-			if (vendor_list[i].pid) {
-				if (!g_str_equal(vendor_list[i].pid, model))
-					continue;
-			}
-
-			driver = vendor_list[i].driver;
-		}
-
+		driver = vendor_index_lookup(drv, vendor, model);
 		if (driver == NULL)
 			return;
 	}
@@ -1759,6 +1832,8 @@ static int detect_init(void)
 
 	modem_list = g_hash_table_new_full(g_str_hash, g_str_equal,
 						NULL, destroy_modem);
+	device_index = g_hash_table_new(g_str_hash, g_str_equal);
+	vendor_index_create();
 
 	udev_monitor_filter_add_match_subsystem_devtype(udev_mon, "tty", NULL);
 	udev_monitor_filter_add_match_subsystem_devtype(udev_mon, "usb", NULL);
@@ -1788,6 +1863,8 @@ static void detect_exit(void)
 	udev_monitor_filter_remove(udev_mon);
 
 	g_hash_table_destroy(modem_list);
+	g_hash_table_destroy(device_index);
+	g_hash_table_destroy(vendor_index);
 
 	udev_monitor_unref(udev_mon);
 	udev_unref(udev_ctx);
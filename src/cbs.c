@@ -68,6 +68,7 @@ struct ofono_cbs {
 	GSList *efcbmir_contents;
 	unsigned short efcbmid_length;
 	GSList *efcbmid_contents;
+	struct cbs_topic_map efcbmid_map; /* efcbmid_contents as a bitmap */
 	gboolean efcbmid_update;
 	guint reset_source;
 	int lac;
@@ -191,7 +192,7 @@ void ofono_cbs_notify(struct ofono_cbs *cbs, const unsigned char *pdu,
 		return;
 	}
 
-	if (cbs_topic_in_range(c.message_identifier, cbs->efcbmid_contents)) {
+	if (cbs_topic_map_contains(&cbs->efcbmid_map, c.message_identifier)) {
 		if (cbs->sim == NULL)
 			return;
 
@@ -307,24 +308,13 @@ static DBusMessage *cbs_get_properties(DBusConnection *conn,
 
 static char *cbs_topics_to_str(struct ofono_cbs *cbs, GSList *user_topics)
 {
-	GSList *topics = NULL;
-	char *topic_str;
-	struct cbs_topic_range etws_range = { 4352, 4356 };
-
-	if (user_topics != NULL)
-		topics = g_slist_concat(topics,
-					g_slist_copy(user_topics));
-
-	if (cbs->efcbmid_contents != NULL)
-		topics = g_slist_concat(topics,
-					g_slist_copy(cbs->efcbmid_contents));
-
-	topics = g_slist_append(topics, &etws_range);
+	struct cbs_topic_map topics = cbs->efcbmid_map;
 
-	topic_str = cbs_topic_ranges_to_string(topics);
-	g_slist_free(topics);
+	cbs_topic_map_add_ranges(&topics, user_topics);
+	cbs_topic_map_add_range(&topics, ETWS_TOPIC_TYPE_EARTHQUAKE,
+					ETWS_TOPIC_TYPE_EMERGENCY);
 
-	return topic_str;
+	return cbs_topic_map_to_string(&topics);
 }
 
 static void cbs_set_topics_cb(const struct ofono_error *error, void *data)
@@ -600,6 +590,7 @@ static void cbs_unregister(struct ofono_atom *atom)
 		cbs->efcbmid_length = 0;
 		g_slist_free_full(cbs->efcbmid_contents, g_free);
 		cbs->efcbmid_contents = NULL;
+		cbs_topic_map_clear(&cbs->efcbmid_map);
 	}
 
 	if (cbs->sim_context) {
@@ -874,6 +865,7 @@ static void sim_cbmid_read_cb(int ok, int length, int record,
 		goto done;
 
 	cbs->efcbmid_contents = g_slist_reverse(contents);
+	cbs_topic_map_add_ranges(&cbs->efcbmid_map, cbs->efcbmid_contents);
 
 	str = cbs_topic_ranges_to_string(cbs->efcbmid_contents);
 	DBG("Got cbmid: %s", str);
@@ -901,6 +893,7 @@ static void cbs_efcbmid_changed(int id, void *userdata)
 		cbs->efcbmid_length = 0;
 		g_slist_free_full(cbs->efcbmid_contents, g_free);
 		cbs->efcbmid_contents = NULL;
+		cbs_topic_map_clear(&cbs->efcbmid_map);
 	}
 
 	cbs->efcbmid_update = TRUE;
@@ -23,6 +23,8 @@
 #include <config.h>
 #endif
 
+#include <string.h>
+
 #include <glib.h>
 #include <gdbus.h>
 
@@ -30,8 +32,79 @@
 
 #define OFONO_ERROR_INTERFACE "org.ofono.Error"
 
+#define RATE_LIMITS_GROUP "PropertyRateLimits"
+
 static DBusConnection *g_connection;
 
+/*
+ * Properties which can change very often, e.g. signal strength, can be
+ * rate limited through main.conf.  For each such property at most one
+ * PropertyChanged signal per object is sent every @interval ms, carrying
+ * the latest value.  Numeric changes smaller than @hysteresis compared to
+ * the last value sent are not signalled at all.
+ */
+struct rate_limit {
+	char *interface;
+	guint interval;
+	guint hysteresis;
+};
+
+union basic_value {
+	dbus_bool_t v_bool;
+	unsigned char v_byte;
+	dbus_int16_t v_int16;
+	dbus_uint16_t v_uint16;
+	dbus_int32_t v_int32;
+	dbus_uint32_t v_uint32;
+	dbus_int64_t v_int64;
+	dbus_uint64_t v_uint64;
+	double v_double;
+	char *v_str;
+};
+
+struct limited_property {
+	char *path;
+	char *interface;
+	char *name;
+	const struct rate_limit *limit;
+	gint64 last_sent;
+	gboolean sent;
+	double sent_value;
+	int type;
+	union basic_value value;
+	guint timeout;
+};
+
+static GHashTable *rate_limits;
+static GHashTable *limited_properties;
+
+/*
+ * While a batch is open, PropertyChanged signals are queued instead of
+ * being sent.  A later change of the same property on the same object
+ * replaces the queued signal, so that only the latest value is sent
+ * when the outermost batch is closed.
+ */
+struct batched_signal {
+	char *key;
+	char *path;
+	char *interface;
+	DBusMessage *signal;
+};
+
+static unsigned int batch_depth;
+static GQueue batch_queue = G_QUEUE_INIT;
+static GHashTable *batch_signals;
+
+/*
+ * GetProperties replies of frequently polled interfaces are kept per
+ * object and interface, and served by copying the cached message.  The
+ * entry is dropped whenever a property on that interface changes.
+ */
+static GHashTable *cached_replies;
+
+static struct ofono_metric *signals_sent;
+static struct ofono_metric *signals_coalesced;
+
 struct error_mapping_entry {
 	int error;
 	DBusMessage *(*ofono_error_func)(DBusMessage *);
@@ -198,8 +271,170 @@ void ofono_dbus_dict_append_dict(DBusMessageIter *dict, const char *key,
 	dbus_message_iter_close_container(dict, &entry);
 }
 
-int ofono_dbus_signal_property_changed(DBusConnection *conn,
+static int emit_property_changed(DBusConnection *conn, DBusMessage *signal,
 					const char *path,
+					const char *interface,
+					const char *name)
+{
+	struct batched_signal *batched;
+	char *key;
+
+	if (batch_depth == 0) {
+		__ofono_metric_add(signals_sent, 1);
+		return g_dbus_send_message(conn, signal);
+	}
+
+	key = g_strconcat(path, " ", interface, " ", name, NULL);
+
+	batched = g_hash_table_lookup(batch_signals, key);
+	if (batched) {
+		g_free(key);
+		dbus_message_unref(batched->signal);
+		batched->signal = signal;
+		__ofono_metric_add(signals_coalesced, 1);
+		return 0;
+	}
+
+	batched = g_new0(struct batched_signal, 1);
+	batched->key = key;
+	batched->path = g_strdup(path);
+	batched->interface = g_strdup(interface);
+	batched->signal = signal;
+
+	g_queue_push_tail(&batch_queue, batched);
+	g_hash_table_insert(batch_signals, key, batched);
+
+	return 0;
+}
+
+static void batched_signal_free(struct batched_signal *batched)
+{
+	if (batched->signal)
+		dbus_message_unref(batched->signal);
+
+	g_free(batched->key);
+	g_free(batched->path);
+	g_free(batched->interface);
+	g_free(batched);
+}
+
+void __ofono_dbus_batch_begin(void)
+{
+	if (batch_signals == NULL)
+		batch_signals = g_hash_table_new(g_str_hash, g_str_equal);
+
+	batch_depth += 1;
+}
+
+void __ofono_dbus_batch_end(void)
+{
+	DBusConnection *conn = ofono_dbus_get_connection();
+	struct batched_signal *batched;
+
+	if (batch_depth == 0 || --batch_depth > 0)
+		return;
+
+	g_hash_table_remove_all(batch_signals);
+
+	while ((batched = g_queue_pop_head(&batch_queue))) {
+		/* The interface might have gone away during the batch */
+		if (conn && g_dbus_interface_is_registered(conn, batched->path,
+							batched->interface)) {
+			__ofono_metric_add(signals_sent, 1);
+			g_dbus_send_message(conn, batched->signal);
+			batched->signal = NULL;
+		}
+
+		batched_signal_free(batched);
+	}
+}
+
+static void batch_remove_interface(const char *path, const char *interface)
+{
+	GList *l = batch_queue.head;
+
+	while (l) {
+		struct batched_signal *batched = l->data;
+		GList *next = l->next;
+
+		if (g_str_equal(batched->path, path) &&
+				g_str_equal(batched->interface, interface)) {
+			g_hash_table_remove(batch_signals, batched->key);
+			g_queue_delete_link(&batch_queue, l);
+			batched_signal_free(batched);
+		}
+
+		l = next;
+	}
+}
+
+DBusMessage *__ofono_dbus_cached_reply(DBusMessage *msg,
+					const char *interface)
+{
+	DBusMessage *cached;
+	DBusMessage *reply;
+	char *key;
+
+	if (cached_replies == NULL)
+		return NULL;
+
+	key = g_strconcat(dbus_message_get_path(msg), " ", interface, NULL);
+	cached = g_hash_table_lookup(cached_replies, key);
+	g_free(key);
+
+	if (cached == NULL)
+		return NULL;
+
+	reply = dbus_message_copy(cached);
+	if (reply == NULL)
+		return NULL;
+
+	if (!dbus_message_set_reply_serial(reply,
+					dbus_message_get_serial(msg)) ||
+			!dbus_message_set_destination(reply,
+					dbus_message_get_sender(msg))) {
+		dbus_message_unref(reply);
+		return NULL;
+	}
+
+	return reply;
+}
+
+void __ofono_dbus_cache_reply(DBusMessage *msg, DBusMessage *reply,
+				const char *interface)
+{
+	DBusMessage *copy;
+	char *key;
+
+	if (reply == NULL)
+		return;
+
+	copy = dbus_message_copy(reply);
+	if (copy == NULL)
+		return;
+
+	if (cached_replies == NULL)
+		cached_replies = g_hash_table_new_full(g_str_hash, g_str_equal,
+					g_free,
+					(GDestroyNotify) dbus_message_unref);
+
+	key = g_strconcat(dbus_message_get_path(msg), " ", interface, NULL);
+	g_hash_table_replace(cached_replies, key, copy);
+}
+
+void __ofono_dbus_invalidate_reply(const char *path, const char *interface)
+{
+	char *key;
+
+	if (cached_replies == NULL || g_hash_table_size(cached_replies) == 0)
+		return;
+
+	key = g_strconcat(path, " ", interface, NULL);
+	g_hash_table_remove(cached_replies, key);
+	g_free(key);
+}
+
+static int send_property_changed(DBusConnection *conn, const char *path,
 					const char *interface,
 					const char *name,
 					int type, const void *value)
@@ -220,7 +455,254 @@ int ofono_dbus_signal_property_changed(DBusConnection *conn,
 
 	append_variant(&iter, type, value);
 
-	return g_dbus_send_message(conn, signal);
+	return emit_property_changed(conn, signal, path, interface, name);
+}
+
+static const struct rate_limit *find_rate_limit(const char *interface,
+						const char *name)
+{
+	GSList *l;
+
+	if (rate_limits == NULL)
+		return NULL;
+
+	for (l = g_hash_table_lookup(rate_limits, name); l; l = l->next) {
+		const struct rate_limit *limit = l->data;
+
+		if (g_str_equal(limit->interface, interface))
+			return limit;
+	}
+
+	return NULL;
+}
+
+static gboolean value_to_double(int type, const void *value, double *out)
+{
+	switch (type) {
+	case DBUS_TYPE_BYTE:
+		*out = *(const unsigned char *) value;
+		return TRUE;
+	case DBUS_TYPE_INT16:
+		*out = *(const dbus_int16_t *) value;
+		return TRUE;
+	case DBUS_TYPE_UINT16:
+		*out = *(const dbus_uint16_t *) value;
+		return TRUE;
+	case DBUS_TYPE_INT32:
+		*out = *(const dbus_int32_t *) value;
+		return TRUE;
+	case DBUS_TYPE_UINT32:
+		*out = *(const dbus_uint32_t *) value;
+		return TRUE;
+	case DBUS_TYPE_INT64:
+		*out = *(const dbus_int64_t *) value;
+		return TRUE;
+	case DBUS_TYPE_UINT64:
+		*out = *(const dbus_uint64_t *) value;
+		return TRUE;
+	case DBUS_TYPE_DOUBLE:
+		*out = *(const double *) value;
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
+static void limited_property_set_value(struct limited_property *prop,
+					int type, const void *value)
+{
+	if (prop->type == DBUS_TYPE_STRING ||
+			prop->type == DBUS_TYPE_OBJECT_PATH)
+		g_free(prop->value.v_str);
+
+	prop->type = type;
+
+	switch (type) {
+	case DBUS_TYPE_STRING:
+	case DBUS_TYPE_OBJECT_PATH:
+		prop->value.v_str = g_strdup(*(const char **) value);
+		break;
+	case DBUS_TYPE_BOOLEAN:
+		prop->value.v_bool = *(const dbus_bool_t *) value;
+		break;
+	case DBUS_TYPE_BYTE:
+		prop->value.v_byte = *(const unsigned char *) value;
+		break;
+	case DBUS_TYPE_INT16:
+		prop->value.v_int16 = *(const dbus_int16_t *) value;
+		break;
+	case DBUS_TYPE_UINT16:
+		prop->value.v_uint16 = *(const dbus_uint16_t *) value;
+		break;
+	case DBUS_TYPE_INT32:
+		prop->value.v_int32 = *(const dbus_int32_t *) value;
+		break;
+	case DBUS_TYPE_UINT32:
+		prop->value.v_uint32 = *(const dbus_uint32_t *) value;
+		break;
+	case DBUS_TYPE_INT64:
+		prop->value.v_int64 = *(const dbus_int64_t *) value;
+		break;
+	case DBUS_TYPE_UINT64:
+		prop->value.v_uint64 = *(const dbus_uint64_t *) value;
+		break;
+	case DBUS_TYPE_DOUBLE:
+		prop->value.v_double = *(const double *) value;
+		break;
+	}
+}
+
+static void limited_property_send(struct limited_property *prop,
+					DBusConnection *conn,
+					const void *value)
+{
+	prop->last_sent = g_get_monotonic_time();
+	prop->sent = value_to_double(prop->type, value, &prop->sent_value);
+
+	send_property_changed(conn, prop->path, prop->interface, prop->name,
+				prop->type, value);
+}
+
+static gboolean limited_property_timeout(gpointer user_data)
+{
+	struct limited_property *prop = user_data;
+	DBusConnection *conn = ofono_dbus_get_connection();
+
+	char *key;
+
+	prop->timeout = 0;
+
+	if (conn == NULL)
+		return FALSE;
+
+	if (g_dbus_interface_is_registered(conn, prop->path,
+						prop->interface)) {
+		limited_property_send(prop, conn, &prop->value);
+		return FALSE;
+	}
+
+	/* The object went away while the change was held back */
+	key = g_strconcat(prop->path, " ", prop->interface, " ",
+				prop->name, NULL);
+	g_hash_table_remove(limited_properties, key);
+	g_free(key);
+
+	return FALSE;
+}
+
+static void limited_property_free(gpointer user_data)
+{
+	struct limited_property *prop = user_data;
+
+	if (prop->timeout)
+		g_source_remove(prop->timeout);
+
+	limited_property_set_value(prop, DBUS_TYPE_INVALID, NULL);
+
+	g_free(prop->path);
+	g_free(prop->interface);
+	g_free(prop->name);
+	g_free(prop);
+}
+
+static gboolean limited_property_match(gpointer key, gpointer value,
+						gpointer user_data)
+{
+	struct limited_property *prop = value;
+	const char **match = user_data;
+
+	return g_str_equal(prop->path, match[0]) &&
+			g_str_equal(prop->interface, match[1]);
+}
+
+static int signal_limited_property(DBusConnection *conn, const char *path,
+					const char *interface,
+					const char *name,
+					const struct rate_limit *limit,
+					int type, const void *value)
+{
+	struct limited_property *prop;
+	char *key;
+	double v;
+	gint64 elapsed;
+
+	key = g_strconcat(path, " ", interface, " ", name, NULL);
+	prop = g_hash_table_lookup(limited_properties, key);
+
+	if (prop == NULL) {
+		prop = g_new0(struct limited_property, 1);
+		prop->path = g_strdup(path);
+		prop->interface = g_strdup(interface);
+		prop->name = g_strdup(name);
+		prop->limit = limit;
+		g_hash_table_insert(limited_properties, key, prop);
+	} else
+		g_free(key);
+
+	/* Small changes relative to what clients last saw are dropped */
+	if (prop->sent && limit->hysteresis &&
+			value_to_double(type, value, &v) &&
+			ABS(v - prop->sent_value) < limit->hysteresis) {
+		if (prop->timeout) {
+			g_source_remove(prop->timeout);
+			prop->timeout = 0;
+		}
+
+		return 0;
+	}
+
+	limited_property_set_value(prop, type, value);
+
+	if (prop->timeout)
+		return 0;
+
+	elapsed = (g_get_monotonic_time() - prop->last_sent) / 1000;
+
+	if (prop->last_sent == 0 || elapsed >= limit->interval) {
+		limited_property_send(prop, conn, value);
+		return 0;
+	}
+
+	prop->timeout = g_timeout_add(limit->interval - elapsed,
+					limited_property_timeout, prop);
+
+	return 0;
+}
+
+/*
+ * Called when @interface is unregistered from @path, drops its cached
+ * reply and any batched or rate limited change still held back for it.
+ */
+void __ofono_dbus_interface_removed(const char *path, const char *interface)
+{
+	const char *match[2] = { path, interface };
+
+	__ofono_dbus_invalidate_reply(path, interface);
+	batch_remove_interface(path, interface);
+
+	if (limited_properties == NULL)
+		return;
+
+	g_hash_table_foreach_remove(limited_properties,
+					limited_property_match, match);
+}
+
+int ofono_dbus_signal_property_changed(DBusConnection *conn,
+					const char *path,
+					const char *interface,
+					const char *name,
+					int type, const void *value)
+{
+	const struct rate_limit *limit = find_rate_limit(interface, name);
+
+	__ofono_dbus_invalidate_reply(path, interface);
+
+	if (limit != NULL)
+		return signal_limited_property(conn, path, interface, name,
+						limit, type, value);
+
+	return send_property_changed(conn, path, interface, name,
+					type, value);
 }
 
 int ofono_dbus_signal_array_property_changed(DBusConnection *conn,
@@ -233,6 +715,8 @@ int ofono_dbus_signal_array_property_changed(DBusConnection *conn,
 	DBusMessage *signal;
 	DBusMessageIter iter;
 
+	__ofono_dbus_invalidate_reply(path, interface);
+
 	signal = dbus_message_new_signal(path, interface, "PropertyChanged");
 	if (signal == NULL) {
 		ofono_error("Unable to allocate new %s.PropertyChanged signal",
@@ -246,7 +730,7 @@ int ofono_dbus_signal_array_property_changed(DBusConnection *conn,
 
 	append_array_variant(&iter, type, value);
 
-	return g_dbus_send_message(conn, signal);
+	return emit_property_changed(conn, signal, path, interface, name);
 }
 
 int ofono_dbus_signal_dict_property_changed(DBusConnection *conn,
@@ -259,6 +743,8 @@ int ofono_dbus_signal_dict_property_changed(DBusConnection *conn,
 	DBusMessage *signal;
 	DBusMessageIter iter;
 
+	__ofono_dbus_invalidate_reply(path, interface);
+
 	signal = dbus_message_new_signal(path, interface, "PropertyChanged");
 	if (signal == NULL) {
 		ofono_error("Unable to allocate new %s.PropertyChanged signal",
@@ -272,7 +758,7 @@ int ofono_dbus_signal_dict_property_changed(DBusConnection *conn,
 
 	append_dict_variant(&iter, type, value);
 
-	return g_dbus_send_message(conn, signal);
+	return emit_property_changed(conn, signal, path, interface, name);
 }
 
 DBusMessage *__ofono_error_invalid_args(DBusMessage *msg)
@@ -513,10 +999,101 @@ static void dbus_gsm_set_connection(DBusConnection *conn)
 	g_connection = conn;
 }
 
+static void rate_limit_list_free(gpointer user_data)
+{
+	GSList *list = user_data;
+	GSList *l;
+
+	for (l = list; l; l = l->next) {
+		struct rate_limit *limit = l->data;
+
+		g_free(limit->interface);
+		g_free(limit);
+	}
+
+	g_slist_free(list);
+}
+
+void __ofono_dbus_load_rate_limits(GKeyFile *config)
+{
+	char **keys;
+	int i;
+
+	if (config == NULL)
+		return;
+
+	keys = g_key_file_get_keys(config, RATE_LIMITS_GROUP, NULL, NULL);
+	if (keys == NULL)
+		return;
+
+	for (i = 0; keys[i]; i++) {
+		struct rate_limit *limit;
+		const char *name;
+		GSList *list;
+		gint *values;
+		gsize length;
+
+		name = strrchr(keys[i], '.');
+		if (name == NULL || name == keys[i] || name[1] == '\0') {
+			ofono_error("Invalid rate limited property %s",
+					keys[i]);
+			continue;
+		}
+
+		values = g_key_file_get_integer_list(config,
+							RATE_LIMITS_GROUP,
+							keys[i], &length, NULL);
+		if (values == NULL || length < 1 || length > 2 ||
+				values[0] <= 0 ||
+				(length == 2 && values[1] < 0)) {
+			ofono_error("Invalid rate limit for %s", keys[i]);
+			g_free(values);
+			continue;
+		}
+
+		limit = g_new0(struct rate_limit, 1);
+		limit->interface = g_strndup(keys[i], name - keys[i]);
+		limit->interval = values[0];
+		limit->hysteresis = length == 2 ? values[1] : 0;
+		name += 1;
+
+		g_free(values);
+
+		DBG("%s.%s interval %u hysteresis %u", limit->interface, name,
+				limit->interval, limit->hysteresis);
+
+		if (rate_limits == NULL) {
+			rate_limits = g_hash_table_new_full(g_str_hash,
+							g_str_equal, g_free,
+							rate_limit_list_free);
+			limited_properties = g_hash_table_new_full(g_str_hash,
+							g_str_equal, g_free,
+							limited_property_free);
+		}
+
+		list = g_hash_table_lookup(rate_limits, name);
+		if (list)
+			g_hash_table_steal(rate_limits, name);
+
+		list = g_slist_prepend(list, limit);
+		g_hash_table_insert(rate_limits, g_strdup(name), list);
+	}
+
+	g_strfreev(keys);
+}
+
 int __ofono_dbus_init(DBusConnection *conn)
 {
 	dbus_gsm_set_connection(conn);
 
+	signals_sent = __ofono_metric_counter(
+				"ofono_dbus_property_changed_total", NULL,
+				"PropertyChanged signals sent");
+	signals_coalesced = __ofono_metric_counter(
+				"ofono_dbus_property_changed_coalesced_total",
+				NULL, "PropertyChanged signals replaced while "
+				"batched");
+
 	return 0;
 }
 
@@ -524,6 +1101,37 @@ void __ofono_dbus_cleanup(void)
 {
 	DBusConnection *conn = ofono_dbus_get_connection();
 
+	if (batch_depth > 0) {
+		batch_depth = 1;
+		__ofono_dbus_batch_end();
+	}
+
+	if (batch_signals) {
+		g_hash_table_destroy(batch_signals);
+		batch_signals = NULL;
+	}
+
+	__ofono_metric_unref(signals_sent);
+	signals_sent = NULL;
+
+	__ofono_metric_unref(signals_coalesced);
+	signals_coalesced = NULL;
+
+	if (cached_replies) {
+		g_hash_table_destroy(cached_replies);
+		cached_replies = NULL;
+	}
+
+	if (limited_properties) {
+		g_hash_table_destroy(limited_properties);
+		limited_properties = NULL;
+	}
+
+	if (rate_limits) {
+		g_hash_table_destroy(rate_limits);
+		rate_limits = NULL;
+	}
+
 	if (conn == NULL || !dbus_connection_get_is_connected(conn))
 		return;
 
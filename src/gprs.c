@@ -1523,6 +1523,9 @@ static gboolean context_dbus_unregister(struct pri_context *ctx)
 	strcpy(path, ctx->path);
 	idmap_put(ctx->gprs->pid_map, ctx->id);
 
+	__ofono_dbus_interface_removed(path,
+					OFONO_CONNECTION_CONTEXT_INTERFACE);
+
 	return g_dbus_unregister_interface(conn, path,
 					OFONO_CONNECTION_CONTEXT_INTERFACE);
 }
@@ -1772,6 +1775,11 @@ static DBusMessage *gprs_get_properties(DBusConnection *conn,
 	DBusMessageIter dict;
 	dbus_bool_t value;
 
+	reply = __ofono_dbus_cached_reply(msg,
+					OFONO_CONNECTION_MANAGER_INTERFACE);
+	if (reply)
+		return reply;
+
 	reply = dbus_message_new_method_return(msg);
 	if (reply == NULL)
 		return NULL;
@@ -1807,6 +1815,9 @@ static DBusMessage *gprs_get_properties(DBusConnection *conn,
 
 	dbus_message_iter_close_container(&iter, &dict);
 
+	__ofono_dbus_cache_reply(msg, reply,
+					OFONO_CONNECTION_MANAGER_INTERFACE);
+
 	return reply;
 }
 
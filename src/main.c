@@ -33,6 +33,11 @@
 #include <gdbus.h>
 
 #include "ofono.h"
+#include "storage.h"
+
+#include "gattrace.h"
+
+#define DEFAULT_TRACE_SIZE 1024	/* KiB */
 
 #define SHUTDOWN_GRACE_SECONDS 10
 
@@ -154,6 +159,53 @@ static gboolean parse_debug(const char *key, const char *value,
 	return TRUE;
 }
 
+static GKeyFile *load_config(const char *file)
+{
+	GError *err = NULL;
+	GKeyFile *keyfile;
+
+	keyfile = g_key_file_new();
+
+	g_key_file_set_list_separator(keyfile, ',');
+
+	if (g_key_file_load_from_file(keyfile, file, 0, &err) == FALSE) {
+		if (!g_error_matches(err, G_FILE_ERROR, G_FILE_ERROR_NOENT))
+			ofono_error("Parsing %s failed: %s", file,
+					err->message);
+
+		g_error_free(err);
+		g_key_file_free(keyfile);
+		return NULL;
+	}
+
+	return keyfile;
+}
+
+static void setup_trace(GKeyFile *config)
+{
+	char *file;
+	int size;
+	GError *err = NULL;
+
+	file = g_key_file_get_string(config, "Trace", "File", NULL);
+	if (file == NULL)
+		return;
+
+	size = g_key_file_get_integer(config, "Trace", "Size", &err);
+	if (err) {
+		g_error_free(err);
+		size = DEFAULT_TRACE_SIZE;
+	}
+
+	if (size <= 0)
+		size = DEFAULT_TRACE_SIZE;
+
+	if (g_at_trace_open(file, (gsize) size * 1024) == FALSE)
+		ofono_error("Unable to open trace file %s", file);
+
+	g_free(file);
+}
+
 static GOptionEntry options[] = {
 	{ "debug", 'd', G_OPTION_FLAG_OPTIONAL_ARG,
 				G_OPTION_ARG_CALLBACK, parse_debug,
@@ -176,6 +228,7 @@ int main(int argc, char **argv)
 	GError *err = NULL;
 	DBusConnection *conn;
 	DBusError error;
+	GKeyFile *config;
 	guint signal;
 
 #ifdef NEED_THREADS
@@ -244,6 +297,20 @@ int main(int argc, char **argv)
 
 	__ofono_dbus_init(conn);
 
+	config = load_config(CONFIGDIR "/main.conf");
+	if (config) {
+		__ofono_dbus_load_rate_limits(config);
+		__ofono_modem_load_config(config);
+		setup_trace(config);
+	}
+
+	__ofono_metrics_init(config);
+
+	if (config)
+		g_key_file_free(config);
+
+	__ofono_storage_init();
+
 	__ofono_modemwatch_init();
 
 	__ofono_manager_init();
@@ -261,9 +328,15 @@ int main(int argc, char **argv)
 
 	__ofono_modemwatch_cleanup();
 
+	__ofono_storage_cleanup();
+
+	__ofono_metrics_cleanup();
+
 	__ofono_dbus_cleanup();
 	dbus_connection_unref(conn);
 
+	g_at_trace_close();
+
 cleanup:
 	g_source_remove(signal);
 
@@ -0,0 +1,708 @@
+/*
+ *
+ *  oFono - Open Source Telephony
+ *
+ *  Copyright (C) 2008-2011  Intel Corporation. All rights reserved.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 2 as
+ *  published by the Free Software Foundation.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <stddef.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include <glib.h>
+#include <gdbus.h>
+
+#include "ofono.h"
+
+#include "gatutil.h"
+
+/*
+ * All metrics are updated from the main loop, so plain integers are
+ * enough and updating a metric costs a pointer check and an add.
+ *
+ * Metrics with the same name form a family sharing the help text and
+ * type, and are told apart by their labels, e.g. modem="/phonesim".
+ * Registering an already known name and labels pair returns the
+ * existing metric with an extra reference, so per-modem users simply
+ * register on probe and unref on removal.
+ */
+
+enum metric_type {
+	METRIC_TYPE_COUNTER,
+	METRIC_TYPE_GAUGE,
+	METRIC_TYPE_HISTOGRAM,
+};
+
+struct ofono_metric {
+	int refcount;
+	enum metric_type type;
+	char *name;
+	char *labels;
+	char *key;
+	gint64 value;
+	guint64 *bounds;
+	guint64 *buckets;
+	unsigned int n_bounds;
+	guint64 sum;
+};
+
+struct metric_family {
+	char *name;
+	char *help;
+	enum metric_type type;
+	GSList *metrics;
+};
+
+static GHashTable *metric_families;
+static GHashTable *metrics;
+
+static GIOChannel *metrics_socket;
+static guint metrics_socket_watch;
+static char *metrics_socket_path;
+static GSList *metrics_clients;
+
+struct metrics_client {
+	GIOChannel *channel;
+	guint watch;
+	char *text;
+	size_t len;
+	size_t written;
+};
+
+static const char *metric_type_names[] = {
+	[METRIC_TYPE_COUNTER] = "counter",
+	[METRIC_TYPE_GAUGE] = "gauge",
+	[METRIC_TYPE_HISTOGRAM] = "histogram",
+};
+
+/* Counters kept by the AT, HDLC and PPP code in gatchat */
+static const struct {
+	const char *name;
+	const char *help;
+	size_t offset;
+} gat_counters[] = {
+	{ "ofono_at_commands_total", "AT commands queued",
+		offsetof(GAtStats, commands) },
+	{ "ofono_at_wakeup_timeouts_total",
+		"Wakeup commands left unanswered by the modem",
+		offsetof(GAtStats, wakeup_timeouts) },
+	{ "ofono_hdlc_rx_frames_total", "HDLC frames received",
+		offsetof(GAtStats, hdlc_rx_frames) },
+	{ "ofono_hdlc_rx_bytes_total", "HDLC payload bytes received",
+		offsetof(GAtStats, hdlc_rx_bytes) },
+	{ "ofono_hdlc_tx_frames_total", "HDLC frames sent",
+		offsetof(GAtStats, hdlc_tx_frames) },
+	{ "ofono_hdlc_tx_bytes_total", "HDLC payload bytes sent",
+		offsetof(GAtStats, hdlc_tx_bytes) },
+	{ "ofono_hdlc_fcs_errors_total",
+		"HDLC frames dropped due to a bad FCS",
+		offsetof(GAtStats, hdlc_fcs_errors) },
+};
+
+static void metric_family_free(gpointer user_data)
+{
+	struct metric_family *family = user_data;
+
+	g_slist_free(family->metrics);
+	g_free(family->name);
+	g_free(family->help);
+	g_free(family);
+}
+
+static struct ofono_metric *metric_register(enum metric_type type,
+						const char *name,
+						const char *labels,
+						const char *help)
+{
+	struct metric_family *family;
+	struct ofono_metric *metric;
+	char *key;
+
+	if (metrics == NULL) {
+		metrics = g_hash_table_new(g_str_hash, g_str_equal);
+		metric_families = g_hash_table_new_full(g_str_hash,
+						g_str_equal, NULL,
+						metric_family_free);
+	}
+
+	if (labels == NULL)
+		labels = "";
+
+	key = g_strconcat(name, "{", labels, "}", NULL);
+
+	metric = g_hash_table_lookup(metrics, key);
+	if (metric) {
+		g_free(key);
+
+		if (metric->type != type)
+			return NULL;
+
+		metric->refcount += 1;
+		return metric;
+	}
+
+	family = g_hash_table_lookup(metric_families, name);
+	if (family == NULL) {
+		family = g_new0(struct metric_family, 1);
+		family->name = g_strdup(name);
+		family->help = g_strdup(help);
+		family->type = type;
+
+		g_hash_table_insert(metric_families, family->name, family);
+	} else if (family->type != type) {
+		ofono_error("Metric %s registered with different types", name);
+		g_free(key);
+		return NULL;
+	}
+
+	metric = g_new0(struct ofono_metric, 1);
+	metric->refcount = 1;
+	metric->type = type;
+	metric->name = g_strdup(name);
+	metric->labels = g_strdup(labels);
+	metric->key = key;
+
+	family->metrics = g_slist_prepend(family->metrics, metric);
+	g_hash_table_insert(metrics, metric->key, metric);
+
+	return metric;
+}
+
+struct ofono_metric *__ofono_metric_counter(const char *name,
+						const char *labels,
+						const char *help)
+{
+	return metric_register(METRIC_TYPE_COUNTER, name, labels, help);
+}
+
+struct ofono_metric *__ofono_metric_gauge(const char *name,
+						const char *labels,
+						const char *help)
+{
+	return metric_register(METRIC_TYPE_GAUGE, name, labels, help);
+}
+
+/*
+ * The bounds are the inclusive upper limits of the buckets in ascending
+ * order, observations above the last bound only count towards +Inf.
+ */
+struct ofono_metric *__ofono_metric_histogram(const char *name,
+						const char *labels,
+						const char *help,
+						const guint64 *bounds,
+						unsigned int n_bounds)
+{
+	struct ofono_metric *metric;
+
+	metric = metric_register(METRIC_TYPE_HISTOGRAM, name, labels, help);
+	if (metric == NULL || metric->bounds != NULL)
+		return metric;
+
+	metric->bounds = g_new(guint64, n_bounds);
+	memcpy(metric->bounds, bounds, n_bounds * sizeof(guint64));
+	metric->buckets = g_new0(guint64, n_bounds + 1);
+	metric->n_bounds = n_bounds;
+
+	return metric;
+}
+
+static void metric_free(struct ofono_metric *metric)
+{
+	g_free(metric->name);
+	g_free(metric->labels);
+	g_free(metric->key);
+	g_free(metric->bounds);
+	g_free(metric->buckets);
+	g_free(metric);
+}
+
+void __ofono_metric_unref(struct ofono_metric *metric)
+{
+	struct metric_family *family;
+
+	if (metric == NULL)
+		return;
+
+	if (--metric->refcount > 0)
+		return;
+
+	/* The registry may be gone already during shutdown */
+	if (metrics == NULL)
+		goto done;
+
+	g_hash_table_remove(metrics, metric->key);
+
+	family = g_hash_table_lookup(metric_families, metric->name);
+	if (family) {
+		family->metrics = g_slist_remove(family->metrics, metric);
+
+		if (family->metrics == NULL)
+			g_hash_table_remove(metric_families, metric->name);
+	}
+
+done:
+	metric_free(metric);
+}
+
+void __ofono_metric_add(struct ofono_metric *metric, guint64 value)
+{
+	if (metric == NULL)
+		return;
+
+	metric->value += value;
+}
+
+void __ofono_metric_set(struct ofono_metric *metric, gint64 value)
+{
+	if (metric == NULL)
+		return;
+
+	metric->value = value;
+}
+
+void __ofono_metric_observe(struct ofono_metric *metric, guint64 value)
+{
+	unsigned int i;
+
+	if (metric == NULL || metric->buckets == NULL)
+		return;
+
+	for (i = 0; i < metric->n_bounds; i++)
+		if (value <= metric->bounds[i])
+			break;
+
+	metric->buckets[i] += 1;
+	metric->value += 1;
+	metric->sum += value;
+}
+
+typedef void (*metrics_family_cb)(const char *name, const char *help,
+					enum metric_type type, void *data);
+typedef void (*metrics_sample_cb)(const char *name, const char *labels,
+					enum metric_type type, gint64 value,
+					void *data);
+
+static void histogram_foreach_sample(struct ofono_metric *metric,
+					metrics_sample_cb sample, void *data)
+{
+	char *name;
+	char *labels;
+	guint64 cumulative = 0;
+	unsigned int i;
+	const char *sep = metric->labels[0] ? "," : "";
+
+	name = g_strconcat(metric->name, "_bucket", NULL);
+
+	for (i = 0; i <= metric->n_bounds; i++) {
+		cumulative += metric->buckets[i];
+
+		if (i < metric->n_bounds)
+			labels = g_strdup_printf("%s%sle=\"%" G_GUINT64_FORMAT
+						"\"", metric->labels, sep,
+						metric->bounds[i]);
+		else
+			labels = g_strdup_printf("%s%sle=\"+Inf\"",
+						metric->labels, sep);
+
+		sample(name, labels, METRIC_TYPE_HISTOGRAM, cumulative, data);
+		g_free(labels);
+	}
+
+	g_free(name);
+
+	name = g_strconcat(metric->name, "_sum", NULL);
+	sample(name, metric->labels, METRIC_TYPE_HISTOGRAM, metric->sum, data);
+	g_free(name);
+
+	name = g_strconcat(metric->name, "_count", NULL);
+	sample(name, metric->labels, METRIC_TYPE_HISTOGRAM, metric->value,
+									data);
+	g_free(name);
+}
+
+static gint metric_compare(gconstpointer a, gconstpointer b)
+{
+	const struct ofono_metric *ma = a;
+	const struct ofono_metric *mb = b;
+
+	return strcmp(ma->labels, mb->labels);
+}
+
+static void metrics_foreach(metrics_family_cb family_cb,
+				metrics_sample_cb sample_cb, void *data)
+{
+	const GAtStats *stats = g_at_util_get_stats();
+	GList *names = NULL;
+	GList *l;
+	unsigned int i;
+
+	for (i = 0; i < G_N_ELEMENTS(gat_counters); i++) {
+		const guint64 *value = (const guint64 *)
+				((const char *) stats + gat_counters[i].offset);
+
+		family_cb(gat_counters[i].name, gat_counters[i].help,
+				METRIC_TYPE_COUNTER, data);
+		sample_cb(gat_counters[i].name, "", METRIC_TYPE_COUNTER,
+				*value, data);
+	}
+
+	if (metric_families == NULL)
+		return;
+
+	names = g_hash_table_get_keys(metric_families);
+	names = g_list_sort(names, (GCompareFunc) strcmp);
+
+	for (l = names; l; l = l->next) {
+		struct metric_family *family;
+		GSList *sorted;
+		GSList *k;
+
+		family = g_hash_table_lookup(metric_families, l->data);
+		family_cb(family->name, family->help, family->type, data);
+
+		sorted = g_slist_sort(g_slist_copy(family->metrics),
+					metric_compare);
+
+		for (k = sorted; k; k = k->next) {
+			struct ofono_metric *metric = k->data;
+
+			if (metric->type == METRIC_TYPE_HISTOGRAM)
+				histogram_foreach_sample(metric, sample_cb,
+								data);
+			else
+				sample_cb(metric->name, metric->labels,
+						metric->type, metric->value,
+						data);
+		}
+
+		g_slist_free(sorted);
+	}
+
+	g_list_free(names);
+}
+
+static void text_family(const char *name, const char *help,
+				enum metric_type type, void *data)
+{
+	GString *text = data;
+
+	g_string_append_printf(text, "# HELP %s %s\n", name, help);
+	g_string_append_printf(text, "# TYPE %s %s\n", name,
+						metric_type_names[type]);
+}
+
+static void text_sample(const char *name, const char *labels,
+				enum metric_type type, gint64 value, void *data)
+{
+	GString *text = data;
+
+	g_string_append(text, name);
+
+	if (labels[0] != '\0')
+		g_string_append_printf(text, "{%s}", labels);
+
+	if (type == METRIC_TYPE_GAUGE)
+		g_string_append_printf(text, " %" G_GINT64_FORMAT "\n", value);
+	else
+		g_string_append_printf(text, " %" G_GUINT64_FORMAT "\n",
+							(guint64) value);
+}
+
+/* Returns all metrics in the Prometheus text exposition format */
+char *__ofono_metrics_export(void)
+{
+	GString *text = g_string_sized_new(4096);
+
+	metrics_foreach(text_family, text_sample, text);
+
+	return g_string_free(text, FALSE);
+}
+
+static void dict_family(const char *name, const char *help,
+				enum metric_type type, void *data)
+{
+}
+
+static void dict_sample(const char *name, const char *labels,
+				enum metric_type type, gint64 value, void *data)
+{
+	DBusMessageIter *dict = data;
+	char *key;
+
+	if (labels[0] != '\0')
+		key = g_strdup_printf("%s{%s}", name, labels);
+	else
+		key = g_strdup(name);
+
+	if (type == METRIC_TYPE_GAUGE)
+		ofono_dbus_dict_append(dict, key, DBUS_TYPE_INT64, &value);
+	else
+		ofono_dbus_dict_append(dict, key, DBUS_TYPE_UINT64, &value);
+
+	g_free(key);
+}
+
+static DBusMessage *metrics_get_metrics(DBusConnection *conn,
+					DBusMessage *msg, void *data)
+{
+	DBusMessage *reply;
+	DBusMessageIter iter;
+	DBusMessageIter dict;
+
+	reply = dbus_message_new_method_return(msg);
+	if (reply == NULL)
+		return NULL;
+
+	dbus_message_iter_init_append(reply, &iter);
+
+	dbus_message_iter_open_container(&iter, DBUS_TYPE_ARRAY,
+					OFONO_PROPERTIES_ARRAY_SIGNATURE,
+					&dict);
+	metrics_foreach(dict_family, dict_sample, &dict);
+	dbus_message_iter_close_container(&iter, &dict);
+
+	return reply;
+}
+
+static DBusMessage *metrics_export(DBusConnection *conn,
+					DBusMessage *msg, void *data)
+{
+	DBusMessage *reply;
+	char *text;
+
+	text = __ofono_metrics_export();
+
+	reply = dbus_message_new_method_return(msg);
+	if (reply)
+		dbus_message_append_args(reply, DBUS_TYPE_STRING, &text,
+						DBUS_TYPE_INVALID);
+
+	g_free(text);
+
+	return reply;
+}
+
+static const GDBusMethodTable metrics_methods[] = {
+	{ GDBUS_METHOD("GetMetrics",
+			NULL, GDBUS_ARGS({ "metrics", "a{sv}" }),
+			metrics_get_metrics) },
+	{ GDBUS_METHOD("Export",
+			NULL, GDBUS_ARGS({ "text", "s" }),
+			metrics_export) },
+	{ }
+};
+
+/*
+ * Every connection on the metrics socket gets a snapshot of all metrics
+ * and is closed again.  The socket is non-blocking and the snapshot is
+ * written out as the client reads it, so a client which stops reading
+ * can't stall the main loop.
+ */
+static void metrics_client_free(gpointer user_data)
+{
+	struct metrics_client *client = user_data;
+
+	metrics_clients = g_slist_remove(metrics_clients, client);
+
+	g_io_channel_unref(client->channel);
+	g_free(client->text);
+	g_free(client);
+}
+
+static gboolean metrics_client_write(GIOChannel *channel,
+					GIOCondition cond, gpointer user_data)
+{
+	struct metrics_client *client = user_data;
+	int fd = g_io_channel_unix_get_fd(channel);
+	ssize_t n;
+
+	if (cond & (G_IO_NVAL | G_IO_ERR | G_IO_HUP))
+		goto done;
+
+	while (client->written < client->len) {
+		n = send(fd, client->text + client->written,
+				client->len - client->written,
+				MSG_NOSIGNAL | MSG_DONTWAIT);
+
+		if (n < 0 && errno == EINTR)
+			continue;
+
+		if (n < 0 && errno == EAGAIN)
+			return TRUE;
+
+		if (n <= 0)
+			goto done;
+
+		client->written += n;
+	}
+
+done:
+	client->watch = 0;
+	return FALSE;
+}
+
+static gboolean metrics_socket_accept(GIOChannel *channel,
+					GIOCondition cond, gpointer user_data)
+{
+	struct metrics_client *client;
+	int fd;
+
+	if (cond & (G_IO_NVAL | G_IO_ERR | G_IO_HUP)) {
+		metrics_socket_watch = 0;
+		return FALSE;
+	}
+
+	fd = accept4(g_io_channel_unix_get_fd(channel), NULL, NULL,
+					SOCK_CLOEXEC | SOCK_NONBLOCK);
+	if (fd < 0)
+		return TRUE;
+
+	client = g_new0(struct metrics_client, 1);
+	client->channel = g_io_channel_unix_new(fd);
+	g_io_channel_set_close_on_unref(client->channel, TRUE);
+	client->text = __ofono_metrics_export();
+	client->len = strlen(client->text);
+
+	client->watch = g_io_add_watch_full(client->channel,
+				G_PRIORITY_DEFAULT,
+				G_IO_OUT | G_IO_ERR | G_IO_HUP | G_IO_NVAL,
+				metrics_client_write, client,
+				metrics_client_free);
+
+	metrics_clients = g_slist_prepend(metrics_clients, client);
+
+	return TRUE;
+}
+
+static int metrics_socket_open(const char *path)
+{
+	struct sockaddr_un addr;
+	int fd;
+
+	if (strlen(path) >= sizeof(addr.sun_path))
+		return -ENAMETOOLONG;
+
+	fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (fd < 0)
+		return -errno;
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, path);
+
+	unlink(path);
+
+	/* Only the user running ofonod may read the metrics */
+	if (bind(fd, (struct sockaddr *) &addr, sizeof(addr)) < 0 ||
+			chmod(path, S_IRUSR | S_IWUSR) < 0 ||
+			listen(fd, 4) < 0) {
+		int err = -errno;
+
+		close(fd);
+		return err;
+	}
+
+	metrics_socket = g_io_channel_unix_new(fd);
+	g_io_channel_set_close_on_unref(metrics_socket, TRUE);
+
+	metrics_socket_watch = g_io_add_watch(metrics_socket,
+				G_IO_IN | G_IO_ERR | G_IO_HUP | G_IO_NVAL,
+				metrics_socket_accept, NULL);
+	metrics_socket_path = g_strdup(path);
+
+	return 0;
+}
+
+int __ofono_metrics_init(GKeyFile *config)
+{
+	DBusConnection *conn = ofono_dbus_get_connection();
+	char *path = NULL;
+	int err;
+
+	if (!g_dbus_register_interface(conn, OFONO_MANAGER_PATH,
+					OFONO_METRICS_INTERFACE,
+					metrics_methods, NULL, NULL,
+					NULL, NULL))
+		return -EIO;
+
+	if (config)
+		path = g_key_file_get_string(config, "Metrics", "Socket",
+						NULL);
+
+	if (path == NULL)
+		return 0;
+
+	err = metrics_socket_open(path);
+	if (err < 0)
+		ofono_error("Unable to open metrics socket %s: %s (%d)",
+				path, strerror(-err), -err);
+
+	g_free(path);
+
+	return 0;
+}
+
+void __ofono_metrics_cleanup(void)
+{
+	DBusConnection *conn = ofono_dbus_get_connection();
+
+	g_dbus_unregister_interface(conn, OFONO_MANAGER_PATH,
+					OFONO_METRICS_INTERFACE);
+
+	if (metrics_socket_watch)
+		g_source_remove(metrics_socket_watch);
+
+	metrics_socket_watch = 0;
+
+	while (metrics_clients) {
+		struct metrics_client *client = metrics_clients->data;
+
+		/* Frees the client and removes it from the list */
+		g_source_remove(client->watch);
+	}
+
+	if (metrics_socket) {
+		g_io_channel_unref(metrics_socket);
+		metrics_socket = NULL;
+
+		unlink(metrics_socket_path);
+	}
+
+	g_free(metrics_socket_path);
+	metrics_socket_path = NULL;
+
+	/* Metrics still referenced are freed by their last unref */
+	if (metrics) {
+		g_hash_table_destroy(metrics);
+		metrics = NULL;
+	}
+
+	if (metric_families) {
+		g_hash_table_destroy(metric_families);
+		metric_families = NULL;
+	}
+}
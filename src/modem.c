@@ -44,6 +44,15 @@ static int modems_remaining = 0;
 
 static struct ofono_watchlist *g_modemwatches = NULL;
 
+/*
+ * Limit on the number of modems powering up at the same time, 0 for no
+ * limit.  Modems above the limit wait in power_up_queue for their turn.
+ */
+static unsigned int max_powering_up = 0;
+static unsigned int powering_up = 0;
+static GQueue power_up_queue = G_QUEUE_INIT;
+static guint power_up_source = 0;
+
 enum property_type {
 	PROPERTY_TYPE_INVALID = 0,
 	PROPERTY_TYPE_STRING,
@@ -62,7 +71,8 @@ struct ofono_modem {
 	char			*path;
 	enum modem_state	modem_state;
 	GSList			*atoms;
-	struct ofono_watchlist	*atom_watches;
+	GSList			*atoms_by_type[OFONO_ATOM_TYPE_LAST];
+	struct ofono_watchlist	*atom_watches[OFONO_ATOM_TYPE_LAST];
 	GSList			*interface_list;
 	GSList			*feature_list;
 	unsigned int		call_ids;
@@ -87,6 +97,10 @@ struct ofono_modem {
 	void			*driver_data;
 	char			*driver_type;
 	char			*name;
+	gint64			power_up_queued;
+	gint64			power_up_start;
+	guint			power_up_timeout;
+	struct ofono_metric	*power_up_time;
 };
 
 struct ofono_devinfo {
@@ -110,10 +124,16 @@ struct ofono_atom {
 	struct ofono_modem *modem;
 };
 
-struct atom_watch {
-	struct ofono_watchlist_item item;
-	enum ofono_atom_type type;
-};
+/*
+ * Atom watches are kept in one watchlist per atom type.  The type is
+ * stored in the low bits of the id handed out, so that a watch can be
+ * removed without searching all the lists.
+ */
+#define ATOM_WATCH_TYPE_BITS 6
+#define ATOM_WATCH_TYPE_MASK ((1 << ATOM_WATCH_TYPE_BITS) - 1)
+
+G_STATIC_ASSERT(OFONO_ATOM_TYPE_LAST <= 1 << ATOM_WATCH_TYPE_BITS);
+G_STATIC_ASSERT(OFONO_WATCHLIST_ID_BITS <= 32 - ATOM_WATCH_TYPE_BITS);
 
 struct modem_property {
 	enum property_type type;
@@ -203,6 +223,8 @@ struct ofono_atom *__ofono_modem_add_atom(struct ofono_modem *modem,
 	atom->modem = modem;
 
 	modem->atoms = g_slist_prepend(modem->atoms, atom);
+	modem->atoms_by_type[type] = g_slist_prepend(
+					modem->atoms_by_type[type], atom);
 
 	return atom;
 }
@@ -240,19 +262,19 @@ static void call_watches(struct ofono_atom *atom,
 				enum ofono_atom_watch_condition cond)
 {
 	struct ofono_modem *modem = atom->modem;
-	GSList *atom_watches = modem->atom_watches->items;
-	GSList *l;
-	struct atom_watch *watch;
+	struct ofono_watchlist *watches = modem->atom_watches[atom->type];
+	struct ofono_watchlist_iter iter;
+	struct ofono_watchlist_item *item;
 	ofono_atom_watch_func notify;
 
-	for (l = atom_watches; l; l = l->next) {
-		watch = l->data;
+	if (watches == NULL)
+		return;
 
-		if (watch->type != atom->type)
-			continue;
+	__ofono_watchlist_iter_init(&iter, watches);
 
-		notify = watch->item.notify;
-		notify(atom, cond, watch->item.notify_data);
+	while ((item = __ofono_watchlist_iter_next(&iter))) {
+		notify = item->notify;
+		notify(atom, cond, item->notify_data);
 	}
 }
 
@@ -264,7 +286,9 @@ void __ofono_atom_register(struct ofono_atom *atom,
 
 	atom->unregister = unregister;
 
+	__ofono_dbus_batch_begin();
 	call_watches(atom, OFONO_ATOM_WATCH_CONDITION_REGISTERED);
+	__ofono_dbus_batch_end();
 }
 
 void __ofono_atom_unregister(struct ofono_atom *atom)
@@ -272,10 +296,18 @@ void __ofono_atom_unregister(struct ofono_atom *atom)
 	if (atom->unregister == NULL)
 		return;
 
+	__ofono_dbus_batch_begin();
+
 	call_watches(atom, OFONO_ATOM_WATCH_CONDITION_UNREGISTERED);
 
 	atom->unregister(atom);
 	atom->unregister = NULL;
+
+	/* Modem properties include e.g. the device information */
+	__ofono_dbus_invalidate_reply(atom->modem->path,
+					OFONO_MODEM_INTERFACE);
+
+	__ofono_dbus_batch_end();
 }
 
 gboolean __ofono_atom_get_registered(struct ofono_atom *atom)
@@ -288,40 +320,51 @@ unsigned int __ofono_modem_add_atom_watch(struct ofono_modem *modem,
 					ofono_atom_watch_func notify,
 					void *data, ofono_destroy_func destroy)
 {
-	struct atom_watch *watch;
+	struct ofono_watchlist_item *item;
 	unsigned int id;
 	GSList *l;
 	struct ofono_atom *atom;
 
-	if (notify == NULL)
+	if (notify == NULL || type >= OFONO_ATOM_TYPE_LAST)
 		return 0;
 
-	watch = g_new0(struct atom_watch, 1);
+	if (modem->atom_watches[type] == NULL)
+		modem->atom_watches[type] = __ofono_watchlist_new(g_free);
 
-	watch->type = type;
-	watch->item.notify = notify;
-	watch->item.destroy = destroy;
-	watch->item.notify_data = data;
+	item = g_new0(struct ofono_watchlist_item, 1);
 
-	id = __ofono_watchlist_add_item(modem->atom_watches,
-					(struct ofono_watchlist_item *)watch);
+	item->notify = notify;
+	item->destroy = destroy;
+	item->notify_data = data;
 
-	for (l = modem->atoms; l; l = l->next) {
+	id = __ofono_watchlist_add_item(modem->atom_watches[type], item);
+	if (id == 0) {
+		g_free(item);
+		return 0;
+	}
+
+	for (l = modem->atoms_by_type[type]; l; l = l->next) {
 		atom = l->data;
 
-		if (atom->type != type || atom->unregister == NULL)
+		if (atom->unregister == NULL)
 			continue;
 
 		notify(atom, OFONO_ATOM_WATCH_CONDITION_REGISTERED, data);
 	}
 
-	return id;
+	return id << ATOM_WATCH_TYPE_BITS | type;
 }
 
 gboolean __ofono_modem_remove_atom_watch(struct ofono_modem *modem,
 						unsigned int id)
 {
-	return __ofono_watchlist_remove_item(modem->atom_watches, id);
+	unsigned int type = id & ATOM_WATCH_TYPE_MASK;
+
+	if (type >= OFONO_ATOM_TYPE_LAST || modem->atom_watches[type] == NULL)
+		return FALSE;
+
+	return __ofono_watchlist_remove_item(modem->atom_watches[type],
+						id >> ATOM_WATCH_TYPE_BITS);
 }
 
 struct ofono_atom *__ofono_modem_find_atom(struct ofono_modem *modem,
@@ -330,13 +373,13 @@ struct ofono_atom *__ofono_modem_find_atom(struct ofono_modem *modem,
 	GSList *l;
 	struct ofono_atom *atom;
 
-	if (modem == NULL)
+	if (modem == NULL || type >= OFONO_ATOM_TYPE_LAST)
 		return NULL;
 
-	for (l = modem->atoms; l; l = l->next) {
+	for (l = modem->atoms_by_type[type]; l; l = l->next) {
 		atom = l->data;
 
-		if (atom->type == type && atom->unregister != NULL)
+		if (atom->unregister != NULL)
 			return atom;
 	}
 
@@ -350,15 +393,12 @@ void __ofono_modem_foreach_atom(struct ofono_modem *modem,
 	GSList *l;
 	struct ofono_atom *atom;
 
-	if (modem == NULL)
+	if (modem == NULL || type >= OFONO_ATOM_TYPE_LAST)
 		return;
 
-	for (l = modem->atoms; l; l = l->next) {
+	for (l = modem->atoms_by_type[type]; l; l = l->next) {
 		atom = l->data;
 
-		if (atom->type != type)
-			continue;
-
 		callback(atom, data);
 	}
 }
@@ -371,15 +411,12 @@ void __ofono_modem_foreach_registered_atom(struct ofono_modem *modem,
 	GSList *l;
 	struct ofono_atom *atom;
 
-	if (modem == NULL)
+	if (modem == NULL || type >= OFONO_ATOM_TYPE_LAST)
 		return;
 
-	for (l = modem->atoms; l; l = l->next) {
+	for (l = modem->atoms_by_type[type]; l; l = l->next) {
 		atom = l->data;
 
-		if (atom->type != type)
-			continue;
-
 		if (atom->unregister == NULL)
 			continue;
 
@@ -392,6 +429,8 @@ void __ofono_atom_free(struct ofono_atom *atom)
 	struct ofono_modem *modem = atom->modem;
 
 	modem->atoms = g_slist_remove(modem->atoms, atom);
+	modem->atoms_by_type[atom->type] = g_slist_remove(
+				modem->atoms_by_type[atom->type], atom);
 
 	__ofono_atom_unregister(atom);
 
@@ -426,6 +465,9 @@ static void flush_atoms(struct ofono_modem *modem, enum modem_state new_state)
 		if (atom->destruct)
 			atom->destruct(atom);
 
+		modem->atoms_by_type[atom->type] = g_slist_remove(
+					modem->atoms_by_type[atom->type], atom);
+
 		g_free(atom);
 
 		if (prev)
@@ -441,15 +483,16 @@ static void flush_atoms(struct ofono_modem *modem, enum modem_state new_state)
 
 static void notify_online_watches(struct ofono_modem *modem)
 {
+	struct ofono_watchlist_iter iter;
 	struct ofono_watchlist_item *item;
-	GSList *l;
 	ofono_modem_online_notify_func notify;
 
 	if (modem->online_watches == NULL)
 		return;
 
-	for (l = modem->online_watches->items; l; l = l->next) {
-		item = l->data;
+	__ofono_watchlist_iter_init(&iter, modem->online_watches);
+
+	while ((item = __ofono_watchlist_iter_next(&iter))) {
 		notify = item->notify;
 		notify(modem, modem->online, item->notify_data);
 	}
@@ -457,15 +500,16 @@ static void notify_online_watches(struct ofono_modem *modem)
 
 static void notify_powered_watches(struct ofono_modem *modem)
 {
+	struct ofono_watchlist_iter iter;
 	struct ofono_watchlist_item *item;
-	GSList *l;
 	ofono_modem_powered_notify_func notify;
 
 	if (modem->powered_watches == NULL)
 		return;
 
-	for (l = modem->powered_watches->items; l; l = l->next) {
-		item = l->data;
+	__ofono_watchlist_iter_init(&iter, modem->powered_watches);
+
+	while ((item = __ofono_watchlist_iter_next(&iter))) {
 		notify = item->notify;
 		notify(modem, modem->powered, item->notify_data);
 	}
@@ -501,6 +545,8 @@ static void modem_change_state(struct ofono_modem *modem,
 
 	modem->modem_state = new_state;
 
+	__ofono_dbus_batch_begin();
+
 	if (old_state > new_state)
 		flush_atoms(modem, new_state);
 
@@ -531,6 +577,8 @@ static void modem_change_state(struct ofono_modem *modem,
 
 		break;
 	}
+
+	__ofono_dbus_batch_end();
 }
 
 unsigned int __ofono_modem_add_online_watch(struct ofono_modem *modem,
@@ -583,17 +631,7 @@ void __ofono_modem_remove_powered_watch(struct ofono_modem *modem,
 
 static gboolean modem_has_sim(struct ofono_modem *modem)
 {
-	GSList *l;
-	struct ofono_atom *atom;
-
-	for (l = modem->atoms; l; l = l->next) {
-		atom = l->data;
-
-		if (atom->type == OFONO_ATOM_TYPE_SIM)
-			return TRUE;
-	}
-
-	return FALSE;
+	return modem->atoms_by_type[OFONO_ATOM_TYPE_SIM] != NULL;
 }
 
 static gboolean modem_is_always_online(struct ofono_modem *modem)
@@ -857,6 +895,10 @@ static DBusMessage *modem_get_properties(DBusConnection *conn,
 	DBusMessageIter iter;
 	DBusMessageIter dict;
 
+	reply = __ofono_dbus_cached_reply(msg, OFONO_MODEM_INTERFACE);
+	if (reply)
+		return reply;
+
 	reply = dbus_message_new_method_return(msg);
 	if (reply == NULL)
 		return NULL;
@@ -869,9 +911,133 @@ static DBusMessage *modem_get_properties(DBusConnection *conn,
 	__ofono_modem_append_properties(modem, &dict);
 	dbus_message_iter_close_container(&iter, &dict);
 
+	__ofono_dbus_cache_reply(msg, reply, OFONO_MODEM_INTERFACE);
+
 	return reply;
 }
 
+static gboolean power_up_next(gpointer user_data);
+
+/* Gives up the slot of a started power up */
+static void power_up_release(struct ofono_modem *modem)
+{
+	if (modem->power_up_timeout > 0) {
+		g_source_remove(modem->power_up_timeout);
+		modem->power_up_timeout = 0;
+	}
+
+	modem->power_up_queued = 0;
+	modem->power_up_start = 0;
+	powering_up -= 1;
+
+	if (power_up_source == 0 && !g_queue_is_empty(&power_up_queue))
+		power_up_source = g_idle_add(power_up_next, NULL);
+}
+
+static void power_up_done(struct ofono_modem *modem, ofono_bool_t powered)
+{
+	gint64 now = g_get_monotonic_time();
+	guint64 elapsed;
+
+	if (modem->power_up_start == 0)
+		return;
+
+	elapsed = (now - modem->power_up_start) / 1000;
+
+	DBG("%s %s after %" G_GUINT64_FORMAT " ms, %" G_GUINT64_FORMAT
+		" ms queued", modem->path,
+		powered ? "powered up" : "failed to power up", elapsed,
+		(guint64) (modem->power_up_start - modem->power_up_queued) /
+		1000);
+
+	if (powered)
+		__ofono_metric_observe(modem->power_up_time, elapsed);
+
+	power_up_release(modem);
+}
+
+/* Drops modem from the power up queue or the modems powering up */
+static void power_up_cancel(struct ofono_modem *modem)
+{
+	if (modem->power_up_start == 0) {
+		g_queue_remove(&power_up_queue, modem);
+		modem->power_up_queued = 0;
+		return;
+	}
+
+	power_up_release(modem);
+}
+
+/*
+ * Not every power up has a D-Bus caller waiting on it, e.g. after a
+ * reset, so the slot is released on its own if the driver never reports
+ */
+static gboolean power_up_timeout(gpointer user_data)
+{
+	struct ofono_modem *modem = user_data;
+
+	DBG("%s did not power up in time", modem->path);
+
+	modem->power_up_timeout = 0;
+	power_up_cancel(modem);
+
+	return FALSE;
+}
+
+static int power_up(struct ofono_modem *modem)
+{
+	int err = -EINVAL;
+
+	modem->power_up_start = g_get_monotonic_time();
+	powering_up += 1;
+
+	if (modem->power_up_queued == 0)
+		modem->power_up_queued = modem->power_up_start;
+
+	if (modem->driver->enable)
+		err = modem->driver->enable(modem);
+
+	if (err == -EINPROGRESS)
+		modem->power_up_timeout = g_timeout_add_seconds(20,
+							power_up_timeout,
+							modem);
+	else
+		power_up_done(modem, err == 0);
+
+	return err;
+}
+
+static gboolean set_powered_timeout(gpointer user);
+
+static gboolean power_up_next(gpointer user_data)
+{
+	struct ofono_modem *modem;
+	int err;
+
+	power_up_source = 0;
+
+	while (max_powering_up == 0 || powering_up < max_powering_up) {
+		modem = g_queue_pop_head(&power_up_queue);
+		if (modem == NULL)
+			break;
+
+		err = power_up(modem);
+		if (err == -EINPROGRESS) {
+			/* Time spent in the queue does not count */
+			if (modem->pending != NULL && modem->timeout == 0)
+				modem->timeout = g_timeout_add_seconds(20,
+							set_powered_timeout,
+							modem);
+
+			continue;
+		}
+
+		ofono_modem_set_powered(modem, err == 0);
+	}
+
+	return FALSE;
+}
+
 static int set_powered(struct ofono_modem *modem, ofono_bool_t powered)
 {
 	const struct ofono_modem_driver *driver = modem->driver;
@@ -880,6 +1046,14 @@ static int set_powered(struct ofono_modem *modem, ofono_bool_t powered)
 	if (modem->powered_pending == powered)
 		return -EALREADY;
 
+	/* Never handed to the driver, nothing to disable */
+	if (powered == FALSE && modem->power_up_queued > 0 &&
+					modem->power_up_start == 0) {
+		power_up_cancel(modem);
+		modem->powered_pending = FALSE;
+		return 0;
+	}
+
 	/* Remove the atoms even if the driver is no longer available */
 	if (powered == FALSE)
 		modem_change_state(modem, MODEM_STATE_POWER_OFF);
@@ -890,8 +1064,14 @@ static int set_powered(struct ofono_modem *modem, ofono_bool_t powered)
 		return -EINVAL;
 
 	if (powered == TRUE) {
-		if (driver->enable)
-			err = driver->enable(modem);
+		if (max_powering_up > 0 && powering_up >= max_powering_up) {
+			DBG("%s waits to power up", modem->path);
+			modem->power_up_queued = g_get_monotonic_time();
+			g_queue_push_tail(&power_up_queue, modem);
+			return -EINPROGRESS;
+		}
+
+		err = power_up(modem);
 	} else {
 		if (driver->disable)
 			err = driver->disable(modem);
@@ -919,6 +1099,9 @@ static void lockdown_remove(struct ofono_modem *modem)
 	modem->lock_owner = NULL;
 
 	modem->lockdown = FALSE;
+
+	/* Not every caller signals Lockdown, don't serve a stale value */
+	__ofono_dbus_invalidate_reply(modem->path, OFONO_MODEM_INTERFACE);
 }
 
 static gboolean set_powered_timeout(gpointer user)
@@ -943,6 +1126,7 @@ static gboolean set_powered_timeout(gpointer user)
 						"Powered", DBUS_TYPE_BOOLEAN,
 						&powered);
 	} else {
+		power_up_cancel(modem);
 		modem->powered_pending = modem->powered;
 	}
 
@@ -1112,6 +1296,12 @@ static DBusMessage *modem_set_property(DBusConnection *conn,
 				return __ofono_error_failed(msg);
 
 			modem->pending = dbus_message_ref(msg);
+
+			/* Queued power ups get their timeout once started */
+			if (modem->power_up_start == 0 &&
+					modem->power_up_queued > 0)
+				return NULL;
+
 			modem->timeout = g_timeout_add_seconds(20,
 						set_powered_timeout, modem);
 			return NULL;
@@ -1184,6 +1374,9 @@ void ofono_modem_set_powered(struct ofono_modem *modem, ofono_bool_t powered)
 
 	modem->powered_pending = powered;
 
+	if (modem->power_up_start > 0)
+		power_up_done(modem, powered);
+
 	if (modem->powered == powered)
 		goto out;
 
@@ -1311,6 +1504,9 @@ void ofono_modem_add_interface(struct ofono_modem *modem,
 		modem->feature_list = g_slist_prepend(modem->feature_list,
 							g_strdup(feature));
 
+	/* Interfaces and Features are only signalled from an idle */
+	__ofono_dbus_invalidate_reply(modem->path, OFONO_MODEM_INTERFACE);
+
 	if (modem->interface_update != 0)
 		return;
 
@@ -1323,6 +1519,8 @@ void ofono_modem_remove_interface(struct ofono_modem *modem,
 	GSList *found;
 	const char *feature;
 
+	__ofono_dbus_interface_removed(modem->path, interface);
+
 	found = g_slist_find_custom(modem->interface_list, interface,
 						(GCompareFunc) strcmp);
 	if (found == NULL) {
@@ -1347,6 +1545,8 @@ void ofono_modem_remove_interface(struct ofono_modem *modem,
 		}
 	}
 
+	__ofono_dbus_invalidate_reply(modem->path, OFONO_MODEM_INTERFACE);
+
 	if (modem->interface_update != 0)
 		return;
 
@@ -1937,15 +2137,15 @@ gboolean __ofono_modemwatch_remove(unsigned int id)
 
 static void call_modemwatches(struct ofono_modem *modem, gboolean added)
 {
-	GSList *l;
+	struct ofono_watchlist_iter iter;
 	struct ofono_watchlist_item *watch;
 	ofono_modemwatch_cb_t notify;
 
 	DBG("%p added:%d", modem, added);
 
-	for (l = g_modemwatches->items; l; l = l->next) {
-		watch = l->data;
+	__ofono_watchlist_iter_init(&iter, g_modemwatches);
 
+	while ((watch = __ofono_watchlist_iter_next(&iter))) {
 		notify = watch->notify;
 		notify(modem, added, watch->notify_data);
 	}
@@ -1991,6 +2191,24 @@ ofono_bool_t ofono_modem_is_registered(struct ofono_modem *modem)
 	return TRUE;
 }
 
+static void modem_metrics_register(struct ofono_modem *modem)
+{
+	static const guint64 power_up_bounds[] = {
+		500, 1000, 2500, 5000, 10000, 20000, 40000
+	};
+	char *labels;
+
+	labels = g_strdup_printf("modem=\"%s\"", modem->path);
+
+	modem->power_up_time = __ofono_metric_histogram(
+					"ofono_modem_power_up_ms", labels,
+					"Time taken by the driver to power up",
+					power_up_bounds,
+					G_N_ELEMENTS(power_up_bounds));
+
+	g_free(labels);
+}
+
 int ofono_modem_register(struct ofono_modem *modem)
 {
 	DBusConnection *conn = ofono_dbus_get_connection();
@@ -2040,10 +2258,11 @@ int ofono_modem_register(struct ofono_modem *modem)
 	g_free(modem->driver_type);
 	modem->driver_type = NULL;
 
-	modem->atom_watches = __ofono_watchlist_new(g_free);
 	modem->online_watches = __ofono_watchlist_new(g_free);
 	modem->powered_watches = __ofono_watchlist_new(g_free);
 
+	modem_metrics_register(modem);
+
 	emit_modem_added(modem);
 	call_modemwatches(modem, TRUE);
 
@@ -2069,14 +2288,28 @@ static void emit_modem_removed(struct ofono_modem *modem)
 static void modem_unregister(struct ofono_modem *modem)
 {
 	DBusConnection *conn = ofono_dbus_get_connection();
+	int i;
 
 	DBG("%p", modem);
 
 	if (modem->powered == TRUE)
 		set_powered(modem, FALSE);
 
-	__ofono_watchlist_free(modem->atom_watches);
-	modem->atom_watches = NULL;
+	if (modem->power_up_queued > 0)
+		power_up_cancel(modem);
+
+	__ofono_metric_unref(modem->power_up_time);
+	modem->power_up_time = NULL;
+
+	__ofono_dbus_interface_removed(modem->path, OFONO_MODEM_INTERFACE);
+
+	for (i = 0; i < OFONO_ATOM_TYPE_LAST; i++) {
+		if (modem->atom_watches[i] == NULL)
+			continue;
+
+		__ofono_watchlist_free(modem->atom_watches[i]);
+		modem->atom_watches[i] = NULL;
+	}
 
 	__ofono_watchlist_free(modem->online_watches);
 	modem->online_watches = NULL;
@@ -2213,6 +2446,27 @@ void ofono_modem_driver_unregister(const struct ofono_modem_driver *d)
 	}
 }
 
+void __ofono_modem_load_config(GKeyFile *config)
+{
+	GError *error = NULL;
+	int max;
+
+	max = g_key_file_get_integer(config, "Modem", "MaxPoweringUp", &error);
+	if (error) {
+		g_error_free(error);
+		return;
+	}
+
+	if (max < 0) {
+		ofono_warn("Invalid Modem.MaxPoweringUp: %d", max);
+		return;
+	}
+
+	DBG("max powering up: %d", max);
+
+	max_powering_up = max;
+}
+
 void __ofono_modem_shutdown(void)
 {
 	struct ofono_modem *modem;
@@ -1180,8 +1180,8 @@ gboolean __ofono_netreg_remove_status_watch(struct ofono_netreg *netreg,
 
 static void notify_status_watches(struct ofono_netreg *netreg)
 {
+	struct ofono_watchlist_iter iter;
 	struct ofono_watchlist_item *item;
-	GSList *l;
 	ofono_netreg_status_notify_cb_t notify;
 	const char *mcc = NULL;
 	const char *mnc = NULL;
@@ -1191,8 +1191,9 @@ static void notify_status_watches(struct ofono_netreg *netreg)
 		mnc = netreg->current_operator->mnc;
 	}
 
-	for (l = netreg->status_watches->items; l; l = l->next) {
-		item = l->data;
+	__ofono_watchlist_iter_init(&iter, netreg->status_watches);
+
+	while ((item = __ofono_watchlist_iter_next(&iter))) {
 		notify = item->notify;
 
 		notify(netreg->status, netreg->location, netreg->cellid,
@@ -33,6 +33,7 @@ void __ofono_manager_cleanup(void);
 int __ofono_handsfree_audio_manager_init(void);
 void __ofono_handsfree_audio_manager_cleanup(void);
 
+void __ofono_modem_load_config(GKeyFile *config);
 void __ofono_modem_shutdown(void);
 
 #include <ofono/log.h>
@@ -47,6 +48,38 @@ void __ofono_log_enable(struct ofono_debug_desc *start,
 
 int __ofono_dbus_init(DBusConnection *conn);
 void __ofono_dbus_cleanup(void);
+void __ofono_dbus_load_rate_limits(GKeyFile *config);
+void __ofono_dbus_batch_begin(void);
+void __ofono_dbus_batch_end(void);
+
+DBusMessage *__ofono_dbus_cached_reply(DBusMessage *msg,
+					const char *interface);
+void __ofono_dbus_cache_reply(DBusMessage *msg, DBusMessage *reply,
+				const char *interface);
+void __ofono_dbus_invalidate_reply(const char *path, const char *interface);
+void __ofono_dbus_interface_removed(const char *path, const char *interface);
+
+struct ofono_metric;
+
+int __ofono_metrics_init(GKeyFile *config);
+void __ofono_metrics_cleanup(void);
+char *__ofono_metrics_export(void);
+
+struct ofono_metric *__ofono_metric_counter(const char *name,
+						const char *labels,
+						const char *help);
+struct ofono_metric *__ofono_metric_gauge(const char *name,
+						const char *labels,
+						const char *help);
+struct ofono_metric *__ofono_metric_histogram(const char *name,
+						const char *labels,
+						const char *help,
+						const guint64 *bounds,
+						unsigned int n_bounds);
+void __ofono_metric_unref(struct ofono_metric *metric);
+void __ofono_metric_add(struct ofono_metric *metric, guint64 value);
+void __ofono_metric_set(struct ofono_metric *metric, gint64 value);
+void __ofono_metric_observe(struct ofono_metric *metric, guint64 value);
 
 DBusMessage *__ofono_error_invalid_args(DBusMessage *msg);
 DBusMessage *__ofono_error_invalid_format(DBusMessage *msg);
@@ -85,17 +118,38 @@ struct ofono_watchlist_item {
 	ofono_destroy_func destroy;
 };
 
+/* Watch ids handed out by a watchlist never exceed this many bits */
+#define OFONO_WATCHLIST_ID_BITS 26
+
+struct ofono_watchlist_slot;
+
 struct ofono_watchlist {
-	int next_id;
-	GSList *items;
+	struct ofono_watchlist_slot *slots;
+	unsigned int size;
+	unsigned int used;
+	unsigned int count;
+	unsigned int free_head;
+	unsigned int free_tail;
+	unsigned int newest;
+	unsigned int serial;
 	ofono_destroy_func destroy;
 };
 
+struct ofono_watchlist_iter {
+	struct ofono_watchlist *watchlist;
+	unsigned int index;	/* Slot of the next watch to return */
+	unsigned int serial;	/* Serial that watch was added with */
+};
+
 struct ofono_watchlist *__ofono_watchlist_new(ofono_destroy_func destroy);
 unsigned int __ofono_watchlist_add_item(struct ofono_watchlist *watchlist,
 					struct ofono_watchlist_item *item);
 gboolean __ofono_watchlist_remove_item(struct ofono_watchlist *watchlist,
 					unsigned int id);
+void __ofono_watchlist_iter_init(struct ofono_watchlist_iter *iter,
+					struct ofono_watchlist *watchlist);
+struct ofono_watchlist_item *__ofono_watchlist_iter_next(
+					struct ofono_watchlist_iter *iter);
 void __ofono_watchlist_free(struct ofono_watchlist *watchlist);
 
 #include <ofono/plugin.h>
@@ -154,6 +208,7 @@ enum ofono_atom_type {
 	OFONO_ATOM_TYPE_SIRI,
 	OFONO_ATOM_TYPE_NETMON,
 	OFONO_ATOM_TYPE_LTE,
+	OFONO_ATOM_TYPE_LAST,
 };
 
 enum ofono_atom_watch_condition {
@@ -375,6 +430,8 @@ ofono_bool_t __ofono_sim_service_available(struct ofono_sim *sim,
 ofono_bool_t __ofono_sim_cphs_service_available(struct ofono_sim *sim,
 						int cphs_service);
 
+const char *__ofono_sim_get_iccid(struct ofono_sim *sim);
+
 ofono_bool_t __ofono_is_valid_sim_pin(const char *pin,
 					enum ofono_sim_password_type type);
 
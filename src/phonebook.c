@@ -29,6 +29,8 @@
 #include <stdlib.h>
 #include <ctype.h>
 #include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
 
 #include <glib.h>
 #include <gdbus.h>
@@ -36,11 +38,26 @@
 #include "ofono.h"
 
 #include "common.h"
+#include "simutil.h"
+#include "storage.h"
 
 #define LEN_MAX 128
 #define TYPE_INTERNATIONAL 145
 
 #define PHONEBOOK_FLAG_CACHED 0x1
+#define PHONEBOOK_FLAG_EXPORTING 0x2
+
+/*
+ * The SM entries are stored per ICCID, prefixed by a version byte and the
+ * contents of EFpsc, EFcc and EFpuid at the time they were exported.  Any
+ * change made to the SIM phonebook by another device updates at least one
+ * of them, 3GPP TS 31.102 Section 4.4.2.12
+ */
+#define PHONEBOOK_CACHE_PATH STORAGEDIR "/%s/phonebook"
+#define PHONEBOOK_CACHE_MODE 0600
+#define PHONEBOOK_CACHE_VERSION 1
+#define PHONEBOOK_KEY_SIZE 8
+#define PHONEBOOK_CACHE_HEADER_SIZE (1 + PHONEBOOK_KEY_SIZE)
 
 static GSList *g_drivers = NULL;
 
@@ -58,6 +75,16 @@ struct ofono_phonebook {
 	int flags;
 	GString *vcards; /* entries with vcard 3.0 format */
 	GSList *merge_list; /* cache the entries that may need a merge */
+	GHashTable *merge_table; /* merge_list entries by text */
+	GIOChannel *stream; /* vcards are streamed to an ImportStream client */
+	guint stream_watch;
+	gsize stream_sent;
+	struct ofono_sim *sim;
+	struct ofono_sim_context *sim_context;
+	unsigned char cache_key[PHONEBOOK_KEY_SIZE];
+	int cache_key_len; /* bytes of cache_key read from the SIM so far */
+	int key_file;
+	gsize storage_start; /* offset of the current storage in vcards */
 	const struct ofono_phonebook_driver *driver;
 	void *driver_data;
 	struct ofono_atom *atom;
@@ -79,7 +106,23 @@ struct phonebook_person {
 };
 
 static const char *storage_support[] = { "SM", "ME", NULL };
+
+static const struct {
+	int id;
+	unsigned short length;
+} phonebook_key_files[] = {
+	{ SIM_EFPSC_FILEID,	4 },
+	{ SIM_EFCC_FILEID,	2 },
+	{ SIM_EFPUID_FILEID,	2 },
+};
+
+/* MF / DFtelecom / DFphonebook */
+static const unsigned char phonebook_path[] = {
+	0x3F, 0x00, 0x7F, 0x10, 0x5F, 0x3A
+};
+
 static void export_phonebook(struct ofono_phonebook *pb);
+static void phonebook_stream_flush(struct ofono_phonebook *pb);
 
 /* according to RFC 2425, the output string may need folding */
 static void vcard_printf(GString *str, const char *fmt, ...)
@@ -368,23 +411,21 @@ void ofono_phonebook_entry(struct ofono_phonebook *phonebook, int index,
 	 * are deemed as entries of one person.
 	 */
 	if (need_merge(text)) {
-		GSList *l;
 		size_t len_text = strlen(text) - 2;
+		char *base = g_strndup(text, len_text);
 		struct phonebook_person *person;
 
-		for (l = phonebook->merge_list; l; l = l->next) {
-			person = l->data;
-			if (!strncmp(text, person->text, len_text) &&
-					(strlen(person->text) == len_text))
-				break;
-		}
+		person = g_hash_table_lookup(phonebook->merge_table, base);
 
-		if (l == NULL) {
+		if (person == NULL) {
 			person = g_new0(struct phonebook_person, 1);
 			phonebook->merge_list =
 				g_slist_prepend(phonebook->merge_list, person);
-			person->text = g_strndup(text, len_text);
-		}
+			person->text = base;
+			g_hash_table_insert(phonebook->merge_table,
+						person->text, person);
+		} else
+			g_free(base);
 
 		merge_field_number(&(person->number_list), number, type,
 					text[len_text + 1]);
@@ -412,24 +453,98 @@ void ofono_phonebook_entry(struct ofono_phonebook *phonebook, int index,
 	vcard_printf_email(phonebook->vcards, email);
 	vcard_printf_sip_uri(phonebook->vcards, sip_uri);
 	vcard_printf_end(phonebook->vcards);
+
+	phonebook_stream_flush(phonebook);
+}
+
+static const char *phonebook_cache_iccid(struct ofono_phonebook *phonebook)
+{
+	if (phonebook->cache_key_len != PHONEBOOK_KEY_SIZE)
+		return NULL;
+
+	return __ofono_sim_get_iccid(phonebook->sim);
+}
+
+static gboolean phonebook_cache_load(struct ofono_phonebook *phonebook)
+{
+	const char *iccid = phonebook_cache_iccid(phonebook);
+	char *path;
+	char *contents;
+	gsize len;
+	gboolean valid;
+
+	if (iccid == NULL)
+		return FALSE;
+
+	path = g_strdup_printf(PHONEBOOK_CACHE_PATH, iccid);
+
+	if (!g_file_get_contents(path, &contents, &len, NULL)) {
+		g_free(path);
+		return FALSE;
+	}
+
+	g_free(path);
+
+	valid = len >= PHONEBOOK_CACHE_HEADER_SIZE &&
+		contents[0] == PHONEBOOK_CACHE_VERSION &&
+		memcmp(contents + 1, phonebook->cache_key,
+						PHONEBOOK_KEY_SIZE) == 0;
+
+	if (valid)
+		g_string_append_len(phonebook->vcards,
+				contents + PHONEBOOK_CACHE_HEADER_SIZE,
+				len - PHONEBOOK_CACHE_HEADER_SIZE);
+
+	g_free(contents);
+
+	return valid;
+}
+
+static void phonebook_cache_store(struct ofono_phonebook *phonebook)
+{
+	const char *iccid = phonebook_cache_iccid(phonebook);
+	gsize len = phonebook->vcards->len - phonebook->storage_start;
+	unsigned char *buf;
+
+	if (iccid == NULL)
+		return;
+
+	buf = g_try_malloc(PHONEBOOK_CACHE_HEADER_SIZE + len);
+	if (buf == NULL)
+		return;
+
+	buf[0] = PHONEBOOK_CACHE_VERSION;
+	memcpy(buf + 1, phonebook->cache_key, PHONEBOOK_KEY_SIZE);
+	memcpy(buf + PHONEBOOK_CACHE_HEADER_SIZE,
+			phonebook->vcards->str + phonebook->storage_start, len);
+
+	write_file(buf, PHONEBOOK_CACHE_HEADER_SIZE + len,
+			PHONEBOOK_CACHE_MODE, PHONEBOOK_CACHE_PATH, iccid);
+
+	g_free(buf);
 }
 
 static void export_phonebook_cb(const struct ofono_error *error, void *data)
 {
 	struct ofono_phonebook *phonebook = data;
+	const char *pb = storage_support[phonebook->storage_index];
 
 	if (error->type != OFONO_ERROR_TYPE_NO_ERROR)
-		ofono_error("export_entries_one_storage_cb with %s failed",
-				storage_support[phonebook->storage_index]);
+		ofono_error("export_entries_one_storage_cb with %s failed", pb);
 
 	/* convert the collected entries that are already merged to vcard */
 	phonebook->merge_list = g_slist_reverse(phonebook->merge_list);
 	g_slist_foreach(phonebook->merge_list, print_merged_entry,
 				phonebook->vcards);
+	g_hash_table_remove_all(phonebook->merge_table);
 	g_slist_free_full(phonebook->merge_list, destroy_merged_entry);
-	g_slist_free(phonebook->merge_list);
 	phonebook->merge_list = NULL;
 
+	if (error->type == OFONO_ERROR_TYPE_NO_ERROR && g_str_equal(pb, "SM"))
+		phonebook_cache_store(phonebook);
+
+	phonebook_stream_flush(phonebook);
+
 	phonebook->storage_index++;
 	export_phonebook(phonebook);
 	return;
@@ -440,20 +555,163 @@ static void export_phonebook(struct ofono_phonebook *phonebook)
 	DBusMessage *reply;
 	const char *pb = storage_support[phonebook->storage_index];
 
+	/* SIM entries that didn't change since the last export */
+	if (pb && g_str_equal(pb, "SM") && phonebook_cache_load(phonebook)) {
+		DBG("Using stored %s entries", pb);
+		phonebook_stream_flush(phonebook);
+		pb = storage_support[++phonebook->storage_index];
+	}
+
 	if (pb) {
+		phonebook->storage_start = phonebook->vcards->len;
 		phonebook->driver->export_entries(phonebook, pb,
 						export_phonebook_cb, phonebook);
 		return;
 	}
 
+	phonebook->flags &= ~PHONEBOOK_FLAG_EXPORTING;
+	phonebook->flags |= PHONEBOOK_FLAG_CACHED;
+
+	/* Let the stream, if any, know that no more entries are coming */
+	phonebook_stream_flush(phonebook);
+
+	if (phonebook->pending == NULL)
+		return;
+
 	reply = generate_export_entries_reply(phonebook, phonebook->pending);
 	if (reply == NULL) {
 		dbus_message_unref(phonebook->pending);
+		phonebook->pending = NULL;
 		return;
 	}
 
 	__ofono_dbus_pending_reply(&phonebook->pending, reply);
-	phonebook->flags |= PHONEBOOK_FLAG_CACHED;
+}
+
+static void phonebook_read_key(struct ofono_phonebook *phonebook);
+
+static void phonebook_key_read_cb(int ok, int length, int record,
+					const unsigned char *data,
+					int record_length, void *userdata)
+{
+	struct ofono_phonebook *phonebook = userdata;
+	unsigned short len = phonebook_key_files[phonebook->key_file].length;
+
+	if (!ok || length < len) {
+		/* Without the counters a stored copy can't be trusted */
+		phonebook->cache_key_len = 0;
+		export_phonebook(phonebook);
+		return;
+	}
+
+	memcpy(phonebook->cache_key + phonebook->cache_key_len, data, len);
+	phonebook->cache_key_len += len;
+	phonebook->key_file += 1;
+
+	if (phonebook->key_file < (int) G_N_ELEMENTS(phonebook_key_files)) {
+		phonebook_read_key(phonebook);
+		return;
+	}
+
+	export_phonebook(phonebook);
+}
+
+static void phonebook_read_key(struct ofono_phonebook *phonebook)
+{
+	int i = phonebook->key_file;
+
+	if (ofono_sim_read_bytes(phonebook->sim_context,
+					phonebook_key_files[i].id, 0,
+					phonebook_key_files[i].length,
+					phonebook_path, sizeof(phonebook_path),
+					phonebook_key_read_cb, phonebook) < 0) {
+		phonebook->cache_key_len = 0;
+		export_phonebook(phonebook);
+	}
+}
+
+static void export_phonebook_start(struct ofono_phonebook *phonebook)
+{
+	g_string_set_size(phonebook->vcards, 0);
+	phonebook->storage_index = 0;
+	phonebook->flags |= PHONEBOOK_FLAG_EXPORTING;
+	phonebook->cache_key_len = 0;
+	phonebook->key_file = 0;
+
+	if (phonebook->sim_context &&
+			__ofono_sim_get_iccid(phonebook->sim) != NULL) {
+		phonebook_read_key(phonebook);
+		return;
+	}
+
+	export_phonebook(phonebook);
+}
+
+static void phonebook_stream_close(struct ofono_phonebook *phonebook)
+{
+	if (phonebook->stream_watch > 0) {
+		g_source_remove(phonebook->stream_watch);
+		phonebook->stream_watch = 0;
+	}
+
+	if (phonebook->stream == NULL)
+		return;
+
+	g_io_channel_shutdown(phonebook->stream, FALSE, NULL);
+	g_io_channel_unref(phonebook->stream);
+	phonebook->stream = NULL;
+}
+
+static gboolean phonebook_stream_write(GIOChannel *io, GIOCondition cond,
+					gpointer user_data)
+{
+	struct ofono_phonebook *phonebook = user_data;
+	int fd = g_io_channel_unix_get_fd(io);
+	GString *vcards = phonebook->vcards;
+	ssize_t written;
+
+	if (cond & (G_IO_ERR | G_IO_HUP | G_IO_NVAL))
+		goto done;
+
+	while (phonebook->stream_sent < vcards->len) {
+		written = send(fd, vcards->str + phonebook->stream_sent,
+				vcards->len - phonebook->stream_sent,
+				MSG_DONTWAIT | MSG_NOSIGNAL);
+
+		if (written < 0) {
+			if (errno == EINTR)
+				continue;
+
+			if (errno == EAGAIN || errno == EWOULDBLOCK)
+				return TRUE;
+
+			goto done;
+		}
+
+		phonebook->stream_sent += written;
+	}
+
+	/* Wait for more entries from the driver */
+	if (phonebook->flags & PHONEBOOK_FLAG_EXPORTING) {
+		phonebook->stream_watch = 0;
+		return FALSE;
+	}
+
+done:
+	phonebook->stream_watch = 0;
+	phonebook_stream_close(phonebook);
+
+	return FALSE;
+}
+
+static void phonebook_stream_flush(struct ofono_phonebook *phonebook)
+{
+	if (phonebook->stream == NULL || phonebook->stream_watch > 0)
+		return;
+
+	phonebook->stream_watch = g_io_add_watch(phonebook->stream,
+				G_IO_OUT | G_IO_ERR | G_IO_HUP | G_IO_NVAL,
+				phonebook_stream_write, phonebook);
 }
 
 static DBusMessage *import_entries(DBusConnection *conn, DBusMessage *msg,
@@ -474,19 +732,68 @@ static DBusMessage *import_entries(DBusConnection *conn, DBusMessage *msg,
 		return NULL;
 	}
 
-	g_string_set_size(phonebook->vcards, 0);
-	phonebook->storage_index = 0;
-
 	phonebook->pending = dbus_message_ref(msg);
-	export_phonebook(phonebook);
+
+	/* An export started by ImportStream might already be running */
+	if (!(phonebook->flags & PHONEBOOK_FLAG_EXPORTING))
+		export_phonebook_start(phonebook);
 
 	return NULL;
 }
 
+static DBusMessage *import_stream(DBusConnection *conn, DBusMessage *msg,
+					void *data)
+{
+	struct ofono_phonebook *phonebook = data;
+	DBusMessage *reply;
+	int fds[2];
+
+	if (phonebook->stream)
+		return __ofono_error_busy(msg);
+
+	if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) < 0)
+		return __ofono_error_failed(msg);
+
+	reply = dbus_message_new_method_return(msg);
+	if (reply == NULL)
+		goto error;
+
+	if (!dbus_message_append_args(reply, DBUS_TYPE_UNIX_FD, &fds[0],
+					DBUS_TYPE_INVALID)) {
+		dbus_message_unref(reply);
+		goto error;
+	}
+
+	/* The message holds its own copy of the client end */
+	close(fds[0]);
+	shutdown(fds[1], SHUT_RD);
+
+	phonebook->stream = g_io_channel_unix_new(fds[1]);
+	g_io_channel_set_close_on_unref(phonebook->stream, TRUE);
+	phonebook->stream_sent = 0;
+
+	if (!(phonebook->flags & (PHONEBOOK_FLAG_CACHED |
+					PHONEBOOK_FLAG_EXPORTING)))
+		export_phonebook_start(phonebook);
+
+	phonebook_stream_flush(phonebook);
+
+	return reply;
+
+error:
+	close(fds[0]);
+	close(fds[1]);
+
+	return __ofono_error_failed(msg);
+}
+
 static const GDBusMethodTable phonebook_methods[] = {
 	{ GDBUS_ASYNC_METHOD("Import",
 			NULL, GDBUS_ARGS({ "entries", "s" }),
 			import_entries) },
+	{ GDBUS_METHOD("ImportStream",
+			NULL, GDBUS_ARGS({ "fd", "h" }),
+			import_stream) },
 	{ }
 };
 
@@ -520,6 +827,13 @@ static void phonebook_unregister(struct ofono_atom *atom)
 	DBusConnection *conn = ofono_dbus_get_connection();
 	struct ofono_modem *modem = __ofono_atom_get_modem(pb->atom);
 
+	if (pb->sim_context) {
+		ofono_sim_context_free(pb->sim_context);
+		pb->sim_context = NULL;
+	}
+
+	pb->sim = NULL;
+
 	ofono_modem_remove_interface(modem, OFONO_PHONEBOOK_INTERFACE);
 	g_dbus_unregister_interface(conn, path, OFONO_PHONEBOOK_INTERFACE);
 }
@@ -536,6 +850,9 @@ static void phonebook_remove(struct ofono_atom *atom)
 	if (pb->driver && pb->driver->remove)
 		pb->driver->remove(pb);
 
+	phonebook_stream_close(pb);
+	g_hash_table_destroy(pb->merge_table);
+	g_slist_free_full(pb->merge_list, destroy_merged_entry);
 	g_string_free(pb->vcards, TRUE);
 	g_free(pb);
 }
@@ -556,6 +873,7 @@ struct ofono_phonebook *ofono_phonebook_create(struct ofono_modem *modem,
 		return NULL;
 
 	pb->vcards = g_string_new(NULL);
+	pb->merge_table = g_hash_table_new(g_str_hash, g_str_equal);
 	pb->atom = __ofono_modem_add_atom(modem, OFONO_ATOM_TYPE_PHONEBOOK,
 						phonebook_remove, pb);
 
@@ -592,6 +910,10 @@ void ofono_phonebook_register(struct ofono_phonebook *pb)
 
 	ofono_modem_add_interface(modem, OFONO_PHONEBOOK_INTERFACE);
 
+	pb->sim = __ofono_atom_find(OFONO_ATOM_TYPE_SIM, modem);
+	if (pb->sim)
+		pb->sim_context = ofono_sim_context_create(pb->sim);
+
 	__ofono_atom_register(pb->atom, phonebook_unregister);
 }
 
@@ -330,11 +330,13 @@ static void service_number_free(gpointer pointer)
 
 static void call_state_watches(struct ofono_sim *sim)
 {
-	GSList *l;
+	struct ofono_watchlist_iter iter;
+	struct ofono_watchlist_item *item;
 	ofono_sim_state_event_cb_t notify;
 
-	for (l = sim->state_watches->items; l; l = l->next) {
-		struct ofono_watchlist_item *item = l->data;
+	__ofono_watchlist_iter_init(&iter, sim->state_watches);
+
+	while ((item = __ofono_watchlist_iter_next(&iter))) {
 		notify = item->notify;
 
 		notify(sim->state, item->notify_data);
@@ -2310,6 +2312,14 @@ ofono_bool_t __ofono_sim_cphs_service_available(struct ofono_sim *sim,
 	return sim_cphs_is_active(sim->cphs_service_table, cphs_service);
 }
 
+const char *__ofono_sim_get_iccid(struct ofono_sim *sim)
+{
+	if (sim == NULL)
+		return NULL;
+
+	return sim->iccid;
+}
+
 static void sim_inserted_update(struct ofono_sim *sim)
 {
 	DBusConnection *conn = ofono_dbus_get_connection();
@@ -2617,11 +2627,9 @@ enum ofono_sim_state ofono_sim_get_state(struct ofono_sim *sim)
 	return sim->state;
 }
 
-static void spn_watch_cb(gpointer data, gpointer user_data)
+static void spn_watch_cb(struct ofono_watchlist_item *item,
+				struct ofono_sim *sim)
 {
-	struct ofono_watchlist_item *item = data;
-	struct ofono_sim *sim = user_data;
-
 	if (item->notify)
 		((ofono_sim_spn_cb_t) item->notify)(sim->spn, sim->spn_dc,
 							item->notify_data);
@@ -2629,8 +2637,13 @@ static void spn_watch_cb(gpointer data, gpointer user_data)
 
 static inline void spn_watches_notify(struct ofono_sim *sim)
 {
-	if (sim->spn_watches->items)
-		g_slist_foreach(sim->spn_watches->items, spn_watch_cb, sim);
+	struct ofono_watchlist_iter iter;
+	struct ofono_watchlist_item *item;
+
+	__ofono_watchlist_iter_init(&iter, sim->spn_watches);
+
+	while ((item = __ofono_watchlist_iter_next(&iter)))
+		spn_watch_cb(item, sim);
 
 	sim->flags &= ~SIM_FLAG_READING_SPN;
 }
@@ -2793,8 +2806,10 @@ ofono_bool_t ofono_sim_add_spn_watch(struct ofono_sim *sim, unsigned int *id,
 	item->notify_data = data;
 
 	watch_id = __ofono_watchlist_add_item(sim->spn_watches, item);
-	if (watch_id == 0)
+	if (watch_id == 0) {
+		g_free(item);
 		return FALSE;
+	}
 
 	*id = watch_id;
 
@@ -34,6 +34,7 @@
 #include <errno.h>
 #include <unistd.h>
 #include <dirent.h>
+#include <sys/mman.h>
 
 #include "ofono.h"
 
@@ -45,12 +46,33 @@
 #define SIM_CACHE_BASEPATH STORAGEDIR "/%s-%i"
 #define SIM_CACHE_VERSION SIM_CACHE_BASEPATH "/version"
 #define SIM_CACHE_PATH SIM_CACHE_BASEPATH "/%04x"
+#define SIM_CACHE_IMAGE_PATH SIM_CACHE_BASEPATH "/simfs"
 #define SIM_CACHE_HEADER_SIZE 39
 #define SIM_FILE_INFO_SIZE 7
 #define SIM_IMAGE_CACHE_BASEPATH STORAGEDIR "/%s-%i/images"
 #define SIM_IMAGE_CACHE_PATH SIM_IMAGE_CACHE_BASEPATH "/%d.xpm"
 
-#define SIM_FS_VERSION 2
+/*
+ * The EF cache is a single image per IMSI / phase.  It starts with a fixed
+ * index of SIM_CACHE_INDEX_ENTRIES entries, each holding the EF id, the
+ * offset of the EF contents within the image, the file info (same layout
+ * as the old per-EF cache header) and the block bitmap.  EF contents are
+ * appended after the index.
+ */
+#define SIM_CACHE_INDEX_ENTRIES 128
+#define SIM_CACHE_ENTRY_SIZE 48
+#define SIM_CACHE_ENTRY_INFO 6
+#define SIM_CACHE_INDEX_SIZE (SIM_CACHE_INDEX_ENTRIES * SIM_CACHE_ENTRY_SIZE)
+#define SIM_CACHE_BITMAP_BLOCKS \
+	((SIM_CACHE_HEADER_SIZE - SIM_FILE_INFO_SIZE) * 8)
+
+#define SIM_FS_VERSION 3
+
+/* Number of record reads kept in flight with the driver */
+#define SIM_FS_READ_AHEAD 4
+
+/* READ RECORD addresses records with a single byte */
+#define SIM_FS_MAX_RECORDS 255
 
 static gboolean sim_fs_op_next(gpointer user_data);
 static gboolean sim_fs_op_read_record(gpointer user);
@@ -72,25 +94,398 @@ struct sim_fs_op {
 	gboolean is_read;
 	void *userdata;
 	struct ofono_sim_context *context;
+	GSList *joined;
+	int requested;
+	int pending;
+	int error_record;
+	unsigned char received[(SIM_FS_MAX_RECORDS + 7) / 8];
+};
+
+struct sim_fs_record_req {
+	struct sim_fs *fs;
+	unsigned int serial;
+	int record;
 };
 
 static void sim_fs_op_free(gpointer pointer)
 {
 	struct sim_fs_op *node = pointer;
+
+	g_slist_free_full(node->joined, sim_fs_op_free);
 	g_free(node->buffer);
 	g_free(node);
 }
 
+static gboolean sim_fs_op_has_cb(struct sim_fs_op *op)
+{
+	GSList *l;
+
+	if (op->cb != NULL)
+		return TRUE;
+
+	for (l = op->joined; l; l = l->next) {
+		struct sim_fs_op *joined = l->data;
+
+		if (joined->cb != NULL)
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
+/* Hand the result of a read to the operation and all reads joined to it */
+static void sim_fs_op_read_notify(struct sim_fs_op *op, int ok, int total,
+					int record, const unsigned char *data,
+					int record_length)
+{
+	ofono_sim_file_read_cb_t cb = op->cb;
+	GSList *l;
+
+	if (cb != NULL)
+		cb(ok, total, record, data, record_length, op->userdata);
+
+	for (l = op->joined; l; l = l->next) {
+		struct sim_fs_op *joined = l->data;
+
+		cb = joined->cb;
+		if (cb != NULL)
+			cb(ok, total, record, data, record_length,
+				joined->userdata);
+	}
+}
+
+static gboolean sim_fs_op_same_read(const struct sim_fs_op *a,
+					const struct sim_fs_op *b)
+{
+	if (b->is_read == FALSE || b->info_only == TRUE)
+		return FALSE;
+
+	if (a->id != b->id || a->structure != b->structure)
+		return FALSE;
+
+	if (a->offset != b->offset || a->num_bytes != b->num_bytes)
+		return FALSE;
+
+	if (a->path_len != b->path_len)
+		return FALSE;
+
+	return memcmp(a->path, b->path, a->path_len) == 0;
+}
+
 struct sim_fs {
 	GQueue *op_q;
 	gint op_source;
-	unsigned char bitmap[32];
-	int fd;
+	unsigned int op_serial;
+	int entry;
+	unsigned char *image;
+	size_t image_size;
+	int image_fd;
+	char *image_imsi;
+	enum ofono_sim_phase image_phase;
 	struct ofono_sim *sim;
 	const struct ofono_sim_driver *driver;
 	GSList *contexts;
+	struct ofono_metric *cache_hits;
+	struct ofono_metric *cache_misses;
 };
 
+static unsigned char *sim_fs_image_entry(struct sim_fs *fs, int entry)
+{
+	return fs->image + entry * SIM_CACHE_ENTRY_SIZE;
+}
+
+static unsigned int sim_fs_entry_id(const unsigned char *e)
+{
+	return (e[0] << 8) | e[1];
+}
+
+static size_t sim_fs_entry_offset(const unsigned char *e)
+{
+	return ((size_t) e[2] << 24) | (e[3] << 16) | (e[4] << 8) | e[5];
+}
+
+static int sim_fs_entry_length(const unsigned char *e)
+{
+	const unsigned char *fileinfo = e + SIM_CACHE_ENTRY_INFO;
+
+	return (fileinfo[1] << 8) | fileinfo[2];
+}
+
+static unsigned char *sim_fs_entry_bitmap(unsigned char *e)
+{
+	return e + SIM_CACHE_ENTRY_INFO + SIM_FILE_INFO_SIZE;
+}
+
+static void sim_fs_image_close(struct sim_fs *fs)
+{
+	if (fs->image != NULL) {
+		munmap(fs->image, fs->image_size);
+		fs->image = NULL;
+		fs->image_size = 0;
+	}
+
+	if (fs->image_fd != -1) {
+		TFR(close(fs->image_fd));
+		fs->image_fd = -1;
+	}
+
+	g_free(fs->image_imsi);
+	fs->image_imsi = NULL;
+	fs->entry = -1;
+}
+
+static gboolean sim_fs_image_map(struct sim_fs *fs, size_t size)
+{
+	void *image;
+
+	if (fs->image != NULL) {
+		munmap(fs->image, fs->image_size);
+		fs->image = NULL;
+		fs->image_size = 0;
+	}
+
+	image = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+			fs->image_fd, 0);
+	if (image == MAP_FAILED)
+		return FALSE;
+
+	fs->image = image;
+	fs->image_size = size;
+
+	return TRUE;
+}
+
+/*
+ * Map the cache image of the current IMSI / phase, creating it if needed.
+ * The mapping is kept for the lifetime of the SIM so that cached reads
+ * are plain memory copies.
+ */
+static gboolean sim_fs_image_open(struct sim_fs *fs)
+{
+	const char *imsi = ofono_sim_get_imsi(fs->sim);
+	enum ofono_sim_phase phase = ofono_sim_get_phase(fs->sim);
+	struct stat st;
+	char *path;
+
+	if (imsi == NULL || phase == OFONO_SIM_PHASE_UNKNOWN)
+		return FALSE;
+
+	if (fs->image != NULL) {
+		if (fs->image_phase == phase &&
+				g_str_equal(fs->image_imsi, imsi))
+			return TRUE;
+
+		sim_fs_image_close(fs);
+	}
+
+	path = g_strdup_printf(SIM_CACHE_IMAGE_PATH, imsi, phase);
+
+	if (create_dirs(path, SIM_CACHE_MODE | S_IXUSR) != 0) {
+		g_free(path);
+		return FALSE;
+	}
+
+	fs->image_fd = TFR(open(path, O_RDWR | O_CREAT, SIM_CACHE_MODE));
+	g_free(path);
+
+	if (fs->image_fd == -1)
+		return FALSE;
+
+	if (fstat(fs->image_fd, &st) < 0)
+		goto error;
+
+	if (st.st_size < SIM_CACHE_INDEX_SIZE) {
+		if (ftruncate(fs->image_fd, SIM_CACHE_INDEX_SIZE) < 0)
+			goto error;
+
+		st.st_size = SIM_CACHE_INDEX_SIZE;
+	}
+
+	if (sim_fs_image_map(fs, st.st_size) == FALSE)
+		goto error;
+
+	fs->image_imsi = g_strdup(imsi);
+	fs->image_phase = phase;
+
+	return TRUE;
+
+error:
+	TFR(close(fs->image_fd));
+	fs->image_fd = -1;
+	return FALSE;
+}
+
+static int sim_fs_image_lookup(struct sim_fs *fs, int id)
+{
+	int i;
+
+	for (i = 0; i < SIM_CACHE_INDEX_ENTRIES; i++) {
+		unsigned char *e = sim_fs_image_entry(fs, i);
+		size_t offset;
+
+		if (sim_fs_entry_id(e) != (unsigned int) id)
+			continue;
+
+		offset = sim_fs_entry_offset(e);
+
+		/* Ignore entries pointing outside of the image */
+		if (offset < SIM_CACHE_INDEX_SIZE || offset +
+				sim_fs_entry_length(e) > fs->image_size)
+			return -1;
+
+		return i;
+	}
+
+	return -1;
+}
+
+static int sim_fs_compare_entry(gconstpointer a, gconstpointer b,
+					gpointer user_data)
+{
+	struct sim_fs *fs = user_data;
+	size_t offset_a = sim_fs_entry_offset(sim_fs_image_entry(fs,
+							GPOINTER_TO_INT(a)));
+	size_t offset_b = sim_fs_entry_offset(sim_fs_image_entry(fs,
+							GPOINTER_TO_INT(b)));
+
+	if (offset_a < offset_b)
+		return -1;
+
+	return offset_a > offset_b;
+}
+
+/*
+ * Areas of dropped entries and of entries that moved to a larger area are
+ * not reused in place.  Once they make up more than half of the data area,
+ * the live entries are moved down to the start of the data area and the
+ * image is shrunk.
+ */
+static void sim_fs_image_compact(struct sim_fs *fs)
+{
+	GSList *live = NULL;
+	GSList *l;
+	size_t used = 0;
+	size_t next = SIM_CACHE_INDEX_SIZE;
+	int i;
+
+	for (i = 0; i < SIM_CACHE_INDEX_ENTRIES; i++) {
+		unsigned char *e = sim_fs_image_entry(fs, i);
+		size_t offset = sim_fs_entry_offset(e);
+
+		if (sim_fs_entry_id(e) == 0)
+			continue;
+
+		if (offset < SIM_CACHE_INDEX_SIZE || offset +
+				sim_fs_entry_length(e) > fs->image_size) {
+			e[0] = 0;
+			e[1] = 0;
+			continue;
+		}
+
+		used += sim_fs_entry_length(e);
+		live = g_slist_insert_sorted_with_data(live,
+						GINT_TO_POINTER(i),
+						sim_fs_compare_entry, fs);
+	}
+
+	if (fs->image_size - SIM_CACHE_INDEX_SIZE - used <= used) {
+		g_slist_free(live);
+		return;
+	}
+
+	DBG("%zu of %zu bytes in use", used,
+			fs->image_size - SIM_CACHE_INDEX_SIZE);
+
+	for (l = live; l; l = l->next) {
+		unsigned char *e = sim_fs_image_entry(fs,
+						GPOINTER_TO_INT(l->data));
+		size_t offset = sim_fs_entry_offset(e);
+		int length = sim_fs_entry_length(e);
+
+		if (offset != next)
+			memmove(fs->image + next, fs->image + offset, length);
+
+		e[2] = next >> 24;
+		e[3] = (next >> 16) & 0xff;
+		e[4] = (next >> 8) & 0xff;
+		e[5] = next & 0xff;
+
+		next += length;
+	}
+
+	g_slist_free(live);
+
+	if (ftruncate(fs->image_fd, next) < 0 ||
+			sim_fs_image_map(fs, next) == FALSE)
+		sim_fs_image_close(fs);
+}
+
+/*
+ * Find room for an EF in the image.  The area of a previous entry for the
+ * same EF is reused if it is large enough, otherwise the EF is appended,
+ * compacting the image first if needed.
+ */
+static int sim_fs_image_alloc(struct sim_fs *fs, int id,
+				const unsigned char *fileinfo, int length)
+{
+	int entry = sim_fs_image_lookup(fs, id);
+	size_t offset = 0;
+	unsigned char *e;
+	int i;
+
+	if (entry != -1) {
+		e = sim_fs_image_entry(fs, entry);
+
+		if (sim_fs_entry_length(e) >= length)
+			offset = sim_fs_entry_offset(e);
+	} else {
+		for (i = 0; i < SIM_CACHE_INDEX_ENTRIES; i++) {
+			e = sim_fs_image_entry(fs, i);
+
+			if (sim_fs_entry_id(e) == 0 ||
+					sim_fs_entry_id(e) == (unsigned int) id)
+				break;
+		}
+
+		if (i == SIM_CACHE_INDEX_ENTRIES)
+			return -1;
+
+		entry = i;
+	}
+
+	if (offset == 0) {
+		/* The old area, if any, is not needed anymore */
+		e = sim_fs_image_entry(fs, entry);
+		e[0] = 0;
+		e[1] = 0;
+
+		sim_fs_image_compact(fs);
+		if (fs->image == NULL)
+			return -1;
+
+		offset = fs->image_size;
+
+		if (ftruncate(fs->image_fd, offset + length) < 0)
+			return -1;
+
+		if (sim_fs_image_map(fs, offset + length) == FALSE) {
+			sim_fs_image_close(fs);
+			return -1;
+		}
+	}
+
+	e = sim_fs_image_entry(fs, entry);
+	e[0] = id >> 8;
+	e[1] = id & 0xff;
+	e[2] = offset >> 24;
+	e[3] = (offset >> 16) & 0xff;
+	e[4] = (offset >> 8) & 0xff;
+	e[5] = offset & 0xff;
+	memcpy(e + SIM_CACHE_ENTRY_INFO, fileinfo, SIM_CACHE_HEADER_SIZE);
+
+	return entry;
+}
+
 void sim_fs_free(struct sim_fs *fs)
 {
 	if (fs == NULL)
@@ -113,6 +508,11 @@ void sim_fs_free(struct sim_fs *fs)
 	while (fs->contexts)
 		sim_fs_context_free(fs->contexts->data);
 
+	sim_fs_image_close(fs);
+
+	__ofono_metric_unref(fs->cache_hits);
+	__ofono_metric_unref(fs->cache_misses);
+
 	g_free(fs);
 }
 
@@ -137,7 +537,15 @@ struct sim_fs *sim_fs_new(struct ofono_sim *sim,
 
 	fs->sim = sim;
 	fs->driver = driver;
-	fs->fd = -1;
+	fs->entry = -1;
+	fs->image_fd = -1;
+
+	fs->cache_hits = __ofono_metric_counter(
+				"ofono_sim_ef_cache_hits_total", NULL,
+				"EF reads served from the SIM file cache");
+	fs->cache_misses = __ofono_metric_counter(
+				"ofono_sim_ef_cache_misses_total", NULL,
+				"EF reads not found in the SIM file cache");
 
 	return fs;
 }
@@ -161,8 +569,19 @@ void sim_fs_context_free(struct ofono_sim_context *context)
 	struct sim_fs *fs = context->fs;
 	int n = 0;
 	struct sim_fs_op *op;
+	GSList *l;
 
 	if (fs->op_q) {
+		op = g_queue_peek_head(fs->op_q);
+
+		/* Reads joined to the current operation are in progress too */
+		for (l = op ? op->joined : NULL; l; l = l->next) {
+			struct sim_fs_op *joined = l->data;
+
+			if (joined->context == context)
+				joined->cb = NULL;
+		}
+
 		while ((op = g_queue_peek_nth(fs->op_q, n)) != NULL) {
 			if (op->context != context) {
 				n += 1;
@@ -224,10 +643,13 @@ void sim_fs_notify_file_watches(struct sim_fs *fs, int id)
 
 	for (l = fs->contexts; l; l = l->next) {
 		struct ofono_sim_context *context = l->data;
-		GSList *k;
+		struct ofono_watchlist_iter iter;
+		struct ofono_watchlist_item *item;
+
+		__ofono_watchlist_iter_init(&iter, context->file_watches);
 
-		for (k = context->file_watches->items; k; k = k->next) {
-			struct file_watch *w = k->data;
+		while ((item = __ofono_watchlist_iter_next(&iter))) {
+			struct file_watch *w = (struct file_watch *) item;
 			ofono_sim_file_changed_cb_t notify = w->item.notify;
 
 			if (id == -1 || w->ef == id)
@@ -241,15 +663,17 @@ static void sim_fs_end_current(struct sim_fs *fs)
 {
 	struct sim_fs_op *op = g_queue_pop_head(fs->op_q);
 
+	if (fs->op_source) {
+		g_source_remove(fs->op_source);
+		fs->op_source = 0;
+	}
+
 	if (g_queue_get_length(fs->op_q) > 0)
 		fs->op_source = g_idle_add(sim_fs_op_next, fs);
 
-	if (fs->fd != -1) {
-		TFR(close(fs->fd));
-		fs->fd = -1;
-	}
-
-	memset(fs->bitmap, 0, sizeof(fs->bitmap));
+	/* Replies to reads still in flight belong to the old operation */
+	fs->op_serial += 1;
+	fs->entry = -1;
 
 	sim_fs_op_free(op);
 }
@@ -258,7 +682,7 @@ static void sim_fs_op_error(struct sim_fs *fs)
 {
 	struct sim_fs_op *op = g_queue_peek_head(fs->op_q);
 
-	if (op->cb == NULL) {
+	if (sim_fs_op_has_cb(op) == FALSE) {
 		sim_fs_end_current(fs);
 		return;
 	}
@@ -267,8 +691,7 @@ static void sim_fs_op_error(struct sim_fs *fs)
 		((sim_fs_read_info_cb_t) op->cb)
 			(0, 0, 0, 0, op->userdata);
 	else if (op->is_read == TRUE)
-		((ofono_sim_file_read_cb_t) op->cb)
-			(0, 0, 0, 0, 0, op->userdata);
+		sim_fs_op_read_notify(op, 0, 0, 0, 0, 0);
 	else
 		((ofono_sim_file_write_cb_t) op->cb)
 			(0, op->userdata);
@@ -279,39 +702,30 @@ static void sim_fs_op_error(struct sim_fs *fs)
 static gboolean cache_block(struct sim_fs *fs, int block, int block_len,
 				const unsigned char *data, int num_bytes)
 {
-	int offset;
-	int bit;
+	unsigned char *e;
+	size_t offset;
 	ssize_t r;
-	unsigned char b;
-
-	if (fs->fd == -1)
-		return FALSE;
 
-	if (lseek(fs->fd, block * block_len +
-				SIM_CACHE_HEADER_SIZE, SEEK_SET) == (off_t) -1)
+	if (fs->entry == -1)
 		return FALSE;
 
-	r = TFR(write(fs->fd, data, num_bytes));
+	e = sim_fs_image_entry(fs, fs->entry);
 
-	if (r != num_bytes)
+	/* Blocks the bitmap has no room for are not cached */
+	if (block >= SIM_CACHE_BITMAP_BLOCKS)
 		return FALSE;
 
-	/* update present bit for this block */
-	offset = block / 8;
-	bit = block % 8;
-
-	/* lseek to correct byte (skip file info) */
-	lseek(fs->fd, offset + SIM_FILE_INFO_SIZE, SEEK_SET);
-
-	b = fs->bitmap[offset];
-	b |= 1 << bit;
+	if (block * block_len + num_bytes > sim_fs_entry_length(e))
+		return FALSE;
 
-	r = TFR(write(fs->fd, &b, sizeof(b)));
+	offset = sim_fs_entry_offset(e) + block * block_len;
+	r = TFR(pwrite(fs->image_fd, data, num_bytes, offset));
 
-	if (r != sizeof(b))
+	if (r != num_bytes)
 		return FALSE;
 
-	fs->bitmap[offset] = b;
+	/* update present bit for this block */
+	sim_fs_entry_bitmap(e)[block / 8] |= 1 << (block % 8);
 
 	return TRUE;
 }
@@ -358,13 +772,13 @@ static void sim_fs_op_read_block_cb(const struct ofono_error *error,
 	if (op->current == start_block) {
 		bufoff = 0;
 		dataoff = op->offset % 256;
-		tocopy = MIN(256 - op->offset % 256,
-				op->num_bytes - op->current * 256);
+		tocopy = MIN(256 - op->offset % 256, op->num_bytes);
 	} else {
-		bufoff = (op->current - start_block - 1) * 256 +
+		bufoff = (op->current - start_block) * 256 -
 				op->offset % 256;
 		dataoff = 0;
-		tocopy = MIN(256, op->num_bytes - op->current * 256);
+		tocopy = MIN(256, op->offset + op->num_bytes -
+				op->current * 256);
 	}
 
 	DBG("bufoff: %d, dataoff: %d, tocopy: %d",
@@ -373,7 +787,7 @@ static void sim_fs_op_read_block_cb(const struct ofono_error *error,
 	memcpy(op->buffer + bufoff, data + dataoff, tocopy);
 	cache_block(fs, op->current, 256, data, len);
 
-	if (op->cb == NULL) {
+	if (sim_fs_op_has_cb(op) == FALSE) {
 		sim_fs_end_current(fs);
 		return;
 	}
@@ -381,10 +795,8 @@ static void sim_fs_op_read_block_cb(const struct ofono_error *error,
 	op->current++;
 
 	if (op->current > end_block) {
-		ofono_sim_file_read_cb_t cb = op->cb;
-
-		cb(1, op->num_bytes, 0, op->buffer,
-				op->record_length, op->userdata);
+		sim_fs_op_read_notify(op, 1, op->num_bytes, 0, op->buffer,
+					op->record_length);
 
 		sim_fs_end_current(fs);
 	} else {
@@ -402,7 +814,7 @@ static gboolean sim_fs_op_read_block(gpointer user_data)
 
 	fs->op_source = 0;
 
-	if (op->cb == NULL) {
+	if (sim_fs_op_has_cb(op) == FALSE) {
 		sim_fs_end_current(fs);
 		return FALSE;
 	}
@@ -419,46 +831,45 @@ static gboolean sim_fs_op_read_block(gpointer user_data)
 		}
 	}
 
-	while (fs->fd != -1 && op->current <= end_block) {
+	while (fs->entry != -1 && op->current <= end_block) {
+		unsigned char *e = sim_fs_image_entry(fs, fs->entry);
 		int offset = op->current / 8;
 		int bit = 1 << op->current % 8;
 		int bufoff;
 		int seekoff;
 		int toread;
 
-		if ((fs->bitmap[offset] & bit) == 0)
+		if ((sim_fs_entry_bitmap(e)[offset] & bit) == 0)
 			break;
 
 		if (op->current == start_block) {
 			bufoff = 0;
-			seekoff = SIM_CACHE_HEADER_SIZE + op->current * 256 +
-				op->offset % 256;
-			toread = MIN(256 - op->offset % 256,
-					op->num_bytes - op->current * 256);
+			seekoff = op->current * 256 + op->offset % 256;
+			toread = MIN(256 - op->offset % 256, op->num_bytes);
 		} else {
-			bufoff = (op->current - start_block - 1) * 256 +
+			bufoff = (op->current - start_block) * 256 -
 					op->offset % 256;
-			seekoff = SIM_CACHE_HEADER_SIZE + op->current * 256;
-			toread = MIN(256, op->num_bytes - op->current * 256);
+			seekoff = op->current * 256;
+			toread = MIN(256, op->offset + op->num_bytes -
+					op->current * 256);
 		}
 
 		DBG("bufoff: %d, seekoff: %d, toread: %d",
 				bufoff, seekoff, toread);
 
-		if (lseek(fs->fd, seekoff, SEEK_SET) == (off_t) -1)
+		if (seekoff + toread > sim_fs_entry_length(e))
 			break;
 
-		if (TFR(read(fs->fd, op->buffer + bufoff, toread)) != toread)
-			break;
+		memcpy(op->buffer + bufoff,
+				fs->image + sim_fs_entry_offset(e) + seekoff,
+				toread);
 
 		op->current += 1;
 	}
 
 	if (op->current > end_block) {
-		ofono_sim_file_read_cb_t cb = op->cb;
-
-		cb(1, op->num_bytes, 0, op->buffer,
-				op->record_length, op->userdata);
+		sim_fs_op_read_notify(op, 1, op->num_bytes, 0, op->buffer,
+					op->record_length);
 
 		sim_fs_end_current(fs);
 
@@ -485,103 +896,172 @@ static void sim_fs_op_retrieve_cb(const struct ofono_error *error,
 					const unsigned char *data, int len,
 					void *user)
 {
-	struct sim_fs *fs = user;
+	struct sim_fs_record_req *req = user;
+	struct sim_fs *fs = req->fs;
 	struct sim_fs_op *op = g_queue_peek_head(fs->op_q);
-	int total = op->length / op->record_length;
-	ofono_sim_file_read_cb_t cb = op->cb;
+	int record = req->record;
 
-	if (error->type != OFONO_ERROR_TYPE_NO_ERROR) {
-		sim_fs_op_error(fs);
+	if (req->serial != fs->op_serial) {
+		g_free(req);
 		return;
 	}
 
-	cache_block(fs, op->current - 1, op->record_length,
-			data, op->record_length);
+	g_free(req);
+	op->pending -= 1;
 
-	if (cb == NULL) {
-		sim_fs_end_current(fs);
-		return;
-	}
+	if (error->type != OFONO_ERROR_TYPE_NO_ERROR) {
+		if (op->error_record == 0 || record < op->error_record)
+			op->error_record = record;
+	} else {
+		cache_block(fs, record - 1, op->record_length,
+				data, op->record_length);
 
-	cb(1, op->length, op->current, data, op->record_length, op->userdata);
+		memcpy(op->buffer + (record - 1) * op->record_length,
+				data, op->record_length);
+		op->received[(record - 1) / 8] |= 1 << ((record - 1) % 8);
+	}
 
-	if (op->current < total) {
-		op->current += 1;
+	/*
+	 * Replies are handled from the idle callback only, drivers are
+	 * allowed to reply from within the request.
+	 */
+	if (fs->op_source == 0)
 		fs->op_source = g_idle_add(sim_fs_op_read_record, fs);
-	} else {
-		sim_fs_end_current(fs);
+}
+
+static gboolean sim_fs_op_request_record(struct sim_fs *fs,
+						struct sim_fs_op *op)
+{
+	const struct ofono_sim_driver *driver = fs->driver;
+	struct sim_fs_record_req *req;
+
+	req = g_new0(struct sim_fs_record_req, 1);
+	req->fs = fs;
+	req->serial = fs->op_serial;
+	req->record = op->requested;
+
+	op->pending += 1;
+
+	switch (op->structure) {
+	case OFONO_SIM_FILE_STRUCTURE_FIXED:
+		driver->read_file_linear(fs->sim, op->id, req->record,
+						op->record_length,
+						NULL, 0,
+						sim_fs_op_retrieve_cb, req);
+		return TRUE;
+	case OFONO_SIM_FILE_STRUCTURE_CYCLIC:
+		driver->read_file_cyclic(fs->sim, op->id, req->record,
+						op->record_length,
+						NULL, 0,
+						sim_fs_op_retrieve_cb, req);
+		return TRUE;
+	default:
+		ofono_error("Unrecognized file structure, this can't happen");
 	}
+
+	op->pending -= 1;
+	g_free(req);
+
+	return FALSE;
 }
 
+/*
+ * Records are read ahead: up to SIM_FS_READ_AHEAD reads are kept in flight
+ * with the driver, records found in the cache are picked up on the way,
+ * and everything is handed to the callbacks in record order.
+ */
 static gboolean sim_fs_op_read_record(gpointer user)
 {
 	struct sim_fs *fs = user;
 	struct sim_fs_op *op = g_queue_peek_head(fs->op_q);
 	const struct ofono_sim_driver *driver = fs->driver;
-	int total = op->length / op->record_length;
-	unsigned char buf[256];
+	int total = MIN(op->length / op->record_length, SIM_FS_MAX_RECORDS);
+	gconstpointer read_fn;
 
 	fs->op_source = 0;
 
-	if (op->cb == NULL) {
+	if (sim_fs_op_has_cb(op) == FALSE) {
 		sim_fs_end_current(fs);
 		return FALSE;
 	}
 
-	while (fs->fd != -1 && op->current <= total) {
-		int offset = (op->current - 1) / 8;
-		int bit = 1 << ((op->current - 1) % 8);
-		ofono_sim_file_read_cb_t cb = op->cb;
+	if (op->buffer == NULL) {
+		op->buffer = g_try_new0(unsigned char, op->length);
 
-		if ((fs->bitmap[offset] & bit) == 0)
+		if (op->buffer == NULL) {
+			sim_fs_op_error(fs);
+			return FALSE;
+		}
+
+		op->requested = op->current;
+	}
+
+	if (op->structure == OFONO_SIM_FILE_STRUCTURE_FIXED)
+		read_fn = driver->read_file_linear;
+	else
+		read_fn = driver->read_file_cyclic;
+
+	while (op->requested <= total && op->error_record == 0) {
+		int record = op->requested;
+		int offset = (record - 1) / 8;
+		int bit = 1 << ((record - 1) % 8);
+		unsigned char *e;
+
+		if (fs->entry == -1)
+			goto request;
+
+		e = sim_fs_image_entry(fs, fs->entry);
+
+		if ((sim_fs_entry_bitmap(e)[offset] & bit) == 0)
+			goto request;
+
+		if (record * op->record_length > sim_fs_entry_length(e))
+			goto request;
+
+		memcpy(op->buffer + (record - 1) * op->record_length,
+				fs->image + sim_fs_entry_offset(e) +
+				(record - 1) * op->record_length,
+				op->record_length);
+		op->received[offset] |= bit;
+		op->requested += 1;
+		continue;
+
+request:
+		if (op->pending >= SIM_FS_READ_AHEAD)
 			break;
 
-		if (lseek(fs->fd, (op->current - 1) * op->record_length +
-				SIM_CACHE_HEADER_SIZE, SEEK_SET) == (off_t) -1)
+		if (read_fn == NULL ||
+				sim_fs_op_request_record(fs, op) == FALSE) {
+			op->error_record = record;
 			break;
+		}
 
-		if (TFR(read(fs->fd, buf, op->record_length)) !=
-				op->record_length)
+		op->requested += 1;
+	}
+
+	while (op->current <= total) {
+		int offset = (op->current - 1) / 8;
+		int bit = 1 << ((op->current - 1) % 8);
+
+		if ((op->received[offset] & bit) == 0)
 			break;
 
-		cb(1, op->length, op->current,
-				buf, op->record_length, op->userdata);
+		sim_fs_op_read_notify(op, 1, op->length, op->current,
+				op->buffer +
+				(op->current - 1) * op->record_length,
+				op->record_length);
 
 		op->current += 1;
 	}
 
 	if (op->current > total) {
 		sim_fs_end_current(fs);
-
 		return FALSE;
 	}
 
-	switch (op->structure) {
-	case OFONO_SIM_FILE_STRUCTURE_FIXED:
-		if (driver->read_file_linear == NULL) {
-			sim_fs_op_error(fs);
-			return FALSE;
-		}
-
-		driver->read_file_linear(fs->sim, op->id, op->current,
-						op->record_length,
-						NULL, 0,
-						sim_fs_op_retrieve_cb, fs);
-		break;
-	case OFONO_SIM_FILE_STRUCTURE_CYCLIC:
-		if (driver->read_file_cyclic == NULL) {
-			sim_fs_op_error(fs);
-			return FALSE;
-		}
-
-		driver->read_file_cyclic(fs->sim, op->id, op->current,
-						op->record_length,
-						NULL, 0,
-						sim_fs_op_retrieve_cb, fs);
-		break;
-	default:
-		ofono_error("Unrecognized file structure, this can't happen");
-	}
+	/* Fail once every record before the failed one has been handed out */
+	if (op->error_record != 0 && op->current >= op->error_record)
+		sim_fs_op_error(fs);
 
 	return FALSE;
 }
@@ -602,7 +1082,6 @@ static void sim_fs_op_cache_fileinfo(struct sim_fs *fs,
 	enum sim_file_access rehabilitate;
 	unsigned char fileinfo[SIM_CACHE_HEADER_SIZE];
 	gboolean cache;
-	char *path;
 
 	/* TS 11.11, Section 9.3 */
 	update = file_access_condition_decode(access[0] & 0xf);
@@ -630,19 +1109,10 @@ static void sim_fs_op_cache_fileinfo(struct sim_fs *fs,
 	fileinfo[5] = record_length & 0xff;
 	fileinfo[6] = file_status;
 
-	path = g_strdup_printf(SIM_CACHE_PATH, imsi, phase, op->id);
-	fs->fd = TFR(open(path, O_WRONLY | O_CREAT | O_TRUNC, SIM_CACHE_MODE));
-	g_free(path);
-
-	if (fs->fd == -1)
+	if (sim_fs_image_open(fs) == FALSE)
 		return;
 
-	if (TFR(write(fs->fd, fileinfo, SIM_CACHE_HEADER_SIZE)) ==
-			SIM_CACHE_HEADER_SIZE)
-		return;
-
-	TFR(close(fs->fd));
-	fs->fd = -1;
+	fs->entry = sim_fs_image_alloc(fs, op->id, fileinfo, length);
 }
 
 static void sim_fs_op_info_cb(const struct ofono_error *error, int length,
@@ -670,7 +1140,7 @@ static void sim_fs_op_info_cb(const struct ofono_error *error, int length,
 		return;
 	}
 
-	if (op->cb == NULL) {
+	if (sim_fs_op_has_cb(op) == FALSE) {
 		sim_fs_end_current(fs);
 		return;
 	}
@@ -688,6 +1158,11 @@ static void sim_fs_op_info_cb(const struct ofono_error *error, int length,
 		if (op->info_only == FALSE)
 			fs->op_source = g_idle_add(sim_fs_op_read_block, fs);
 	} else {
+		if (record_length == 0) {
+			sim_fs_op_error(fs);
+			return;
+		}
+
 		op->record_length = record_length;
 		op->current = 1;
 
@@ -711,43 +1186,23 @@ static void sim_fs_op_info_cb(const struct ofono_error *error, int length,
 
 static gboolean sim_fs_op_check_cached(struct sim_fs *fs)
 {
-	const char *imsi = ofono_sim_get_imsi(fs->sim);
-	enum ofono_sim_phase phase = ofono_sim_get_phase(fs->sim);
 	struct sim_fs_op *op = g_queue_peek_head(fs->op_q);
-	char *path;
-	int fd;
-	ssize_t len;
-	unsigned char fileinfo[SIM_CACHE_HEADER_SIZE];
+	const unsigned char *fileinfo;
+	int entry;
 	int error_type;
 	int file_length;
 	enum ofono_sim_file_structure structure;
 	int record_length;
 	unsigned char file_status;
 
-	if (imsi == NULL || phase == OFONO_SIM_PHASE_UNKNOWN)
+	if (sim_fs_image_open(fs) == FALSE)
 		return FALSE;
 
-	path = g_strdup_printf(SIM_CACHE_PATH, imsi, phase, op->id);
-
-	if (path == NULL)
+	entry = sim_fs_image_lookup(fs, op->id);
+	if (entry == -1)
 		return FALSE;
 
-	fd = TFR(open(path, O_RDWR));
-	g_free(path);
-
-	if (fd == -1) {
-		if (errno != ENOENT)
-			DBG("Error %i opening cache file for "
-					"fileid %04x, IMSI %s",
-					errno, op->id, imsi);
-
-		return FALSE;
-	}
-
-	len = TFR(read(fd, fileinfo, SIM_CACHE_HEADER_SIZE));
-
-	if (len != SIM_CACHE_HEADER_SIZE)
-		goto error;
+	fileinfo = sim_fs_image_entry(fs, entry) + SIM_CACHE_ENTRY_INFO;
 
 	error_type = fileinfo[0];
 	file_length = (fileinfo[1] << 8) | fileinfo[2];
@@ -759,13 +1214,11 @@ static gboolean sim_fs_op_check_cached(struct sim_fs *fs)
 		record_length = file_length;
 
 	if (record_length == 0 || file_length < record_length)
-		goto error;
+		return FALSE;
 
 	op->length = file_length;
 	op->record_length = record_length;
-	memcpy(fs->bitmap, fileinfo + SIM_FILE_INFO_SIZE,
-			SIM_CACHE_HEADER_SIZE - SIM_FILE_INFO_SIZE);
-	fs->fd = fd;
+	fs->entry = entry;
 
 	if (error_type != OFONO_ERROR_TYPE_NO_ERROR ||
 			structure != op->structure) {
@@ -796,10 +1249,32 @@ static gboolean sim_fs_op_check_cached(struct sim_fs *fs)
 	}
 
 	return TRUE;
+}
 
-error:
-	TFR(close(fd));
-	return FALSE;
+/*
+ * Identical reads queued behind the current one, e.g. the same EF being
+ * requested by several atoms during SIM initialization, are served by the
+ * same transaction with the SIM.  Reads queued after a write must see the
+ * data written, so the search ends at the first write.
+ */
+static void sim_fs_op_join_reads(struct sim_fs *fs, struct sim_fs_op *op)
+{
+	GList *l = g_queue_peek_head_link(fs->op_q)->next;
+
+	while (l) {
+		GList *next = l->next;
+		struct sim_fs_op *queued = l->data;
+
+		if (queued->is_read == FALSE)
+			break;
+
+		if (sim_fs_op_same_read(op, queued)) {
+			g_queue_delete_link(fs->op_q, l);
+			op->joined = g_slist_append(op->joined, queued);
+		}
+
+		l = next;
+	}
 }
 
 static gboolean sim_fs_op_next(gpointer user_data)
@@ -821,8 +1296,15 @@ static gboolean sim_fs_op_next(gpointer user_data)
 	}
 
 	if (op->is_read == TRUE) {
-		if (sim_fs_op_check_cached(fs))
+		if (op->info_only == FALSE)
+			sim_fs_op_join_reads(fs, op);
+
+		if (sim_fs_op_check_cached(fs)) {
+			__ofono_metric_add(fs->cache_hits, 1);
 			return FALSE;
+		}
+
+		__ofono_metric_add(fs->cache_misses, 1);
 
 		driver->read_file_info(fs->sim, op->id,
 					op->path_len ? op->path : NULL,
@@ -1135,7 +1617,7 @@ void sim_fs_cache_flush(struct sim_fs *fs)
 	g_free(path);
 
 	if (len > 0) {
-		/* Remove all file ids */
+		/* Remove all file ids left over from older cache versions */
 		while (len--) {
 			remove_cachefile(imsi, phase, entries[len]);
 			g_free(entries[len]);
@@ -1144,17 +1626,33 @@ void sim_fs_cache_flush(struct sim_fs *fs)
 		g_free(entries);
 	}
 
+	sim_fs_image_close(fs);
+
+	path = g_strdup_printf(SIM_CACHE_IMAGE_PATH, imsi, phase);
+	remove(path);
+	g_free(path);
+
 	sim_fs_image_cache_flush(fs);
 }
 
 void sim_fs_cache_flush_file(struct sim_fs *fs, int id)
 {
-	const char *imsi = ofono_sim_get_imsi(fs->sim);
-	enum ofono_sim_phase phase = ofono_sim_get_phase(fs->sim);
-	char *path = g_strdup_printf(SIM_CACHE_PATH, imsi, phase, id);
+	unsigned char *e;
+	int entry;
 
-	remove(path);
-	g_free(path);
+	if (sim_fs_image_open(fs) == FALSE)
+		return;
+
+	entry = sim_fs_image_lookup(fs, id);
+	if (entry == -1)
+		return;
+
+	e = sim_fs_image_entry(fs, entry);
+	e[0] = 0;
+	e[1] = 0;
+
+	if (fs->entry == entry)
+		fs->entry = -1;
 }
 
 void sim_fs_image_cache_flush(struct sim_fs *fs)
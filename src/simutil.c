@@ -38,6 +38,9 @@ struct sim_eons {
 	GSList *opl_list;
 	gboolean pnn_valid;
 	int pnn_max;
+	struct opl_operator **opl;
+	GHashTable *opl_exact;
+	GSList *opl_wildcard;
 };
 
 struct spdi_operator {
@@ -53,6 +56,21 @@ struct opl_operator {
 	guint8 id;
 };
 
+/*
+ * All EFopl records for one PLMN (or one wildcard PLMN pattern).  The LAC /
+ * TAC ranges of the records are flattened into sorted, non-overlapping
+ * intervals, each remembering the first record in EFopl order covering it.
+ */
+struct opl_bucket {
+	char key[OFONO_MAX_MCC_LENGTH + OFONO_MAX_MNC_LENGTH + 1];
+	const struct opl_operator *pattern;
+	int any;
+	GSList *ranged;
+	int n_intervals;
+	guint32 *bounds;
+	int *first;
+};
+
 #define MF	1
 #define DF	2
 #define EF	4
@@ -1055,6 +1073,30 @@ static struct opl_operator *opl_operator_alloc(const guint8 *record)
 	return oper;
 }
 
+static void opl_bucket_free(gpointer data)
+{
+	struct opl_bucket *bucket = data;
+
+	g_slist_free(bucket->ranged);
+	g_free(bucket->bounds);
+	g_free(bucket->first);
+	g_free(bucket);
+}
+
+static void opl_index_free(struct sim_eons *eons)
+{
+	if (eons->opl_exact) {
+		g_hash_table_destroy(eons->opl_exact);
+		eons->opl_exact = NULL;
+	}
+
+	g_slist_free_full(eons->opl_wildcard, opl_bucket_free);
+	eons->opl_wildcard = NULL;
+
+	g_free(eons->opl);
+	eons->opl = NULL;
+}
+
 void sim_eons_add_opl_record(struct sim_eons *eons,
 				const guint8 *contents, int length)
 {
@@ -1067,12 +1109,216 @@ void sim_eons_add_opl_record(struct sim_eons *eons,
 		return;
 	}
 
+	opl_index_free(eons);
 	eons->opl_list = g_slist_prepend(eons->opl_list, oper);
 }
 
+static void opl_plmn_key(char *key, const char *mcc, const char *mnc)
+{
+	int i;
+
+	/* Unused digits of the record never match a digit of the network */
+	for (i = 0; i < OFONO_MAX_MCC_LENGTH; i++)
+		*key++ = mcc[i] ? mcc[i] : 'f';
+
+	for (i = 0; i < OFONO_MAX_MNC_LENGTH; i++)
+		*key++ = mnc[i] ? mnc[i] : 'f';
+
+	*key = '\0';
+}
+
+static gboolean opl_is_wildcard(const struct opl_operator *opl)
+{
+	return memchr(opl->mcc, 'b', OFONO_MAX_MCC_LENGTH) != NULL ||
+		memchr(opl->mnc, 'b', OFONO_MAX_MNC_LENGTH) != NULL;
+}
+
+static gboolean opl_plmn_match(const struct opl_operator *opl,
+				const char *mcc, const char *mnc)
+{
+	int i;
+
+	for (i = 0; i < OFONO_MAX_MCC_LENGTH; i++)
+		if (mcc[i] != opl->mcc[i] && !(opl->mcc[i] == 'b' && mcc[i]))
+			return FALSE;
+
+	for (i = 0; i < OFONO_MAX_MNC_LENGTH; i++)
+		if (mnc[i] != opl->mnc[i] && !(opl->mnc[i] == 'b' && mnc[i]))
+			return FALSE;
+
+	return TRUE;
+}
+
+static int opl_bound_compare(const void *a, const void *b)
+{
+	guint32 ua = *(const guint32 *) a;
+	guint32 ub = *(const guint32 *) b;
+
+	return ua < ub ? -1 : ua > ub;
+}
+
+/* Index of the interval containing value, or -1 */
+static int opl_bucket_find(const struct opl_bucket *bucket, guint32 value)
+{
+	int low = 0;
+	int high = bucket->n_intervals - 1;
+
+	while (low <= high) {
+		int mid = (low + high) / 2;
+
+		if (value < bucket->bounds[mid])
+			high = mid - 1;
+		else if (value >= bucket->bounds[mid + 1])
+			low = mid + 1;
+		else
+			return mid;
+	}
+
+	return -1;
+}
+
+static void opl_bucket_build(struct opl_bucket *bucket,
+				struct opl_operator **opl)
+{
+	int n = g_slist_length(bucket->ranged);
+	int n_bounds = 0;
+	GSList *l;
+	int i;
+
+	if (n == 0)
+		return;
+
+	bucket->ranged = g_slist_reverse(bucket->ranged);
+	bucket->bounds = g_new(guint32, 2 * n);
+
+	for (l = bucket->ranged; l; l = l->next) {
+		const struct opl_operator *oper = opl[GPOINTER_TO_INT(l->data)];
+
+		bucket->bounds[n_bounds++] = oper->lac_tac_low;
+		bucket->bounds[n_bounds++] = oper->lac_tac_high + 1;
+	}
+
+	qsort(bucket->bounds, n_bounds, sizeof(guint32), opl_bound_compare);
+
+	for (i = 1, n = 1; i < n_bounds; i++)
+		if (bucket->bounds[i] != bucket->bounds[n - 1])
+			bucket->bounds[n++] = bucket->bounds[i];
+
+	bucket->n_intervals = n - 1;
+	bucket->first = g_new(int, bucket->n_intervals);
+
+	for (i = 0; i < bucket->n_intervals; i++)
+		bucket->first[i] = -1;
+
+	/* Records are visited in EFopl order, so the first one sticks */
+	for (l = bucket->ranged; l; l = l->next) {
+		int pos = GPOINTER_TO_INT(l->data);
+		const struct opl_operator *oper = opl[pos];
+
+		i = opl_bucket_find(bucket, oper->lac_tac_low);
+
+		for (; i < bucket->n_intervals &&
+				bucket->bounds[i] <= oper->lac_tac_high; i++)
+			if (bucket->first[i] == -1)
+				bucket->first[i] = pos;
+	}
+
+	g_slist_free(bucket->ranged);
+	bucket->ranged = NULL;
+}
+
+static void opl_bucket_add(struct opl_bucket *bucket,
+				const struct opl_operator *oper, int pos)
+{
+	/* A record covering every LAC hides all records following it */
+	if (bucket->any != -1)
+		return;
+
+	if (oper->lac_tac_low == 0 && oper->lac_tac_high == 0xfffe) {
+		bucket->any = pos;
+		return;
+	}
+
+	if (oper->lac_tac_low > oper->lac_tac_high)
+		return;
+
+	bucket->ranged = g_slist_prepend(bucket->ranged, GINT_TO_POINTER(pos));
+}
+
+static struct opl_bucket *opl_bucket_new(const struct opl_operator *oper)
+{
+	struct opl_bucket *bucket = g_new0(struct opl_bucket, 1);
+
+	opl_plmn_key(bucket->key, oper->mcc, oper->mnc);
+	bucket->pattern = oper;
+	bucket->any = -1;
+
+	return bucket;
+}
+
+static void opl_bucket_build_cb(gpointer key, gpointer value,
+					gpointer user_data)
+{
+	opl_bucket_build(value, user_data);
+}
+
 void sim_eons_optimize(struct sim_eons *eons)
 {
-	eons->opl_list = g_slist_reverse(eons->opl_list);
+	GSList *l;
+	int n;
+	int pos;
+
+	opl_index_free(eons);
+
+	n = g_slist_length(eons->opl_list);
+	eons->opl = g_new(struct opl_operator *, n + 1);
+	eons->opl_exact = g_hash_table_new_full(g_str_hash, g_str_equal,
+						NULL, opl_bucket_free);
+
+	/* opl_list is kept in reverse EFopl order */
+	for (l = eons->opl_list, pos = n - 1; l; l = l->next, pos--)
+		eons->opl[pos] = l->data;
+
+	for (pos = 0; pos < n; pos++) {
+		struct opl_operator *oper = eons->opl[pos];
+		struct opl_bucket *bucket = NULL;
+		char key[OFONO_MAX_MCC_LENGTH + OFONO_MAX_MNC_LENGTH + 1];
+
+		opl_plmn_key(key, oper->mcc, oper->mnc);
+
+		if (opl_is_wildcard(oper)) {
+			for (l = eons->opl_wildcard; l; l = l->next) {
+				struct opl_bucket *b = l->data;
+
+				if (g_str_equal(b->key, key)) {
+					bucket = b;
+					break;
+				}
+			}
+
+			if (bucket == NULL) {
+				bucket = opl_bucket_new(oper);
+				eons->opl_wildcard = g_slist_append(
+							eons->opl_wildcard,
+							bucket);
+			}
+		} else {
+			bucket = g_hash_table_lookup(eons->opl_exact, key);
+
+			if (bucket == NULL) {
+				bucket = opl_bucket_new(oper);
+				g_hash_table_insert(eons->opl_exact,
+							bucket->key, bucket);
+			}
+		}
+
+		opl_bucket_add(bucket, oper, pos);
+	}
+
+	for (l = eons->opl_wildcard; l; l = l->next)
+		opl_bucket_build(l->data, eons->opl);
+
+	g_hash_table_foreach(eons->opl_exact, opl_bucket_build_cb, eons->opl);
 }
 
 void sim_eons_free(struct sim_eons *eons)
@@ -1087,51 +1333,75 @@ void sim_eons_free(struct sim_eons *eons)
 
 	g_free(eons->pnn_list);
 
+	opl_index_free(eons);
 	g_slist_free_full(eons->opl_list, g_free);
 
 	g_free(eons);
 }
 
+/* Position in EFopl of the first record of the bucket matching, or -1 */
+static int opl_bucket_lookup(const struct opl_bucket *bucket,
+				gboolean have_lac, guint16 lac)
+{
+	int i;
+
+	if (have_lac == FALSE || bucket->n_intervals == 0)
+		return bucket->any;
+
+	i = opl_bucket_find(bucket, lac);
+	if (i == -1 || bucket->first[i] == -1)
+		return bucket->any;
+
+	if (bucket->any != -1 && bucket->any < bucket->first[i])
+		return bucket->any;
+
+	return bucket->first[i];
+}
+
 static const struct sim_eons_operator_info *
 	sim_eons_lookup_common(struct sim_eons *eons,
 				const char *mcc, const char *mnc,
 				gboolean have_lac, guint16 lac)
 {
-	GSList *l;
+	char key[OFONO_MAX_MCC_LENGTH + OFONO_MAX_MNC_LENGTH + 1];
+	char mcc_digits[OFONO_MAX_MCC_LENGTH + 1];
+	char mnc_digits[OFONO_MAX_MNC_LENGTH + 1];
+	const struct opl_bucket *bucket;
 	const struct opl_operator *opl;
-	int i;
+	GSList *l;
+	int best = -1;
+	int pos;
 
-	for (l = eons->opl_list; l; l = l->next) {
-		opl = l->data;
+	if (eons->opl == NULL)
+		sim_eons_optimize(eons);
 
-		for (i = 0; i < OFONO_MAX_MCC_LENGTH; i++)
-			if (mcc[i] != opl->mcc[i] &&
-					!(opl->mcc[i] == 'b' && mcc[i]))
-				break;
-		if (i < OFONO_MAX_MCC_LENGTH)
-			continue;
+	/* Callers may pass shorter strings, pad them like the records */
+	memset(mcc_digits, 0, sizeof(mcc_digits));
+	memset(mnc_digits, 0, sizeof(mnc_digits));
+	strncpy(mcc_digits, mcc, OFONO_MAX_MCC_LENGTH);
+	strncpy(mnc_digits, mnc, OFONO_MAX_MNC_LENGTH);
 
-		for (i = 0; i < OFONO_MAX_MNC_LENGTH; i++)
-			if (mnc[i] != opl->mnc[i] &&
-					!(opl->mnc[i] == 'b' && mnc[i]))
-				break;
-		if (i < OFONO_MAX_MNC_LENGTH)
-			continue;
+	opl_plmn_key(key, mcc_digits, mnc_digits);
 
-		if (opl->lac_tac_low == 0 && opl->lac_tac_high == 0xfffe)
-			break;
+	bucket = g_hash_table_lookup(eons->opl_exact, key);
+	if (bucket)
+		best = opl_bucket_lookup(bucket, have_lac, lac);
+
+	for (l = eons->opl_wildcard; l; l = l->next) {
+		bucket = l->data;
 
-		if (have_lac == FALSE)
+		if (!opl_plmn_match(bucket->pattern, mcc_digits, mnc_digits))
 			continue;
 
-		if ((lac >= opl->lac_tac_low) && (lac <= opl->lac_tac_high))
-			break;
+		pos = opl_bucket_lookup(bucket, have_lac, lac);
+		if (pos != -1 && (best == -1 || pos < best))
+			best = pos;
 	}
 
-	if (l == NULL)
+	if (best == -1)
 		return NULL;
 
-	opl = l->data;
+	opl = eons->opl[best];
 
 	/* 0 is not a valid record id */
 	if (opl->id == 0)
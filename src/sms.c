@@ -87,6 +87,12 @@ struct ofono_sms {
 	GHashTable *messages;
 	struct ofono_watchlist *text_handlers;
 	struct ofono_watchlist *datagram_handlers;
+	gint64 submit_start;
+	struct ofono_metric *submitted;
+	struct ofono_metric *failed;
+	struct ofono_metric *retried;
+	struct ofono_metric *queue_depth;
+	struct ofono_metric *submit_latency;
 };
 
 struct pending_pdu {
@@ -170,6 +176,26 @@ static const char *sms_alphabet_to_string(enum sms_alphabet alphabet)
 		return "spanish";
 	case SMS_ALPHABET_PORTUGUESE:
 		return "portuguese";
+	case SMS_ALPHABET_BENGALI:
+		return "bengali";
+	case SMS_ALPHABET_GUJARATI:
+		return "gujarati";
+	case SMS_ALPHABET_HINDI:
+		return "hindi";
+	case SMS_ALPHABET_KANNADA:
+		return "kannada";
+	case SMS_ALPHABET_MALAYALAM:
+		return "malayalam";
+	case SMS_ALPHABET_ORIYA:
+		return "oriya";
+	case SMS_ALPHABET_PUNJABI:
+		return "punjabi";
+	case SMS_ALPHABET_TAMIL:
+		return "tamil";
+	case SMS_ALPHABET_TELUGU:
+		return "telugu";
+	case SMS_ALPHABET_URDU:
+		return "urdu";
 	case SMS_ALPHABET_DEFAULT:
 		return "default";
 	}
@@ -188,6 +214,26 @@ static gboolean sms_alphabet_from_string(const char *str,
 		*alphabet = SMS_ALPHABET_SPANISH;
 	else if (g_str_equal(str, "portuguese"))
 		*alphabet = SMS_ALPHABET_PORTUGUESE;
+	else if (g_str_equal(str, "bengali"))
+		*alphabet = SMS_ALPHABET_BENGALI;
+	else if (g_str_equal(str, "gujarati"))
+		*alphabet = SMS_ALPHABET_GUJARATI;
+	else if (g_str_equal(str, "hindi"))
+		*alphabet = SMS_ALPHABET_HINDI;
+	else if (g_str_equal(str, "kannada"))
+		*alphabet = SMS_ALPHABET_KANNADA;
+	else if (g_str_equal(str, "malayalam"))
+		*alphabet = SMS_ALPHABET_MALAYALAM;
+	else if (g_str_equal(str, "oriya"))
+		*alphabet = SMS_ALPHABET_ORIYA;
+	else if (g_str_equal(str, "punjabi"))
+		*alphabet = SMS_ALPHABET_PUNJABI;
+	else if (g_str_equal(str, "tamil"))
+		*alphabet = SMS_ALPHABET_TAMIL;
+	else if (g_str_equal(str, "telugu"))
+		*alphabet = SMS_ALPHABET_TELUGU;
+	else if (g_str_equal(str, "urdu"))
+		*alphabet = SMS_ALPHABET_URDU;
 	else
 		return FALSE;
 
@@ -368,6 +414,10 @@ static DBusMessage *generate_get_properties_reply(struct ofono_sms *sms,
 
 	dbus_message_iter_close_container(&iter, &dict);
 
+	if (sms->flags & MESSAGE_MANAGER_FLAG_CACHED)
+		__ofono_dbus_cache_reply(msg, reply,
+					OFONO_MESSAGE_MANAGER_INTERFACE);
+
 	return reply;
 }
 
@@ -396,9 +446,16 @@ static DBusMessage *sms_get_properties(DBusConnection *conn,
 					DBusMessage *msg, void *data)
 {
 	struct ofono_sms *sms = data;
+	DBusMessage *reply;
+
+	if (sms->flags & MESSAGE_MANAGER_FLAG_CACHED) {
+		reply = __ofono_dbus_cached_reply(msg,
+					OFONO_MESSAGE_MANAGER_INTERFACE);
+		if (reply)
+			return reply;
 
-	if (sms->flags & MESSAGE_MANAGER_FLAG_CACHED)
 		return generate_get_properties_reply(sms, msg);
+	}
 
 	if (sms->pending)
 		return __ofono_error_busy(msg);
@@ -622,6 +679,7 @@ static void sms_tx_queue_remove_entry(struct ofono_sms *sms, GList *entry_list,
 	struct ofono_modem *modem = __ofono_atom_get_modem(sms->atom);
 
 	g_queue_delete_link(sms->txq, entry_list);
+	__ofono_metric_set(sms->queue_depth, g_queue_get_length(sms->txq));
 
 	DBG("%p", entry);
 
@@ -682,6 +740,9 @@ static void tx_finished(const struct ofono_error *error, int mr, void *data)
 
 	sms->flags &= ~MESSAGE_MANAGER_FLAG_TXQ_ACTIVE;
 
+	__ofono_metric_observe(sms->submit_latency,
+			(g_get_monotonic_time() - sms->submit_start) / 1000);
+
 	if (ok == FALSE) {
 		/* Retry again when back in online mode */
 		/* Note this does not increment retry count */
@@ -703,6 +764,7 @@ static void tx_finished(const struct ofono_error *error, int mr, void *data)
 		if (entry->retry < TXQ_MAX_RETRIES) {
 			DBG("Sending failed, retry in %d secs",
 					entry->retry * 5);
+			__ofono_metric_add(sms->retried, 1);
 			sms->tx_source = g_timeout_add_seconds(entry->retry * 5,
 								tx_next, sms);
 			return;
@@ -735,6 +797,11 @@ static void tx_finished(const struct ofono_error *error, int mr, void *data)
 	tx_state = MESSAGE_STATE_SENT;
 
 next_q:
+	if (tx_state == MESSAGE_STATE_SENT)
+		__ofono_metric_add(sms->submitted, 1);
+	else
+		__ofono_metric_add(sms->failed, 1);
+
 	sms_tx_queue_remove_entry(sms, g_queue_peek_head_link(sms->txq),
 					tx_state);
 
@@ -766,6 +833,7 @@ static gboolean tx_next(gpointer user_data)
 		send_mms = 1;
 
 	sms->flags |= MESSAGE_MANAGER_FLAG_TXQ_ACTIVE;
+	sms->submit_start = g_get_monotonic_time();
 
 	sms->driver->submit(sms, pdu->pdu, pdu->pdu_len, pdu->tpdu_len,
 				send_mms, tx_finished, sms);
@@ -1181,15 +1249,17 @@ static void dispatch_app_datagram(struct ofono_sms *sms,
 	struct tm local;
 
 	ofono_sms_datagram_notify_cb_t notify;
+	struct ofono_watchlist_iter iter;
 	struct sms_handler *h;
-	GSList *l;
 	gboolean dispatched = FALSE;
 
 	ts = sms_scts_to_time(scts, &remote);
 	localtime_r(&ts, &local);
 
-	for (l = sms->datagram_handlers->items; l; l = l->next) {
-		h = l->data;
+	__ofono_watchlist_iter_init(&iter, sms->datagram_handlers);
+
+	while ((h = (struct sms_handler *)
+			__ofono_watchlist_iter_next(&iter))) {
 		notify = h->item.notify;
 
 		if (!port_equal(dst, h->dst) || !port_equal(src, h->src))
@@ -1226,8 +1296,8 @@ static void dispatch_text_message(struct ofono_sms *sms,
 	struct tm local;
 	const char *str = buf;
 	ofono_sms_text_notify_cb_t notify;
+	struct ofono_watchlist_iter watch_iter;
 	struct sms_handler *h;
-	GSList *l;
 
 	if (message == NULL)
 		return;
@@ -1272,8 +1342,10 @@ static void dispatch_text_message(struct ofono_sms *sms,
 	if (cls == SMS_CLASS_0)
 		return;
 
-	for (l = sms->text_handlers->items; l; l = l->next) {
-		h = l->data;
+	__ofono_watchlist_iter_init(&watch_iter, sms->text_handlers);
+
+	while ((h = (struct sms_handler *)
+			__ofono_watchlist_iter_next(&watch_iter))) {
 		notify = h->item.notify;
 
 		notify(str, &remote, &local, message, h->item.notify_data);
@@ -1664,6 +1736,52 @@ void ofono_sms_driver_unregister(const struct ofono_sms_driver *d)
 	g_drivers = g_slist_remove(g_drivers, (void *) d);
 }
 
+static void sms_metrics_register(struct ofono_sms *sms,
+					struct ofono_modem *modem)
+{
+	static const guint64 latency_bounds[] = {
+		250, 500, 1000, 2500, 5000, 10000, 30000, 60000
+	};
+	char *labels;
+
+	labels = g_strdup_printf("modem=\"%s\"", ofono_modem_get_path(modem));
+
+	sms->submitted = __ofono_metric_counter("ofono_sms_submitted_total",
+					labels, "Short messages submitted");
+	sms->failed = __ofono_metric_counter("ofono_sms_failed_total",
+					labels, "Short messages that failed");
+	sms->retried = __ofono_metric_counter("ofono_sms_retried_total",
+					labels, "Short message submit retries");
+	sms->queue_depth = __ofono_metric_gauge("ofono_sms_queue_depth",
+					labels, "Short messages waiting to be "
+					"sent");
+	sms->submit_latency = __ofono_metric_histogram(
+					"ofono_sms_submit_latency_ms", labels,
+					"Time taken to submit a PDU",
+					latency_bounds,
+					G_N_ELEMENTS(latency_bounds));
+
+	g_free(labels);
+}
+
+static void sms_metrics_unregister(struct ofono_sms *sms)
+{
+	__ofono_metric_unref(sms->submitted);
+	sms->submitted = NULL;
+
+	__ofono_metric_unref(sms->failed);
+	sms->failed = NULL;
+
+	__ofono_metric_unref(sms->retried);
+	sms->retried = NULL;
+
+	__ofono_metric_unref(sms->queue_depth);
+	sms->queue_depth = NULL;
+
+	__ofono_metric_unref(sms->submit_latency);
+	sms->submit_latency = NULL;
+}
+
 static void sms_unregister(struct ofono_atom *atom)
 {
 	struct ofono_sms *sms = __ofono_atom_get_data(atom);
@@ -1715,6 +1833,8 @@ static void sms_unregister(struct ofono_atom *atom)
 
 	__ofono_watchlist_free(sms->datagram_handlers);
 	sms->datagram_handlers = NULL;
+
+	sms_metrics_unregister(sms);
 }
 
 static void sms_remove(struct ofono_atom *atom)
@@ -1942,6 +2062,8 @@ static void sms_restore_tx_queue(struct ofono_sms *sms)
 
 		txq_entry->id = sms->tx_counter++;
 		g_queue_push_tail(sms->txq, txq_entry);
+		__ofono_metric_set(sms->queue_depth,
+					g_queue_get_length(sms->txq));
 
 loop_out:
 		g_slist_free_full(backup_entry->msg_list, g_free);
@@ -2014,6 +2136,7 @@ void ofono_sms_register(struct ofono_sms *sms)
 		sms->driver->bearer_set(sms, sms->bearer,
 						bearer_init_callback, sms);
 
+	sms_metrics_register(sms, modem);
 	sms_restore_tx_queue(sms);
 
 	sms->text_handlers = __ofono_watchlist_new(g_free);
@@ -2077,6 +2200,7 @@ int __ofono_sms_txq_submit(struct ofono_sms *sms, GSList *list,
 	entry->id = sms->tx_counter++;
 
 	g_queue_push_tail(sms->txq, entry);
+	__ofono_metric_set(sms->queue_depth, g_queue_get_length(sms->txq));
 
 	if (sms->registered && g_queue_get_length(sms->txq) == 1)
 		sms->tx_source = g_timeout_add(0, tx_next, sms);
@@ -2280,10 +2280,10 @@ char *sms_decode_text(GSList *sms_list)
 			 * If language is not defined in 3GPP TS 23.038,
 			 * implementations are instructed to ignore it
 			 */
-			if (locking_shift > SMS_ALPHABET_PORTUGUESE)
+			if (locking_shift > SMS_ALPHABET_URDU)
 				locking_shift = GSM_DIALECT_DEFAULT;
 
-			if (single_shift > SMS_ALPHABET_PORTUGUESE)
+			if (single_shift > SMS_ALPHABET_URDU)
 				single_shift = GSM_DIALECT_DEFAULT;
 
 			converted = convert_gsm_to_utf8_with_lang(buf, written,
@@ -3545,6 +3545,111 @@ GSList *sms_datagram_prepare(const char *to,
 	return r;
 }
 
+/*
+ * Size of the user data header of a text message, given the number of
+ * national language information elements and whether it is concatenated.
+ */
+static int sms_text_header_gsm(int lang_ies, gboolean concat,
+					gboolean use_16bit)
+{
+	int offset = lang_ies ? 1 + lang_ies * 3 : 0;
+
+	if (!concat)
+		return offset;
+
+	if (!offset)
+		offset = 1;
+
+	return offset + (use_16bit ? 6 : 5);
+}
+
+static unsigned char *sms_text_encode_gsm(const char *utf8,
+					enum sms_alphabet alphabet,
+					gboolean use_16bit, long *written,
+					enum gsm_dialect *used_locking,
+					enum gsm_dialect *used_single)
+{
+	enum gsm_dialect locking[4];
+	enum gsm_dialect single[4];
+	int lang_ies[4];
+	long chunk_size[4];
+	long lengths[4];
+	long chunks[4];
+	unsigned int n = 0;
+	unsigned int i;
+	int best = -1;
+	long best_segments = 0;
+
+	locking[n] = GSM_DIALECT_DEFAULT;
+	single[n++] = GSM_DIALECT_DEFAULT;
+
+	if (alphabet != SMS_ALPHABET_DEFAULT) {
+		locking[n] = GSM_DIALECT_DEFAULT;
+		single[n++] = (enum gsm_dialect) alphabet;
+	}
+
+	/* Spanish dialect uses the default locking shift table */
+	if (alphabet != SMS_ALPHABET_DEFAULT &&
+			alphabet != SMS_ALPHABET_SPANISH) {
+		locking[n] = (enum gsm_dialect) alphabet;
+		single[n++] = GSM_DIALECT_DEFAULT;
+
+		locking[n] = (enum gsm_dialect) alphabet;
+		single[n++] = (enum gsm_dialect) alphabet;
+	}
+
+	/*
+	 * Segments are counted the way sms_text_prepare splits the text,
+	 * an escape sequence is never split across two segments
+	 */
+	for (i = 0; i < n; i++) {
+		int offset;
+
+		lang_ies[i] = 0;
+
+		if (locking[i] != GSM_DIALECT_DEFAULT)
+			lang_ies[i] += 1;
+
+		if (single[i] != GSM_DIALECT_DEFAULT)
+			lang_ies[i] += 1;
+
+		offset = sms_text_header_gsm(lang_ies[i], TRUE, use_16bit);
+		chunk_size[i] = sms_text_capacity_gsm(160, offset);
+	}
+
+	convert_utf8_to_gsm_lengths(utf8, -1, locking, single, n, lengths,
+					chunk_size, chunks);
+
+	for (i = 0; i < n; i++) {
+		int offset;
+		long segments;
+
+		if (lengths[i] < 0)
+			continue;
+
+		offset = sms_text_header_gsm(lang_ies[i], FALSE, use_16bit);
+
+		if (lengths[i] <= sms_text_capacity_gsm(160, offset))
+			segments = 1;
+		else
+			segments = chunks[i];
+
+		if (best < 0 || segments < best_segments) {
+			best = i;
+			best_segments = segments;
+		}
+	}
+
+	if (best < 0)
+		return NULL;
+
+	*used_locking = locking[best];
+	*used_single = single[best];
+
+	return convert_utf8_to_gsm_with_lang(utf8, -1, NULL, written, 0,
+						locking[best], single[best]);
+}
+
 /*
  * Prepares the text for transmission.  Breaks up into fragments if
  * necessary using ref as the concatenated message reference number.
@@ -3583,9 +3688,8 @@ GSList *sms_text_prepare_with_alphabet(const char *to, const char *utf8,
 	 * UDHI, UDL, UD and DCS actually depend on the contents of
 	 * the text, and also on the GSM dialect we use to encode it.
 	 */
-	gsm_encoded = convert_utf8_to_gsm_best_lang(utf8, -1, NULL, &written, 0,
-							alphabet, &used_locking,
-							&used_single);
+	gsm_encoded = sms_text_encode_gsm(utf8, alphabet, use_16bit, &written,
+						&used_locking, &used_single);
 	if (gsm_encoded == NULL) {
 		gsize converted;
 
@@ -4222,102 +4326,67 @@ static inline gboolean cbs_is_update_newer(unsigned int n, unsigned int o)
 	return FALSE;
 }
 
-struct cbs_assembly *cbs_assembly_new(void)
+static void cbs_assembly_node_free(gpointer data)
 {
-	return g_new0(struct cbs_assembly, 1);
-}
+	struct cbs_assembly_node *node = data;
 
-void cbs_assembly_free(struct cbs_assembly *assembly)
-{
-	GSList *l;
-
-	for (l = assembly->assembly_list; l; l = l->next) {
-		struct cbs_assembly_node *node = l->data;
-
-		g_slist_free_full(node->pages, g_free);
-		g_free(node);
-	}
-
-	g_slist_free(assembly->assembly_list);
-	g_slist_free(assembly->recv_plmn);
-	g_slist_free(assembly->recv_loc);
-	g_slist_free(assembly->recv_cell);
-
-	g_free(assembly);
-}
-
-static gint cbs_compare_node_by_gs(gconstpointer a, gconstpointer b)
-{
-	const struct cbs_assembly_node *node = a;
-	unsigned int gs = GPOINTER_TO_UINT(b);
-
-	if (((node->serial >> 14) & 0x3) == gs)
-		return 0;
-
-	return 1;
+	g_slist_free_full(node->pages, g_free);
+	g_free(node);
 }
 
-static gint cbs_compare_node_by_update(gconstpointer a, gconstpointer b)
+struct cbs_assembly *cbs_assembly_new(void)
 {
-	const struct cbs_assembly_node *node = a;
-	unsigned int serial = GPOINTER_TO_UINT(b);
-
-	if ((serial & (~0xf)) != (node->serial & (~0xf)))
-		return 1;
-
-	if (cbs_is_update_newer(node->serial, serial))
-		return 1;
-
-	return 0;
+	struct cbs_assembly *assembly = g_new0(struct cbs_assembly, 1);
+
+	assembly->assembly_plmn = g_hash_table_new_full(g_direct_hash,
+					g_direct_equal, NULL,
+					cbs_assembly_node_free);
+	assembly->assembly_loc = g_hash_table_new_full(g_direct_hash,
+					g_direct_equal, NULL,
+					cbs_assembly_node_free);
+	assembly->assembly_cell = g_hash_table_new_full(g_direct_hash,
+					g_direct_equal, NULL,
+					cbs_assembly_node_free);
+
+	assembly->recv_plmn = g_hash_table_new(g_direct_hash, g_direct_equal);
+	assembly->recv_loc = g_hash_table_new(g_direct_hash, g_direct_equal);
+	assembly->recv_cell = g_hash_table_new(g_direct_hash, g_direct_equal);
+
+	return assembly;
 }
 
-static gint cbs_compare_recv_by_serial(gconstpointer a, gconstpointer b)
+void cbs_assembly_free(struct cbs_assembly *assembly)
 {
-	unsigned int old_serial = GPOINTER_TO_UINT(a);
-	unsigned int new_serial = GPOINTER_TO_UINT(b);
+	g_hash_table_destroy(assembly->assembly_plmn);
+	g_hash_table_destroy(assembly->assembly_loc);
+	g_hash_table_destroy(assembly->assembly_cell);
+	g_hash_table_destroy(assembly->recv_plmn);
+	g_hash_table_destroy(assembly->recv_loc);
+	g_hash_table_destroy(assembly->recv_cell);
 
-	if ((old_serial & (~0xf)) == (new_serial & (~0xf)))
-		return 0;
-
-	return 1;
+	g_free(assembly);
 }
 
-static void cbs_assembly_expire(struct cbs_assembly *assembly,
-				GCompareFunc func, gconstpointer *userdata)
+/*
+ * Take care of the case where several updates are being reassembled at the
+ * same time. If the newer one is assembled first, then the subsequent old
+ * update is discarded, make sure that we're also discarding the assembly
+ * node for the partially assembled ones.  Only the update number differs,
+ * so there are at most 16 candidates to look up.
+ */
+static void cbs_assembly_expire_updates(GHashTable *nodes,
+					unsigned int serial)
 {
-	GSList *l;
-	GSList *prev;
-	GSList *tmp;
+	unsigned int update;
+	unsigned int old_serial;
 
-	/*
-	 * Take care of the case where several updates are being
-	 * reassembled at the same time. If the newer one is assembled
-	 * first, then the subsequent old update is discarded, make
-	 * sure that we're also discarding the assembly node for the
-	 * partially assembled ones
-	 */
-	prev = NULL;
-	l = assembly->assembly_list;
-
-	while (l) {
-		struct cbs_assembly_node *node = l->data;
+	for (update = 0; update < 16; update++) {
+		old_serial = (serial & (~0xf)) | update;
 
-		if (func(node, userdata) != 0) {
-			prev = l;
-			l = l->next;
+		if (cbs_is_update_newer(old_serial, serial))
 			continue;
-		}
 
-		if (prev)
-			prev->next = l->next;
-		else
-			assembly->assembly_list = l->next;
-
-		g_slist_free_full(node->pages, g_free);
-		g_free(node->pages);
-		tmp = l;
-		l = l->next;
-		g_slist_free_1(tmp);
+		g_hash_table_remove(nodes, GUINT_TO_POINTER(old_serial));
 	}
 }
 
@@ -4341,30 +4410,20 @@ void cbs_assembly_location_changed(struct cbs_assembly *assembly, gboolean plmn,
 
 	if (plmn) {
 		lac = TRUE;
-		g_slist_free(assembly->recv_plmn);
-		assembly->recv_plmn = NULL;
-
-		cbs_assembly_expire(assembly, cbs_compare_node_by_gs,
-				GUINT_TO_POINTER(CBS_GEO_SCOPE_PLMN));
+		g_hash_table_remove_all(assembly->recv_plmn);
+		g_hash_table_remove_all(assembly->assembly_plmn);
 	}
 
 	if (lac) {
 		/* If LAC changed, then cell id has changed */
 		ci = TRUE;
-		g_slist_free(assembly->recv_loc);
-		assembly->recv_loc = NULL;
-
-		cbs_assembly_expire(assembly, cbs_compare_node_by_gs,
-				GUINT_TO_POINTER(CBS_GEO_SCOPE_SERVICE_AREA));
+		g_hash_table_remove_all(assembly->recv_loc);
+		g_hash_table_remove_all(assembly->assembly_loc);
 	}
 
 	if (ci) {
-		g_slist_free(assembly->recv_cell);
-		assembly->recv_cell = NULL;
-		cbs_assembly_expire(assembly, cbs_compare_node_by_gs,
-				GUINT_TO_POINTER(CBS_GEO_SCOPE_CELL_IMMEDIATE));
-		cbs_assembly_expire(assembly, cbs_compare_node_by_gs,
-				GUINT_TO_POINTER(CBS_GEO_SCOPE_CELL_NORMAL));
+		g_hash_table_remove_all(assembly->recv_cell);
+		g_hash_table_remove_all(assembly->assembly_cell);
 	}
 }
 
@@ -4375,38 +4434,41 @@ GSList *cbs_assembly_add_page(struct cbs_assembly *assembly,
 	struct cbs_assembly_node *node;
 	GSList *completed;
 	unsigned int new_serial;
-	GSList **recv;
-	GSList *l;
-	GSList *prev;
+	GHashTable *nodes;
+	GHashTable *recv;
+	gpointer key;
+	gpointer old_serial;
 	int position;
+	int j;
 
 	new_serial = cbs->gs << 14;
 	new_serial |= cbs->message_code << 4;
 	new_serial |= cbs->update_number;
 	new_serial |= cbs->message_identifier << 16;
 
-	if (cbs->gs == CBS_GEO_SCOPE_PLMN)
-		recv = &assembly->recv_plmn;
-	else if (cbs->gs == CBS_GEO_SCOPE_SERVICE_AREA)
-		recv = &assembly->recv_loc;
-	else
-		recv = &assembly->recv_cell;
+	if (cbs->gs == CBS_GEO_SCOPE_PLMN) {
+		nodes = assembly->assembly_plmn;
+		recv = assembly->recv_plmn;
+	} else if (cbs->gs == CBS_GEO_SCOPE_SERVICE_AREA) {
+		nodes = assembly->assembly_loc;
+		recv = assembly->recv_loc;
+	} else {
+		nodes = assembly->assembly_cell;
+		recv = assembly->recv_cell;
+	}
 
-	/* Have we seen this message before? */
-	l = g_slist_find_custom(*recv, GUINT_TO_POINTER(new_serial),
-				cbs_compare_recv_by_serial);
+	/* Received messages are indexed without their update number */
+	key = GUINT_TO_POINTER(new_serial & (~0xf));
 
-	/* If we have, is the message newer? */
-	if (l && !cbs_is_update_newer(new_serial, GPOINTER_TO_UINT(l->data)))
+	/* Have we seen this message before?  If we have, is it newer? */
+	if (g_hash_table_lookup_extended(recv, key, NULL, &old_serial) &&
+			!cbs_is_update_newer(new_serial,
+						GPOINTER_TO_UINT(old_serial)))
 		return NULL;
 
 	/* Easy case first, page 1 of 1 */
 	if (cbs->max_pages == 1 && cbs->page == 1) {
-		if (l)
-			l->data = GUINT_TO_POINTER(new_serial);
-		else
-			*recv = g_slist_prepend(*recv,
-						GUINT_TO_POINTER(new_serial));
+		g_hash_table_insert(recv, key, GUINT_TO_POINTER(new_serial));
 
 		newcbs = g_new(struct cbs, 1);
 		memcpy(newcbs, cbs, sizeof(struct cbs));
@@ -4415,37 +4477,22 @@ GSList *cbs_assembly_add_page(struct cbs_assembly *assembly,
 		return completed;
 	}
 
-	prev = NULL;
-	position = 0;
-
-	for (l = assembly->assembly_list; l; prev = l, l = l->next) {
-		int j;
-		node = l->data;
-
-		if (new_serial != node->serial)
-			continue;
-
-		if (node->bitmap & (1 << cbs->page))
-			return NULL;
-
-		for (j = 1; j < cbs->page; j++)
-			if (node->bitmap & (1 << j))
-				position += 1;
-
-		goto out;
-	}
+	node = g_hash_table_lookup(nodes, GUINT_TO_POINTER(new_serial));
 
-	node = g_new0(struct cbs_assembly_node, 1);
-	node->serial = new_serial;
+	if (node == NULL) {
+		node = g_new0(struct cbs_assembly_node, 1);
+		node->serial = new_serial;
 
-	assembly->assembly_list = g_slist_prepend(assembly->assembly_list,
-							node);
+		g_hash_table_insert(nodes, GUINT_TO_POINTER(new_serial), node);
+	} else if (node->bitmap & (1 << cbs->page))
+		return NULL;
 
-	prev = NULL;
-	l = assembly->assembly_list;
 	position = 0;
 
-out:
+	for (j = 1; j < cbs->page; j++)
+		if (node->bitmap & (1 << j))
+			position += 1;
+
 	newcbs = g_new(struct cbs, 1);
 	memcpy(newcbs, cbs, sizeof(struct cbs));
 	node->pages = g_slist_insert(node->pages, newcbs, position);
@@ -4456,17 +4503,11 @@ out:
 
 	completed = node->pages;
 
-	if (prev)
-		prev->next = l->next;
-	else
-		assembly->assembly_list = l->next;
-
+	g_hash_table_steal(nodes, GUINT_TO_POINTER(new_serial));
 	g_free(node);
-	g_slist_free_1(l);
 
-	cbs_assembly_expire(assembly, cbs_compare_node_by_update,
-				GUINT_TO_POINTER(new_serial));
-	*recv = g_slist_prepend(*recv, GUINT_TO_POINTER(new_serial));
+	cbs_assembly_expire_updates(nodes, new_serial);
+	g_hash_table_insert(recv, key, GUINT_TO_POINTER(new_serial));
 
 	return completed;
 }
@@ -4711,6 +4752,98 @@ gboolean cbs_topic_in_range(unsigned int topic, GSList *ranges)
 					cbs_topic_compare) != NULL;
 }
 
+void cbs_topic_map_clear(struct cbs_topic_map *map)
+{
+	memset(map->bits, 0, sizeof(map->bits));
+}
+
+void cbs_topic_map_add_range(struct cbs_topic_map *map,
+				unsigned short min, unsigned short max)
+{
+	unsigned int first = min >> 5;
+	unsigned int last = max >> 5;
+	guint32 head = 0xffffffffU << (min & 31);
+	guint32 tail = 0xffffffffU >> (31 - (max & 31));
+	unsigned int i;
+
+	if (max < min)
+		return;
+
+	if (first == last) {
+		map->bits[first] |= head & tail;
+		return;
+	}
+
+	map->bits[first] |= head;
+
+	for (i = first + 1; i < last; i++)
+		map->bits[i] = 0xffffffffU;
+
+	map->bits[last] |= tail;
+}
+
+void cbs_topic_map_add_ranges(struct cbs_topic_map *map, GSList *ranges)
+{
+	struct cbs_topic_range *range;
+	GSList *l;
+
+	for (l = ranges; l; l = l->next) {
+		range = l->data;
+		cbs_topic_map_add_range(map, range->min, range->max);
+	}
+}
+
+static void topic_range_append(GString *str, unsigned int min,
+				unsigned int max)
+{
+	if (str->len > 0)
+		g_string_append_c(str, ',');
+
+	if (min != max)
+		g_string_append_printf(str, "%u-%u", min, max);
+	else
+		g_string_append_printf(str, "%u", min);
+}
+
+/*
+ * Produces the same sorted, merged format as cbs_topic_ranges_to_string,
+ * skipping empty words instead of testing every identifier
+ */
+char *cbs_topic_map_to_string(const struct cbs_topic_map *map)
+{
+	GString *str = g_string_sized_new(32);
+	unsigned int i;
+	unsigned int topic;
+	int min = -1;
+
+	for (i = 0; i < G_N_ELEMENTS(map->bits); i++) {
+		guint32 word = map->bits[i];
+
+		if ((word == 0 && min < 0) || (word == 0xffffffffU && min >= 0))
+			continue;
+
+		for (topic = i << 5; topic < (i + 1) << 5; topic++) {
+			gboolean set = (word >> (topic & 31)) & 1;
+
+			if (set && min < 0) {
+				min = topic;
+				continue;
+			}
+
+			if (set || min < 0)
+				continue;
+
+			topic_range_append(str, min, topic - 1);
+			min = -1;
+		}
+	}
+
+	if (min >= 0)
+		topic_range_append(str, min, 65535);
+
+	return g_string_free(str, FALSE);
+}
+
 char *ussd_decode(int dcs, int len, const unsigned char *data)
 {
 	gboolean udhi;
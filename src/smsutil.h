@@ -159,6 +159,16 @@ enum sms_alphabet {
 	SMS_ALPHABET_TURKISH,
 	SMS_ALPHABET_SPANISH,
 	SMS_ALPHABET_PORTUGUESE,
+	SMS_ALPHABET_BENGALI,
+	SMS_ALPHABET_GUJARATI,
+	SMS_ALPHABET_HINDI,
+	SMS_ALPHABET_KANNADA,
+	SMS_ALPHABET_MALAYALAM,
+	SMS_ALPHABET_ORIYA,
+	SMS_ALPHABET_PUNJABI,
+	SMS_ALPHABET_TAMIL,
+	SMS_ALPHABET_TELUGU,
+	SMS_ALPHABET_URDU,
 };
 
 enum sms_mwi_type {
@@ -407,11 +417,18 @@ struct cbs_assembly_node {
 	GSList *pages;
 };
 
+/*
+ * Pages being assembled are indexed by serial, received messages by serial
+ * without the update number.  Each geographical scope has its own tables so
+ * that a location change simply empties them.
+ */
 struct cbs_assembly {
-	GSList *assembly_list;
-	GSList *recv_plmn;
-	GSList *recv_loc;
-	GSList *recv_cell;
+	GHashTable *assembly_plmn;
+	GHashTable *assembly_loc;
+	GHashTable *assembly_cell;
+	GHashTable *recv_plmn;
+	GHashTable *recv_loc;
+	GHashTable *recv_cell;
 };
 
 struct cbs_topic_range {
@@ -419,6 +436,11 @@ struct cbs_topic_range {
 	unsigned short max;
 };
 
+/* One bit for each of the 65536 possible message identifiers */
+struct cbs_topic_map {
+	guint32 bits[65536 / 32];
+};
+
 struct txq_backup_entry {
 	GSList *msg_list;
 	unsigned char uuid[SMS_MSGID_LEN];
@@ -585,5 +607,17 @@ GSList *cbs_extract_topic_ranges(const char *ranges);
 GSList *cbs_optimize_ranges(GSList *ranges);
 gboolean cbs_topic_in_range(unsigned int topic, GSList *ranges);
 
+void cbs_topic_map_clear(struct cbs_topic_map *map);
+void cbs_topic_map_add_range(struct cbs_topic_map *map,
+				unsigned short min, unsigned short max);
+void cbs_topic_map_add_ranges(struct cbs_topic_map *map, GSList *ranges);
+char *cbs_topic_map_to_string(const struct cbs_topic_map *map);
+
+static inline gboolean cbs_topic_map_contains(const struct cbs_topic_map *map,
+						unsigned short topic)
+{
+	return (map->bits[topic >> 5] >> (topic & 31)) & 1;
+}
+
 char *ussd_decode(int dcs, int len, const unsigned char *data);
 gboolean ussd_encode(const char *str, long *items_written, unsigned char *pdu);
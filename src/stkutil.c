@@ -57,7 +57,8 @@ struct stk_tlv_builder {
 	unsigned int max_len;
 };
 
-typedef gboolean (*dataobj_handler)(struct comprehension_tlv_iter *, void *);
+typedef gboolean (*dataobj_handler)(struct comprehension_tlv_iter *,
+					struct stk_arena_block **, void *);
 typedef gboolean (*dataobj_writer)(struct stk_tlv_builder *,
 					const void *, gboolean);
 
@@ -74,6 +75,101 @@ struct gsm_sms_tpdu {
 	unsigned char tpdu[184];
 };
 
+/*
+ * Everything a decoded command points to, texts, byte arrays, items and
+ * file lists, comes from blocks chained off command->arena which are all
+ * released by stk_command_free.  The arena is handed to every data object
+ * handler, so decoding keeps no state outside of the command.
+ */
+#define STK_ARENA_BLOCK_SIZE 512
+#define STK_ARENA_ALIGN(size) (((size) + 7) & ~((gsize) 7))
+
+struct stk_arena_block {
+	struct stk_arena_block *next;
+	gsize used;
+	gsize size;
+};
+
+static void *arena_alloc(struct stk_arena_block **arena, gsize size)
+{
+	struct stk_arena_block *head = *arena;
+	struct stk_arena_block *block;
+	gsize block_size;
+	unsigned char *ptr;
+
+	size = STK_ARENA_ALIGN(size);
+
+	if (head != NULL && head->size - head->used >= size) {
+		ptr = (unsigned char *) (head + 1) + head->used;
+		head->used += size;
+
+		return ptr;
+	}
+
+	block_size = MAX(size, STK_ARENA_BLOCK_SIZE);
+
+	block = g_malloc(sizeof(struct stk_arena_block) + block_size);
+	block->used = size;
+	block->size = block_size;
+
+	/* Large objects fill a block of their own, keep using the current */
+	if (head != NULL && size >= STK_ARENA_BLOCK_SIZE) {
+		block->next = head->next;
+		head->next = block;
+	} else {
+		block->next = head;
+		*arena = block;
+	}
+
+	return block + 1;
+}
+
+static void *arena_alloc0(struct stk_arena_block **arena, gsize size)
+{
+	return memset(arena_alloc(arena, size), 0, size);
+}
+
+static void *arena_memdup(struct stk_arena_block **arena,
+				const void *mem, gsize size)
+{
+	return memcpy(arena_alloc(arena, size), mem, size);
+}
+
+/* Moves a string returned by the text conversion helpers into the arena */
+static char *arena_take_string(struct stk_arena_block **arena, char *str)
+{
+	char *ret;
+
+	if (str == NULL)
+		return NULL;
+
+	ret = arena_memdup(arena, str, strlen(str) + 1);
+	g_free(str);
+
+	return ret;
+}
+
+static GSList *arena_slist_prepend(struct stk_arena_block **arena,
+					GSList *list, gpointer data)
+{
+	GSList *l = arena_alloc(arena, sizeof(GSList));
+
+	l->data = data;
+	l->next = list;
+
+	return l;
+}
+
+static void arena_free(struct stk_arena_block *block)
+{
+	struct stk_arena_block *next;
+
+	for (; block; block = next) {
+		next = block->next;
+		g_free(block);
+	}
+}
+
 #define CHECK_TEXT_AND_ICON(text, icon_id)			\
 	if (status != STK_PARSE_RESULT_OK)			\
 		return status;					\
@@ -149,6 +245,7 @@ static gboolean parse_dataobj_common_byte(struct comprehension_tlv_iter *iter,
 
 /* For data object that only has text terminated by '\0' */
 static gboolean parse_dataobj_common_text(struct comprehension_tlv_iter *iter,
+						struct stk_arena_block **arena,
 						char **text)
 {
 	const unsigned char *data;
@@ -159,7 +256,7 @@ static gboolean parse_dataobj_common_text(struct comprehension_tlv_iter *iter,
 
 	data = comprehension_tlv_iter_get_data(iter);
 
-	*text = g_try_malloc(len + 1);
+	*text = arena_alloc(arena, len + 1);
 	if (*text == NULL)
 		return FALSE;
 
@@ -172,6 +269,7 @@ static gboolean parse_dataobj_common_text(struct comprehension_tlv_iter *iter,
 /* For data object that only has a byte array with undetermined length */
 static gboolean parse_dataobj_common_byte_array(
 			struct comprehension_tlv_iter *iter,
+			struct stk_arena_block **arena,
 			struct stk_common_byte_array *array)
 {
 	const unsigned char *data;
@@ -183,7 +281,7 @@ static gboolean parse_dataobj_common_byte_array(
 	data = comprehension_tlv_iter_get_data(iter);
 	array->len = len;
 
-	array->array = g_try_malloc(len);
+	array->array = arena_alloc(arena, len);
 	if (array->array == NULL)
 		return FALSE;
 
@@ -274,6 +372,7 @@ static gboolean stk_file_iter_next(struct stk_file_iter *iter)
 
 /* Defined in TS 102.223 Section 8.1 */
 static gboolean parse_dataobj_address(struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *user)
 {
 	struct stk_address *addr = user;
@@ -287,7 +386,7 @@ static gboolean parse_dataobj_address(struct comprehension_tlv_iter *iter,
 
 	data = comprehension_tlv_iter_get_data(iter);
 
-	number = g_try_malloc(len * 2 - 1);
+	number = arena_alloc(arena, len * 2 - 1);
 	if (number == NULL)
 		return FALSE;
 
@@ -300,6 +399,7 @@ static gboolean parse_dataobj_address(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.2 */
 static gboolean parse_dataobj_alpha_id(struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *user)
 {
 	char **alpha_id = user;
@@ -314,7 +414,7 @@ static gboolean parse_dataobj_alpha_id(struct comprehension_tlv_iter *iter,
 	}
 
 	data = comprehension_tlv_iter_get_data(iter);
-	utf8 = sim_string_to_utf8(data, len);
+	utf8 = arena_take_string(arena, sim_string_to_utf8(data, len));
 
 	if (utf8 == NULL)
 		return FALSE;
@@ -326,6 +426,7 @@ static gboolean parse_dataobj_alpha_id(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.3 */
 static gboolean parse_dataobj_subaddress(struct comprehension_tlv_iter *iter,
+						struct stk_arena_block **arena,
 						void *user)
 {
 	struct stk_subaddress *subaddr = user;
@@ -350,6 +451,7 @@ static gboolean parse_dataobj_subaddress(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.4 */
 static gboolean parse_dataobj_ccp(struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *user)
 {
 	struct stk_ccp *ccp = user;
@@ -372,6 +474,7 @@ static gboolean parse_dataobj_ccp(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 31.111 Section 8.5 */
 static gboolean parse_dataobj_cbs_page(struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *user)
 {
 	struct stk_cbs_page *cp = user;
@@ -394,6 +497,7 @@ static gboolean parse_dataobj_cbs_page(struct comprehension_tlv_iter *iter,
 
 /* Described in TS 102.223 Section 8.8 */
 static gboolean parse_dataobj_duration(struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *user)
 {
 	struct stk_duration *duration = user;
@@ -418,6 +522,7 @@ static gboolean parse_dataobj_duration(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.9 */
 static gboolean parse_dataobj_item(struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *user)
 {
 	struct stk_item *item = user;
@@ -439,7 +544,7 @@ static gboolean parse_dataobj_item(struct comprehension_tlv_iter *iter,
 	if (data[0] == 0)
 		return FALSE;
 
-	utf8 = sim_string_to_utf8(data + 1, len - 1);
+	utf8 = arena_take_string(arena, sim_string_to_utf8(data + 1, len - 1));
 
 	if (utf8 == NULL)
 		return FALSE;
@@ -452,6 +557,7 @@ static gboolean parse_dataobj_item(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.10 */
 static gboolean parse_dataobj_item_id(struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *user)
 {
 	unsigned char *id = user;
@@ -468,6 +574,7 @@ static gboolean parse_dataobj_item_id(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.11 */
 static gboolean parse_dataobj_response_len(struct comprehension_tlv_iter *iter,
+						struct stk_arena_block **arena,
 						void *user)
 {
 	struct stk_response_length *response_len = user;
@@ -486,6 +593,7 @@ static gboolean parse_dataobj_response_len(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.12 */
 static gboolean parse_dataobj_result(struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *user)
 {
 	struct stk_result *result = user;
@@ -505,7 +613,7 @@ static gboolean parse_dataobj_result(struct comprehension_tlv_iter *iter,
 				(data[0] == 0x3c) || (data[0] == 0x3d)))
 		return FALSE;
 
-	additional = g_try_malloc(len - 1);
+	additional = arena_alloc(arena, len - 1);
 	if (additional == NULL)
 		return FALSE;
 
@@ -519,6 +627,7 @@ static gboolean parse_dataobj_result(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.13 */
 static gboolean parse_dataobj_gsm_sms_tpdu(struct comprehension_tlv_iter *iter,
+						struct stk_arena_block **arena,
 						void *user)
 {
 	struct gsm_sms_tpdu *tpdu = user;
@@ -539,6 +648,7 @@ static gboolean parse_dataobj_gsm_sms_tpdu(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.14 */
 static gboolean parse_dataobj_ss(struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *user)
 {
 	struct stk_ss *ss = user;
@@ -552,7 +662,7 @@ static gboolean parse_dataobj_ss(struct comprehension_tlv_iter *iter,
 
 	data = comprehension_tlv_iter_get_data(iter);
 
-	s = g_try_malloc(len * 2 - 1);
+	s = arena_alloc(arena, len * 2 - 1);
 	if (s == NULL)
 		return FALSE;
 
@@ -565,6 +675,7 @@ static gboolean parse_dataobj_ss(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.15 */
 static gboolean parse_dataobj_text(struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *user)
 {
 	char **text = user;
@@ -573,13 +684,14 @@ static gboolean parse_dataobj_text(struct comprehension_tlv_iter *iter,
 	char *utf8;
 
 	if (len <= 1) {
-		*text = g_try_malloc0(1);
+		*text = arena_alloc0(arena, 1);
 		return TRUE;
 	}
 
 	data = comprehension_tlv_iter_get_data(iter);
 
-	utf8 = decode_text(data[0], len - 1, data + 1);
+	utf8 = arena_take_string(arena,
+				decode_text(data[0], len - 1, data + 1));
 
 	if (utf8 == NULL)
 		return FALSE;
@@ -590,6 +702,7 @@ static gboolean parse_dataobj_text(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.16 */
 static gboolean parse_dataobj_tone(struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *user)
 {
 	unsigned char *byte = user;
@@ -598,6 +711,7 @@ static gboolean parse_dataobj_tone(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.17 */
 static gboolean parse_dataobj_ussd(struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *user)
 {
 	struct stk_ussd_string *us = user;
@@ -616,6 +730,7 @@ static gboolean parse_dataobj_ussd(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.18 */
 static gboolean parse_dataobj_file_list(struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *user)
 {
 	GSList **fl = user;
@@ -633,13 +748,13 @@ static gboolean parse_dataobj_file_list(struct comprehension_tlv_iter *iter,
 	stk_file_iter_init(&sf_iter, data + 1, len - 1);
 
 	while (stk_file_iter_next(&sf_iter)) {
-		sf = g_try_new0(struct stk_file, 1);
+		sf = arena_alloc0(arena, sizeof(struct stk_file));
 		if (sf == NULL)
 			goto error;
 
 		sf->len = sf_iter.len;
 		memcpy(sf->file, sf_iter.file, sf_iter.len);
-		*fl = g_slist_prepend(*fl, sf);
+		*fl = arena_slist_prepend(arena, *fl, sf);
 	}
 
 	if (sf_iter.pos != sf_iter.max)
@@ -649,12 +764,13 @@ static gboolean parse_dataobj_file_list(struct comprehension_tlv_iter *iter,
 	return TRUE;
 
 error:
-	g_slist_free_full(*fl, g_free);
+	*fl = NULL;
 	return FALSE;
 }
 
 /* Defined in TS 102.223 Section 8.19 */
 static gboolean parse_dataobj_location_info(struct comprehension_tlv_iter *iter,
+						struct stk_arena_block **arena,
 						void *user)
 {
 	struct stk_location_info *li = user;
@@ -698,6 +814,7 @@ static gboolean parse_dataobj_location_info(struct comprehension_tlv_iter *iter,
  * "1A 32 54 76 98 10 32 54".
  */
 static gboolean parse_dataobj_imei(struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *user)
 {
 	char *imei = user;
@@ -723,6 +840,7 @@ static gboolean parse_dataobj_imei(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.21 */
 static gboolean parse_dataobj_help_request(struct comprehension_tlv_iter *iter,
+						struct stk_arena_block **arena,
 						void *user)
 {
 	gboolean *ret = user;
@@ -731,7 +849,8 @@ static gboolean parse_dataobj_help_request(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.22 */
 static gboolean parse_dataobj_network_measurement_results(
-		struct comprehension_tlv_iter *iter, void *user)
+		struct comprehension_tlv_iter *iter,
+		struct stk_arena_block **arena, void *user)
 {
 	unsigned char *nmr = user;
 	const unsigned char *data;
@@ -751,6 +870,7 @@ static gboolean parse_dataobj_network_measurement_results(
 
 /* Defined in TS 102.223 Section 8.23 */
 static gboolean parse_dataobj_default_text(struct comprehension_tlv_iter *iter,
+						struct stk_arena_block **arena,
 						void *user)
 {
 	char **text = user;
@@ -762,7 +882,8 @@ static gboolean parse_dataobj_default_text(struct comprehension_tlv_iter *iter,
 	if (len <= 1)
 		return FALSE;
 
-	utf8 = decode_text(data[0], len - 1, data + 1);
+	utf8 = arena_take_string(arena,
+				decode_text(data[0], len - 1, data + 1));
 
 	if (utf8 == NULL)
 		return FALSE;
@@ -773,7 +894,8 @@ static gboolean parse_dataobj_default_text(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.24 */
 static gboolean parse_dataobj_items_next_action_indicator(
-		struct comprehension_tlv_iter *iter, void *user)
+		struct comprehension_tlv_iter *iter,
+		struct stk_arena_block **arena, void *user)
 {
 	struct stk_items_next_action_indicator *inai = user;
 	const unsigned char *data;
@@ -791,6 +913,7 @@ static gboolean parse_dataobj_items_next_action_indicator(
 
 /* Defined in TS 102.223 Section 8.25 */
 static gboolean parse_dataobj_event_list(struct comprehension_tlv_iter *iter,
+						struct stk_arena_block **arena,
 						void *user)
 {
 	struct stk_event_list *el = user;
@@ -812,6 +935,7 @@ static gboolean parse_dataobj_event_list(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.26 */
 static gboolean parse_dataobj_cause(struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *user)
 {
 	struct stk_cause *cause = user;
@@ -835,7 +959,8 @@ static gboolean parse_dataobj_cause(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.27 */
 static gboolean parse_dataobj_location_status(
-		struct comprehension_tlv_iter *iter, void *user)
+		struct comprehension_tlv_iter *iter,
+		struct stk_arena_block **arena, void *user)
 {
 	unsigned char *byte = user;
 
@@ -844,7 +969,8 @@ static gboolean parse_dataobj_location_status(
 
 /* Defined in TS 102.223 Section 8.28 */
 static gboolean parse_dataobj_transaction_id(
-		struct comprehension_tlv_iter *iter, void *user)
+		struct comprehension_tlv_iter *iter,
+		struct stk_arena_block **arena, void *user)
 {
 	struct stk_transaction_id *ti = user;
 	const unsigned char *data;
@@ -862,7 +988,8 @@ static gboolean parse_dataobj_transaction_id(
 
 /* Defined in TS 31.111 Section 8.29 */
 static gboolean parse_dataobj_bcch_channel_list(
-		struct comprehension_tlv_iter *iter, void *user)
+		struct comprehension_tlv_iter *iter,
+		struct stk_arena_block **arena, void *user)
 {
 	struct stk_bcch_channel_list *bcl = user;
 	const unsigned char *data;
@@ -891,15 +1018,17 @@ static gboolean parse_dataobj_bcch_channel_list(
 
 /* Defined in TS 102.223 Section 8.30 */
 static gboolean parse_dataobj_call_control_requested_action(
-		struct comprehension_tlv_iter *iter, void *user)
+		struct comprehension_tlv_iter *iter,
+		struct stk_arena_block **arena, void *user)
 {
 	struct stk_common_byte_array *array = user;
 
-	return parse_dataobj_common_byte_array(iter, array);
+	return parse_dataobj_common_byte_array(iter, arena, array);
 }
 
 /* Defined in TS 102.223 Section 8.31 */
 static gboolean parse_dataobj_icon_id(struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *user)
 {
 	struct stk_icon_id *id = user;
@@ -918,7 +1047,8 @@ static gboolean parse_dataobj_icon_id(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.32 */
 static gboolean parse_dataobj_item_icon_id_list(
-		struct comprehension_tlv_iter *iter, void *user)
+		struct comprehension_tlv_iter *iter,
+		struct stk_arena_block **arena, void *user)
 {
 	struct stk_item_icon_id_list *iiil = user;
 	const unsigned char *data;
@@ -937,7 +1067,8 @@ static gboolean parse_dataobj_item_icon_id_list(
 
 /* Defined in TS 102.223 Section 8.33 */
 static gboolean parse_dataobj_card_reader_status(
-		struct comprehension_tlv_iter *iter, void *user)
+		struct comprehension_tlv_iter *iter,
+		struct stk_arena_block **arena, void *user)
 {
 	unsigned char *byte = user;
 
@@ -946,6 +1077,7 @@ static gboolean parse_dataobj_card_reader_status(
 
 /* Defined in TS 102.223 Section 8.34 */
 static gboolean parse_dataobj_card_atr(struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *user)
 {
 	struct stk_card_atr *ca = user;
@@ -964,6 +1096,7 @@ static gboolean parse_dataobj_card_atr(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.35 */
 static gboolean parse_dataobj_c_apdu(struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *user)
 {
 	struct stk_c_apdu *ca = user;
@@ -1010,6 +1143,7 @@ static gboolean parse_dataobj_c_apdu(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.36 */
 static gboolean parse_dataobj_r_apdu(struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *user)
 {
 	struct stk_r_apdu *ra = user;
@@ -1034,6 +1168,7 @@ static gboolean parse_dataobj_r_apdu(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.37 */
 static gboolean parse_dataobj_timer_id(struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *user)
 {
 	unsigned char *byte = user;
@@ -1043,6 +1178,7 @@ static gboolean parse_dataobj_timer_id(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.38 */
 static gboolean parse_dataobj_timer_value(struct comprehension_tlv_iter *iter,
+						struct stk_arena_block **arena,
 						void *user)
 {
 	struct stk_timer_value *tv = user;
@@ -1062,7 +1198,8 @@ static gboolean parse_dataobj_timer_value(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.39 */
 static gboolean parse_dataobj_datetime_timezone(
-		struct comprehension_tlv_iter *iter, void *user)
+		struct comprehension_tlv_iter *iter,
+		struct stk_arena_block **arena, void *user)
 {
 	struct sms_scts *scts = user;
 	const unsigned char *data;
@@ -1079,23 +1216,26 @@ static gboolean parse_dataobj_datetime_timezone(
 
 /* Defined in TS 102.223 Section 8.40 */
 static gboolean parse_dataobj_at_command(struct comprehension_tlv_iter *iter,
+						struct stk_arena_block **arena,
 						void *user)
 {
 	char **command = user;
-	return parse_dataobj_common_text(iter, command);
+	return parse_dataobj_common_text(iter, arena, command);
 }
 
 /* Defined in TS 102.223 Section 8.41 */
 static gboolean parse_dataobj_at_response(struct comprehension_tlv_iter *iter,
+						struct stk_arena_block **arena,
 						void *user)
 {
 	char **response = user;
-	return parse_dataobj_common_text(iter, response);
+	return parse_dataobj_common_text(iter, arena, response);
 }
 
 /* Defined in TS 102.223 Section 8.42 */
 static gboolean parse_dataobj_bc_repeat_indicator(
-		struct comprehension_tlv_iter *iter, void *user)
+		struct comprehension_tlv_iter *iter,
+		struct stk_arena_block **arena, void *user)
 {
 	struct stk_bc_repeat *bc_repeat = user;
 
@@ -1108,6 +1248,7 @@ static gboolean parse_dataobj_bc_repeat_indicator(
 
 /* Defined in 102.223 Section 8.43 */
 static gboolean parse_dataobj_imm_resp(struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *user)
 {
 	gboolean *ret = user;
@@ -1116,6 +1257,7 @@ static gboolean parse_dataobj_imm_resp(struct comprehension_tlv_iter *iter,
 
 /* Defined in 102.223 Section 8.44 */
 static gboolean parse_dataobj_dtmf_string(struct comprehension_tlv_iter *iter,
+						struct stk_arena_block **arena,
 						void *user)
 {
 	char **dtmf = user;
@@ -1127,7 +1269,7 @@ static gboolean parse_dataobj_dtmf_string(struct comprehension_tlv_iter *iter,
 
 	data = comprehension_tlv_iter_get_data(iter);
 
-	*dtmf = g_try_malloc(len * 2 + 1);
+	*dtmf = arena_alloc(arena, len * 2 + 1);
 	if (*dtmf == NULL)
 		return FALSE;
 
@@ -1138,6 +1280,7 @@ static gboolean parse_dataobj_dtmf_string(struct comprehension_tlv_iter *iter,
 
 /* Defined in 102.223 Section 8.45 */
 static gboolean parse_dataobj_language(struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *user)
 {
 	char *lang = user;
@@ -1163,7 +1306,8 @@ static gboolean parse_dataobj_language(struct comprehension_tlv_iter *iter,
 
 /* Defined in 31.111 Section 8.46 */
 static gboolean parse_dataobj_timing_advance(
-			struct comprehension_tlv_iter *iter, void *user)
+			struct comprehension_tlv_iter *iter,
+			struct stk_arena_block **arena, void *user)
 {
 	struct stk_timing_advance *ta = user;
 	const unsigned char *data;
@@ -1183,6 +1327,7 @@ static gboolean parse_dataobj_timing_advance(
 
 /* Defined in 102.223 Section 8.47 */
 static gboolean parse_dataobj_browser_id(struct comprehension_tlv_iter *iter,
+						struct stk_arena_block **arena,
 						void *user)
 {
 	unsigned char *byte = user;
@@ -1195,6 +1340,7 @@ static gboolean parse_dataobj_browser_id(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.48 */
 static gboolean parse_dataobj_url(struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *user)
 {
 	char **url = user;
@@ -1205,20 +1351,22 @@ static gboolean parse_dataobj_url(struct comprehension_tlv_iter *iter,
 		return TRUE;
 	}
 
-	return parse_dataobj_common_text(iter, url);
+	return parse_dataobj_common_text(iter, arena, url);
 }
 
 /* Defined in TS 102.223 Section 8.49 */
 static gboolean parse_dataobj_bearer(struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *user)
 {
 	struct stk_common_byte_array *array = user;
-	return parse_dataobj_common_byte_array(iter, array);
+	return parse_dataobj_common_byte_array(iter, arena, array);
 }
 
 /* Defined in TS 102.223 Section 8.50 */
 static gboolean parse_dataobj_provisioning_file_reference(
-		struct comprehension_tlv_iter *iter, void *user)
+		struct comprehension_tlv_iter *iter,
+		struct stk_arena_block **arena, void *user)
 {
 	struct stk_file *f = user;
 	const unsigned char *data;
@@ -1244,7 +1392,8 @@ static gboolean parse_dataobj_provisioning_file_reference(
 
 /* Defined in 102.223 Section 8.51 */
 static gboolean parse_dataobj_browser_termination_cause(
-		struct comprehension_tlv_iter *iter, void *user)
+		struct comprehension_tlv_iter *iter,
+		struct stk_arena_block **arena, void *user)
 {
 	unsigned char *byte = user;
 	return parse_dataobj_common_byte(iter, byte);
@@ -1252,7 +1401,8 @@ static gboolean parse_dataobj_browser_termination_cause(
 
 /* Defined in TS 102.223 Section 8.52 */
 static gboolean parse_dataobj_bearer_description(
-		struct comprehension_tlv_iter *iter, void *user)
+		struct comprehension_tlv_iter *iter,
+		struct stk_arena_block **arena, void *user)
 {
 	struct stk_bearer_description *bd = user;
 	const unsigned char *data;
@@ -1283,15 +1433,17 @@ static gboolean parse_dataobj_bearer_description(
 
 /* Defined in TS 102.223 Section 8.53 */
 static gboolean parse_dataobj_channel_data(struct comprehension_tlv_iter *iter,
+						struct stk_arena_block **arena,
 						void *user)
 {
 	struct stk_common_byte_array *array = user;
-	return parse_dataobj_common_byte_array(iter, array);
+	return parse_dataobj_common_byte_array(iter, arena, array);
 }
 
 /* Defined in TS 102.223 Section 8.54 */
 static gboolean parse_dataobj_channel_data_length(
-		struct comprehension_tlv_iter *iter, void *user)
+		struct comprehension_tlv_iter *iter,
+		struct stk_arena_block **arena, void *user)
 {
 	unsigned char *byte = user;
 	return parse_dataobj_common_byte(iter, byte);
@@ -1299,6 +1451,7 @@ static gboolean parse_dataobj_channel_data_length(
 
 /* Defined in TS 102.223 Section 8.55 */
 static gboolean parse_dataobj_buffer_size(struct comprehension_tlv_iter *iter,
+						struct stk_arena_block **arena,
 						void *user)
 {
 	unsigned short *size = user;
@@ -1315,7 +1468,8 @@ static gboolean parse_dataobj_buffer_size(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.56 */
 static gboolean parse_dataobj_channel_status(
-			struct comprehension_tlv_iter *iter, void *user)
+			struct comprehension_tlv_iter *iter,
+			struct stk_arena_block **arena, void *user)
 {
 	unsigned char *status = user;
 	const unsigned char *data;
@@ -1333,7 +1487,8 @@ static gboolean parse_dataobj_channel_status(
 
 /* Defined in TS 102.223 Section 8.57 */
 static gboolean parse_dataobj_card_reader_id(
-			struct comprehension_tlv_iter *iter, void *user)
+			struct comprehension_tlv_iter *iter,
+			struct stk_arena_block **arena, void *user)
 {
 	struct stk_card_reader_id *cr_id = user;
 	const unsigned char *data;
@@ -1351,7 +1506,8 @@ static gboolean parse_dataobj_card_reader_id(
 
 /* Defined in TS 102.223 Section 8.58 */
 static gboolean parse_dataobj_other_address(
-		struct comprehension_tlv_iter *iter, void *user)
+		struct comprehension_tlv_iter *iter,
+		struct stk_arena_block **arena, void *user)
 {
 	struct stk_other_address *oa = user;
 	const unsigned char *data;
@@ -1382,7 +1538,8 @@ static gboolean parse_dataobj_other_address(
 
 /* Defined in TS 102.223 Section 8.59 */
 static gboolean parse_dataobj_uicc_te_interface(
-		struct comprehension_tlv_iter *iter, void *user)
+		struct comprehension_tlv_iter *iter,
+		struct stk_arena_block **arena, void *user)
 {
 	struct stk_uicc_te_interface *uti = user;
 	const unsigned char *data;
@@ -1400,6 +1557,7 @@ static gboolean parse_dataobj_uicc_te_interface(
 
 /* Defined in TS 102.223 Section 8.60 */
 static gboolean parse_dataobj_aid(struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *user)
 {
 	struct stk_aid *aid = user;
@@ -1422,7 +1580,8 @@ static gboolean parse_dataobj_aid(struct comprehension_tlv_iter *iter,
  * so we just use 1 byte to represent it.
  */
 static gboolean parse_dataobj_access_technology(
-		struct comprehension_tlv_iter *iter, void *user)
+		struct comprehension_tlv_iter *iter,
+		struct stk_arena_block **arena, void *user)
 {
 	unsigned char *byte = user;
 	return parse_dataobj_common_byte(iter, byte);
@@ -1430,7 +1589,8 @@ static gboolean parse_dataobj_access_technology(
 
 /* Defined in TS 102.223 Section 8.62 */
 static gboolean parse_dataobj_display_parameters(
-		struct comprehension_tlv_iter *iter, void *user)
+		struct comprehension_tlv_iter *iter,
+		struct stk_arena_block **arena, void *user)
 {
 	struct stk_display_parameters *dp = user;
 	const unsigned char *data;
@@ -1448,7 +1608,8 @@ static gboolean parse_dataobj_display_parameters(
 
 /* Defined in TS 102.223 Section 8.63 */
 static gboolean parse_dataobj_service_record(
-		struct comprehension_tlv_iter *iter, void *user)
+		struct comprehension_tlv_iter *iter,
+		struct stk_arena_block **arena, void *user)
 {
 	struct stk_service_record *sr = user;
 	const unsigned char *data;
@@ -1463,7 +1624,7 @@ static gboolean parse_dataobj_service_record(
 	sr->serv_id = data[1];
 	sr->len = len - 2;
 
-	sr->serv_rec = g_try_malloc(sr->len);
+	sr->serv_rec = arena_alloc(arena, sr->len);
 	if (sr->serv_rec == NULL)
 		return FALSE;
 
@@ -1474,6 +1635,7 @@ static gboolean parse_dataobj_service_record(
 
 /* Defined in TS 102.223 Section 8.64 */
 static gboolean parse_dataobj_device_filter(struct comprehension_tlv_iter *iter,
+						struct stk_arena_block **arena,
 						void *user)
 {
 	struct stk_device_filter *df = user;
@@ -1493,7 +1655,7 @@ static gboolean parse_dataobj_device_filter(struct comprehension_tlv_iter *iter,
 	df->tech_id = data[0];
 	df->len = len - 1;
 
-	df->dev_filter = g_try_malloc(df->len);
+	df->dev_filter = arena_alloc(arena, df->len);
 	if (df->dev_filter == NULL)
 		return FALSE;
 
@@ -1504,7 +1666,8 @@ static gboolean parse_dataobj_device_filter(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.65 */
 static gboolean parse_dataobj_service_search(
-		struct comprehension_tlv_iter *iter, void *user)
+		struct comprehension_tlv_iter *iter,
+		struct stk_arena_block **arena, void *user)
 {
 	struct stk_service_search *ss = user;
 	const unsigned char *data;
@@ -1523,7 +1686,7 @@ static gboolean parse_dataobj_service_search(
 	ss->tech_id = data[0];
 	ss->len = len - 1;
 
-	ss->ser_search = g_try_malloc(ss->len);
+	ss->ser_search = arena_alloc(arena, ss->len);
 	if (ss->ser_search == NULL)
 		return FALSE;
 
@@ -1534,7 +1697,8 @@ static gboolean parse_dataobj_service_search(
 
 /* Defined in TS 102.223 Section 8.66 */
 static gboolean parse_dataobj_attribute_info(
-		struct comprehension_tlv_iter *iter, void *user)
+		struct comprehension_tlv_iter *iter,
+		struct stk_arena_block **arena, void *user)
 {
 	struct stk_attribute_info *ai = user;
 	const unsigned char *data;
@@ -1553,7 +1717,7 @@ static gboolean parse_dataobj_attribute_info(
 	ai->tech_id = data[0];
 	ai->len = len - 1;
 
-	ai->attr_info = g_try_malloc(ai->len);
+	ai->attr_info = arena_alloc(arena, ai->len);
 	if (ai->attr_info == NULL)
 		return FALSE;
 
@@ -1564,15 +1728,17 @@ static gboolean parse_dataobj_attribute_info(
 
 /* Defined in TS 102.223 Section 8.67 */
 static gboolean parse_dataobj_service_availability(
-		struct comprehension_tlv_iter *iter, void *user)
+		struct comprehension_tlv_iter *iter,
+		struct stk_arena_block **arena, void *user)
 {
 	struct stk_common_byte_array *array = user;
-	return parse_dataobj_common_byte_array(iter, array);
+	return parse_dataobj_common_byte_array(iter, arena, array);
 }
 
 /* Defined in TS 102.223 Section 8.68 */
 static gboolean parse_dataobj_remote_entity_address(
-		struct comprehension_tlv_iter *iter, void *user)
+		struct comprehension_tlv_iter *iter,
+		struct stk_arena_block **arena, void *user)
 {
 	struct stk_remote_entity_address *rea = user;
 	const unsigned char *data;
@@ -1602,6 +1768,7 @@ static gboolean parse_dataobj_remote_entity_address(
 
 /* Defined in TS 102.223 Section 8.69 */
 static gboolean parse_dataobj_esn(struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *user)
 {
 	unsigned char *esn = user;
@@ -1622,6 +1789,7 @@ static gboolean parse_dataobj_esn(struct comprehension_tlv_iter *iter,
 /* Defined in TS 102.223 Section 8.70 */
 static gboolean parse_dataobj_network_access_name(
 					struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *user)
 {
 	char **apn = user;
@@ -1659,21 +1827,23 @@ static gboolean parse_dataobj_network_access_name(
 	}
 
 	decoded_apn[offset] = '\0';
-	*apn = g_strdup(decoded_apn);
+	*apn = arena_memdup(arena, decoded_apn, offset + 1);
 
 	return TRUE;
 }
 
 /* Defined in TS 102.223 Section 8.71 */
 static gboolean parse_dataobj_cdma_sms_tpdu(struct comprehension_tlv_iter *iter,
+						struct stk_arena_block **arena,
 						void *user)
 {
 	struct stk_common_byte_array *array = user;
-	return parse_dataobj_common_byte_array(iter, array);
+	return parse_dataobj_common_byte_array(iter, arena, array);
 }
 
 /* Defined in TS 102.223 Section 8.72 */
 static gboolean parse_dataobj_text_attr(struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *user)
 {
 	struct stk_text_attribute *attr = user;
@@ -1695,7 +1865,8 @@ static gboolean parse_dataobj_text_attr(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 31.111 Section 8.72 */
 static gboolean parse_dataobj_pdp_act_par(
-			struct comprehension_tlv_iter *iter, void *user)
+			struct comprehension_tlv_iter *iter,
+			struct stk_arena_block **arena, void *user)
 {
 	struct stk_pdp_act_par *pcap = user;
 	const unsigned char *data;
@@ -1716,7 +1887,8 @@ static gboolean parse_dataobj_pdp_act_par(
 
 /* Defined in TS 102.223 Section 8.73 */
 static gboolean parse_dataobj_item_text_attribute_list(
-		struct comprehension_tlv_iter *iter, void *user)
+		struct comprehension_tlv_iter *iter,
+		struct stk_arena_block **arena, void *user)
 {
 	struct stk_item_text_attribute_list *ital = user;
 	const unsigned char *data;
@@ -1735,7 +1907,8 @@ static gboolean parse_dataobj_item_text_attribute_list(
 
 /* Defined in TS 31.111 Section 8.73 */
 static gboolean parse_dataobj_utran_meas_qualifier(
-			struct comprehension_tlv_iter *iter, void *user)
+			struct comprehension_tlv_iter *iter,
+			struct stk_arena_block **arena, void *user)
 {
 	unsigned char *byte = user;
 	return parse_dataobj_common_byte(iter, byte);
@@ -1756,6 +1929,7 @@ static gboolean parse_dataobj_utran_meas_qualifier(
  * "13 32 54 76 98 10 32 54 F6".
  */
 static gboolean parse_dataobj_imeisv(struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *user)
 {
 	char *imeisv = user;
@@ -1786,7 +1960,8 @@ static gboolean parse_dataobj_imeisv(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.75 */
 static gboolean parse_dataobj_network_search_mode(
-		struct comprehension_tlv_iter *iter, void *user)
+		struct comprehension_tlv_iter *iter,
+		struct stk_arena_block **arena, void *user)
 {
 	unsigned char *byte = user;
 	return parse_dataobj_common_byte(iter, byte);
@@ -1794,6 +1969,7 @@ static gboolean parse_dataobj_network_search_mode(
 
 /* Defined in TS 102.223 Section 8.76 */
 static gboolean parse_dataobj_battery_state(struct comprehension_tlv_iter *iter,
+						struct stk_arena_block **arena,
 						void *user)
 {
 	unsigned char *byte = user;
@@ -1802,14 +1978,16 @@ static gboolean parse_dataobj_battery_state(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.77 */
 static gboolean parse_dataobj_browsing_status(
-		struct comprehension_tlv_iter *iter, void *user)
+		struct comprehension_tlv_iter *iter,
+		struct stk_arena_block **arena, void *user)
 {
 	struct stk_common_byte_array *array = user;
-	return parse_dataobj_common_byte_array(iter, array);
+	return parse_dataobj_common_byte_array(iter, arena, array);
 }
 
 /* Defined in TS 102.223 Section 8.78 */
 static gboolean parse_dataobj_frame_layout(struct comprehension_tlv_iter *iter,
+						struct stk_arena_block **arena,
 						void *user)
 {
 	struct stk_frame_layout *fl = user;
@@ -1834,6 +2012,7 @@ static gboolean parse_dataobj_frame_layout(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.79 */
 static gboolean parse_dataobj_frames_info(struct comprehension_tlv_iter *iter,
+						struct stk_arena_block **arena,
 						void *user)
 {
 	struct stk_frames_info *fi = user;
@@ -1870,6 +2049,7 @@ static gboolean parse_dataobj_frames_info(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.80 */
 static gboolean parse_dataobj_frame_id(struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *user)
 {
 	struct stk_frame_id *fi = user;
@@ -1891,6 +2071,7 @@ static gboolean parse_dataobj_frame_id(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.81 */
 static gboolean parse_dataobj_meid(struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *user)
 {
 	unsigned char *meid = user;
@@ -1909,6 +2090,7 @@ static gboolean parse_dataobj_meid(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.82 */
 static gboolean parse_dataobj_mms_reference(struct comprehension_tlv_iter *iter,
+						struct stk_arena_block **arena,
 						void *user)
 {
 	struct stk_mms_reference *mr = user;
@@ -1927,6 +2109,7 @@ static gboolean parse_dataobj_mms_reference(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.83 */
 static gboolean parse_dataobj_mms_id(struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *user)
 {
 	struct stk_mms_id *mi = user;
@@ -1945,7 +2128,8 @@ static gboolean parse_dataobj_mms_id(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.84 */
 static gboolean parse_dataobj_mms_transfer_status(
-		struct comprehension_tlv_iter *iter, void *user)
+		struct comprehension_tlv_iter *iter,
+		struct stk_arena_block **arena, void *user)
 {
 	struct stk_mms_transfer_status *mts = user;
 	const unsigned char *data;
@@ -1963,7 +2147,8 @@ static gboolean parse_dataobj_mms_transfer_status(
 
 /* Defined in TS 102.223 Section 8.85 */
 static gboolean parse_dataobj_mms_content_id(
-		struct comprehension_tlv_iter *iter, void *user)
+		struct comprehension_tlv_iter *iter,
+		struct stk_arena_block **arena, void *user)
 {
 	struct stk_mms_content_id *mci = user;
 	const unsigned char *data;
@@ -1981,14 +2166,16 @@ static gboolean parse_dataobj_mms_content_id(
 
 /* Defined in TS 102.223 Section 8.86 */
 static gboolean parse_dataobj_mms_notification(
-		struct comprehension_tlv_iter *iter, void *user)
+		struct comprehension_tlv_iter *iter,
+		struct stk_arena_block **arena, void *user)
 {
 	struct stk_common_byte_array *array = user;
-	return parse_dataobj_common_byte_array(iter, array);
+	return parse_dataobj_common_byte_array(iter, arena, array);
 }
 
 /* Defined in TS 102.223 Section 8.87 */
 static gboolean parse_dataobj_last_envelope(struct comprehension_tlv_iter *iter,
+						struct stk_arena_block **arena,
 						void *user)
 {
 	gboolean *ret = user;
@@ -1997,7 +2184,8 @@ static gboolean parse_dataobj_last_envelope(struct comprehension_tlv_iter *iter,
 
 /* Defined in TS 102.223 Section 8.88 */
 static gboolean parse_dataobj_registry_application_data(
-		struct comprehension_tlv_iter *iter, void *user)
+		struct comprehension_tlv_iter *iter,
+		struct stk_arena_block **arena, void *user)
 {
 	struct stk_registry_application_data *rad = user;
 	const unsigned char *data;
@@ -2009,7 +2197,8 @@ static gboolean parse_dataobj_registry_application_data(
 
 	data = comprehension_tlv_iter_get_data(iter);
 
-	utf8 = decode_text(data[2], len - 4, data + 4);
+	utf8 = arena_take_string(arena,
+				decode_text(data[2], len - 4, data + 4));
 
 	if (utf8 == NULL)
 		return FALSE;
@@ -2023,7 +2212,8 @@ static gboolean parse_dataobj_registry_application_data(
 
 /* Defined in TS 102.223 Section 8.89 */
 static gboolean parse_dataobj_activate_descriptor(
-		struct comprehension_tlv_iter *iter, void *user)
+		struct comprehension_tlv_iter *iter,
+		struct stk_arena_block **arena, void *user)
 {
 	unsigned char *byte = user;
 	const unsigned char *data;
@@ -2043,7 +2233,8 @@ static gboolean parse_dataobj_activate_descriptor(
 
 /* Defined in TS 102.223 Section 8.90 */
 static gboolean parse_dataobj_broadcast_network_info(
-		struct comprehension_tlv_iter *iter, void *user)
+		struct comprehension_tlv_iter *iter,
+		struct stk_arena_block **arena, void *user)
 {
 	struct stk_broadcast_network_information *bni = user;
 	const unsigned char *data;
@@ -2064,208 +2255,147 @@ static gboolean parse_dataobj_broadcast_network_info(
 	return TRUE;
 }
 
+/*
+ * Comprehension-TLV tags of all data objects understood by parse_dataobj
+ * are below 0x80, so the handler is looked up directly by tag
+ */
+static const dataobj_handler dataobj_handlers[0x80] = {
+	[STK_DATA_OBJECT_TYPE_ADDRESS] = parse_dataobj_address,
+	[STK_DATA_OBJECT_TYPE_ALPHA_ID] = parse_dataobj_alpha_id,
+	[STK_DATA_OBJECT_TYPE_SUBADDRESS] = parse_dataobj_subaddress,
+	[STK_DATA_OBJECT_TYPE_CCP] = parse_dataobj_ccp,
+	[STK_DATA_OBJECT_TYPE_CBS_PAGE] = parse_dataobj_cbs_page,
+	[STK_DATA_OBJECT_TYPE_DURATION] = parse_dataobj_duration,
+	[STK_DATA_OBJECT_TYPE_ITEM] = parse_dataobj_item,
+	[STK_DATA_OBJECT_TYPE_ITEM_ID] = parse_dataobj_item_id,
+	[STK_DATA_OBJECT_TYPE_RESPONSE_LENGTH] = parse_dataobj_response_len,
+	[STK_DATA_OBJECT_TYPE_RESULT] = parse_dataobj_result,
+	[STK_DATA_OBJECT_TYPE_GSM_SMS_TPDU] = parse_dataobj_gsm_sms_tpdu,
+	[STK_DATA_OBJECT_TYPE_SS_STRING] = parse_dataobj_ss,
+	[STK_DATA_OBJECT_TYPE_TEXT] = parse_dataobj_text,
+	[STK_DATA_OBJECT_TYPE_TONE] = parse_dataobj_tone,
+	[STK_DATA_OBJECT_TYPE_USSD_STRING] = parse_dataobj_ussd,
+	[STK_DATA_OBJECT_TYPE_FILE_LIST] = parse_dataobj_file_list,
+	[STK_DATA_OBJECT_TYPE_LOCATION_INFO] = parse_dataobj_location_info,
+	[STK_DATA_OBJECT_TYPE_IMEI] = parse_dataobj_imei,
+	[STK_DATA_OBJECT_TYPE_HELP_REQUEST] = parse_dataobj_help_request,
+	[STK_DATA_OBJECT_TYPE_NETWORK_MEASUREMENT_RESULTS] =
+			parse_dataobj_network_measurement_results,
+	[STK_DATA_OBJECT_TYPE_DEFAULT_TEXT] = parse_dataobj_default_text,
+	[STK_DATA_OBJECT_TYPE_ITEMS_NEXT_ACTION_INDICATOR] =
+			parse_dataobj_items_next_action_indicator,
+	[STK_DATA_OBJECT_TYPE_EVENT_LIST] = parse_dataobj_event_list,
+	[STK_DATA_OBJECT_TYPE_CAUSE] = parse_dataobj_cause,
+	[STK_DATA_OBJECT_TYPE_LOCATION_STATUS] = parse_dataobj_location_status,
+	[STK_DATA_OBJECT_TYPE_TRANSACTION_ID] = parse_dataobj_transaction_id,
+	[STK_DATA_OBJECT_TYPE_BCCH_CHANNEL_LIST] =
+			parse_dataobj_bcch_channel_list,
+	[STK_DATA_OBJECT_TYPE_CALL_CONTROL_REQUESTED_ACTION] =
+			parse_dataobj_call_control_requested_action,
+	[STK_DATA_OBJECT_TYPE_ICON_ID] = parse_dataobj_icon_id,
+	[STK_DATA_OBJECT_TYPE_ITEM_ICON_ID_LIST] =
+			parse_dataobj_item_icon_id_list,
+	[STK_DATA_OBJECT_TYPE_CARD_READER_STATUS] =
+			parse_dataobj_card_reader_status,
+	[STK_DATA_OBJECT_TYPE_CARD_ATR] = parse_dataobj_card_atr,
+	[STK_DATA_OBJECT_TYPE_C_APDU] = parse_dataobj_c_apdu,
+	[STK_DATA_OBJECT_TYPE_R_APDU] = parse_dataobj_r_apdu,
+	[STK_DATA_OBJECT_TYPE_TIMER_ID] = parse_dataobj_timer_id,
+	[STK_DATA_OBJECT_TYPE_TIMER_VALUE] = parse_dataobj_timer_value,
+	[STK_DATA_OBJECT_TYPE_DATETIME_TIMEZONE] =
+			parse_dataobj_datetime_timezone,
+	[STK_DATA_OBJECT_TYPE_AT_COMMAND] = parse_dataobj_at_command,
+	[STK_DATA_OBJECT_TYPE_AT_RESPONSE] = parse_dataobj_at_response,
+	[STK_DATA_OBJECT_TYPE_BC_REPEAT_INDICATOR] =
+			parse_dataobj_bc_repeat_indicator,
+	[STK_DATA_OBJECT_TYPE_IMMEDIATE_RESPONSE] = parse_dataobj_imm_resp,
+	[STK_DATA_OBJECT_TYPE_DTMF_STRING] = parse_dataobj_dtmf_string,
+	[STK_DATA_OBJECT_TYPE_LANGUAGE] = parse_dataobj_language,
+	[STK_DATA_OBJECT_TYPE_BROWSER_ID] = parse_dataobj_browser_id,
+	[STK_DATA_OBJECT_TYPE_TIMING_ADVANCE] = parse_dataobj_timing_advance,
+	[STK_DATA_OBJECT_TYPE_URL] = parse_dataobj_url,
+	[STK_DATA_OBJECT_TYPE_BEARER] = parse_dataobj_bearer,
+	[STK_DATA_OBJECT_TYPE_PROVISIONING_FILE_REF] =
+			parse_dataobj_provisioning_file_reference,
+	[STK_DATA_OBJECT_TYPE_BROWSER_TERMINATION_CAUSE] =
+			parse_dataobj_browser_termination_cause,
+	[STK_DATA_OBJECT_TYPE_BEARER_DESCRIPTION] =
+			parse_dataobj_bearer_description,
+	[STK_DATA_OBJECT_TYPE_CHANNEL_DATA] = parse_dataobj_channel_data,
+	[STK_DATA_OBJECT_TYPE_CHANNEL_DATA_LENGTH] =
+			parse_dataobj_channel_data_length,
+	[STK_DATA_OBJECT_TYPE_BUFFER_SIZE] = parse_dataobj_buffer_size,
+	[STK_DATA_OBJECT_TYPE_CHANNEL_STATUS] = parse_dataobj_channel_status,
+	[STK_DATA_OBJECT_TYPE_CARD_READER_ID] = parse_dataobj_card_reader_id,
+	[STK_DATA_OBJECT_TYPE_OTHER_ADDRESS] = parse_dataobj_other_address,
+	[STK_DATA_OBJECT_TYPE_UICC_TE_INTERFACE] =
+			parse_dataobj_uicc_te_interface,
+	[STK_DATA_OBJECT_TYPE_AID] = parse_dataobj_aid,
+	[STK_DATA_OBJECT_TYPE_ACCESS_TECHNOLOGY] =
+			parse_dataobj_access_technology,
+	[STK_DATA_OBJECT_TYPE_DISPLAY_PARAMETERS] =
+			parse_dataobj_display_parameters,
+	[STK_DATA_OBJECT_TYPE_SERVICE_RECORD] = parse_dataobj_service_record,
+	[STK_DATA_OBJECT_TYPE_DEVICE_FILTER] = parse_dataobj_device_filter,
+	[STK_DATA_OBJECT_TYPE_SERVICE_SEARCH] = parse_dataobj_service_search,
+	[STK_DATA_OBJECT_TYPE_ATTRIBUTE_INFO] = parse_dataobj_attribute_info,
+	[STK_DATA_OBJECT_TYPE_SERVICE_AVAILABILITY] =
+			parse_dataobj_service_availability,
+	[STK_DATA_OBJECT_TYPE_REMOTE_ENTITY_ADDRESS] =
+			parse_dataobj_remote_entity_address,
+	[STK_DATA_OBJECT_TYPE_ESN] = parse_dataobj_esn,
+	[STK_DATA_OBJECT_TYPE_NETWORK_ACCESS_NAME] =
+			parse_dataobj_network_access_name,
+	[STK_DATA_OBJECT_TYPE_CDMA_SMS_TPDU] = parse_dataobj_cdma_sms_tpdu,
+	[STK_DATA_OBJECT_TYPE_TEXT_ATTRIBUTE] = parse_dataobj_text_attr,
+	[STK_DATA_OBJECT_TYPE_PDP_ACTIVATION_PARAMETER] =
+			parse_dataobj_pdp_act_par,
+	[STK_DATA_OBJECT_TYPE_ITEM_TEXT_ATTRIBUTE_LIST] =
+			parse_dataobj_item_text_attribute_list,
+	[STK_DATA_OBJECT_TYPE_UTRAN_MEASUREMENT_QUALIFIER] =
+			parse_dataobj_utran_meas_qualifier,
+	[STK_DATA_OBJECT_TYPE_IMEISV] = parse_dataobj_imeisv,
+	[STK_DATA_OBJECT_TYPE_NETWORK_SEARCH_MODE] =
+			parse_dataobj_network_search_mode,
+	[STK_DATA_OBJECT_TYPE_BATTERY_STATE] = parse_dataobj_battery_state,
+	[STK_DATA_OBJECT_TYPE_BROWSING_STATUS] = parse_dataobj_browsing_status,
+	[STK_DATA_OBJECT_TYPE_FRAME_LAYOUT] = parse_dataobj_frame_layout,
+	[STK_DATA_OBJECT_TYPE_FRAMES_INFO] = parse_dataobj_frames_info,
+	[STK_DATA_OBJECT_TYPE_FRAME_ID] = parse_dataobj_frame_id,
+	[STK_DATA_OBJECT_TYPE_MEID] = parse_dataobj_meid,
+	[STK_DATA_OBJECT_TYPE_MMS_REFERENCE] = parse_dataobj_mms_reference,
+	[STK_DATA_OBJECT_TYPE_MMS_ID] = parse_dataobj_mms_id,
+	[STK_DATA_OBJECT_TYPE_MMS_TRANSFER_STATUS] =
+			parse_dataobj_mms_transfer_status,
+	[STK_DATA_OBJECT_TYPE_MMS_CONTENT_ID] = parse_dataobj_mms_content_id,
+	[STK_DATA_OBJECT_TYPE_MMS_NOTIFICATION] =
+			parse_dataobj_mms_notification,
+	[STK_DATA_OBJECT_TYPE_LAST_ENVELOPE] = parse_dataobj_last_envelope,
+	[STK_DATA_OBJECT_TYPE_REGISTRY_APPLICATION_DATA] =
+			parse_dataobj_registry_application_data,
+	[STK_DATA_OBJECT_TYPE_ACTIVATE_DESCRIPTOR] =
+			parse_dataobj_activate_descriptor,
+	[STK_DATA_OBJECT_TYPE_BROADCAST_NETWORK_INFO] =
+			parse_dataobj_broadcast_network_info,
+};
+
 static dataobj_handler handler_for_type(enum stk_data_object_type type)
 {
-	switch (type) {
-	case STK_DATA_OBJECT_TYPE_ADDRESS:
-		return parse_dataobj_address;
-	case STK_DATA_OBJECT_TYPE_ALPHA_ID:
-		return parse_dataobj_alpha_id;
-	case STK_DATA_OBJECT_TYPE_SUBADDRESS:
-		return parse_dataobj_subaddress;
-	case STK_DATA_OBJECT_TYPE_CCP:
-		return parse_dataobj_ccp;
-	case STK_DATA_OBJECT_TYPE_CBS_PAGE:
-		return parse_dataobj_cbs_page;
-	case STK_DATA_OBJECT_TYPE_DURATION:
-		return parse_dataobj_duration;
-	case STK_DATA_OBJECT_TYPE_ITEM:
-		return parse_dataobj_item;
-	case STK_DATA_OBJECT_TYPE_ITEM_ID:
-		return parse_dataobj_item_id;
-	case STK_DATA_OBJECT_TYPE_RESPONSE_LENGTH:
-		return parse_dataobj_response_len;
-	case STK_DATA_OBJECT_TYPE_RESULT:
-		return parse_dataobj_result;
-	case STK_DATA_OBJECT_TYPE_GSM_SMS_TPDU:
-		return parse_dataobj_gsm_sms_tpdu;
-	case STK_DATA_OBJECT_TYPE_SS_STRING:
-		return parse_dataobj_ss;
-	case STK_DATA_OBJECT_TYPE_TEXT:
-		return parse_dataobj_text;
-	case STK_DATA_OBJECT_TYPE_TONE:
-		return parse_dataobj_tone;
-	case STK_DATA_OBJECT_TYPE_USSD_STRING:
-		return parse_dataobj_ussd;
-	case STK_DATA_OBJECT_TYPE_FILE_LIST:
-		return parse_dataobj_file_list;
-	case STK_DATA_OBJECT_TYPE_LOCATION_INFO:
-		return parse_dataobj_location_info;
-	case STK_DATA_OBJECT_TYPE_IMEI:
-		return parse_dataobj_imei;
-	case STK_DATA_OBJECT_TYPE_HELP_REQUEST:
-		return parse_dataobj_help_request;
-	case STK_DATA_OBJECT_TYPE_NETWORK_MEASUREMENT_RESULTS:
-		return parse_dataobj_network_measurement_results;
-	case STK_DATA_OBJECT_TYPE_DEFAULT_TEXT:
-		return parse_dataobj_default_text;
-	case STK_DATA_OBJECT_TYPE_ITEMS_NEXT_ACTION_INDICATOR:
-		return parse_dataobj_items_next_action_indicator;
-	case STK_DATA_OBJECT_TYPE_EVENT_LIST:
-		return parse_dataobj_event_list;
-	case STK_DATA_OBJECT_TYPE_CAUSE:
-		return parse_dataobj_cause;
-	case STK_DATA_OBJECT_TYPE_LOCATION_STATUS:
-		return parse_dataobj_location_status;
-	case STK_DATA_OBJECT_TYPE_TRANSACTION_ID:
-		return parse_dataobj_transaction_id;
-	case STK_DATA_OBJECT_TYPE_BCCH_CHANNEL_LIST:
-		return parse_dataobj_bcch_channel_list;
-	case STK_DATA_OBJECT_TYPE_CALL_CONTROL_REQUESTED_ACTION:
-		return parse_dataobj_call_control_requested_action;
-	case STK_DATA_OBJECT_TYPE_ICON_ID:
-		return parse_dataobj_icon_id;
-	case STK_DATA_OBJECT_TYPE_ITEM_ICON_ID_LIST:
-		return parse_dataobj_item_icon_id_list;
-	case STK_DATA_OBJECT_TYPE_CARD_READER_STATUS:
-		return parse_dataobj_card_reader_status;
-	case STK_DATA_OBJECT_TYPE_CARD_ATR:
-		return parse_dataobj_card_atr;
-	case STK_DATA_OBJECT_TYPE_C_APDU:
-		return parse_dataobj_c_apdu;
-	case STK_DATA_OBJECT_TYPE_R_APDU:
-		return parse_dataobj_r_apdu;
-	case STK_DATA_OBJECT_TYPE_TIMER_ID:
-		return parse_dataobj_timer_id;
-	case STK_DATA_OBJECT_TYPE_TIMER_VALUE:
-		return parse_dataobj_timer_value;
-	case STK_DATA_OBJECT_TYPE_DATETIME_TIMEZONE:
-		return parse_dataobj_datetime_timezone;
-	case STK_DATA_OBJECT_TYPE_AT_COMMAND:
-		return parse_dataobj_at_command;
-	case STK_DATA_OBJECT_TYPE_AT_RESPONSE:
-		return parse_dataobj_at_response;
-	case STK_DATA_OBJECT_TYPE_BC_REPEAT_INDICATOR:
-		return parse_dataobj_bc_repeat_indicator;
-	case STK_DATA_OBJECT_TYPE_IMMEDIATE_RESPONSE:
-		return parse_dataobj_imm_resp;
-	case STK_DATA_OBJECT_TYPE_DTMF_STRING:
-		return parse_dataobj_dtmf_string;
-	case STK_DATA_OBJECT_TYPE_LANGUAGE:
-		return parse_dataobj_language;
-	case STK_DATA_OBJECT_TYPE_BROWSER_ID:
-		return parse_dataobj_browser_id;
-	case STK_DATA_OBJECT_TYPE_TIMING_ADVANCE:
-		return parse_dataobj_timing_advance;
-	case STK_DATA_OBJECT_TYPE_URL:
-		return parse_dataobj_url;
-	case STK_DATA_OBJECT_TYPE_BEARER:
-		return parse_dataobj_bearer;
-	case STK_DATA_OBJECT_TYPE_PROVISIONING_FILE_REF:
-		return parse_dataobj_provisioning_file_reference;
-	case STK_DATA_OBJECT_TYPE_BROWSER_TERMINATION_CAUSE:
-		return parse_dataobj_browser_termination_cause;
-	case STK_DATA_OBJECT_TYPE_BEARER_DESCRIPTION:
-		return parse_dataobj_bearer_description;
-	case STK_DATA_OBJECT_TYPE_CHANNEL_DATA:
-		return parse_dataobj_channel_data;
-	case STK_DATA_OBJECT_TYPE_CHANNEL_DATA_LENGTH:
-		return parse_dataobj_channel_data_length;
-	case STK_DATA_OBJECT_TYPE_BUFFER_SIZE:
-		return parse_dataobj_buffer_size;
-	case STK_DATA_OBJECT_TYPE_CHANNEL_STATUS:
-		return parse_dataobj_channel_status;
-	case STK_DATA_OBJECT_TYPE_CARD_READER_ID:
-		return parse_dataobj_card_reader_id;
-	case STK_DATA_OBJECT_TYPE_OTHER_ADDRESS:
-		return parse_dataobj_other_address;
-	case STK_DATA_OBJECT_TYPE_UICC_TE_INTERFACE:
-		return parse_dataobj_uicc_te_interface;
-	case STK_DATA_OBJECT_TYPE_AID:
-		return parse_dataobj_aid;
-	case STK_DATA_OBJECT_TYPE_ACCESS_TECHNOLOGY:
-		return parse_dataobj_access_technology;
-	case STK_DATA_OBJECT_TYPE_DISPLAY_PARAMETERS:
-		return parse_dataobj_display_parameters;
-	case STK_DATA_OBJECT_TYPE_SERVICE_RECORD:
-		return parse_dataobj_service_record;
-	case STK_DATA_OBJECT_TYPE_DEVICE_FILTER:
-		return parse_dataobj_device_filter;
-	case STK_DATA_OBJECT_TYPE_SERVICE_SEARCH:
-		return parse_dataobj_service_search;
-	case STK_DATA_OBJECT_TYPE_ATTRIBUTE_INFO:
-		return parse_dataobj_attribute_info;
-	case STK_DATA_OBJECT_TYPE_SERVICE_AVAILABILITY:
-		return parse_dataobj_service_availability;
-	case STK_DATA_OBJECT_TYPE_REMOTE_ENTITY_ADDRESS:
-		return parse_dataobj_remote_entity_address;
-	case STK_DATA_OBJECT_TYPE_ESN:
-		return parse_dataobj_esn;
-	case STK_DATA_OBJECT_TYPE_NETWORK_ACCESS_NAME:
-		return parse_dataobj_network_access_name;
-	case STK_DATA_OBJECT_TYPE_CDMA_SMS_TPDU:
-		return parse_dataobj_cdma_sms_tpdu;
-	case STK_DATA_OBJECT_TYPE_TEXT_ATTRIBUTE:
-		return parse_dataobj_text_attr;
-	case STK_DATA_OBJECT_TYPE_PDP_ACTIVATION_PARAMETER:
-		return parse_dataobj_pdp_act_par;
-	case STK_DATA_OBJECT_TYPE_ITEM_TEXT_ATTRIBUTE_LIST:
-		return parse_dataobj_item_text_attribute_list;
-	case STK_DATA_OBJECT_TYPE_UTRAN_MEASUREMENT_QUALIFIER:
-		return parse_dataobj_utran_meas_qualifier;
-	case STK_DATA_OBJECT_TYPE_IMEISV:
-		return parse_dataobj_imeisv;
-	case STK_DATA_OBJECT_TYPE_NETWORK_SEARCH_MODE:
-		return parse_dataobj_network_search_mode;
-	case STK_DATA_OBJECT_TYPE_BATTERY_STATE:
-		return parse_dataobj_battery_state;
-	case STK_DATA_OBJECT_TYPE_BROWSING_STATUS:
-		return parse_dataobj_browsing_status;
-	case STK_DATA_OBJECT_TYPE_FRAME_LAYOUT:
-		return parse_dataobj_frame_layout;
-	case STK_DATA_OBJECT_TYPE_FRAMES_INFO:
-		return parse_dataobj_frames_info;
-	case STK_DATA_OBJECT_TYPE_FRAME_ID:
-		return parse_dataobj_frame_id;
-	case STK_DATA_OBJECT_TYPE_MEID:
-		return parse_dataobj_meid;
-	case STK_DATA_OBJECT_TYPE_MMS_REFERENCE:
-		return parse_dataobj_mms_reference;
-	case STK_DATA_OBJECT_TYPE_MMS_ID:
-		return parse_dataobj_mms_id;
-	case STK_DATA_OBJECT_TYPE_MMS_TRANSFER_STATUS:
-		return parse_dataobj_mms_transfer_status;
-	case STK_DATA_OBJECT_TYPE_MMS_CONTENT_ID:
-		return parse_dataobj_mms_content_id;
-	case STK_DATA_OBJECT_TYPE_MMS_NOTIFICATION:
-		return parse_dataobj_mms_notification;
-	case STK_DATA_OBJECT_TYPE_LAST_ENVELOPE:
-		return parse_dataobj_last_envelope;
-	case STK_DATA_OBJECT_TYPE_REGISTRY_APPLICATION_DATA:
-		return parse_dataobj_registry_application_data;
-	case STK_DATA_OBJECT_TYPE_ACTIVATE_DESCRIPTOR:
-		return parse_dataobj_activate_descriptor;
-	case STK_DATA_OBJECT_TYPE_BROADCAST_NETWORK_INFO:
-		return parse_dataobj_broadcast_network_info;
-	default:
+	if ((unsigned int) type >= G_N_ELEMENTS(dataobj_handlers))
 		return NULL;
-	}
-}
 
-static void destroy_stk_item(gpointer pointer)
-{
-	struct stk_item *item = pointer;
-	g_free(item->text);
-	g_free(item);
+	return dataobj_handlers[type];
 }
 
 static gboolean parse_item_list(struct comprehension_tlv_iter *iter,
+				struct stk_arena_block **arena,
 				void *data)
 {
 	GSList **out = data;
 	unsigned short tag = STK_DATA_OBJECT_TYPE_ITEM;
 	struct comprehension_tlv_iter iter_old;
 	struct stk_item item;
+	struct stk_item *item_copy;
 	GSList *list = NULL;
 	unsigned int count = 0;
 	gboolean has_empty = FALSE;
@@ -2275,14 +2405,14 @@ static gboolean parse_item_list(struct comprehension_tlv_iter *iter,
 		memset(&item, 0, sizeof(item));
 		count++;
 
-		if (parse_dataobj_item(iter, &item) == TRUE) {
+		if (parse_dataobj_item(iter, arena, &item) == TRUE) {
 			if (item.id == 0) {
 				has_empty = TRUE;
 				continue;
 			}
 
-			list = g_slist_prepend(list,
-						g_memdup(&item, sizeof(item)));
+			item_copy = arena_memdup(arena, &item, sizeof(item));
+			list = arena_slist_prepend(arena, list, item_copy);
 		}
 	} while (comprehension_tlv_iter_next(iter) == TRUE &&
 			comprehension_tlv_iter_get_tag(iter) == tag);
@@ -2294,31 +2424,31 @@ static gboolean parse_item_list(struct comprehension_tlv_iter *iter,
 		return TRUE;
 	}
 
-	if (count == 1)
-		return TRUE;
-
-	g_slist_free_full(list, destroy_stk_item);
-	return FALSE;
+	return count == 1;
 
 }
 
 static gboolean parse_provisioning_list(struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					void *data)
 {
 	GSList **out = data;
 	unsigned short tag = STK_DATA_OBJECT_TYPE_PROVISIONING_FILE_REF;
 	struct comprehension_tlv_iter iter_old;
 	struct stk_file file;
+	struct stk_file *file_copy;
 	GSList *list = NULL;
 
 	do {
 		comprehension_tlv_iter_copy(iter, &iter_old);
 		memset(&file, 0, sizeof(file));
 
-		if (parse_dataobj_provisioning_file_reference(iter, &file)
-									== TRUE)
-			list = g_slist_prepend(list,
-						g_memdup(&file, sizeof(file)));
+		if (parse_dataobj_provisioning_file_reference(iter, arena,
+								&file) == FALSE)
+			continue;
+
+		file_copy = arena_memdup(arena, &file, sizeof(file));
+		list = arena_slist_prepend(arena, list, file_copy);
 	} while (comprehension_tlv_iter_next(iter) == TRUE &&
 			comprehension_tlv_iter_get_tag(iter) == tag);
 
@@ -2340,18 +2470,25 @@ static dataobj_handler list_handler_for_type(enum stk_data_object_type type)
 	}
 }
 
+/* No command takes more data objects than this */
+#define DATAOBJ_MAX_ENTRIES 16
+
 struct dataobj_handler_entry {
 	enum stk_data_object_type type;
 	int flags;
 	void *data;
+	dataobj_handler handler;
 };
 
 static enum stk_command_parse_result parse_dataobj(
 					struct comprehension_tlv_iter *iter,
+					struct stk_arena_block **arena,
 					enum stk_data_object_type type, ...)
 {
-	GSList *entries = NULL;
-	GSList *l;
+	struct dataobj_handler_entry entries[DATAOBJ_MAX_ENTRIES];
+	unsigned int n_entries = 0;
+	unsigned int next = 0;
+	unsigned int i;
 	va_list args;
 	gboolean minimum_set = TRUE;
 	gboolean parse_error = FALSE;
@@ -2361,66 +2498,64 @@ static enum stk_command_parse_result parse_dataobj(
 	while (type != STK_DATA_OBJECT_TYPE_INVALID) {
 		struct dataobj_handler_entry *entry;
 
-		entry = g_new0(struct dataobj_handler_entry, 1);
+		if (n_entries == DATAOBJ_MAX_ENTRIES) {
+			va_end(args);
+			return STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
+		}
 
+		entry = &entries[n_entries++];
 		entry->type = type;
 		entry->flags = va_arg(args, int);
 		entry->data = va_arg(args, void *);
 
+		if (entry->flags & DATAOBJ_FLAG_LIST)
+			entry->handler = list_handler_for_type(type);
+		else
+			entry->handler = handler_for_type(type);
+
 		type = va_arg(args, enum stk_data_object_type);
-		entries = g_slist_prepend(entries, entry);
 	}
 
 	va_end(args);
 
-	entries = g_slist_reverse(entries);
-
-	l = entries;
+	/*
+	 * Data objects appear in the order they are expected in, so a single
+	 * pass over the TLVs matches each of them against the remaining
+	 * entries.
+	 */
 	while (comprehension_tlv_iter_next(iter) == TRUE) {
-		dataobj_handler handler;
-		struct dataobj_handler_entry *entry;
-		GSList *l2;
-
-		for (l2 = l; l2; l2 = l2->next) {
-			entry = l2->data;
+		unsigned short tag = comprehension_tlv_iter_get_tag(iter);
+		struct dataobj_handler_entry *entry = NULL;
 
-			if (comprehension_tlv_iter_get_tag(iter) == entry->type)
+		for (i = next; i < n_entries; i++) {
+			if (tag == entries[i].type) {
+				entry = &entries[i];
 				break;
+			}
 
 			/* Can't skip over mandatory objects */
-			if (entry->flags & DATAOBJ_FLAG_MANDATORY) {
-				l2 = NULL;
+			if (entries[i].flags & DATAOBJ_FLAG_MANDATORY)
 				break;
-			}
 		}
 
-		if (l2 == NULL) {
+		if (entry == NULL) {
 			if (comprehension_tlv_get_cr(iter) == TRUE)
 				parse_error = TRUE;
 
 			continue;
 		}
 
-		if (entry->flags & DATAOBJ_FLAG_LIST)
-			handler = list_handler_for_type(entry->type);
-		else
-			handler = handler_for_type(entry->type);
-
-		if (handler(iter, entry->data) == FALSE)
+		if (entry->handler(iter, arena, entry->data) == FALSE)
 			parse_error = TRUE;
 
-		l = l2->next;
+		next = i + 1;
 	}
 
-	for (; l; l = l->next) {
-		struct dataobj_handler_entry *entry = l->data;
-
-		if (entry->flags & DATAOBJ_FLAG_MANDATORY)
+	for (i = next; i < n_entries; i++) {
+		if (entries[i].flags & DATAOBJ_FLAG_MANDATORY)
 			minimum_set = FALSE;
 	}
 
-	g_slist_free_full(entries, g_free);
-
 	if (minimum_set == FALSE)
 		return STK_PARSE_RESULT_MISSING_VALUE;
 	if (parse_error == TRUE)
@@ -2429,11 +2564,6 @@ static enum stk_command_parse_result parse_dataobj(
 	return STK_PARSE_RESULT_OK;
 }
 
-static void destroy_display_text(struct stk_command *command)
-{
-	g_free(command->display_text.text);
-}
-
 static enum stk_command_parse_result parse_display_text(
 					struct stk_command *command,
 					struct comprehension_tlv_iter *iter)
@@ -2447,9 +2577,8 @@ static enum stk_command_parse_result parse_display_text(
 	if (command->dst != STK_DEVICE_IDENTITY_TYPE_DISPLAY)
 		return STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
 
-	command->destructor = destroy_display_text;
-
-	status = parse_dataobj(iter, STK_DATA_OBJECT_TYPE_TEXT,
+	status = parse_dataobj(iter, &command->arena,
+				STK_DATA_OBJECT_TYPE_TEXT,
 				DATAOBJ_FLAG_MANDATORY | DATAOBJ_FLAG_MINIMUM,
 				&obj->text,
 				STK_DATA_OBJECT_TYPE_ICON_ID, 0,
@@ -2469,11 +2598,6 @@ static enum stk_command_parse_result parse_display_text(
 	return status;
 }
 
-static void destroy_get_inkey(struct stk_command *command)
-{
-	g_free(command->get_inkey.text);
-}
-
 static enum stk_command_parse_result parse_get_inkey(
 					struct stk_command *command,
 					struct comprehension_tlv_iter *iter)
@@ -2487,9 +2611,8 @@ static enum stk_command_parse_result parse_get_inkey(
 	if (command->dst != STK_DEVICE_IDENTITY_TYPE_TERMINAL)
 		return STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
 
-	command->destructor = destroy_get_inkey;
-
-	status = parse_dataobj(iter, STK_DATA_OBJECT_TYPE_TEXT,
+	status = parse_dataobj(iter, &command->arena,
+				STK_DATA_OBJECT_TYPE_TEXT,
 				DATAOBJ_FLAG_MANDATORY | DATAOBJ_FLAG_MINIMUM,
 				&obj->text,
 				STK_DATA_OBJECT_TYPE_ICON_ID, 0,
@@ -2507,12 +2630,6 @@ static enum stk_command_parse_result parse_get_inkey(
 	return status;
 }
 
-static void destroy_get_input(struct stk_command *command)
-{
-	g_free(command->get_input.text);
-	g_free(command->get_input.default_text);
-}
-
 static enum stk_command_parse_result parse_get_input(
 					struct stk_command *command,
 					struct comprehension_tlv_iter *iter)
@@ -2526,9 +2643,8 @@ static enum stk_command_parse_result parse_get_input(
 	if (command->dst != STK_DEVICE_IDENTITY_TYPE_TERMINAL)
 		return STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
 
-	command->destructor = destroy_get_input;
-
-	status = parse_dataobj(iter, STK_DATA_OBJECT_TYPE_TEXT,
+	status = parse_dataobj(iter, &command->arena,
+				STK_DATA_OBJECT_TYPE_TEXT,
 				DATAOBJ_FLAG_MANDATORY | DATAOBJ_FLAG_MINIMUM,
 				&obj->text,
 				STK_DATA_OBJECT_TYPE_RESPONSE_LENGTH,
@@ -2562,11 +2678,6 @@ static enum stk_command_parse_result parse_more_time(
 	return STK_PARSE_RESULT_OK;
 }
 
-static void destroy_play_tone(struct stk_command *command)
-{
-	g_free(command->play_tone.alpha_id);
-}
-
 static enum stk_command_parse_result parse_play_tone(
 					struct stk_command *command,
 					struct comprehension_tlv_iter *iter)
@@ -2580,9 +2691,8 @@ static enum stk_command_parse_result parse_play_tone(
 	if (command->dst != STK_DEVICE_IDENTITY_TYPE_EARPIECE)
 		return STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
 
-	command->destructor = destroy_play_tone;
-
-	status = parse_dataobj(iter, STK_DATA_OBJECT_TYPE_ALPHA_ID, 0,
+	status = parse_dataobj(iter, &command->arena,
+				STK_DATA_OBJECT_TYPE_ALPHA_ID, 0,
 				&obj->alpha_id,
 				STK_DATA_OBJECT_TYPE_TONE, 0,
 				&obj->tone,
@@ -2613,18 +2723,13 @@ static enum stk_command_parse_result parse_poll_interval(
 	if (command->dst != STK_DEVICE_IDENTITY_TYPE_TERMINAL)
 		return STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
 
-	return parse_dataobj(iter, STK_DATA_OBJECT_TYPE_DURATION,
+	return parse_dataobj(iter, &command->arena,
+				STK_DATA_OBJECT_TYPE_DURATION,
 				DATAOBJ_FLAG_MANDATORY | DATAOBJ_FLAG_MINIMUM,
 				&obj->duration,
 				STK_DATA_OBJECT_TYPE_INVALID);
 }
 
-static void destroy_setup_menu(struct stk_command *command)
-{
-	g_free(command->setup_menu.alpha_id);
-	g_slist_free_full(command->setup_menu.items, destroy_stk_item);
-}
-
 static enum stk_command_parse_result parse_setup_menu(
 					struct stk_command *command,
 					struct comprehension_tlv_iter *iter)
@@ -2638,9 +2743,7 @@ static enum stk_command_parse_result parse_setup_menu(
 	if (command->dst != STK_DEVICE_IDENTITY_TYPE_TERMINAL)
 		return STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
 
-	command->destructor = destroy_setup_menu;
-
-	status = parse_dataobj(iter,
+	status = parse_dataobj(iter, &command->arena,
 			STK_DATA_OBJECT_TYPE_ALPHA_ID,
 			DATAOBJ_FLAG_MANDATORY | DATAOBJ_FLAG_MINIMUM,
 			&obj->alpha_id,
@@ -2664,12 +2767,6 @@ static enum stk_command_parse_result parse_setup_menu(
 	return status;
 }
 
-static void destroy_select_item(struct stk_command *command)
-{
-	g_free(command->select_item.alpha_id);
-	g_slist_free_full(command->select_item.items, destroy_stk_item);
-}
-
 static enum stk_command_parse_result parse_select_item(
 					struct stk_command *command,
 					struct comprehension_tlv_iter *iter)
@@ -2683,7 +2780,7 @@ static enum stk_command_parse_result parse_select_item(
 	if (command->dst != STK_DEVICE_IDENTITY_TYPE_TERMINAL)
 		return STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
 
-	status = parse_dataobj(iter,
+	status = parse_dataobj(iter, &command->arena,
 			STK_DATA_OBJECT_TYPE_ALPHA_ID, 0,
 			&obj->alpha_id,
 			STK_DATA_OBJECT_TYPE_ITEM,
@@ -2705,8 +2802,6 @@ static enum stk_command_parse_result parse_select_item(
 			&obj->frame_id,
 			STK_DATA_OBJECT_TYPE_INVALID);
 
-	command->destructor = destroy_select_item;
-
 	if (status == STK_PARSE_RESULT_OK && obj->items == NULL)
 		status = STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
 
@@ -2715,12 +2810,6 @@ static enum stk_command_parse_result parse_select_item(
 	return status;
 }
 
-static void destroy_send_sms(struct stk_command *command)
-{
-	g_free(command->send_sms.alpha_id);
-	g_free(command->send_sms.cdma_sms.array);
-}
-
 static enum stk_command_parse_result parse_send_sms(
 					struct stk_command *command,
 					struct comprehension_tlv_iter *iter)
@@ -2737,7 +2826,8 @@ static enum stk_command_parse_result parse_send_sms(
 		return STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
 
 	memset(&gsm_tpdu, 0, sizeof(gsm_tpdu));
-	status = parse_dataobj(iter, STK_DATA_OBJECT_TYPE_ALPHA_ID, 0,
+	status = parse_dataobj(iter, &command->arena,
+				STK_DATA_OBJECT_TYPE_ALPHA_ID, 0,
 				&obj->alpha_id,
 				STK_DATA_OBJECT_TYPE_ADDRESS, 0,
 				&sc_address,
@@ -2753,8 +2843,6 @@ static enum stk_command_parse_result parse_send_sms(
 				&obj->frame_id,
 				STK_DATA_OBJECT_TYPE_INVALID);
 
-	command->destructor = destroy_send_sms;
-
 	if (status != STK_PARSE_RESULT_OK)
 		goto out;
 
@@ -2815,17 +2903,9 @@ set_addr:
 	obj->gsm_sms.sc_addr.number_type = (sc_address.ton_npi >> 4) & 7;
 
 out:
-	g_free(sc_address.number);
-
 	return status;
 }
 
-static void destroy_send_ss(struct stk_command *command)
-{
-	g_free(command->send_ss.alpha_id);
-	g_free(command->send_ss.ss.ss);
-}
-
 static enum stk_command_parse_result parse_send_ss(struct stk_command *command,
 					struct comprehension_tlv_iter *iter)
 {
@@ -2837,9 +2917,8 @@ static enum stk_command_parse_result parse_send_ss(struct stk_command *command,
 	if (command->dst != STK_DEVICE_IDENTITY_TYPE_NETWORK)
 		return STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
 
-	command->destructor = destroy_send_ss;
-
-	return parse_dataobj(iter, STK_DATA_OBJECT_TYPE_ALPHA_ID, 0,
+	return parse_dataobj(iter, &command->arena,
+				STK_DATA_OBJECT_TYPE_ALPHA_ID, 0,
 				&obj->alpha_id,
 				STK_DATA_OBJECT_TYPE_SS_STRING,
 				DATAOBJ_FLAG_MANDATORY | DATAOBJ_FLAG_MINIMUM,
@@ -2853,11 +2932,6 @@ static enum stk_command_parse_result parse_send_ss(struct stk_command *command,
 				STK_DATA_OBJECT_TYPE_INVALID);
 }
 
-static void destroy_send_ussd(struct stk_command *command)
-{
-	g_free(command->send_ussd.alpha_id);
-}
-
 static enum stk_command_parse_result parse_send_ussd(
 					struct stk_command *command,
 					struct comprehension_tlv_iter *iter)
@@ -2870,9 +2944,8 @@ static enum stk_command_parse_result parse_send_ussd(
 	if (command->dst != STK_DEVICE_IDENTITY_TYPE_NETWORK)
 		return STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
 
-	command->destructor = destroy_send_ussd;
-
-	return parse_dataobj(iter, STK_DATA_OBJECT_TYPE_ALPHA_ID, 0,
+	return parse_dataobj(iter, &command->arena,
+				STK_DATA_OBJECT_TYPE_ALPHA_ID, 0,
 				&obj->alpha_id,
 				STK_DATA_OBJECT_TYPE_USSD_STRING,
 				DATAOBJ_FLAG_MANDATORY | DATAOBJ_FLAG_MINIMUM,
@@ -2886,13 +2959,6 @@ static enum stk_command_parse_result parse_send_ussd(
 				STK_DATA_OBJECT_TYPE_INVALID);
 }
 
-static void destroy_setup_call(struct stk_command *command)
-{
-	g_free(command->setup_call.alpha_id_usr_cfm);
-	g_free(command->setup_call.addr.number);
-	g_free(command->setup_call.alpha_id_call_setup);
-}
-
 static enum stk_command_parse_result parse_setup_call(
 					struct stk_command *command,
 					struct comprehension_tlv_iter *iter)
@@ -2906,9 +2972,8 @@ static enum stk_command_parse_result parse_setup_call(
 	if (command->dst != STK_DEVICE_IDENTITY_TYPE_NETWORK)
 		return STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
 
-	command->destructor = destroy_setup_call;
-
-	status = parse_dataobj(iter, STK_DATA_OBJECT_TYPE_ALPHA_ID, 0,
+	status = parse_dataobj(iter, &command->arena,
+				STK_DATA_OBJECT_TYPE_ALPHA_ID, 0,
 				&obj->alpha_id_usr_cfm,
 				STK_DATA_OBJECT_TYPE_ADDRESS,
 				DATAOBJ_FLAG_MANDATORY | DATAOBJ_FLAG_MINIMUM,
@@ -2940,12 +3005,6 @@ static enum stk_command_parse_result parse_setup_call(
 	return status;
 }
 
-static void destroy_refresh(struct stk_command *command)
-{
-	g_slist_free_full(command->refresh.file_list, g_free);
-	g_free(command->refresh.alpha_id);
-}
-
 static enum stk_command_parse_result parse_refresh(
 					struct stk_command *command,
 					struct comprehension_tlv_iter *iter)
@@ -2959,9 +3018,8 @@ static enum stk_command_parse_result parse_refresh(
 	if (command->dst != STK_DEVICE_IDENTITY_TYPE_TERMINAL)
 		return STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
 
-	command->destructor = destroy_refresh;
-
-	status = parse_dataobj(iter, STK_DATA_OBJECT_TYPE_FILE_LIST, 0,
+	status = parse_dataobj(iter, &command->arena,
+				STK_DATA_OBJECT_TYPE_FILE_LIST, 0,
 				&obj->file_list,
 				STK_DATA_OBJECT_TYPE_AID, 0,
 				&obj->aid,
@@ -3018,7 +3076,8 @@ static enum stk_command_parse_result parse_setup_event_list(
 	if (command->dst != STK_DEVICE_IDENTITY_TYPE_TERMINAL)
 		return STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
 
-	return parse_dataobj(iter, STK_DATA_OBJECT_TYPE_EVENT_LIST,
+	return parse_dataobj(iter, &command->arena,
+				STK_DATA_OBJECT_TYPE_EVENT_LIST,
 				DATAOBJ_FLAG_MANDATORY | DATAOBJ_FLAG_MINIMUM,
 				&obj->event_list,
 				STK_DATA_OBJECT_TYPE_INVALID);
@@ -3037,7 +3096,8 @@ static enum stk_command_parse_result parse_perform_card_apdu(
 			(command->dst > STK_DEVICE_IDENTITY_TYPE_CARD_READER_7))
 		return STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
 
-	return parse_dataobj(iter, STK_DATA_OBJECT_TYPE_C_APDU,
+	return parse_dataobj(iter, &command->arena,
+				STK_DATA_OBJECT_TYPE_C_APDU,
 				DATAOBJ_FLAG_MANDATORY | DATAOBJ_FLAG_MINIMUM,
 				&obj->c_apdu,
 				STK_DATA_OBJECT_TYPE_INVALID);
@@ -3112,7 +3172,8 @@ static enum stk_command_parse_result parse_timer_mgmt(
 	if ((command->qualifier & 3) == 0) /* Start a timer */
 		value_flags = DATAOBJ_FLAG_MANDATORY;
 
-	return parse_dataobj(iter, STK_DATA_OBJECT_TYPE_TIMER_ID,
+	return parse_dataobj(iter, &command->arena,
+				STK_DATA_OBJECT_TYPE_TIMER_ID,
 				DATAOBJ_FLAG_MANDATORY | DATAOBJ_FLAG_MINIMUM,
 				&obj->timer_id,
 				STK_DATA_OBJECT_TYPE_TIMER_VALUE, value_flags,
@@ -3120,11 +3181,6 @@ static enum stk_command_parse_result parse_timer_mgmt(
 				STK_DATA_OBJECT_TYPE_INVALID);
 }
 
-static void destroy_setup_idle_mode_text(struct stk_command *command)
-{
-	g_free(command->setup_idle_mode_text.text);
-}
-
 static enum stk_command_parse_result parse_setup_idle_mode_text(
 					struct stk_command *command,
 					struct comprehension_tlv_iter *iter)
@@ -3139,9 +3195,8 @@ static enum stk_command_parse_result parse_setup_idle_mode_text(
 	if (command->dst != STK_DEVICE_IDENTITY_TYPE_TERMINAL)
 		return STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
 
-	command->destructor = destroy_setup_idle_mode_text;
-
-	status = parse_dataobj(iter, STK_DATA_OBJECT_TYPE_TEXT,
+	status = parse_dataobj(iter, &command->arena,
+				STK_DATA_OBJECT_TYPE_TEXT,
 				DATAOBJ_FLAG_MANDATORY | DATAOBJ_FLAG_MINIMUM,
 				&obj->text,
 				STK_DATA_OBJECT_TYPE_ICON_ID, 0,
@@ -3157,12 +3212,6 @@ static enum stk_command_parse_result parse_setup_idle_mode_text(
 	return status;
 }
 
-static void destroy_run_at_command(struct stk_command *command)
-{
-	g_free(command->run_at_command.alpha_id);
-	g_free(command->run_at_command.at_command);
-}
-
 static enum stk_command_parse_result parse_run_at_command(
 					struct stk_command *command,
 					struct comprehension_tlv_iter *iter)
@@ -3176,9 +3225,8 @@ static enum stk_command_parse_result parse_run_at_command(
 	if (command->dst != STK_DEVICE_IDENTITY_TYPE_TERMINAL)
 		return STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
 
-	command->destructor = destroy_run_at_command;
-
-	status = parse_dataobj(iter, STK_DATA_OBJECT_TYPE_ALPHA_ID, 0,
+	status = parse_dataobj(iter, &command->arena,
+				STK_DATA_OBJECT_TYPE_ALPHA_ID, 0,
 				&obj->alpha_id,
 				STK_DATA_OBJECT_TYPE_AT_COMMAND,
 				DATAOBJ_FLAG_MANDATORY | DATAOBJ_FLAG_MINIMUM,
@@ -3196,12 +3244,6 @@ static enum stk_command_parse_result parse_run_at_command(
 	return status;
 }
 
-static void destroy_send_dtmf(struct stk_command *command)
-{
-	g_free(command->send_dtmf.alpha_id);
-	g_free(command->send_dtmf.dtmf);
-}
-
 static enum stk_command_parse_result parse_send_dtmf(
 					struct stk_command *command,
 					struct comprehension_tlv_iter *iter)
@@ -3215,9 +3257,8 @@ static enum stk_command_parse_result parse_send_dtmf(
 	if (command->dst != STK_DEVICE_IDENTITY_TYPE_NETWORK)
 		return STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
 
-	command->destructor = destroy_send_dtmf;
-
-	status = parse_dataobj(iter, STK_DATA_OBJECT_TYPE_ALPHA_ID, 0,
+	status = parse_dataobj(iter, &command->arena,
+				STK_DATA_OBJECT_TYPE_ALPHA_ID, 0,
 				&obj->alpha_id,
 				STK_DATA_OBJECT_TYPE_DTMF_STRING,
 				DATAOBJ_FLAG_MANDATORY | DATAOBJ_FLAG_MINIMUM,
@@ -3248,23 +3289,12 @@ static enum stk_command_parse_result parse_language_notification(
 	if (command->dst != STK_DEVICE_IDENTITY_TYPE_TERMINAL)
 		return STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
 
-	return parse_dataobj(iter, STK_DATA_OBJECT_TYPE_LANGUAGE, 0,
+	return parse_dataobj(iter, &command->arena,
+				STK_DATA_OBJECT_TYPE_LANGUAGE, 0,
 				&obj->language,
 				STK_DATA_OBJECT_TYPE_INVALID);
 }
 
-static void destroy_launch_browser(struct stk_command *command)
-{
-	g_free(command->launch_browser.url);
-	g_free(command->launch_browser.bearer.array);
-	g_slist_free_full(command->launch_browser.prov_file_refs, g_free);
-	g_free(command->launch_browser.text_gateway_proxy_id);
-	g_free(command->launch_browser.alpha_id);
-	g_free(command->launch_browser.network_name.array);
-	g_free(command->launch_browser.text_usr);
-	g_free(command->launch_browser.text_passwd);
-}
-
 static enum stk_command_parse_result parse_launch_browser(
 					struct stk_command *command,
 					struct comprehension_tlv_iter *iter)
@@ -3280,9 +3310,7 @@ static enum stk_command_parse_result parse_launch_browser(
 	if (command->dst != STK_DEVICE_IDENTITY_TYPE_TERMINAL)
 		return STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
 
-	command->destructor = destroy_launch_browser;
-
-	return parse_dataobj(iter,
+	return parse_dataobj(iter, &command->arena,
 				STK_DATA_OBJECT_TYPE_BROWSER_ID, 0,
 				&obj->browser_id,
 				STK_DATA_OBJECT_TYPE_URL,
@@ -3312,14 +3340,6 @@ static enum stk_command_parse_result parse_launch_browser(
 				STK_DATA_OBJECT_TYPE_INVALID);
 }
 
-static void destroy_open_channel(struct stk_command *command)
-{
-	g_free(command->open_channel.alpha_id);
-	g_free(command->open_channel.apn);
-	g_free(command->open_channel.text_usr);
-	g_free(command->open_channel.text_passwd);
-}
-
 static enum stk_command_parse_result parse_open_channel(
 					struct stk_command *command,
 					struct comprehension_tlv_iter *iter)
@@ -3336,13 +3356,11 @@ static enum stk_command_parse_result parse_open_channel(
 	if (command->dst != STK_DEVICE_IDENTITY_TYPE_TERMINAL)
 		return STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
 
-	command->destructor = destroy_open_channel;
-
 	/*
 	 * parse the Open Channel data objects related to packet data service
 	 * bearer
 	 */
-	status = parse_dataobj(iter,
+	status = parse_dataobj(iter, &command->arena,
 				STK_DATA_OBJECT_TYPE_ALPHA_ID, 0,
 				&obj->alpha_id,
 				STK_DATA_OBJECT_TYPE_ICON_ID, 0,
@@ -3376,11 +3394,6 @@ static enum stk_command_parse_result parse_open_channel(
 	return status;
 }
 
-static void destroy_close_channel(struct stk_command *command)
-{
-	g_free(command->close_channel.alpha_id);
-}
-
 static enum stk_command_parse_result parse_close_channel(
 					struct stk_command *command,
 					struct comprehension_tlv_iter *iter)
@@ -3395,9 +3408,8 @@ static enum stk_command_parse_result parse_close_channel(
 			(command->dst > STK_DEVICE_IDENTITY_TYPE_CHANNEL_7))
 		return STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
 
-	command->destructor = destroy_close_channel;
-
-	status = parse_dataobj(iter, STK_DATA_OBJECT_TYPE_ALPHA_ID, 0,
+	status = parse_dataobj(iter, &command->arena,
+				STK_DATA_OBJECT_TYPE_ALPHA_ID, 0,
 				&obj->alpha_id,
 				STK_DATA_OBJECT_TYPE_ICON_ID, 0,
 				&obj->icon_id,
@@ -3412,11 +3424,6 @@ static enum stk_command_parse_result parse_close_channel(
 	return status;
 }
 
-static void destroy_receive_data(struct stk_command *command)
-{
-	g_free(command->receive_data.alpha_id);
-}
-
 static enum stk_command_parse_result parse_receive_data(
 					struct stk_command *command,
 					struct comprehension_tlv_iter *iter)
@@ -3431,9 +3438,8 @@ static enum stk_command_parse_result parse_receive_data(
 			(command->dst > STK_DEVICE_IDENTITY_TYPE_CHANNEL_7))
 		return STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
 
-	command->destructor = destroy_receive_data;
-
-	status = parse_dataobj(iter, STK_DATA_OBJECT_TYPE_ALPHA_ID, 0,
+	status = parse_dataobj(iter, &command->arena,
+				STK_DATA_OBJECT_TYPE_ALPHA_ID, 0,
 				&obj->alpha_id,
 				STK_DATA_OBJECT_TYPE_ICON_ID, 0,
 				&obj->icon_id,
@@ -3451,12 +3457,6 @@ static enum stk_command_parse_result parse_receive_data(
 	return status;
 }
 
-static void destroy_send_data(struct stk_command *command)
-{
-	g_free(command->send_data.alpha_id);
-	g_free(command->send_data.data.array);
-}
-
 static enum stk_command_parse_result parse_send_data(
 					struct stk_command *command,
 					struct comprehension_tlv_iter *iter)
@@ -3474,9 +3474,8 @@ static enum stk_command_parse_result parse_send_data(
 			(command->dst > STK_DEVICE_IDENTITY_TYPE_CHANNEL_7))
 		return STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
 
-	command->destructor = destroy_send_data;
-
-	status = parse_dataobj(iter, STK_DATA_OBJECT_TYPE_ALPHA_ID, 0,
+	status = parse_dataobj(iter, &command->arena,
+				STK_DATA_OBJECT_TYPE_ALPHA_ID, 0,
 				&obj->alpha_id,
 				STK_DATA_OBJECT_TYPE_ICON_ID, 0,
 				&obj->icon_id,
@@ -3507,13 +3506,6 @@ static enum stk_command_parse_result parse_get_channel_status(
 	return STK_PARSE_RESULT_OK;
 }
 
-static void destroy_service_search(struct stk_command *command)
-{
-	g_free(command->service_search.alpha_id);
-	g_free(command->service_search.serv_search.ser_search);
-	g_free(command->service_search.dev_filter.dev_filter);
-}
-
 static enum stk_command_parse_result parse_service_search(
 					struct stk_command *command,
 					struct comprehension_tlv_iter *iter)
@@ -3526,9 +3518,8 @@ static enum stk_command_parse_result parse_service_search(
 	if (command->dst != STK_DEVICE_IDENTITY_TYPE_TERMINAL)
 		return STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
 
-	command->destructor = destroy_service_search;
-
-	return parse_dataobj(iter, STK_DATA_OBJECT_TYPE_ALPHA_ID, 0,
+	return parse_dataobj(iter, &command->arena,
+				STK_DATA_OBJECT_TYPE_ALPHA_ID, 0,
 				&obj->alpha_id,
 				STK_DATA_OBJECT_TYPE_ICON_ID, 0,
 				&obj->icon_id,
@@ -3544,12 +3535,6 @@ static enum stk_command_parse_result parse_service_search(
 				STK_DATA_OBJECT_TYPE_INVALID);
 }
 
-static void destroy_get_service_info(struct stk_command *command)
-{
-	g_free(command->get_service_info.alpha_id);
-	g_free(command->get_service_info.attr_info.attr_info);
-}
-
 static enum stk_command_parse_result parse_get_service_info(
 					struct stk_command *command,
 					struct comprehension_tlv_iter *iter)
@@ -3562,9 +3547,8 @@ static enum stk_command_parse_result parse_get_service_info(
 	if (command->dst != STK_DEVICE_IDENTITY_TYPE_TERMINAL)
 		return STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
 
-	command->destructor = destroy_get_service_info;
-
-	return parse_dataobj(iter, STK_DATA_OBJECT_TYPE_ALPHA_ID, 0,
+	return parse_dataobj(iter, &command->arena,
+				STK_DATA_OBJECT_TYPE_ALPHA_ID, 0,
 				&obj->alpha_id,
 				STK_DATA_OBJECT_TYPE_ICON_ID, 0,
 				&obj->icon_id,
@@ -3578,11 +3562,6 @@ static enum stk_command_parse_result parse_get_service_info(
 				STK_DATA_OBJECT_TYPE_INVALID);
 }
 
-static void destroy_declare_service(struct stk_command *command)
-{
-	g_free(command->declare_service.serv_rec.serv_rec);
-}
-
 static enum stk_command_parse_result parse_declare_service(
 					struct stk_command *command,
 					struct comprehension_tlv_iter *iter)
@@ -3595,9 +3574,8 @@ static enum stk_command_parse_result parse_declare_service(
 	if (command->dst != STK_DEVICE_IDENTITY_TYPE_TERMINAL)
 		return STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
 
-	command->destructor = destroy_declare_service;
-
-	return parse_dataobj(iter, STK_DATA_OBJECT_TYPE_SERVICE_RECORD,
+	return parse_dataobj(iter, &command->arena,
+				STK_DATA_OBJECT_TYPE_SERVICE_RECORD,
 				DATAOBJ_FLAG_MANDATORY | DATAOBJ_FLAG_MINIMUM,
 				&obj->serv_rec,
 				STK_DATA_OBJECT_TYPE_UICC_TE_INTERFACE, 0,
@@ -3617,7 +3595,8 @@ static enum stk_command_parse_result parse_set_frames(
 	if (command->dst != STK_DEVICE_IDENTITY_TYPE_TERMINAL)
 		return STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
 
-	return parse_dataobj(iter, STK_DATA_OBJECT_TYPE_FRAME_ID,
+	return parse_dataobj(iter, &command->arena,
+				STK_DATA_OBJECT_TYPE_FRAME_ID,
 				DATAOBJ_FLAG_MANDATORY | DATAOBJ_FLAG_MINIMUM,
 				&obj->frame_id,
 				STK_DATA_OBJECT_TYPE_FRAME_LAYOUT, 0,
@@ -3640,12 +3619,6 @@ static enum stk_command_parse_result parse_get_frames_status(
 	return STK_PARSE_RESULT_OK;
 }
 
-static void destroy_retrieve_mms(struct stk_command *command)
-{
-	g_free(command->retrieve_mms.alpha_id);
-	g_slist_free_full(command->retrieve_mms.mms_rec_files, g_free);
-}
-
 static enum stk_command_parse_result parse_retrieve_mms(
 					struct stk_command *command,
 					struct comprehension_tlv_iter *iter)
@@ -3659,9 +3632,8 @@ static enum stk_command_parse_result parse_retrieve_mms(
 	if (command->dst != STK_DEVICE_IDENTITY_TYPE_NETWORK)
 		return STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
 
-	command->destructor = destroy_retrieve_mms;
-
-	status = parse_dataobj(iter, STK_DATA_OBJECT_TYPE_ALPHA_ID, 0,
+	status = parse_dataobj(iter, &command->arena,
+				STK_DATA_OBJECT_TYPE_ALPHA_ID, 0,
 				&obj->alpha_id,
 				STK_DATA_OBJECT_TYPE_ICON_ID, 0,
 				&obj->icon_id,
@@ -3687,12 +3659,6 @@ static enum stk_command_parse_result parse_retrieve_mms(
 	return status;
 }
 
-static void destroy_submit_mms(struct stk_command *command)
-{
-	g_free(command->submit_mms.alpha_id);
-	g_slist_free_full(command->submit_mms.mms_subm_files, g_free);
-}
-
 static enum stk_command_parse_result parse_submit_mms(
 					struct stk_command *command,
 					struct comprehension_tlv_iter *iter)
@@ -3706,9 +3672,8 @@ static enum stk_command_parse_result parse_submit_mms(
 	if (command->dst != STK_DEVICE_IDENTITY_TYPE_NETWORK)
 		return STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
 
-	command->destructor = destroy_submit_mms;
-
-	status = parse_dataobj(iter, STK_DATA_OBJECT_TYPE_ALPHA_ID, 0,
+	status = parse_dataobj(iter, &command->arena,
+				STK_DATA_OBJECT_TYPE_ALPHA_ID, 0,
 				&obj->alpha_id,
 				STK_DATA_OBJECT_TYPE_ICON_ID, 0,
 				&obj->icon_id,
@@ -3728,11 +3693,6 @@ static enum stk_command_parse_result parse_submit_mms(
 	return status;
 }
 
-static void destroy_display_mms(struct stk_command *command)
-{
-	g_slist_free_full(command->display_mms.mms_subm_files, g_free);
-}
-
 static enum stk_command_parse_result parse_display_mms(
 					struct stk_command *command,
 					struct comprehension_tlv_iter *iter)
@@ -3745,9 +3705,8 @@ static enum stk_command_parse_result parse_display_mms(
 	if (command->dst != STK_DEVICE_IDENTITY_TYPE_TERMINAL)
 		return STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
 
-	command->destructor = destroy_display_mms;
-
-	return parse_dataobj(iter, STK_DATA_OBJECT_TYPE_FILE_LIST,
+	return parse_dataobj(iter, &command->arena,
+				STK_DATA_OBJECT_TYPE_FILE_LIST,
 				DATAOBJ_FLAG_MANDATORY | DATAOBJ_FLAG_MINIMUM,
 				&obj->mms_subm_files,
 				STK_DATA_OBJECT_TYPE_MMS_ID,
@@ -3772,7 +3731,8 @@ static enum stk_command_parse_result parse_activate(
 	if (command->dst != STK_DEVICE_IDENTITY_TYPE_TERMINAL)
 		return STK_PARSE_RESULT_DATA_NOT_UNDERSTOOD;
 
-	return parse_dataobj(iter, STK_DATA_OBJECT_TYPE_ACTIVATE_DESCRIPTOR,
+	return parse_dataobj(iter, &command->arena,
+				STK_DATA_OBJECT_TYPE_ACTIVATE_DESCRIPTOR,
 				DATAOBJ_FLAG_MANDATORY | DATAOBJ_FLAG_MINIMUM,
 				&obj->actv_desc,
 				STK_DATA_OBJECT_TYPE_INVALID);
@@ -3938,9 +3898,7 @@ out:
 
 void stk_command_free(struct stk_command *command)
 {
-	if (command->destructor)
-		command->destructor(command);
-
+	arena_free(command->arena);
 	g_free(command);
 }
 
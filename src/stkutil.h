@@ -1447,7 +1447,7 @@ struct stk_command {
 		struct stk_command_activate activate;
 	};
 
-	void (*destructor)(struct stk_command *command);
+	struct stk_arena_block *arena;
 };
 
 /* TERMINAL RESPONSEs defined in TS 102.223 Section 6.8 */
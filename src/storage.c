@@ -159,6 +159,173 @@ error_create_dirs:
 	return r;
 }
 
+/*
+ * Settings stores are not written out on every storage_sync() call.
+ * Instead the store is marked dirty and all dirty stores, across all
+ * modems, are written out together once per STORAGE_SYNC_INTERVAL
+ * seconds.  The key files are serialized on the main loop, while the
+ * actual file I/O is done by a writer thread so that slow storage does
+ * not delay D-Bus replies.  storage_close() queues any pending changes
+ * immediately and storage_flush() waits until everything is on disk.
+ */
+#define STORAGE_SYNC_INTERVAL 5
+
+struct storage_pending {
+	char *path;
+	GKeyFile *keyfile;
+};
+
+struct storage_job {
+	char *path;
+	char *data;
+	gsize length;
+};
+
+static GHashTable *pending_syncs;
+static guint sync_source;
+
+static GThread *writer_thread;
+static GMutex writer_lock;
+static GCond writer_cond;
+static GQueue writer_jobs = G_QUEUE_INIT;
+static gboolean writer_busy;
+static gboolean writer_exit;
+
+static char *storage_path(const char *imsi, const char *store)
+{
+	if (imsi)
+		return g_strdup_printf(STORAGEDIR "/%s/%s", imsi, store);
+
+	return g_strdup_printf(STORAGEDIR "/%s", store);
+}
+
+static void storage_write(const char *path, const char *data, gsize length)
+{
+	char *old_data;
+	gsize old_length;
+
+	if (create_dirs(path, S_IRUSR | S_IWUSR | S_IXUSR) != 0)
+		return;
+
+	/* Avoid rewriting the file if nothing actually changed */
+	if (g_file_get_contents(path, &old_data, &old_length, NULL)) {
+		gboolean same = old_length == length &&
+					memcmp(old_data, data, length) == 0;
+
+		g_free(old_data);
+
+		if (same)
+			return;
+	}
+
+	g_file_set_contents(path, data, length, NULL);
+}
+
+static gpointer storage_writer(gpointer user_data)
+{
+	struct storage_job *job;
+
+	g_mutex_lock(&writer_lock);
+
+	while (TRUE) {
+		while (writer_jobs.length == 0 && !writer_exit)
+			g_cond_wait(&writer_cond, &writer_lock);
+
+		job = g_queue_pop_head(&writer_jobs);
+		if (job == NULL)
+			break;
+
+		writer_busy = TRUE;
+		g_mutex_unlock(&writer_lock);
+
+		storage_write(job->path, job->data, job->length);
+
+		g_free(job->data);
+		g_free(job->path);
+		g_free(job);
+
+		g_mutex_lock(&writer_lock);
+		writer_busy = FALSE;
+		g_cond_broadcast(&writer_cond);
+	}
+
+	g_mutex_unlock(&writer_lock);
+
+	return NULL;
+}
+
+static void storage_writer_wait(void)
+{
+	if (writer_thread == NULL)
+		return;
+
+	g_mutex_lock(&writer_lock);
+
+	while (writer_jobs.length > 0 || writer_busy)
+		g_cond_wait(&writer_cond, &writer_lock);
+
+	g_mutex_unlock(&writer_lock);
+}
+
+static void storage_submit(const char *path, GKeyFile *keyfile)
+{
+	struct storage_job *job;
+
+	job = g_new0(struct storage_job, 1);
+	job->path = g_strdup(path);
+	job->data = g_key_file_to_data(keyfile, &job->length, NULL);
+
+	if (writer_thread == NULL) {
+		storage_write(job->path, job->data, job->length);
+
+		g_free(job->data);
+		g_free(job->path);
+		g_free(job);
+		return;
+	}
+
+	g_mutex_lock(&writer_lock);
+	g_queue_push_tail(&writer_jobs, job);
+	g_cond_broadcast(&writer_cond);
+	g_mutex_unlock(&writer_lock);
+}
+
+static void storage_pending_free(gpointer user_data)
+{
+	struct storage_pending *pending = user_data;
+
+	g_free(pending->path);
+	g_free(pending);
+}
+
+static void storage_submit_pending(void)
+{
+	GHashTableIter iter;
+	gpointer value;
+
+	if (pending_syncs == NULL)
+		return;
+
+	g_hash_table_iter_init(&iter, pending_syncs);
+
+	while (g_hash_table_iter_next(&iter, NULL, &value)) {
+		struct storage_pending *pending = value;
+
+		storage_submit(pending->path, pending->keyfile);
+	}
+
+	g_hash_table_remove_all(pending_syncs);
+}
+
+static gboolean storage_sync_timeout(gpointer user_data)
+{
+	sync_source = 0;
+
+	storage_submit_pending();
+
+	return FALSE;
+}
+
 GKeyFile *storage_open(const char *imsi, const char *store)
 {
 	GKeyFile *keyfile;
@@ -167,10 +334,10 @@ GKeyFile *storage_open(const char *imsi, const char *store)
 	if (store == NULL)
 		return NULL;
 
-	if (imsi)
-		path = g_strdup_printf(STORAGEDIR "/%s/%s", imsi, store);
-	else
-		path = g_strdup_printf(STORAGEDIR "/%s", store);
+	/* Make sure a previously closed store has hit the disk */
+	storage_writer_wait();
+
+	path = storage_path(imsi, store);
 
 	keyfile = g_key_file_new();
 
@@ -184,36 +351,76 @@ GKeyFile *storage_open(const char *imsi, const char *store)
 
 void storage_sync(const char *imsi, const char *store, GKeyFile *keyfile)
 {
-	char *path;
-	char *data;
-	gsize length = 0;
+	struct storage_pending *pending;
 
-	if (imsi)
-		path = g_strdup_printf(STORAGEDIR "/%s/%s", imsi, store);
-	else
-		path = g_strdup_printf(STORAGEDIR "/%s", store);
+	if (pending_syncs == NULL)
+		pending_syncs = g_hash_table_new_full(g_direct_hash,
+							g_direct_equal, NULL,
+							storage_pending_free);
 
-	if (path == NULL)
-		return;
+	if (g_hash_table_lookup(pending_syncs, keyfile) == NULL) {
+		pending = g_new0(struct storage_pending, 1);
+		pending->path = storage_path(imsi, store);
+		pending->keyfile = keyfile;
 
-	if (create_dirs(path, S_IRUSR | S_IWUSR | S_IXUSR) != 0) {
-		g_free(path);
-		return;
+		g_hash_table_insert(pending_syncs, keyfile, pending);
 	}
 
-	data = g_key_file_to_data(keyfile, &length, NULL);
-
-	g_file_set_contents(path, data, length, NULL);
-
-	g_free(data);
-	g_free(path);
+	if (sync_source == 0)
+		sync_source = g_timeout_add_seconds(STORAGE_SYNC_INTERVAL,
+							storage_sync_timeout,
+							NULL);
 }
 
 void storage_close(const char *imsi, const char *store, GKeyFile *keyfile,
 			gboolean save)
 {
-	if (save == TRUE)
-		storage_sync(imsi, store, keyfile);
+	if (pending_syncs && g_hash_table_remove(pending_syncs, keyfile))
+		save = TRUE;
+
+	if (save == TRUE) {
+		char *path = storage_path(imsi, store);
+
+		storage_submit(path, keyfile);
+		g_free(path);
+	}
 
 	g_key_file_free(keyfile);
 }
+
+void storage_flush(void)
+{
+	if (sync_source) {
+		g_source_remove(sync_source);
+		sync_source = 0;
+	}
+
+	storage_submit_pending();
+	storage_writer_wait();
+}
+
+void __ofono_storage_init(void)
+{
+	writer_exit = FALSE;
+	writer_thread = g_thread_new("storage", storage_writer, NULL);
+}
+
+void __ofono_storage_cleanup(void)
+{
+	storage_flush();
+
+	if (writer_thread) {
+		g_mutex_lock(&writer_lock);
+		writer_exit = TRUE;
+		g_cond_broadcast(&writer_cond);
+		g_mutex_unlock(&writer_lock);
+
+		g_thread_join(writer_thread);
+		writer_thread = NULL;
+	}
+
+	if (pending_syncs) {
+		g_hash_table_destroy(pending_syncs);
+		pending_syncs = NULL;
+	}
+}
@@ -73,21 +73,27 @@ struct codepoint {
 	unsigned short to;
 };
 
+/*
+ * Unicode to GSM lookup table, indexed by the high byte of a BMP code point
+ * and then by its low byte.  Pages without any mapping all point to a
+ * single page filled with GUND, so a lookup never needs to branch.
+ */
+struct unicode_index {
+	const unsigned short *pages[256];
+};
+
 struct conversion_table {
-	/* To unicode locking shift table */
-	const struct codepoint *locking_u;
-	unsigned int locking_len_u;
+	/* To unicode locking shift table, fixed size */
+	const unsigned short *locking_g;
 
-	/* To unicode single shift table */
-	const struct codepoint *single_u;
-	unsigned int single_len_u;
+	/* To unicode single shift table, fixed size */
+	const unsigned short *single_g;
 
-	/* To GSM locking shift table, fixed size */
-	const unsigned short *locking_g;
+	/* To GSM locking shift table */
+	const struct unicode_index *locking_u;
 
 	/* To GSM single shift table */
-	const struct codepoint *single_g;
-	unsigned int single_len_g;
+	const struct unicode_index *single_u;
 };
 
 /* GSM to Unicode extension table, for GSM sequences starting with 0x1B */
@@ -288,6 +294,1652 @@ static const struct codepoint por_ext_unicode[] = {
 	{ 0x20AC, 0x1B65 }
 };
 
+/* Appendix A.2.4. in 3GPP TS23.038 V.9.1.1 */
+static const struct codepoint ben_ext_gsm[] = {
+	{ 0x00, 0x0040 },
+	{ 0x01, 0x00A3 },
+	{ 0x02, 0x0024 },
+	{ 0x03, 0x00A5 },
+	{ 0x04, 0x00BF },
+	{ 0x05, 0x0022 },
+	{ 0x06, 0x00A4 },
+	{ 0x07, 0x0025 },
+	{ 0x08, 0x0026 },
+	{ 0x09, 0x0027 },
+	{ 0x0A, 0x000C },		/* See NOTE 3 */
+	{ 0x0B, 0x002A },
+	{ 0x0C, 0x002B },
+	{ 0x0E, 0x002D },
+	{ 0x0F, 0x002F },
+	{ 0x10, 0x003C },
+	{ 0x11, 0x003D },
+	{ 0x12, 0x003E },
+	{ 0x13, 0x00A1 },
+	{ 0x14, 0x005E },
+	{ 0x15, 0x00A1 },
+	{ 0x16, 0x005F },
+	{ 0x17, 0x0023 },
+	{ 0x18, 0x002A },
+	{ 0x19, 0x09E6 },
+	{ 0x1A, 0x09E7 },
+	{ 0x1B, 0x0020 },		/* See NOTE 1 */
+	{ 0x1C, 0x09E8 },
+	{ 0x1D, 0x09E9 },
+	{ 0x1E, 0x09EA },
+	{ 0x1F, 0x09EB },
+	{ 0x20, 0x09EC },
+	{ 0x21, 0x09ED },
+	{ 0x22, 0x09EE },
+	{ 0x23, 0x09EF },
+	{ 0x24, 0x09DF },
+	{ 0x25, 0x09E0 },
+	{ 0x26, 0x09E1 },
+	{ 0x27, 0x09E2 },
+	{ 0x28, 0x007B },
+	{ 0x29, 0x007D },
+	{ 0x2A, 0x09E3 },
+	{ 0x2B, 0x09F2 },
+	{ 0x2C, 0x09F3 },
+	{ 0x2D, 0x09F4 },
+	{ 0x2E, 0x09F5 },
+	{ 0x2F, 0x005C },
+	{ 0x30, 0x09F6 },
+	{ 0x31, 0x09F7 },
+	{ 0x32, 0x09F8 },
+	{ 0x33, 0x09F9 },
+	{ 0x34, 0x09FA },
+	{ 0x3C, 0x005B },
+	{ 0x3D, 0x007E },
+	{ 0x3E, 0x005D },
+	{ 0x40, 0x007C },
+	{ 0x41, 0x0041 },
+	{ 0x42, 0x0042 },
+	{ 0x43, 0x0043 },
+	{ 0x44, 0x0044 },
+	{ 0x45, 0x0045 },
+	{ 0x46, 0x0046 },
+	{ 0x47, 0x0047 },
+	{ 0x48, 0x0048 },
+	{ 0x49, 0x0049 },
+	{ 0x4A, 0x004A },
+	{ 0x4B, 0x004B },
+	{ 0x4C, 0x004C },
+	{ 0x4D, 0x004D },
+	{ 0x4E, 0x004E },
+	{ 0x4F, 0x004F },
+	{ 0x50, 0x0050 },
+	{ 0x51, 0x0051 },
+	{ 0x52, 0x0052 },
+	{ 0x53, 0x0053 },
+	{ 0x54, 0x0054 },
+	{ 0x55, 0x0055 },
+	{ 0x56, 0x0056 },
+	{ 0x57, 0x0057 },
+	{ 0x58, 0x0058 },
+	{ 0x59, 0x0059 },
+	{ 0x5A, 0x005A },
+	{ 0x65, 0x20AC }
+};
+
+static const struct codepoint ben_ext_unicode[] = {
+	{ 0x000C, 0x1B0A },
+	{ 0x0022, 0x1B05 },
+	{ 0x0023, 0x1B17 },
+	{ 0x0024, 0x1B02 },
+	{ 0x0025, 0x1B07 },
+	{ 0x0026, 0x1B08 },
+	{ 0x0027, 0x1B09 },
+	{ 0x002A, 0x1B0B },
+	{ 0x002B, 0x1B0C },
+	{ 0x002D, 0x1B0E },
+	{ 0x002F, 0x1B0F },
+	{ 0x003C, 0x1B10 },
+	{ 0x003D, 0x1B11 },
+	{ 0x003E, 0x1B12 },
+	{ 0x0040, 0x1B00 },
+	{ 0x0041, 0x1B41 },
+	{ 0x0042, 0x1B42 },
+	{ 0x0043, 0x1B43 },
+	{ 0x0044, 0x1B44 },
+	{ 0x0045, 0x1B45 },
+	{ 0x0046, 0x1B46 },
+	{ 0x0047, 0x1B47 },
+	{ 0x0048, 0x1B48 },
+	{ 0x0049, 0x1B49 },
+	{ 0x004A, 0x1B4A },
+	{ 0x004B, 0x1B4B },
+	{ 0x004C, 0x1B4C },
+	{ 0x004D, 0x1B4D },
+	{ 0x004E, 0x1B4E },
+	{ 0x004F, 0x1B4F },
+	{ 0x0050, 0x1B50 },
+	{ 0x0051, 0x1B51 },
+	{ 0x0052, 0x1B52 },
+	{ 0x0053, 0x1B53 },
+	{ 0x0054, 0x1B54 },
+	{ 0x0055, 0x1B55 },
+	{ 0x0056, 0x1B56 },
+	{ 0x0057, 0x1B57 },
+	{ 0x0058, 0x1B58 },
+	{ 0x0059, 0x1B59 },
+	{ 0x005A, 0x1B5A },
+	{ 0x005B, 0x1B3C },
+	{ 0x005C, 0x1B2F },
+	{ 0x005D, 0x1B3E },
+	{ 0x005E, 0x1B14 },
+	{ 0x005F, 0x1B16 },
+	{ 0x007B, 0x1B28 },
+	{ 0x007C, 0x1B40 },
+	{ 0x007D, 0x1B29 },
+	{ 0x007E, 0x1B3D },
+	{ 0x00A1, 0x1B13 },
+	{ 0x00A3, 0x1B01 },
+	{ 0x00A4, 0x1B06 },
+	{ 0x00A5, 0x1B03 },
+	{ 0x00BF, 0x1B04 },
+	{ 0x09DF, 0x1B24 },
+	{ 0x09E0, 0x1B25 },
+	{ 0x09E1, 0x1B26 },
+	{ 0x09E2, 0x1B27 },
+	{ 0x09E3, 0x1B2A },
+	{ 0x09E6, 0x1B19 },
+	{ 0x09E7, 0x1B1A },
+	{ 0x09E8, 0x1B1C },
+	{ 0x09E9, 0x1B1D },
+	{ 0x09EA, 0x1B1E },
+	{ 0x09EB, 0x1B1F },
+	{ 0x09EC, 0x1B20 },
+	{ 0x09ED, 0x1B21 },
+	{ 0x09EE, 0x1B22 },
+	{ 0x09EF, 0x1B23 },
+	{ 0x09F2, 0x1B2B },
+	{ 0x09F3, 0x1B2C },
+	{ 0x09F4, 0x1B2D },
+	{ 0x09F5, 0x1B2E },
+	{ 0x09F6, 0x1B30 },
+	{ 0x09F7, 0x1B31 },
+	{ 0x09F8, 0x1B32 },
+	{ 0x09F9, 0x1B33 },
+	{ 0x09FA, 0x1B34 },
+	{ 0x20AC, 0x1B65 }
+};
+
+/* Appendix A.2.5. in 3GPP TS23.038 V.9.1.1 */
+static const struct codepoint guj_ext_gsm[] = {
+	{ 0x00, 0x0040 },
+	{ 0x01, 0x00A3 },
+	{ 0x02, 0x0024 },
+	{ 0x03, 0x00A5 },
+	{ 0x04, 0x00BF },
+	{ 0x05, 0x0022 },
+	{ 0x06, 0x00A4 },
+	{ 0x07, 0x0025 },
+	{ 0x08, 0x0026 },
+	{ 0x09, 0x0027 },
+	{ 0x0A, 0x000C },		/* See NOTE 3 */
+	{ 0x0B, 0x002A },
+	{ 0x0C, 0x002B },
+	{ 0x0E, 0x002D },
+	{ 0x0F, 0x002F },
+	{ 0x10, 0x003C },
+	{ 0x11, 0x003D },
+	{ 0x12, 0x003E },
+	{ 0x13, 0x00A1 },
+	{ 0x14, 0x005E },
+	{ 0x15, 0x00A1 },
+	{ 0x16, 0x005F },
+	{ 0x17, 0x0023 },
+	{ 0x18, 0x002A },
+	{ 0x19, 0x0964 },
+	{ 0x1A, 0x0965 },
+	{ 0x1B, 0x0020 },		/* See NOTE 1 */
+	{ 0x1C, 0x0AE6 },
+	{ 0x1D, 0x0AE7 },
+	{ 0x1E, 0x0AE8 },
+	{ 0x1F, 0x0AE9 },
+	{ 0x20, 0x0AEA },
+	{ 0x21, 0x0AEB },
+	{ 0x22, 0x0AEC },
+	{ 0x23, 0x0AED },
+	{ 0x24, 0x0AEE },
+	{ 0x25, 0x0AEF },
+	{ 0x28, 0x007B },
+	{ 0x29, 0x007D },
+	{ 0x2F, 0x005C },
+	{ 0x3C, 0x005B },
+	{ 0x3D, 0x007E },
+	{ 0x3E, 0x005D },
+	{ 0x40, 0x007C },
+	{ 0x41, 0x0041 },
+	{ 0x42, 0x0042 },
+	{ 0x43, 0x0043 },
+	{ 0x44, 0x0044 },
+	{ 0x45, 0x0045 },
+	{ 0x46, 0x0046 },
+	{ 0x47, 0x0047 },
+	{ 0x48, 0x0048 },
+	{ 0x49, 0x0049 },
+	{ 0x4A, 0x004A },
+	{ 0x4B, 0x004B },
+	{ 0x4C, 0x004C },
+	{ 0x4D, 0x004D },
+	{ 0x4E, 0x004E },
+	{ 0x4F, 0x004F },
+	{ 0x50, 0x0050 },
+	{ 0x51, 0x0051 },
+	{ 0x52, 0x0052 },
+	{ 0x53, 0x0053 },
+	{ 0x54, 0x0054 },
+	{ 0x55, 0x0055 },
+	{ 0x56, 0x0056 },
+	{ 0x57, 0x0057 },
+	{ 0x58, 0x0058 },
+	{ 0x59, 0x0059 },
+	{ 0x5A, 0x005A },
+	{ 0x65, 0x20AC }
+};
+
+static const struct codepoint guj_ext_unicode[] = {
+	{ 0x000C, 0x1B0A },
+	{ 0x0022, 0x1B05 },
+	{ 0x0023, 0x1B17 },
+	{ 0x0024, 0x1B02 },
+	{ 0x0025, 0x1B07 },
+	{ 0x0026, 0x1B08 },
+	{ 0x0027, 0x1B09 },
+	{ 0x002A, 0x1B0B },
+	{ 0x002B, 0x1B0C },
+	{ 0x002D, 0x1B0E },
+	{ 0x002F, 0x1B0F },
+	{ 0x003C, 0x1B10 },
+	{ 0x003D, 0x1B11 },
+	{ 0x003E, 0x1B12 },
+	{ 0x0040, 0x1B00 },
+	{ 0x0041, 0x1B41 },
+	{ 0x0042, 0x1B42 },
+	{ 0x0043, 0x1B43 },
+	{ 0x0044, 0x1B44 },
+	{ 0x0045, 0x1B45 },
+	{ 0x0046, 0x1B46 },
+	{ 0x0047, 0x1B47 },
+	{ 0x0048, 0x1B48 },
+	{ 0x0049, 0x1B49 },
+	{ 0x004A, 0x1B4A },
+	{ 0x004B, 0x1B4B },
+	{ 0x004C, 0x1B4C },
+	{ 0x004D, 0x1B4D },
+	{ 0x004E, 0x1B4E },
+	{ 0x004F, 0x1B4F },
+	{ 0x0050, 0x1B50 },
+	{ 0x0051, 0x1B51 },
+	{ 0x0052, 0x1B52 },
+	{ 0x0053, 0x1B53 },
+	{ 0x0054, 0x1B54 },
+	{ 0x0055, 0x1B55 },
+	{ 0x0056, 0x1B56 },
+	{ 0x0057, 0x1B57 },
+	{ 0x0058, 0x1B58 },
+	{ 0x0059, 0x1B59 },
+	{ 0x005A, 0x1B5A },
+	{ 0x005B, 0x1B3C },
+	{ 0x005C, 0x1B2F },
+	{ 0x005D, 0x1B3E },
+	{ 0x005E, 0x1B14 },
+	{ 0x005F, 0x1B16 },
+	{ 0x007B, 0x1B28 },
+	{ 0x007C, 0x1B40 },
+	{ 0x007D, 0x1B29 },
+	{ 0x007E, 0x1B3D },
+	{ 0x00A1, 0x1B13 },
+	{ 0x00A3, 0x1B01 },
+	{ 0x00A4, 0x1B06 },
+	{ 0x00A5, 0x1B03 },
+	{ 0x00BF, 0x1B04 },
+	{ 0x0964, 0x1B19 },
+	{ 0x0965, 0x1B1A },
+	{ 0x0AE6, 0x1B1C },
+	{ 0x0AE7, 0x1B1D },
+	{ 0x0AE8, 0x1B1E },
+	{ 0x0AE9, 0x1B1F },
+	{ 0x0AEA, 0x1B20 },
+	{ 0x0AEB, 0x1B21 },
+	{ 0x0AEC, 0x1B22 },
+	{ 0x0AED, 0x1B23 },
+	{ 0x0AEE, 0x1B24 },
+	{ 0x0AEF, 0x1B25 },
+	{ 0x20AC, 0x1B65 }
+};
+
+/* Appendix A.2.6. in 3GPP TS23.038 V.9.1.1 */
+static const struct codepoint hin_ext_gsm[] = {
+	{ 0x00, 0x0040 },
+	{ 0x01, 0x00A3 },
+	{ 0x02, 0x0024 },
+	{ 0x03, 0x00A5 },
+	{ 0x04, 0x00BF },
+	{ 0x05, 0x0022 },
+	{ 0x06, 0x00A4 },
+	{ 0x07, 0x0025 },
+	{ 0x08, 0x0026 },
+	{ 0x09, 0x0027 },
+	{ 0x0A, 0x000C },		/* See NOTE 3 */
+	{ 0x0B, 0x002A },
+	{ 0x0C, 0x002B },
+	{ 0x0E, 0x002D },
+	{ 0x0F, 0x002F },
+	{ 0x10, 0x003C },
+	{ 0x11, 0x003D },
+	{ 0x12, 0x003E },
+	{ 0x13, 0x00A1 },
+	{ 0x14, 0x005E },
+	{ 0x15, 0x00A1 },
+	{ 0x16, 0x005F },
+	{ 0x17, 0x0023 },
+	{ 0x18, 0x002A },
+	{ 0x19, 0x0964 },
+	{ 0x1A, 0x0965 },
+	{ 0x1B, 0x0020 },		/* See NOTE 1 */
+	{ 0x1C, 0x0966 },
+	{ 0x1D, 0x0967 },
+	{ 0x1E, 0x0968 },
+	{ 0x1F, 0x0969 },
+	{ 0x20, 0x096A },
+	{ 0x21, 0x096B },
+	{ 0x22, 0x096C },
+	{ 0x23, 0x096D },
+	{ 0x24, 0x096E },
+	{ 0x25, 0x096F },
+	{ 0x26, 0x0951 },
+	{ 0x27, 0x0952 },
+	{ 0x28, 0x007B },
+	{ 0x29, 0x007D },
+	{ 0x2A, 0x0953 },
+	{ 0x2B, 0x0954 },
+	{ 0x2C, 0x0958 },
+	{ 0x2D, 0x0959 },
+	{ 0x2E, 0x095A },
+	{ 0x2F, 0x005C },
+	{ 0x30, 0x095B },
+	{ 0x31, 0x095C },
+	{ 0x32, 0x095D },
+	{ 0x33, 0x095E },
+	{ 0x34, 0x095F },
+	{ 0x35, 0x0960 },
+	{ 0x36, 0x0961 },
+	{ 0x37, 0x0962 },
+	{ 0x38, 0x0963 },
+	{ 0x39, 0x0970 },
+	{ 0x3A, 0x0971 },
+	{ 0x3C, 0x005B },
+	{ 0x3D, 0x007E },
+	{ 0x3E, 0x005D },
+	{ 0x40, 0x007C },
+	{ 0x41, 0x0041 },
+	{ 0x42, 0x0042 },
+	{ 0x43, 0x0043 },
+	{ 0x44, 0x0044 },
+	{ 0x45, 0x0045 },
+	{ 0x46, 0x0046 },
+	{ 0x47, 0x0047 },
+	{ 0x48, 0x0048 },
+	{ 0x49, 0x0049 },
+	{ 0x4A, 0x004A },
+	{ 0x4B, 0x004B },
+	{ 0x4C, 0x004C },
+	{ 0x4D, 0x004D },
+	{ 0x4E, 0x004E },
+	{ 0x4F, 0x004F },
+	{ 0x50, 0x0050 },
+	{ 0x51, 0x0051 },
+	{ 0x52, 0x0052 },
+	{ 0x53, 0x0053 },
+	{ 0x54, 0x0054 },
+	{ 0x55, 0x0055 },
+	{ 0x56, 0x0056 },
+	{ 0x57, 0x0057 },
+	{ 0x58, 0x0058 },
+	{ 0x59, 0x0059 },
+	{ 0x5A, 0x005A },
+	{ 0x65, 0x20AC }
+};
+
+static const struct codepoint hin_ext_unicode[] = {
+	{ 0x000C, 0x1B0A },
+	{ 0x0022, 0x1B05 },
+	{ 0x0023, 0x1B17 },
+	{ 0x0024, 0x1B02 },
+	{ 0x0025, 0x1B07 },
+	{ 0x0026, 0x1B08 },
+	{ 0x0027, 0x1B09 },
+	{ 0x002A, 0x1B0B },
+	{ 0x002B, 0x1B0C },
+	{ 0x002D, 0x1B0E },
+	{ 0x002F, 0x1B0F },
+	{ 0x003C, 0x1B10 },
+	{ 0x003D, 0x1B11 },
+	{ 0x003E, 0x1B12 },
+	{ 0x0040, 0x1B00 },
+	{ 0x0041, 0x1B41 },
+	{ 0x0042, 0x1B42 },
+	{ 0x0043, 0x1B43 },
+	{ 0x0044, 0x1B44 },
+	{ 0x0045, 0x1B45 },
+	{ 0x0046, 0x1B46 },
+	{ 0x0047, 0x1B47 },
+	{ 0x0048, 0x1B48 },
+	{ 0x0049, 0x1B49 },
+	{ 0x004A, 0x1B4A },
+	{ 0x004B, 0x1B4B },
+	{ 0x004C, 0x1B4C },
+	{ 0x004D, 0x1B4D },
+	{ 0x004E, 0x1B4E },
+	{ 0x004F, 0x1B4F },
+	{ 0x0050, 0x1B50 },
+	{ 0x0051, 0x1B51 },
+	{ 0x0052, 0x1B52 },
+	{ 0x0053, 0x1B53 },
+	{ 0x0054, 0x1B54 },
+	{ 0x0055, 0x1B55 },
+	{ 0x0056, 0x1B56 },
+	{ 0x0057, 0x1B57 },
+	{ 0x0058, 0x1B58 },
+	{ 0x0059, 0x1B59 },
+	{ 0x005A, 0x1B5A },
+	{ 0x005B, 0x1B3C },
+	{ 0x005C, 0x1B2F },
+	{ 0x005D, 0x1B3E },
+	{ 0x005E, 0x1B14 },
+	{ 0x005F, 0x1B16 },
+	{ 0x007B, 0x1B28 },
+	{ 0x007C, 0x1B40 },
+	{ 0x007D, 0x1B29 },
+	{ 0x007E, 0x1B3D },
+	{ 0x00A1, 0x1B13 },
+	{ 0x00A3, 0x1B01 },
+	{ 0x00A4, 0x1B06 },
+	{ 0x00A5, 0x1B03 },
+	{ 0x00BF, 0x1B04 },
+	{ 0x0951, 0x1B26 },
+	{ 0x0952, 0x1B27 },
+	{ 0x0953, 0x1B2A },
+	{ 0x0954, 0x1B2B },
+	{ 0x0958, 0x1B2C },
+	{ 0x0959, 0x1B2D },
+	{ 0x095A, 0x1B2E },
+	{ 0x095B, 0x1B30 },
+	{ 0x095C, 0x1B31 },
+	{ 0x095D, 0x1B32 },
+	{ 0x095E, 0x1B33 },
+	{ 0x095F, 0x1B34 },
+	{ 0x0960, 0x1B35 },
+	{ 0x0961, 0x1B36 },
+	{ 0x0962, 0x1B37 },
+	{ 0x0963, 0x1B38 },
+	{ 0x0964, 0x1B19 },
+	{ 0x0965, 0x1B1A },
+	{ 0x0966, 0x1B1C },
+	{ 0x0967, 0x1B1D },
+	{ 0x0968, 0x1B1E },
+	{ 0x0969, 0x1B1F },
+	{ 0x096A, 0x1B20 },
+	{ 0x096B, 0x1B21 },
+	{ 0x096C, 0x1B22 },
+	{ 0x096D, 0x1B23 },
+	{ 0x096E, 0x1B24 },
+	{ 0x096F, 0x1B25 },
+	{ 0x0970, 0x1B39 },
+	{ 0x0971, 0x1B3A },
+	{ 0x20AC, 0x1B65 }
+};
+
+/* Appendix A.2.7. in 3GPP TS23.038 V.9.1.1 */
+static const struct codepoint kan_ext_gsm[] = {
+	{ 0x00, 0x0040 },
+	{ 0x01, 0x00A3 },
+	{ 0x02, 0x0024 },
+	{ 0x03, 0x00A5 },
+	{ 0x04, 0x00BF },
+	{ 0x05, 0x0022 },
+	{ 0x06, 0x00A4 },
+	{ 0x07, 0x0025 },
+	{ 0x08, 0x0026 },
+	{ 0x09, 0x0027 },
+	{ 0x0A, 0x000C },		/* See NOTE 3 */
+	{ 0x0B, 0x002A },
+	{ 0x0C, 0x002B },
+	{ 0x0E, 0x002D },
+	{ 0x0F, 0x002F },
+	{ 0x10, 0x003C },
+	{ 0x11, 0x003D },
+	{ 0x12, 0x003E },
+	{ 0x13, 0x00A1 },
+	{ 0x14, 0x005E },
+	{ 0x15, 0x00A1 },
+	{ 0x16, 0x005F },
+	{ 0x17, 0x0023 },
+	{ 0x18, 0x002A },
+	{ 0x19, 0x0964 },
+	{ 0x1A, 0x0965 },
+	{ 0x1B, 0x0020 },		/* See NOTE 1 */
+	{ 0x1C, 0x0CE6 },
+	{ 0x1D, 0x0CE7 },
+	{ 0x1E, 0x0CE8 },
+	{ 0x1F, 0x0CE9 },
+	{ 0x20, 0x0CEA },
+	{ 0x21, 0x0CEB },
+	{ 0x22, 0x0CEC },
+	{ 0x23, 0x0CED },
+	{ 0x24, 0x0CEE },
+	{ 0x25, 0x0CEF },
+	{ 0x26, 0x0CDE },
+	{ 0x27, 0x0CF1 },
+	{ 0x28, 0x007B },
+	{ 0x29, 0x007D },
+	{ 0x2A, 0x0CF2 },
+	{ 0x2F, 0x005C },
+	{ 0x3C, 0x005B },
+	{ 0x3D, 0x007E },
+	{ 0x3E, 0x005D },
+	{ 0x40, 0x007C },
+	{ 0x41, 0x0041 },
+	{ 0x42, 0x0042 },
+	{ 0x43, 0x0043 },
+	{ 0x44, 0x0044 },
+	{ 0x45, 0x0045 },
+	{ 0x46, 0x0046 },
+	{ 0x47, 0x0047 },
+	{ 0x48, 0x0048 },
+	{ 0x49, 0x0049 },
+	{ 0x4A, 0x004A },
+	{ 0x4B, 0x004B },
+	{ 0x4C, 0x004C },
+	{ 0x4D, 0x004D },
+	{ 0x4E, 0x004E },
+	{ 0x4F, 0x004F },
+	{ 0x50, 0x0050 },
+	{ 0x51, 0x0051 },
+	{ 0x52, 0x0052 },
+	{ 0x53, 0x0053 },
+	{ 0x54, 0x0054 },
+	{ 0x55, 0x0055 },
+	{ 0x56, 0x0056 },
+	{ 0x57, 0x0057 },
+	{ 0x58, 0x0058 },
+	{ 0x59, 0x0059 },
+	{ 0x5A, 0x005A },
+	{ 0x65, 0x20AC }
+};
+
+static const struct codepoint kan_ext_unicode[] = {
+	{ 0x000C, 0x1B0A },
+	{ 0x0022, 0x1B05 },
+	{ 0x0023, 0x1B17 },
+	{ 0x0024, 0x1B02 },
+	{ 0x0025, 0x1B07 },
+	{ 0x0026, 0x1B08 },
+	{ 0x0027, 0x1B09 },
+	{ 0x002A, 0x1B0B },
+	{ 0x002B, 0x1B0C },
+	{ 0x002D, 0x1B0E },
+	{ 0x002F, 0x1B0F },
+	{ 0x003C, 0x1B10 },
+	{ 0x003D, 0x1B11 },
+	{ 0x003E, 0x1B12 },
+	{ 0x0040, 0x1B00 },
+	{ 0x0041, 0x1B41 },
+	{ 0x0042, 0x1B42 },
+	{ 0x0043, 0x1B43 },
+	{ 0x0044, 0x1B44 },
+	{ 0x0045, 0x1B45 },
+	{ 0x0046, 0x1B46 },
+	{ 0x0047, 0x1B47 },
+	{ 0x0048, 0x1B48 },
+	{ 0x0049, 0x1B49 },
+	{ 0x004A, 0x1B4A },
+	{ 0x004B, 0x1B4B },
+	{ 0x004C, 0x1B4C },
+	{ 0x004D, 0x1B4D },
+	{ 0x004E, 0x1B4E },
+	{ 0x004F, 0x1B4F },
+	{ 0x0050, 0x1B50 },
+	{ 0x0051, 0x1B51 },
+	{ 0x0052, 0x1B52 },
+	{ 0x0053, 0x1B53 },
+	{ 0x0054, 0x1B54 },
+	{ 0x0055, 0x1B55 },
+	{ 0x0056, 0x1B56 },
+	{ 0x0057, 0x1B57 },
+	{ 0x0058, 0x1B58 },
+	{ 0x0059, 0x1B59 },
+	{ 0x005A, 0x1B5A },
+	{ 0x005B, 0x1B3C },
+	{ 0x005C, 0x1B2F },
+	{ 0x005D, 0x1B3E },
+	{ 0x005E, 0x1B14 },
+	{ 0x005F, 0x1B16 },
+	{ 0x007B, 0x1B28 },
+	{ 0x007C, 0x1B40 },
+	{ 0x007D, 0x1B29 },
+	{ 0x007E, 0x1B3D },
+	{ 0x00A1, 0x1B13 },
+	{ 0x00A3, 0x1B01 },
+	{ 0x00A4, 0x1B06 },
+	{ 0x00A5, 0x1B03 },
+	{ 0x00BF, 0x1B04 },
+	{ 0x0964, 0x1B19 },
+	{ 0x0965, 0x1B1A },
+	{ 0x0CDE, 0x1B26 },
+	{ 0x0CE6, 0x1B1C },
+	{ 0x0CE7, 0x1B1D },
+	{ 0x0CE8, 0x1B1E },
+	{ 0x0CE9, 0x1B1F },
+	{ 0x0CEA, 0x1B20 },
+	{ 0x0CEB, 0x1B21 },
+	{ 0x0CEC, 0x1B22 },
+	{ 0x0CED, 0x1B23 },
+	{ 0x0CEE, 0x1B24 },
+	{ 0x0CEF, 0x1B25 },
+	{ 0x0CF1, 0x1B27 },
+	{ 0x0CF2, 0x1B2A },
+	{ 0x20AC, 0x1B65 }
+};
+
+/* Appendix A.2.8. in 3GPP TS23.038 V.9.1.1 */
+static const struct codepoint mal_ext_gsm[] = {
+	{ 0x00, 0x0040 },
+	{ 0x01, 0x00A3 },
+	{ 0x02, 0x0024 },
+	{ 0x03, 0x00A5 },
+	{ 0x04, 0x00BF },
+	{ 0x05, 0x0022 },
+	{ 0x06, 0x00A4 },
+	{ 0x07, 0x0025 },
+	{ 0x08, 0x0026 },
+	{ 0x09, 0x0027 },
+	{ 0x0A, 0x000C },		/* See NOTE 3 */
+	{ 0x0B, 0x002A },
+	{ 0x0C, 0x002B },
+	{ 0x0E, 0x002D },
+	{ 0x0F, 0x002F },
+	{ 0x10, 0x003C },
+	{ 0x11, 0x003D },
+	{ 0x12, 0x003E },
+	{ 0x13, 0x00A1 },
+	{ 0x14, 0x005E },
+	{ 0x15, 0x00A1 },
+	{ 0x16, 0x005F },
+	{ 0x17, 0x0023 },
+	{ 0x18, 0x002A },
+	{ 0x19, 0x0964 },
+	{ 0x1A, 0x0965 },
+	{ 0x1B, 0x0020 },		/* See NOTE 1 */
+	{ 0x1C, 0x0D66 },
+	{ 0x1D, 0x0D67 },
+	{ 0x1E, 0x0D68 },
+	{ 0x1F, 0x0D69 },
+	{ 0x20, 0x0D6A },
+	{ 0x21, 0x0D6B },
+	{ 0x22, 0x0D6C },
+	{ 0x23, 0x0D6D },
+	{ 0x24, 0x0D6E },
+	{ 0x25, 0x0D6F },
+	{ 0x26, 0x0D70 },
+	{ 0x27, 0x0D71 },
+	{ 0x28, 0x007B },
+	{ 0x29, 0x007D },
+	{ 0x2A, 0x0D72 },
+	{ 0x2B, 0x0D73 },
+	{ 0x2C, 0x0D74 },
+	{ 0x2D, 0x0D75 },
+	{ 0x2E, 0x0D7A },
+	{ 0x2F, 0x005C },
+	{ 0x30, 0x0D7B },
+	{ 0x31, 0x0D7C },
+	{ 0x32, 0x0D7D },
+	{ 0x33, 0x0D7E },
+	{ 0x34, 0x0D7F },
+	{ 0x3C, 0x005B },
+	{ 0x3D, 0x007E },
+	{ 0x3E, 0x005D },
+	{ 0x40, 0x007C },
+	{ 0x41, 0x0041 },
+	{ 0x42, 0x0042 },
+	{ 0x43, 0x0043 },
+	{ 0x44, 0x0044 },
+	{ 0x45, 0x0045 },
+	{ 0x46, 0x0046 },
+	{ 0x47, 0x0047 },
+	{ 0x48, 0x0048 },
+	{ 0x49, 0x0049 },
+	{ 0x4A, 0x004A },
+	{ 0x4B, 0x004B },
+	{ 0x4C, 0x004C },
+	{ 0x4D, 0x004D },
+	{ 0x4E, 0x004E },
+	{ 0x4F, 0x004F },
+	{ 0x50, 0x0050 },
+	{ 0x51, 0x0051 },
+	{ 0x52, 0x0052 },
+	{ 0x53, 0x0053 },
+	{ 0x54, 0x0054 },
+	{ 0x55, 0x0055 },
+	{ 0x56, 0x0056 },
+	{ 0x57, 0x0057 },
+	{ 0x58, 0x0058 },
+	{ 0x59, 0x0059 },
+	{ 0x5A, 0x005A },
+	{ 0x65, 0x20AC }
+};
+
+static const struct codepoint mal_ext_unicode[] = {
+	{ 0x000C, 0x1B0A },
+	{ 0x0022, 0x1B05 },
+	{ 0x0023, 0x1B17 },
+	{ 0x0024, 0x1B02 },
+	{ 0x0025, 0x1B07 },
+	{ 0x0026, 0x1B08 },
+	{ 0x0027, 0x1B09 },
+	{ 0x002A, 0x1B0B },
+	{ 0x002B, 0x1B0C },
+	{ 0x002D, 0x1B0E },
+	{ 0x002F, 0x1B0F },
+	{ 0x003C, 0x1B10 },
+	{ 0x003D, 0x1B11 },
+	{ 0x003E, 0x1B12 },
+	{ 0x0040, 0x1B00 },
+	{ 0x0041, 0x1B41 },
+	{ 0x0042, 0x1B42 },
+	{ 0x0043, 0x1B43 },
+	{ 0x0044, 0x1B44 },
+	{ 0x0045, 0x1B45 },
+	{ 0x0046, 0x1B46 },
+	{ 0x0047, 0x1B47 },
+	{ 0x0048, 0x1B48 },
+	{ 0x0049, 0x1B49 },
+	{ 0x004A, 0x1B4A },
+	{ 0x004B, 0x1B4B },
+	{ 0x004C, 0x1B4C },
+	{ 0x004D, 0x1B4D },
+	{ 0x004E, 0x1B4E },
+	{ 0x004F, 0x1B4F },
+	{ 0x0050, 0x1B50 },
+	{ 0x0051, 0x1B51 },
+	{ 0x0052, 0x1B52 },
+	{ 0x0053, 0x1B53 },
+	{ 0x0054, 0x1B54 },
+	{ 0x0055, 0x1B55 },
+	{ 0x0056, 0x1B56 },
+	{ 0x0057, 0x1B57 },
+	{ 0x0058, 0x1B58 },
+	{ 0x0059, 0x1B59 },
+	{ 0x005A, 0x1B5A },
+	{ 0x005B, 0x1B3C },
+	{ 0x005C, 0x1B2F },
+	{ 0x005D, 0x1B3E },
+	{ 0x005E, 0x1B14 },
+	{ 0x005F, 0x1B16 },
+	{ 0x007B, 0x1B28 },
+	{ 0x007C, 0x1B40 },
+	{ 0x007D, 0x1B29 },
+	{ 0x007E, 0x1B3D },
+	{ 0x00A1, 0x1B13 },
+	{ 0x00A3, 0x1B01 },
+	{ 0x00A4, 0x1B06 },
+	{ 0x00A5, 0x1B03 },
+	{ 0x00BF, 0x1B04 },
+	{ 0x0964, 0x1B19 },
+	{ 0x0965, 0x1B1A },
+	{ 0x0D66, 0x1B1C },
+	{ 0x0D67, 0x1B1D },
+	{ 0x0D68, 0x1B1E },
+	{ 0x0D69, 0x1B1F },
+	{ 0x0D6A, 0x1B20 },
+	{ 0x0D6B, 0x1B21 },
+	{ 0x0D6C, 0x1B22 },
+	{ 0x0D6D, 0x1B23 },
+	{ 0x0D6E, 0x1B24 },
+	{ 0x0D6F, 0x1B25 },
+	{ 0x0D70, 0x1B26 },
+	{ 0x0D71, 0x1B27 },
+	{ 0x0D72, 0x1B2A },
+	{ 0x0D73, 0x1B2B },
+	{ 0x0D74, 0x1B2C },
+	{ 0x0D75, 0x1B2D },
+	{ 0x0D7A, 0x1B2E },
+	{ 0x0D7B, 0x1B30 },
+	{ 0x0D7C, 0x1B31 },
+	{ 0x0D7D, 0x1B32 },
+	{ 0x0D7E, 0x1B33 },
+	{ 0x0D7F, 0x1B34 },
+	{ 0x20AC, 0x1B65 }
+};
+
+/* Appendix A.2.9. in 3GPP TS23.038 V.9.1.1 */
+static const struct codepoint ori_ext_gsm[] = {
+	{ 0x00, 0x0040 },
+	{ 0x01, 0x00A3 },
+	{ 0x02, 0x0024 },
+	{ 0x03, 0x00A5 },
+	{ 0x04, 0x00BF },
+	{ 0x05, 0x0022 },
+	{ 0x06, 0x00A4 },
+	{ 0x07, 0x0025 },
+	{ 0x08, 0x0026 },
+	{ 0x09, 0x0027 },
+	{ 0x0A, 0x000C },		/* See NOTE 3 */
+	{ 0x0B, 0x002A },
+	{ 0x0C, 0x002B },
+	{ 0x0E, 0x002D },
+	{ 0x0F, 0x002F },
+	{ 0x10, 0x003C },
+	{ 0x11, 0x003D },
+	{ 0x12, 0x003E },
+	{ 0x13, 0x00A1 },
+	{ 0x14, 0x005E },
+	{ 0x15, 0x00A1 },
+	{ 0x16, 0x005F },
+	{ 0x17, 0x0023 },
+	{ 0x18, 0x002A },
+	{ 0x19, 0x0964 },
+	{ 0x1A, 0x0965 },
+	{ 0x1B, 0x0020 },		/* See NOTE 1 */
+	{ 0x1C, 0x0B66 },
+	{ 0x1D, 0x0B67 },
+	{ 0x1E, 0x0B68 },
+	{ 0x1F, 0x0B69 },
+	{ 0x20, 0x0B6A },
+	{ 0x21, 0x0B6B },
+	{ 0x22, 0x0B6C },
+	{ 0x23, 0x0B6D },
+	{ 0x24, 0x0B6E },
+	{ 0x25, 0x0B6F },
+	{ 0x26, 0x0B5C },
+	{ 0x27, 0x0B5D },
+	{ 0x28, 0x007B },
+	{ 0x29, 0x007D },
+	{ 0x2A, 0x0B5F },
+	{ 0x2B, 0x0B70 },
+	{ 0x2C, 0x0B71 },
+	{ 0x2F, 0x005C },
+	{ 0x3C, 0x005B },
+	{ 0x3D, 0x007E },
+	{ 0x3E, 0x005D },
+	{ 0x40, 0x007C },
+	{ 0x41, 0x0041 },
+	{ 0x42, 0x0042 },
+	{ 0x43, 0x0043 },
+	{ 0x44, 0x0044 },
+	{ 0x45, 0x0045 },
+	{ 0x46, 0x0046 },
+	{ 0x47, 0x0047 },
+	{ 0x48, 0x0048 },
+	{ 0x49, 0x0049 },
+	{ 0x4A, 0x004A },
+	{ 0x4B, 0x004B },
+	{ 0x4C, 0x004C },
+	{ 0x4D, 0x004D },
+	{ 0x4E, 0x004E },
+	{ 0x4F, 0x004F },
+	{ 0x50, 0x0050 },
+	{ 0x51, 0x0051 },
+	{ 0x52, 0x0052 },
+	{ 0x53, 0x0053 },
+	{ 0x54, 0x0054 },
+	{ 0x55, 0x0055 },
+	{ 0x56, 0x0056 },
+	{ 0x57, 0x0057 },
+	{ 0x58, 0x0058 },
+	{ 0x59, 0x0059 },
+	{ 0x5A, 0x005A },
+	{ 0x65, 0x20AC }
+};
+
+static const struct codepoint ori_ext_unicode[] = {
+	{ 0x000C, 0x1B0A },
+	{ 0x0022, 0x1B05 },
+	{ 0x0023, 0x1B17 },
+	{ 0x0024, 0x1B02 },
+	{ 0x0025, 0x1B07 },
+	{ 0x0026, 0x1B08 },
+	{ 0x0027, 0x1B09 },
+	{ 0x002A, 0x1B0B },
+	{ 0x002B, 0x1B0C },
+	{ 0x002D, 0x1B0E },
+	{ 0x002F, 0x1B0F },
+	{ 0x003C, 0x1B10 },
+	{ 0x003D, 0x1B11 },
+	{ 0x003E, 0x1B12 },
+	{ 0x0040, 0x1B00 },
+	{ 0x0041, 0x1B41 },
+	{ 0x0042, 0x1B42 },
+	{ 0x0043, 0x1B43 },
+	{ 0x0044, 0x1B44 },
+	{ 0x0045, 0x1B45 },
+	{ 0x0046, 0x1B46 },
+	{ 0x0047, 0x1B47 },
+	{ 0x0048, 0x1B48 },
+	{ 0x0049, 0x1B49 },
+	{ 0x004A, 0x1B4A },
+	{ 0x004B, 0x1B4B },
+	{ 0x004C, 0x1B4C },
+	{ 0x004D, 0x1B4D },
+	{ 0x004E, 0x1B4E },
+	{ 0x004F, 0x1B4F },
+	{ 0x0050, 0x1B50 },
+	{ 0x0051, 0x1B51 },
+	{ 0x0052, 0x1B52 },
+	{ 0x0053, 0x1B53 },
+	{ 0x0054, 0x1B54 },
+	{ 0x0055, 0x1B55 },
+	{ 0x0056, 0x1B56 },
+	{ 0x0057, 0x1B57 },
+	{ 0x0058, 0x1B58 },
+	{ 0x0059, 0x1B59 },
+	{ 0x005A, 0x1B5A },
+	{ 0x005B, 0x1B3C },
+	{ 0x005C, 0x1B2F },
+	{ 0x005D, 0x1B3E },
+	{ 0x005E, 0x1B14 },
+	{ 0x005F, 0x1B16 },
+	{ 0x007B, 0x1B28 },
+	{ 0x007C, 0x1B40 },
+	{ 0x007D, 0x1B29 },
+	{ 0x007E, 0x1B3D },
+	{ 0x00A1, 0x1B13 },
+	{ 0x00A3, 0x1B01 },
+	{ 0x00A4, 0x1B06 },
+	{ 0x00A5, 0x1B03 },
+	{ 0x00BF, 0x1B04 },
+	{ 0x0964, 0x1B19 },
+	{ 0x0965, 0x1B1A },
+	{ 0x0B5C, 0x1B26 },
+	{ 0x0B5D, 0x1B27 },
+	{ 0x0B5F, 0x1B2A },
+	{ 0x0B66, 0x1B1C },
+	{ 0x0B67, 0x1B1D },
+	{ 0x0B68, 0x1B1E },
+	{ 0x0B69, 0x1B1F },
+	{ 0x0B6A, 0x1B20 },
+	{ 0x0B6B, 0x1B21 },
+	{ 0x0B6C, 0x1B22 },
+	{ 0x0B6D, 0x1B23 },
+	{ 0x0B6E, 0x1B24 },
+	{ 0x0B6F, 0x1B25 },
+	{ 0x0B70, 0x1B2B },
+	{ 0x0B71, 0x1B2C },
+	{ 0x20AC, 0x1B65 }
+};
+
+/* Appendix A.2.10. in 3GPP TS23.038 V.9.1.1 */
+static const struct codepoint pun_ext_gsm[] = {
+	{ 0x00, 0x0040 },
+	{ 0x01, 0x00A3 },
+	{ 0x02, 0x0024 },
+	{ 0x03, 0x00A5 },
+	{ 0x04, 0x00BF },
+	{ 0x05, 0x0022 },
+	{ 0x06, 0x00A4 },
+	{ 0x07, 0x0025 },
+	{ 0x08, 0x0026 },
+	{ 0x09, 0x0027 },
+	{ 0x0A, 0x000C },		/* See NOTE 3 */
+	{ 0x0B, 0x002A },
+	{ 0x0C, 0x002B },
+	{ 0x0E, 0x002D },
+	{ 0x0F, 0x002F },
+	{ 0x10, 0x003C },
+	{ 0x11, 0x003D },
+	{ 0x12, 0x003E },
+	{ 0x13, 0x00A1 },
+	{ 0x14, 0x005E },
+	{ 0x15, 0x00A1 },
+	{ 0x16, 0x005F },
+	{ 0x17, 0x0023 },
+	{ 0x18, 0x002A },
+	{ 0x19, 0x0964 },
+	{ 0x1A, 0x0965 },
+	{ 0x1B, 0x0020 },		/* See NOTE 1 */
+	{ 0x1C, 0x0A66 },
+	{ 0x1D, 0x0A67 },
+	{ 0x1E, 0x0A68 },
+	{ 0x1F, 0x0A69 },
+	{ 0x20, 0x0A6A },
+	{ 0x21, 0x0A6B },
+	{ 0x22, 0x0A6C },
+	{ 0x23, 0x0A6D },
+	{ 0x24, 0x0A6E },
+	{ 0x25, 0x0A6F },
+	{ 0x26, 0x0A59 },
+	{ 0x27, 0x0A5A },
+	{ 0x28, 0x007B },
+	{ 0x29, 0x007D },
+	{ 0x2A, 0x0A5B },
+	{ 0x2B, 0x0A5C },
+	{ 0x2C, 0x0A5E },
+	{ 0x2D, 0x0A75 },
+	{ 0x2F, 0x005C },
+	{ 0x3C, 0x005B },
+	{ 0x3D, 0x007E },
+	{ 0x3E, 0x005D },
+	{ 0x40, 0x007C },
+	{ 0x41, 0x0041 },
+	{ 0x42, 0x0042 },
+	{ 0x43, 0x0043 },
+	{ 0x44, 0x0044 },
+	{ 0x45, 0x0045 },
+	{ 0x46, 0x0046 },
+	{ 0x47, 0x0047 },
+	{ 0x48, 0x0048 },
+	{ 0x49, 0x0049 },
+	{ 0x4A, 0x004A },
+	{ 0x4B, 0x004B },
+	{ 0x4C, 0x004C },
+	{ 0x4D, 0x004D },
+	{ 0x4E, 0x004E },
+	{ 0x4F, 0x004F },
+	{ 0x50, 0x0050 },
+	{ 0x51, 0x0051 },
+	{ 0x52, 0x0052 },
+	{ 0x53, 0x0053 },
+	{ 0x54, 0x0054 },
+	{ 0x55, 0x0055 },
+	{ 0x56, 0x0056 },
+	{ 0x57, 0x0057 },
+	{ 0x58, 0x0058 },
+	{ 0x59, 0x0059 },
+	{ 0x5A, 0x005A },
+	{ 0x65, 0x20AC }
+};
+
+static const struct codepoint pun_ext_unicode[] = {
+	{ 0x000C, 0x1B0A },
+	{ 0x0022, 0x1B05 },
+	{ 0x0023, 0x1B17 },
+	{ 0x0024, 0x1B02 },
+	{ 0x0025, 0x1B07 },
+	{ 0x0026, 0x1B08 },
+	{ 0x0027, 0x1B09 },
+	{ 0x002A, 0x1B0B },
+	{ 0x002B, 0x1B0C },
+	{ 0x002D, 0x1B0E },
+	{ 0x002F, 0x1B0F },
+	{ 0x003C, 0x1B10 },
+	{ 0x003D, 0x1B11 },
+	{ 0x003E, 0x1B12 },
+	{ 0x0040, 0x1B00 },
+	{ 0x0041, 0x1B41 },
+	{ 0x0042, 0x1B42 },
+	{ 0x0043, 0x1B43 },
+	{ 0x0044, 0x1B44 },
+	{ 0x0045, 0x1B45 },
+	{ 0x0046, 0x1B46 },
+	{ 0x0047, 0x1B47 },
+	{ 0x0048, 0x1B48 },
+	{ 0x0049, 0x1B49 },
+	{ 0x004A, 0x1B4A },
+	{ 0x004B, 0x1B4B },
+	{ 0x004C, 0x1B4C },
+	{ 0x004D, 0x1B4D },
+	{ 0x004E, 0x1B4E },
+	{ 0x004F, 0x1B4F },
+	{ 0x0050, 0x1B50 },
+	{ 0x0051, 0x1B51 },
+	{ 0x0052, 0x1B52 },
+	{ 0x0053, 0x1B53 },
+	{ 0x0054, 0x1B54 },
+	{ 0x0055, 0x1B55 },
+	{ 0x0056, 0x1B56 },
+	{ 0x0057, 0x1B57 },
+	{ 0x0058, 0x1B58 },
+	{ 0x0059, 0x1B59 },
+	{ 0x005A, 0x1B5A },
+	{ 0x005B, 0x1B3C },
+	{ 0x005C, 0x1B2F },
+	{ 0x005D, 0x1B3E },
+	{ 0x005E, 0x1B14 },
+	{ 0x005F, 0x1B16 },
+	{ 0x007B, 0x1B28 },
+	{ 0x007C, 0x1B40 },
+	{ 0x007D, 0x1B29 },
+	{ 0x007E, 0x1B3D },
+	{ 0x00A1, 0x1B13 },
+	{ 0x00A3, 0x1B01 },
+	{ 0x00A4, 0x1B06 },
+	{ 0x00A5, 0x1B03 },
+	{ 0x00BF, 0x1B04 },
+	{ 0x0964, 0x1B19 },
+	{ 0x0965, 0x1B1A },
+	{ 0x0A59, 0x1B26 },
+	{ 0x0A5A, 0x1B27 },
+	{ 0x0A5B, 0x1B2A },
+	{ 0x0A5C, 0x1B2B },
+	{ 0x0A5E, 0x1B2C },
+	{ 0x0A66, 0x1B1C },
+	{ 0x0A67, 0x1B1D },
+	{ 0x0A68, 0x1B1E },
+	{ 0x0A69, 0x1B1F },
+	{ 0x0A6A, 0x1B20 },
+	{ 0x0A6B, 0x1B21 },
+	{ 0x0A6C, 0x1B22 },
+	{ 0x0A6D, 0x1B23 },
+	{ 0x0A6E, 0x1B24 },
+	{ 0x0A6F, 0x1B25 },
+	{ 0x0A75, 0x1B2D },
+	{ 0x20AC, 0x1B65 }
+};
+
+/* Appendix A.2.11. in 3GPP TS23.038 V.9.1.1 */
+static const struct codepoint tam_ext_gsm[] = {
+	{ 0x00, 0x0040 },
+	{ 0x01, 0x00A3 },
+	{ 0x02, 0x0024 },
+	{ 0x03, 0x00A5 },
+	{ 0x04, 0x00BF },
+	{ 0x05, 0x0022 },
+	{ 0x06, 0x00A4 },
+	{ 0x07, 0x0025 },
+	{ 0x08, 0x0026 },
+	{ 0x09, 0x0027 },
+	{ 0x0A, 0x000C },		/* See NOTE 3 */
+	{ 0x0B, 0x002A },
+	{ 0x0C, 0x002B },
+	{ 0x0E, 0x002D },
+	{ 0x0F, 0x002F },
+	{ 0x10, 0x003C },
+	{ 0x11, 0x003D },
+	{ 0x12, 0x003E },
+	{ 0x13, 0x00A1 },
+	{ 0x14, 0x005E },
+	{ 0x15, 0x00A1 },
+	{ 0x16, 0x005F },
+	{ 0x17, 0x0023 },
+	{ 0x18, 0x002A },
+	{ 0x19, 0x0964 },
+	{ 0x1A, 0x0965 },
+	{ 0x1B, 0x0020 },		/* See NOTE 1 */
+	{ 0x1C, 0x0BE6 },
+	{ 0x1D, 0x0BE7 },
+	{ 0x1E, 0x0BE8 },
+	{ 0x1F, 0x0BE9 },
+	{ 0x20, 0x0BEA },
+	{ 0x21, 0x0BEB },
+	{ 0x22, 0x0BEC },
+	{ 0x23, 0x0BED },
+	{ 0x24, 0x0BEE },
+	{ 0x25, 0x0BEF },
+	{ 0x26, 0x0BF3 },
+	{ 0x27, 0x0BF4 },
+	{ 0x28, 0x007B },
+	{ 0x29, 0x007D },
+	{ 0x2A, 0x0BF5 },
+	{ 0x2B, 0x0BF6 },
+	{ 0x2C, 0x0BF7 },
+	{ 0x2D, 0x0BF8 },
+	{ 0x2E, 0x0BFA },
+	{ 0x2F, 0x005C },
+	{ 0x3C, 0x005B },
+	{ 0x3D, 0x007E },
+	{ 0x3E, 0x005D },
+	{ 0x40, 0x007C },
+	{ 0x41, 0x0041 },
+	{ 0x42, 0x0042 },
+	{ 0x43, 0x0043 },
+	{ 0x44, 0x0044 },
+	{ 0x45, 0x0045 },
+	{ 0x46, 0x0046 },
+	{ 0x47, 0x0047 },
+	{ 0x48, 0x0048 },
+	{ 0x49, 0x0049 },
+	{ 0x4A, 0x004A },
+	{ 0x4B, 0x004B },
+	{ 0x4C, 0x004C },
+	{ 0x4D, 0x004D },
+	{ 0x4E, 0x004E },
+	{ 0x4F, 0x004F },
+	{ 0x50, 0x0050 },
+	{ 0x51, 0x0051 },
+	{ 0x52, 0x0052 },
+	{ 0x53, 0x0053 },
+	{ 0x54, 0x0054 },
+	{ 0x55, 0x0055 },
+	{ 0x56, 0x0056 },
+	{ 0x57, 0x0057 },
+	{ 0x58, 0x0058 },
+	{ 0x59, 0x0059 },
+	{ 0x5A, 0x005A },
+	{ 0x65, 0x20AC }
+};
+
+static const struct codepoint tam_ext_unicode[] = {
+	{ 0x000C, 0x1B0A },
+	{ 0x0022, 0x1B05 },
+	{ 0x0023, 0x1B17 },
+	{ 0x0024, 0x1B02 },
+	{ 0x0025, 0x1B07 },
+	{ 0x0026, 0x1B08 },
+	{ 0x0027, 0x1B09 },
+	{ 0x002A, 0x1B0B },
+	{ 0x002B, 0x1B0C },
+	{ 0x002D, 0x1B0E },
+	{ 0x002F, 0x1B0F },
+	{ 0x003C, 0x1B10 },
+	{ 0x003D, 0x1B11 },
+	{ 0x003E, 0x1B12 },
+	{ 0x0040, 0x1B00 },
+	{ 0x0041, 0x1B41 },
+	{ 0x0042, 0x1B42 },
+	{ 0x0043, 0x1B43 },
+	{ 0x0044, 0x1B44 },
+	{ 0x0045, 0x1B45 },
+	{ 0x0046, 0x1B46 },
+	{ 0x0047, 0x1B47 },
+	{ 0x0048, 0x1B48 },
+	{ 0x0049, 0x1B49 },
+	{ 0x004A, 0x1B4A },
+	{ 0x004B, 0x1B4B },
+	{ 0x004C, 0x1B4C },
+	{ 0x004D, 0x1B4D },
+	{ 0x004E, 0x1B4E },
+	{ 0x004F, 0x1B4F },
+	{ 0x0050, 0x1B50 },
+	{ 0x0051, 0x1B51 },
+	{ 0x0052, 0x1B52 },
+	{ 0x0053, 0x1B53 },
+	{ 0x0054, 0x1B54 },
+	{ 0x0055, 0x1B55 },
+	{ 0x0056, 0x1B56 },
+	{ 0x0057, 0x1B57 },
+	{ 0x0058, 0x1B58 },
+	{ 0x0059, 0x1B59 },
+	{ 0x005A, 0x1B5A },
+	{ 0x005B, 0x1B3C },
+	{ 0x005C, 0x1B2F },
+	{ 0x005D, 0x1B3E },
+	{ 0x005E, 0x1B14 },
+	{ 0x005F, 0x1B16 },
+	{ 0x007B, 0x1B28 },
+	{ 0x007C, 0x1B40 },
+	{ 0x007D, 0x1B29 },
+	{ 0x007E, 0x1B3D },
+	{ 0x00A1, 0x1B13 },
+	{ 0x00A3, 0x1B01 },
+	{ 0x00A4, 0x1B06 },
+	{ 0x00A5, 0x1B03 },
+	{ 0x00BF, 0x1B04 },
+	{ 0x0964, 0x1B19 },
+	{ 0x0965, 0x1B1A },
+	{ 0x0BE6, 0x1B1C },
+	{ 0x0BE7, 0x1B1D },
+	{ 0x0BE8, 0x1B1E },
+	{ 0x0BE9, 0x1B1F },
+	{ 0x0BEA, 0x1B20 },
+	{ 0x0BEB, 0x1B21 },
+	{ 0x0BEC, 0x1B22 },
+	{ 0x0BED, 0x1B23 },
+	{ 0x0BEE, 0x1B24 },
+	{ 0x0BEF, 0x1B25 },
+	{ 0x0BF3, 0x1B26 },
+	{ 0x0BF4, 0x1B27 },
+	{ 0x0BF5, 0x1B2A },
+	{ 0x0BF6, 0x1B2B },
+	{ 0x0BF7, 0x1B2C },
+	{ 0x0BF8, 0x1B2D },
+	{ 0x0BFA, 0x1B2E },
+	{ 0x20AC, 0x1B65 }
+};
+
+/* Appendix A.2.12. in 3GPP TS23.038 V.9.1.1 */
+static const struct codepoint tel_ext_gsm[] = {
+	{ 0x00, 0x0040 },
+	{ 0x01, 0x00A3 },
+	{ 0x02, 0x0024 },
+	{ 0x03, 0x00A5 },
+	{ 0x04, 0x00BF },
+	{ 0x05, 0x0022 },
+	{ 0x06, 0x00A4 },
+	{ 0x07, 0x0025 },
+	{ 0x08, 0x0026 },
+	{ 0x09, 0x0027 },
+	{ 0x0A, 0x000C },		/* See NOTE 3 */
+	{ 0x0B, 0x002A },
+	{ 0x0C, 0x002B },
+	{ 0x0E, 0x002D },
+	{ 0x0F, 0x002F },
+	{ 0x10, 0x003C },
+	{ 0x11, 0x003D },
+	{ 0x12, 0x003E },
+	{ 0x13, 0x00A1 },
+	{ 0x14, 0x005E },
+	{ 0x15, 0x00A1 },
+	{ 0x16, 0x005F },
+	{ 0x17, 0x0023 },
+	{ 0x18, 0x002A },
+	{ 0x19, 0x0964 },
+	{ 0x1A, 0x0965 },
+	{ 0x1B, 0x0020 },		/* See NOTE 1 */
+	{ 0x1C, 0x0C66 },
+	{ 0x1D, 0x0C67 },
+	{ 0x1E, 0x0C68 },
+	{ 0x1F, 0x0C69 },
+	{ 0x20, 0x0C6A },
+	{ 0x21, 0x0C6B },
+	{ 0x22, 0x0C6C },
+	{ 0x23, 0x0C6D },
+	{ 0x24, 0x0C6E },
+	{ 0x25, 0x0C6F },
+	{ 0x26, 0x0C58 },
+	{ 0x27, 0x0C59 },
+	{ 0x28, 0x007B },
+	{ 0x29, 0x007D },
+	{ 0x2A, 0x0C78 },
+	{ 0x2B, 0x0C79 },
+	{ 0x2C, 0x0C7A },
+	{ 0x2D, 0x0C7B },
+	{ 0x2E, 0x0C7C },
+	{ 0x2F, 0x005C },
+	{ 0x30, 0x0C7D },
+	{ 0x31, 0x0C7E },
+	{ 0x32, 0x0C7F },
+	{ 0x3C, 0x005B },
+	{ 0x3D, 0x007E },
+	{ 0x3E, 0x005D },
+	{ 0x40, 0x007C },
+	{ 0x41, 0x0041 },
+	{ 0x42, 0x0042 },
+	{ 0x43, 0x0043 },
+	{ 0x44, 0x0044 },
+	{ 0x45, 0x0045 },
+	{ 0x46, 0x0046 },
+	{ 0x47, 0x0047 },
+	{ 0x48, 0x0048 },
+	{ 0x49, 0x0049 },
+	{ 0x4A, 0x004A },
+	{ 0x4B, 0x004B },
+	{ 0x4C, 0x004C },
+	{ 0x4D, 0x004D },
+	{ 0x4E, 0x004E },
+	{ 0x4F, 0x004F },
+	{ 0x50, 0x0050 },
+	{ 0x51, 0x0051 },
+	{ 0x52, 0x0052 },
+	{ 0x53, 0x0053 },
+	{ 0x54, 0x0054 },
+	{ 0x55, 0x0055 },
+	{ 0x56, 0x0056 },
+	{ 0x57, 0x0057 },
+	{ 0x58, 0x0058 },
+	{ 0x59, 0x0059 },
+	{ 0x5A, 0x005A },
+	{ 0x65, 0x20AC }
+};
+
+static const struct codepoint tel_ext_unicode[] = {
+	{ 0x000C, 0x1B0A },
+	{ 0x0022, 0x1B05 },
+	{ 0x0023, 0x1B17 },
+	{ 0x0024, 0x1B02 },
+	{ 0x0025, 0x1B07 },
+	{ 0x0026, 0x1B08 },
+	{ 0x0027, 0x1B09 },
+	{ 0x002A, 0x1B0B },
+	{ 0x002B, 0x1B0C },
+	{ 0x002D, 0x1B0E },
+	{ 0x002F, 0x1B0F },
+	{ 0x003C, 0x1B10 },
+	{ 0x003D, 0x1B11 },
+	{ 0x003E, 0x1B12 },
+	{ 0x0040, 0x1B00 },
+	{ 0x0041, 0x1B41 },
+	{ 0x0042, 0x1B42 },
+	{ 0x0043, 0x1B43 },
+	{ 0x0044, 0x1B44 },
+	{ 0x0045, 0x1B45 },
+	{ 0x0046, 0x1B46 },
+	{ 0x0047, 0x1B47 },
+	{ 0x0048, 0x1B48 },
+	{ 0x0049, 0x1B49 },
+	{ 0x004A, 0x1B4A },
+	{ 0x004B, 0x1B4B },
+	{ 0x004C, 0x1B4C },
+	{ 0x004D, 0x1B4D },
+	{ 0x004E, 0x1B4E },
+	{ 0x004F, 0x1B4F },
+	{ 0x0050, 0x1B50 },
+	{ 0x0051, 0x1B51 },
+	{ 0x0052, 0x1B52 },
+	{ 0x0053, 0x1B53 },
+	{ 0x0054, 0x1B54 },
+	{ 0x0055, 0x1B55 },
+	{ 0x0056, 0x1B56 },
+	{ 0x0057, 0x1B57 },
+	{ 0x0058, 0x1B58 },
+	{ 0x0059, 0x1B59 },
+	{ 0x005A, 0x1B5A },
+	{ 0x005B, 0x1B3C },
+	{ 0x005C, 0x1B2F },
+	{ 0x005D, 0x1B3E },
+	{ 0x005E, 0x1B14 },
+	{ 0x005F, 0x1B16 },
+	{ 0x007B, 0x1B28 },
+	{ 0x007C, 0x1B40 },
+	{ 0x007D, 0x1B29 },
+	{ 0x007E, 0x1B3D },
+	{ 0x00A1, 0x1B13 },
+	{ 0x00A3, 0x1B01 },
+	{ 0x00A4, 0x1B06 },
+	{ 0x00A5, 0x1B03 },
+	{ 0x00BF, 0x1B04 },
+	{ 0x0964, 0x1B19 },
+	{ 0x0965, 0x1B1A },
+	{ 0x0C58, 0x1B26 },
+	{ 0x0C59, 0x1B27 },
+	{ 0x0C66, 0x1B1C },
+	{ 0x0C67, 0x1B1D },
+	{ 0x0C68, 0x1B1E },
+	{ 0x0C69, 0x1B1F },
+	{ 0x0C6A, 0x1B20 },
+	{ 0x0C6B, 0x1B21 },
+	{ 0x0C6C, 0x1B22 },
+	{ 0x0C6D, 0x1B23 },
+	{ 0x0C6E, 0x1B24 },
+	{ 0x0C6F, 0x1B25 },
+	{ 0x0C78, 0x1B2A },
+	{ 0x0C79, 0x1B2B },
+	{ 0x0C7A, 0x1B2C },
+	{ 0x0C7B, 0x1B2D },
+	{ 0x0C7C, 0x1B2E },
+	{ 0x0C7D, 0x1B30 },
+	{ 0x0C7E, 0x1B31 },
+	{ 0x0C7F, 0x1B32 },
+	{ 0x20AC, 0x1B65 }
+};
+
+/* Appendix A.2.13. in 3GPP TS23.038 V.9.1.1 */
+static const struct codepoint urd_ext_gsm[] = {
+	{ 0x00, 0x0040 },
+	{ 0x01, 0x00A3 },
+	{ 0x02, 0x0024 },
+	{ 0x03, 0x00A5 },
+	{ 0x04, 0x00BF },
+	{ 0x05, 0x0022 },
+	{ 0x06, 0x00A4 },
+	{ 0x07, 0x0025 },
+	{ 0x08, 0x0026 },
+	{ 0x09, 0x0027 },
+	{ 0x0A, 0x000C },		/* See NOTE 3 */
+	{ 0x0B, 0x002A },
+	{ 0x0C, 0x002B },
+	{ 0x0E, 0x002D },
+	{ 0x0F, 0x002F },
+	{ 0x10, 0x003C },
+	{ 0x11, 0x003D },
+	{ 0x12, 0x003E },
+	{ 0x13, 0x00A1 },
+	{ 0x14, 0x005E },
+	{ 0x15, 0x00A1 },
+	{ 0x16, 0x005F },
+	{ 0x17, 0x0023 },
+	{ 0x18, 0x002A },
+	{ 0x19, 0x0600 },
+	{ 0x1A, 0x0601 },
+	{ 0x1B, 0x0020 },		/* See NOTE 1 */
+	{ 0x1C, 0x06F0 },
+	{ 0x1D, 0x06F1 },
+	{ 0x1E, 0x06F2 },
+	{ 0x1F, 0x06F3 },
+	{ 0x20, 0x06F4 },
+	{ 0x21, 0x06F5 },
+	{ 0x22, 0x06F6 },
+	{ 0x23, 0x06F7 },
+	{ 0x24, 0x06F8 },
+	{ 0x25, 0x06F9 },
+	{ 0x26, 0x060C },
+	{ 0x27, 0x060D },
+	{ 0x28, 0x007B },
+	{ 0x29, 0x007D },
+	{ 0x2A, 0x060E },
+	{ 0x2B, 0x060F },
+	{ 0x2C, 0x0610 },
+	{ 0x2D, 0x0611 },
+	{ 0x2E, 0x0612 },
+	{ 0x2F, 0x005C },
+	{ 0x30, 0x0613 },
+	{ 0x31, 0x0614 },
+	{ 0x32, 0x061B },
+	{ 0x33, 0x061F },
+	{ 0x34, 0x0640 },
+	{ 0x35, 0x0652 },
+	{ 0x36, 0x0658 },
+	{ 0x37, 0x066B },
+	{ 0x38, 0x066C },
+	{ 0x39, 0x0672 },
+	{ 0x3A, 0x0673 },
+	{ 0x3B, 0x06CD },
+	{ 0x3C, 0x005B },
+	{ 0x3D, 0x007E },
+	{ 0x3E, 0x005D },
+	{ 0x3F, 0x06D4 },
+	{ 0x40, 0x007C },
+	{ 0x41, 0x0041 },
+	{ 0x42, 0x0042 },
+	{ 0x43, 0x0043 },
+	{ 0x44, 0x0044 },
+	{ 0x45, 0x0045 },
+	{ 0x46, 0x0046 },
+	{ 0x47, 0x0047 },
+	{ 0x48, 0x0048 },
+	{ 0x49, 0x0049 },
+	{ 0x4A, 0x004A },
+	{ 0x4B, 0x004B },
+	{ 0x4C, 0x004C },
+	{ 0x4D, 0x004D },
+	{ 0x4E, 0x004E },
+	{ 0x4F, 0x004F },
+	{ 0x50, 0x0050 },
+	{ 0x51, 0x0051 },
+	{ 0x52, 0x0052 },
+	{ 0x53, 0x0053 },
+	{ 0x54, 0x0054 },
+	{ 0x55, 0x0055 },
+	{ 0x56, 0x0056 },
+	{ 0x57, 0x0057 },
+	{ 0x58, 0x0058 },
+	{ 0x59, 0x0059 },
+	{ 0x5A, 0x005A },
+	{ 0x65, 0x20AC }
+};
+
+static const struct codepoint urd_ext_unicode[] = {
+	{ 0x000C, 0x1B0A },
+	{ 0x0022, 0x1B05 },
+	{ 0x0023, 0x1B17 },
+	{ 0x0024, 0x1B02 },
+	{ 0x0025, 0x1B07 },
+	{ 0x0026, 0x1B08 },
+	{ 0x0027, 0x1B09 },
+	{ 0x002A, 0x1B0B },
+	{ 0x002B, 0x1B0C },
+	{ 0x002D, 0x1B0E },
+	{ 0x002F, 0x1B0F },
+	{ 0x003C, 0x1B10 },
+	{ 0x003D, 0x1B11 },
+	{ 0x003E, 0x1B12 },
+	{ 0x0040, 0x1B00 },
+	{ 0x0041, 0x1B41 },
+	{ 0x0042, 0x1B42 },
+	{ 0x0043, 0x1B43 },
+	{ 0x0044, 0x1B44 },
+	{ 0x0045, 0x1B45 },
+	{ 0x0046, 0x1B46 },
+	{ 0x0047, 0x1B47 },
+	{ 0x0048, 0x1B48 },
+	{ 0x0049, 0x1B49 },
+	{ 0x004A, 0x1B4A },
+	{ 0x004B, 0x1B4B },
+	{ 0x004C, 0x1B4C },
+	{ 0x004D, 0x1B4D },
+	{ 0x004E, 0x1B4E },
+	{ 0x004F, 0x1B4F },
+	{ 0x0050, 0x1B50 },
+	{ 0x0051, 0x1B51 },
+	{ 0x0052, 0x1B52 },
+	{ 0x0053, 0x1B53 },
+	{ 0x0054, 0x1B54 },
+	{ 0x0055, 0x1B55 },
+	{ 0x0056, 0x1B56 },
+	{ 0x0057, 0x1B57 },
+	{ 0x0058, 0x1B58 },
+	{ 0x0059, 0x1B59 },
+	{ 0x005A, 0x1B5A },
+	{ 0x005B, 0x1B3C },
+	{ 0x005C, 0x1B2F },
+	{ 0x005D, 0x1B3E },
+	{ 0x005E, 0x1B14 },
+	{ 0x005F, 0x1B16 },
+	{ 0x007B, 0x1B28 },
+	{ 0x007C, 0x1B40 },
+	{ 0x007D, 0x1B29 },
+	{ 0x007E, 0x1B3D },
+	{ 0x00A1, 0x1B13 },
+	{ 0x00A3, 0x1B01 },
+	{ 0x00A4, 0x1B06 },
+	{ 0x00A5, 0x1B03 },
+	{ 0x00BF, 0x1B04 },
+	{ 0x0600, 0x1B19 },
+	{ 0x0601, 0x1B1A },
+	{ 0x060C, 0x1B26 },
+	{ 0x060D, 0x1B27 },
+	{ 0x060E, 0x1B2A },
+	{ 0x060F, 0x1B2B },
+	{ 0x0610, 0x1B2C },
+	{ 0x0611, 0x1B2D },
+	{ 0x0612, 0x1B2E },
+	{ 0x0613, 0x1B30 },
+	{ 0x0614, 0x1B31 },
+	{ 0x061B, 0x1B32 },
+	{ 0x061F, 0x1B33 },
+	{ 0x0640, 0x1B34 },
+	{ 0x0652, 0x1B35 },
+	{ 0x0658, 0x1B36 },
+	{ 0x066B, 0x1B37 },
+	{ 0x066C, 0x1B38 },
+	{ 0x0672, 0x1B39 },
+	{ 0x0673, 0x1B3A },
+	{ 0x06CD, 0x1B3B },
+	{ 0x06D4, 0x1B3F },
+	{ 0x06F0, 0x1B1C },
+	{ 0x06F1, 0x1B1D },
+	{ 0x06F2, 0x1B1E },
+	{ 0x06F3, 0x1B1F },
+	{ 0x06F4, 0x1B20 },
+	{ 0x06F5, 0x1B21 },
+	{ 0x06F6, 0x1B22 },
+	{ 0x06F7, 0x1B23 },
+	{ 0x06F8, 0x1B24 },
+	{ 0x06F9, 0x1B25 },
+	{ 0x20AC, 0x1B65 }
+};
+
 /* Used for conversion of GSM to Unicode */
 static const unsigned short def_gsm[] = {
 	0x0040, 0x00A3, 0x0024, 0x00A5, 0x00E8, 0x00E9, 0x00F9, 0x00EC,
@@ -416,62 +2068,694 @@ static const unsigned short por_gsm[] = {
 	0x007E, 0x0061, 0x0062, 0x0063, 0x0064, 0x0065, 0x0066, 0x0067,
 	0x0068, 0x0069, 0x006A, 0x006B, 0x006C, 0x006D, 0x006E, 0x006F,
 	0x0070, 0x0071, 0x0072, 0x0073, 0x0074, 0x0075, 0x0076, 0x0077,
-	0x0078, 0x0079, 0x007A, 0x00E3, 0x00F5, 0x0060, 0x00FC, 0x00E0
+	0x0078, 0x0079, 0x007A, 0x00E3, 0x00F5, 0x0060, 0x00FC, 0x00E0
+};
+
+static const struct codepoint por_unicode[] = {
+	{ 0x000A, 0x0A }, { 0x000D, 0x0D }, { 0x0020, 0x20 }, { 0x0021, 0x21 },
+	{ 0x0022, 0x22 }, { 0x0023, 0x23 }, { 0x0024, 0x02 }, { 0x0025, 0x25 },
+	{ 0x0026, 0x26 }, { 0x0027, 0x27 }, { 0x0028, 0x28 }, { 0x0029, 0x29 },
+	{ 0x002A, 0x2A }, { 0x002B, 0x2B }, { 0x002C, 0x2C }, { 0x002D, 0x2D },
+	{ 0x002E, 0x2E }, { 0x002F, 0x2F }, { 0x0030, 0x30 }, { 0x0031, 0x31 },
+	{ 0x0032, 0x32 }, { 0x0033, 0x33 }, { 0x0034, 0x34 }, { 0x0035, 0x35 },
+	{ 0x0036, 0x36 }, { 0x0037, 0x37 }, { 0x0038, 0x38 }, { 0x0039, 0x39 },
+	{ 0x003A, 0x3A }, { 0x003B, 0x3B }, { 0x003C, 0x3C }, { 0x003D, 0x3D },
+	{ 0x003E, 0x3E }, { 0x003F, 0x3F }, { 0x0040, 0x00 }, { 0x0041, 0x41 },
+	{ 0x0042, 0x42 }, { 0x0043, 0x43 }, { 0x0044, 0x44 }, { 0x0045, 0x45 },
+	{ 0x0046, 0x46 }, { 0x0047, 0x47 }, { 0x0048, 0x48 }, { 0x0049, 0x49 },
+	{ 0x004A, 0x4A }, { 0x004B, 0x4B }, { 0x004C, 0x4C }, { 0x004D, 0x4D },
+	{ 0x004E, 0x4E }, { 0x004F, 0x4F }, { 0x0050, 0x50 }, { 0x0051, 0x51 },
+	{ 0x0052, 0x52 }, { 0x0053, 0x53 }, { 0x0054, 0x54 }, { 0x0055, 0x55 },
+	{ 0x0056, 0x56 }, { 0x0057, 0x57 }, { 0x0058, 0x58 }, { 0x0059, 0x59 },
+	{ 0x005A, 0x5A }, { 0x005C, 0x17 }, { 0x005E, 0x16 }, { 0x005F, 0x11 },
+	{ 0x0060, 0x7D }, { 0x0061, 0x61 }, { 0x0062, 0x62 }, { 0x0063, 0x63 },
+	{ 0x0064, 0x64 }, { 0x0065, 0x65 }, { 0x0066, 0x66 }, { 0x0067, 0x67 },
+	{ 0x0068, 0x68 }, { 0x0069, 0x69 }, { 0x006A, 0x6A }, { 0x006B, 0x6B },
+	{ 0x006C, 0x6C }, { 0x006D, 0x6D }, { 0x006E, 0x6E }, { 0x006F, 0x6F },
+	{ 0x0070, 0x70 }, { 0x0071, 0x71 }, { 0x0072, 0x72 }, { 0x0073, 0x73 },
+	{ 0x0074, 0x74 }, { 0x0075, 0x75 }, { 0x0076, 0x76 }, { 0x0077, 0x77 },
+	{ 0x0078, 0x78 }, { 0x0079, 0x79 }, { 0x007A, 0x7A }, { 0x007C, 0x1A },
+	{ 0x007E, 0x60 }, { 0x00A0, 0x20 }, { 0x00A3, 0x01 }, { 0x00A5, 0x03 },
+	{ 0x00A7, 0x5F }, { 0x00AA, 0x12 }, { 0x00BA, 0x24 }, { 0x00C0, 0x14 },
+	{ 0x00C1, 0x0E }, { 0x00C2, 0x1C }, { 0x00C3, 0x5B }, { 0x00C7, 0x13 },
+	{ 0x00C9, 0x1F }, { 0x00CA, 0x1E }, { 0x00CD, 0x40 }, { 0x00D3, 0x19 },
+	{ 0x00D4, 0x0B }, { 0x00D5, 0x5C }, { 0x00DA, 0x5D }, { 0x00DC, 0x5E },
+	{ 0x00E0, 0x7F }, { 0x00E1, 0x0F }, { 0x00E2, 0x1D }, { 0x00E3, 0x7B },
+	{ 0x00E7, 0x09 }, { 0x00E9, 0x05 }, { 0x00EA, 0x04 }, { 0x00ED, 0x07 },
+	{ 0x00F3, 0x08 }, { 0x00F4, 0x0C }, { 0x00F5, 0x7C }, { 0x00FA, 0x06 },
+	{ 0x00FC, 0x7E }, { 0x0394, 0x10 }, { 0x20AC, 0x18 }, { 0x221E, 0x15 }
+};
+
+/* Appendix A.3.4 in 3GPP TS23.038 */
+static const unsigned short ben_gsm[] = {
+	0x0981, 0x0982, 0x0983, 0x0985, 0x0986, 0x0987, 0x0988, 0x0989,
+	0x098A, 0x098B, 0x000A, 0x098C, 0x0020, 0x000D, 0x0020, 0x098F,
+	0x0990, 0x0020, 0x0020, 0x0993, 0x0994, 0x0995, 0x0996, 0x0997,
+	0x0998, 0x0999, 0x099A, 0x00A0, 0x099B, 0x099C, 0x099D, 0x099E,
+	0x0020, 0x0021, 0x099F, 0x09A0, 0x09A1, 0x09A2, 0x09A3, 0x09A4,
+	0x0029, 0x0028, 0x09A5, 0x09A6, 0x002C, 0x09A7, 0x002E, 0x09A8,
+	0x0030, 0x0031, 0x0032, 0x0033, 0x0034, 0x0035, 0x0036, 0x0037,
+	0x0038, 0x0039, 0x003A, 0x003B, 0x0020, 0x09AA, 0x09AB, 0x003F,
+	0x09AC, 0x09AD, 0x09AE, 0x09AF, 0x09B0, 0x0020, 0x09B2, 0x0020,
+	0x0020, 0x0020, 0x09B6, 0x09B7, 0x09B8, 0x09B9, 0x09BC, 0x09BD,
+	0x09BE, 0x09BF, 0x09C0, 0x09C1, 0x09C2, 0x09C3, 0x09C4, 0x0020,
+	0x0020, 0x09C7, 0x09C8, 0x0020, 0x0020, 0x09CB, 0x09CC, 0x09CD,
+	0x09CE, 0x0061, 0x0062, 0x0063, 0x0064, 0x0065, 0x0066, 0x0067,
+	0x0068, 0x0069, 0x006A, 0x006B, 0x006C, 0x006D, 0x006E, 0x006F,
+	0x0070, 0x0071, 0x0072, 0x0073, 0x0074, 0x0075, 0x0076, 0x0077,
+	0x0078, 0x0079, 0x007A, 0x09D7, 0x09DC, 0x09DD, 0x09F0, 0x09F1
+};
+
+static const struct codepoint ben_unicode[] = {
+	{ 0x000A, 0x0A }, { 0x000D, 0x0D }, { 0x0020, 0x20 }, { 0x0021, 0x21 },
+	{ 0x0028, 0x29 }, { 0x0029, 0x28 }, { 0x002C, 0x2C }, { 0x002E, 0x2E },
+	{ 0x0030, 0x30 }, { 0x0031, 0x31 }, { 0x0032, 0x32 }, { 0x0033, 0x33 },
+	{ 0x0034, 0x34 }, { 0x0035, 0x35 }, { 0x0036, 0x36 }, { 0x0037, 0x37 },
+	{ 0x0038, 0x38 }, { 0x0039, 0x39 }, { 0x003A, 0x3A }, { 0x003B, 0x3B },
+	{ 0x003F, 0x3F }, { 0x0061, 0x61 }, { 0x0062, 0x62 }, { 0x0063, 0x63 },
+	{ 0x0064, 0x64 }, { 0x0065, 0x65 }, { 0x0066, 0x66 }, { 0x0067, 0x67 },
+	{ 0x0068, 0x68 }, { 0x0069, 0x69 }, { 0x006A, 0x6A }, { 0x006B, 0x6B },
+	{ 0x006C, 0x6C }, { 0x006D, 0x6D }, { 0x006E, 0x6E }, { 0x006F, 0x6F },
+	{ 0x0070, 0x70 }, { 0x0071, 0x71 }, { 0x0072, 0x72 }, { 0x0073, 0x73 },
+	{ 0x0074, 0x74 }, { 0x0075, 0x75 }, { 0x0076, 0x76 }, { 0x0077, 0x77 },
+	{ 0x0078, 0x78 }, { 0x0079, 0x79 }, { 0x007A, 0x7A }, { 0x00A0, 0x20 },
+	{ 0x0981, 0x00 }, { 0x0982, 0x01 }, { 0x0983, 0x02 }, { 0x0985, 0x03 },
+	{ 0x0986, 0x04 }, { 0x0987, 0x05 }, { 0x0988, 0x06 }, { 0x0989, 0x07 },
+	{ 0x098A, 0x08 }, { 0x098B, 0x09 }, { 0x098C, 0x0B }, { 0x098F, 0x0F },
+	{ 0x0990, 0x10 }, { 0x0993, 0x13 }, { 0x0994, 0x14 }, { 0x0995, 0x15 },
+	{ 0x0996, 0x16 }, { 0x0997, 0x17 }, { 0x0998, 0x18 }, { 0x0999, 0x19 },
+	{ 0x099A, 0x1A }, { 0x099B, 0x1C }, { 0x099C, 0x1D }, { 0x099D, 0x1E },
+	{ 0x099E, 0x1F }, { 0x099F, 0x22 }, { 0x09A0, 0x23 }, { 0x09A1, 0x24 },
+	{ 0x09A2, 0x25 }, { 0x09A3, 0x26 }, { 0x09A4, 0x27 }, { 0x09A5, 0x2A },
+	{ 0x09A6, 0x2B }, { 0x09A7, 0x2D }, { 0x09A8, 0x2F }, { 0x09AA, 0x3D },
+	{ 0x09AB, 0x3E }, { 0x09AC, 0x40 }, { 0x09AD, 0x41 }, { 0x09AE, 0x42 },
+	{ 0x09AF, 0x43 }, { 0x09B0, 0x44 }, { 0x09B2, 0x46 }, { 0x09B6, 0x4A },
+	{ 0x09B7, 0x4B }, { 0x09B8, 0x4C }, { 0x09B9, 0x4D }, { 0x09BC, 0x4E },
+	{ 0x09BD, 0x4F }, { 0x09BE, 0x50 }, { 0x09BF, 0x51 }, { 0x09C0, 0x52 },
+	{ 0x09C1, 0x53 }, { 0x09C2, 0x54 }, { 0x09C3, 0x55 }, { 0x09C4, 0x56 },
+	{ 0x09C7, 0x59 }, { 0x09C8, 0x5A }, { 0x09CB, 0x5D }, { 0x09CC, 0x5E },
+	{ 0x09CD, 0x5F }, { 0x09CE, 0x60 }, { 0x09D7, 0x7B }, { 0x09DC, 0x7C },
+	{ 0x09DD, 0x7D }, { 0x09F0, 0x7E }, { 0x09F1, 0x7F }
+};
+
+/* Appendix A.3.5 in 3GPP TS23.038 */
+static const unsigned short guj_gsm[] = {
+	0x0A81, 0x0A82, 0x0A83, 0x0A85, 0x0A86, 0x0A87, 0x0A88, 0x0A89,
+	0x0A8A, 0x0A8B, 0x000A, 0x0A8C, 0x0A8D, 0x000D, 0x0020, 0x0A8F,
+	0x0A90, 0x0A91, 0x0020, 0x0A93, 0x0A94, 0x0A95, 0x0A96, 0x0A97,
+	0x0A98, 0x0A99, 0x0A9A, 0x00A0, 0x0A9B, 0x0A9C, 0x0A9D, 0x0A9E,
+	0x0020, 0x0021, 0x0A9F, 0x0AA0, 0x0AA1, 0x0AA2, 0x0AA3, 0x0AA4,
+	0x0029, 0x0028, 0x0AA5, 0x0AA6, 0x002C, 0x0AA7, 0x002E, 0x0AA8,
+	0x0030, 0x0031, 0x0032, 0x0033, 0x0034, 0x0035, 0x0036, 0x0037,
+	0x0038, 0x0039, 0x003A, 0x003B, 0x0020, 0x0AAA, 0x0AAB, 0x003F,
+	0x0AAC, 0x0AAD, 0x0AAE, 0x0AAF, 0x0AB0, 0x0020, 0x0AB2, 0x0AB3,
+	0x0020, 0x0AB5, 0x0AB6, 0x0AB7, 0x0AB8, 0x0AB9, 0x0ABC, 0x0ABD,
+	0x0ABE, 0x0ABF, 0x0AC0, 0x0AC1, 0x0AC2, 0x0AC3, 0x0AC4, 0x0AC5,
+	0x0020, 0x0AC7, 0x0AC8, 0x0AC9, 0x0020, 0x0ACB, 0x0ACC, 0x0ACD,
+	0x0AD0, 0x0061, 0x0062, 0x0063, 0x0064, 0x0065, 0x0066, 0x0067,
+	0x0068, 0x0069, 0x006A, 0x006B, 0x006C, 0x006D, 0x006E, 0x006F,
+	0x0070, 0x0071, 0x0072, 0x0073, 0x0074, 0x0075, 0x0076, 0x0077,
+	0x0078, 0x0079, 0x007A, 0x0AE0, 0x0AE1, 0x0AE2, 0x0AE3, 0x0AF1
+};
+
+static const struct codepoint guj_unicode[] = {
+	{ 0x000A, 0x0A }, { 0x000D, 0x0D }, { 0x0020, 0x20 }, { 0x0021, 0x21 },
+	{ 0x0028, 0x29 }, { 0x0029, 0x28 }, { 0x002C, 0x2C }, { 0x002E, 0x2E },
+	{ 0x0030, 0x30 }, { 0x0031, 0x31 }, { 0x0032, 0x32 }, { 0x0033, 0x33 },
+	{ 0x0034, 0x34 }, { 0x0035, 0x35 }, { 0x0036, 0x36 }, { 0x0037, 0x37 },
+	{ 0x0038, 0x38 }, { 0x0039, 0x39 }, { 0x003A, 0x3A }, { 0x003B, 0x3B },
+	{ 0x003F, 0x3F }, { 0x0061, 0x61 }, { 0x0062, 0x62 }, { 0x0063, 0x63 },
+	{ 0x0064, 0x64 }, { 0x0065, 0x65 }, { 0x0066, 0x66 }, { 0x0067, 0x67 },
+	{ 0x0068, 0x68 }, { 0x0069, 0x69 }, { 0x006A, 0x6A }, { 0x006B, 0x6B },
+	{ 0x006C, 0x6C }, { 0x006D, 0x6D }, { 0x006E, 0x6E }, { 0x006F, 0x6F },
+	{ 0x0070, 0x70 }, { 0x0071, 0x71 }, { 0x0072, 0x72 }, { 0x0073, 0x73 },
+	{ 0x0074, 0x74 }, { 0x0075, 0x75 }, { 0x0076, 0x76 }, { 0x0077, 0x77 },
+	{ 0x0078, 0x78 }, { 0x0079, 0x79 }, { 0x007A, 0x7A }, { 0x00A0, 0x20 },
+	{ 0x0A81, 0x00 }, { 0x0A82, 0x01 }, { 0x0A83, 0x02 }, { 0x0A85, 0x03 },
+	{ 0x0A86, 0x04 }, { 0x0A87, 0x05 }, { 0x0A88, 0x06 }, { 0x0A89, 0x07 },
+	{ 0x0A8A, 0x08 }, { 0x0A8B, 0x09 }, { 0x0A8C, 0x0B }, { 0x0A8D, 0x0C },
+	{ 0x0A8F, 0x0F }, { 0x0A90, 0x10 }, { 0x0A91, 0x11 }, { 0x0A93, 0x13 },
+	{ 0x0A94, 0x14 }, { 0x0A95, 0x15 }, { 0x0A96, 0x16 }, { 0x0A97, 0x17 },
+	{ 0x0A98, 0x18 }, { 0x0A99, 0x19 }, { 0x0A9A, 0x1A }, { 0x0A9B, 0x1C },
+	{ 0x0A9C, 0x1D }, { 0x0A9D, 0x1E }, { 0x0A9E, 0x1F }, { 0x0A9F, 0x22 },
+	{ 0x0AA0, 0x23 }, { 0x0AA1, 0x24 }, { 0x0AA2, 0x25 }, { 0x0AA3, 0x26 },
+	{ 0x0AA4, 0x27 }, { 0x0AA5, 0x2A }, { 0x0AA6, 0x2B }, { 0x0AA7, 0x2D },
+	{ 0x0AA8, 0x2F }, { 0x0AAA, 0x3D }, { 0x0AAB, 0x3E }, { 0x0AAC, 0x40 },
+	{ 0x0AAD, 0x41 }, { 0x0AAE, 0x42 }, { 0x0AAF, 0x43 }, { 0x0AB0, 0x44 },
+	{ 0x0AB2, 0x46 }, { 0x0AB3, 0x47 }, { 0x0AB5, 0x49 }, { 0x0AB6, 0x4A },
+	{ 0x0AB7, 0x4B }, { 0x0AB8, 0x4C }, { 0x0AB9, 0x4D }, { 0x0ABC, 0x4E },
+	{ 0x0ABD, 0x4F }, { 0x0ABE, 0x50 }, { 0x0ABF, 0x51 }, { 0x0AC0, 0x52 },
+	{ 0x0AC1, 0x53 }, { 0x0AC2, 0x54 }, { 0x0AC3, 0x55 }, { 0x0AC4, 0x56 },
+	{ 0x0AC5, 0x57 }, { 0x0AC7, 0x59 }, { 0x0AC8, 0x5A }, { 0x0AC9, 0x5B },
+	{ 0x0ACB, 0x5D }, { 0x0ACC, 0x5E }, { 0x0ACD, 0x5F }, { 0x0AD0, 0x60 },
+	{ 0x0AE0, 0x7B }, { 0x0AE1, 0x7C }, { 0x0AE2, 0x7D }, { 0x0AE3, 0x7E },
+	{ 0x0AF1, 0x7F }
+};
+
+/* Appendix A.3.6 in 3GPP TS23.038 */
+static const unsigned short hin_gsm[] = {
+	0x0901, 0x0902, 0x0903, 0x0905, 0x0906, 0x0907, 0x0908, 0x0909,
+	0x090A, 0x090B, 0x000A, 0x090C, 0x090D, 0x000D, 0x090E, 0x090F,
+	0x0910, 0x0911, 0x0912, 0x0913, 0x0914, 0x0915, 0x0916, 0x0917,
+	0x0918, 0x0919, 0x091A, 0x00A0, 0x091B, 0x091C, 0x091D, 0x091E,
+	0x0020, 0x0021, 0x091F, 0x0920, 0x0921, 0x0922, 0x0923, 0x0924,
+	0x0029, 0x0028, 0x0925, 0x0926, 0x002C, 0x0927, 0x002E, 0x0928,
+	0x0030, 0x0031, 0x0032, 0x0033, 0x0034, 0x0035, 0x0036, 0x0037,
+	0x0038, 0x0039, 0x003A, 0x003B, 0x0929, 0x092A, 0x092B, 0x003F,
+	0x092C, 0x092D, 0x092E, 0x092F, 0x0930, 0x0931, 0x0932, 0x0933,
+	0x0934, 0x0935, 0x0936, 0x0937, 0x0938, 0x0939, 0x093C, 0x093D,
+	0x093E, 0x093F, 0x0940, 0x0941, 0x0942, 0x0943, 0x0944, 0x0945,
+	0x0946, 0x0947, 0x0948, 0x0949, 0x094A, 0x094B, 0x094C, 0x094D,
+	0x0950, 0x0061, 0x0062, 0x0063, 0x0064, 0x0065, 0x0066, 0x0067,
+	0x0068, 0x0069, 0x006A, 0x006B, 0x006C, 0x006D, 0x006E, 0x006F,
+	0x0070, 0x0071, 0x0072, 0x0073, 0x0074, 0x0075, 0x0076, 0x0077,
+	0x0078, 0x0079, 0x007A, 0x0972, 0x097B, 0x097C, 0x097E, 0x097F
+};
+
+static const struct codepoint hin_unicode[] = {
+	{ 0x000A, 0x0A }, { 0x000D, 0x0D }, { 0x0020, 0x20 }, { 0x0021, 0x21 },
+	{ 0x0028, 0x29 }, { 0x0029, 0x28 }, { 0x002C, 0x2C }, { 0x002E, 0x2E },
+	{ 0x0030, 0x30 }, { 0x0031, 0x31 }, { 0x0032, 0x32 }, { 0x0033, 0x33 },
+	{ 0x0034, 0x34 }, { 0x0035, 0x35 }, { 0x0036, 0x36 }, { 0x0037, 0x37 },
+	{ 0x0038, 0x38 }, { 0x0039, 0x39 }, { 0x003A, 0x3A }, { 0x003B, 0x3B },
+	{ 0x003F, 0x3F }, { 0x0061, 0x61 }, { 0x0062, 0x62 }, { 0x0063, 0x63 },
+	{ 0x0064, 0x64 }, { 0x0065, 0x65 }, { 0x0066, 0x66 }, { 0x0067, 0x67 },
+	{ 0x0068, 0x68 }, { 0x0069, 0x69 }, { 0x006A, 0x6A }, { 0x006B, 0x6B },
+	{ 0x006C, 0x6C }, { 0x006D, 0x6D }, { 0x006E, 0x6E }, { 0x006F, 0x6F },
+	{ 0x0070, 0x70 }, { 0x0071, 0x71 }, { 0x0072, 0x72 }, { 0x0073, 0x73 },
+	{ 0x0074, 0x74 }, { 0x0075, 0x75 }, { 0x0076, 0x76 }, { 0x0077, 0x77 },
+	{ 0x0078, 0x78 }, { 0x0079, 0x79 }, { 0x007A, 0x7A }, { 0x00A0, 0x20 },
+	{ 0x0901, 0x00 }, { 0x0902, 0x01 }, { 0x0903, 0x02 }, { 0x0905, 0x03 },
+	{ 0x0906, 0x04 }, { 0x0907, 0x05 }, { 0x0908, 0x06 }, { 0x0909, 0x07 },
+	{ 0x090A, 0x08 }, { 0x090B, 0x09 }, { 0x090C, 0x0B }, { 0x090D, 0x0C },
+	{ 0x090E, 0x0E }, { 0x090F, 0x0F }, { 0x0910, 0x10 }, { 0x0911, 0x11 },
+	{ 0x0912, 0x12 }, { 0x0913, 0x13 }, { 0x0914, 0x14 }, { 0x0915, 0x15 },
+	{ 0x0916, 0x16 }, { 0x0917, 0x17 }, { 0x0918, 0x18 }, { 0x0919, 0x19 },
+	{ 0x091A, 0x1A }, { 0x091B, 0x1C }, { 0x091C, 0x1D }, { 0x091D, 0x1E },
+	{ 0x091E, 0x1F }, { 0x091F, 0x22 }, { 0x0920, 0x23 }, { 0x0921, 0x24 },
+	{ 0x0922, 0x25 }, { 0x0923, 0x26 }, { 0x0924, 0x27 }, { 0x0925, 0x2A },
+	{ 0x0926, 0x2B }, { 0x0927, 0x2D }, { 0x0928, 0x2F }, { 0x0929, 0x3C },
+	{ 0x092A, 0x3D }, { 0x092B, 0x3E }, { 0x092C, 0x40 }, { 0x092D, 0x41 },
+	{ 0x092E, 0x42 }, { 0x092F, 0x43 }, { 0x0930, 0x44 }, { 0x0931, 0x45 },
+	{ 0x0932, 0x46 }, { 0x0933, 0x47 }, { 0x0934, 0x48 }, { 0x0935, 0x49 },
+	{ 0x0936, 0x4A }, { 0x0937, 0x4B }, { 0x0938, 0x4C }, { 0x0939, 0x4D },
+	{ 0x093C, 0x4E }, { 0x093D, 0x4F }, { 0x093E, 0x50 }, { 0x093F, 0x51 },
+	{ 0x0940, 0x52 }, { 0x0941, 0x53 }, { 0x0942, 0x54 }, { 0x0943, 0x55 },
+	{ 0x0944, 0x56 }, { 0x0945, 0x57 }, { 0x0946, 0x58 }, { 0x0947, 0x59 },
+	{ 0x0948, 0x5A }, { 0x0949, 0x5B }, { 0x094A, 0x5C }, { 0x094B, 0x5D },
+	{ 0x094C, 0x5E }, { 0x094D, 0x5F }, { 0x0950, 0x60 }, { 0x0972, 0x7B },
+	{ 0x097B, 0x7C }, { 0x097C, 0x7D }, { 0x097E, 0x7E }, { 0x097F, 0x7F }
+};
+
+/* Appendix A.3.7 in 3GPP TS23.038 */
+static const unsigned short kan_gsm[] = {
+	0x0020, 0x0C82, 0x0C83, 0x0C85, 0x0C86, 0x0C87, 0x0C88, 0x0C89,
+	0x0C8A, 0x0C8B, 0x000A, 0x0C8C, 0x0020, 0x000D, 0x0C8E, 0x0C8F,
+	0x0C90, 0x0020, 0x0C92, 0x0C93, 0x0C94, 0x0C95, 0x0C96, 0x0C97,
+	0x0C98, 0x0C99, 0x0C9A, 0x00A0, 0x0C9B, 0x0C9C, 0x0C9D, 0x0C9E,
+	0x0020, 0x0021, 0x0C9F, 0x0CA0, 0x0CA1, 0x0CA2, 0x0CA3, 0x0CA4,
+	0x0029, 0x0028, 0x0CA5, 0x0CA6, 0x002C, 0x0CA7, 0x002E, 0x0CA8,
+	0x0030, 0x0031, 0x0032, 0x0033, 0x0034, 0x0035, 0x0036, 0x0037,
+	0x0038, 0x0039, 0x003A, 0x003B, 0x0020, 0x0CAA, 0x0CAB, 0x003F,
+	0x0CAC, 0x0CAD, 0x0CAE, 0x0CAF, 0x0CB0, 0x0CB1, 0x0CB2, 0x0CB3,
+	0x0020, 0x0CB5, 0x0CB6, 0x0CB7, 0x0CB8, 0x0CB9, 0x0CBC, 0x0CBD,
+	0x0CBE, 0x0CBF, 0x0CC0, 0x0CC1, 0x0CC2, 0x0CC3, 0x0CC4, 0x0020,
+	0x0CC6, 0x0CC7, 0x0CC8, 0x0020, 0x0CCA, 0x0CCB, 0x0CCC, 0x0CCD,
+	0x0020, 0x0061, 0x0062, 0x0063, 0x0064, 0x0065, 0x0066, 0x0067,
+	0x0068, 0x0069, 0x006A, 0x006B, 0x006C, 0x006D, 0x006E, 0x006F,
+	0x0070, 0x0071, 0x0072, 0x0073, 0x0074, 0x0075, 0x0076, 0x0077,
+	0x0078, 0x0079, 0x007A, 0x0CD5, 0x0CD6, 0x0CE0, 0x0CE1, 0x0CE2
+};
+
+static const struct codepoint kan_unicode[] = {
+	{ 0x000A, 0x0A }, { 0x000D, 0x0D }, { 0x0020, 0x20 }, { 0x0021, 0x21 },
+	{ 0x0028, 0x29 }, { 0x0029, 0x28 }, { 0x002C, 0x2C }, { 0x002E, 0x2E },
+	{ 0x0030, 0x30 }, { 0x0031, 0x31 }, { 0x0032, 0x32 }, { 0x0033, 0x33 },
+	{ 0x0034, 0x34 }, { 0x0035, 0x35 }, { 0x0036, 0x36 }, { 0x0037, 0x37 },
+	{ 0x0038, 0x38 }, { 0x0039, 0x39 }, { 0x003A, 0x3A }, { 0x003B, 0x3B },
+	{ 0x003F, 0x3F }, { 0x0061, 0x61 }, { 0x0062, 0x62 }, { 0x0063, 0x63 },
+	{ 0x0064, 0x64 }, { 0x0065, 0x65 }, { 0x0066, 0x66 }, { 0x0067, 0x67 },
+	{ 0x0068, 0x68 }, { 0x0069, 0x69 }, { 0x006A, 0x6A }, { 0x006B, 0x6B },
+	{ 0x006C, 0x6C }, { 0x006D, 0x6D }, { 0x006E, 0x6E }, { 0x006F, 0x6F },
+	{ 0x0070, 0x70 }, { 0x0071, 0x71 }, { 0x0072, 0x72 }, { 0x0073, 0x73 },
+	{ 0x0074, 0x74 }, { 0x0075, 0x75 }, { 0x0076, 0x76 }, { 0x0077, 0x77 },
+	{ 0x0078, 0x78 }, { 0x0079, 0x79 }, { 0x007A, 0x7A }, { 0x00A0, 0x20 },
+	{ 0x0C82, 0x01 }, { 0x0C83, 0x02 }, { 0x0C85, 0x03 }, { 0x0C86, 0x04 },
+	{ 0x0C87, 0x05 }, { 0x0C88, 0x06 }, { 0x0C89, 0x07 }, { 0x0C8A, 0x08 },
+	{ 0x0C8B, 0x09 }, { 0x0C8C, 0x0B }, { 0x0C8E, 0x0E }, { 0x0C8F, 0x0F },
+	{ 0x0C90, 0x10 }, { 0x0C92, 0x12 }, { 0x0C93, 0x13 }, { 0x0C94, 0x14 },
+	{ 0x0C95, 0x15 }, { 0x0C96, 0x16 }, { 0x0C97, 0x17 }, { 0x0C98, 0x18 },
+	{ 0x0C99, 0x19 }, { 0x0C9A, 0x1A }, { 0x0C9B, 0x1C }, { 0x0C9C, 0x1D },
+	{ 0x0C9D, 0x1E }, { 0x0C9E, 0x1F }, { 0x0C9F, 0x22 }, { 0x0CA0, 0x23 },
+	{ 0x0CA1, 0x24 }, { 0x0CA2, 0x25 }, { 0x0CA3, 0x26 }, { 0x0CA4, 0x27 },
+	{ 0x0CA5, 0x2A }, { 0x0CA6, 0x2B }, { 0x0CA7, 0x2D }, { 0x0CA8, 0x2F },
+	{ 0x0CAA, 0x3D }, { 0x0CAB, 0x3E }, { 0x0CAC, 0x40 }, { 0x0CAD, 0x41 },
+	{ 0x0CAE, 0x42 }, { 0x0CAF, 0x43 }, { 0x0CB0, 0x44 }, { 0x0CB1, 0x45 },
+	{ 0x0CB2, 0x46 }, { 0x0CB3, 0x47 }, { 0x0CB5, 0x49 }, { 0x0CB6, 0x4A },
+	{ 0x0CB7, 0x4B }, { 0x0CB8, 0x4C }, { 0x0CB9, 0x4D }, { 0x0CBC, 0x4E },
+	{ 0x0CBD, 0x4F }, { 0x0CBE, 0x50 }, { 0x0CBF, 0x51 }, { 0x0CC0, 0x52 },
+	{ 0x0CC1, 0x53 }, { 0x0CC2, 0x54 }, { 0x0CC3, 0x55 }, { 0x0CC4, 0x56 },
+	{ 0x0CC6, 0x58 }, { 0x0CC7, 0x59 }, { 0x0CC8, 0x5A }, { 0x0CCA, 0x5C },
+	{ 0x0CCB, 0x5D }, { 0x0CCC, 0x5E }, { 0x0CCD, 0x5F }, { 0x0CD5, 0x7B },
+	{ 0x0CD6, 0x7C }, { 0x0CE0, 0x7D }, { 0x0CE1, 0x7E }, { 0x0CE2, 0x7F }
+};
+
+/* Appendix A.3.8 in 3GPP TS23.038 */
+static const unsigned short mal_gsm[] = {
+	0x0020, 0x0D02, 0x0D03, 0x0D05, 0x0D06, 0x0D07, 0x0D08, 0x0D09,
+	0x0D0A, 0x0D0B, 0x000A, 0x0D0C, 0x0020, 0x000D, 0x0D0E, 0x0D0F,
+	0x0D10, 0x0020, 0x0D12, 0x0D13, 0x0D14, 0x0D15, 0x0D16, 0x0D17,
+	0x0D18, 0x0D19, 0x0D1A, 0x00A0, 0x0D1B, 0x0D1C, 0x0D1D, 0x0D1E,
+	0x0020, 0x0021, 0x0D1F, 0x0D20, 0x0D21, 0x0D22, 0x0D23, 0x0D24,
+	0x0029, 0x0028, 0x0D25, 0x0D26, 0x002C, 0x0D27, 0x002E, 0x0D28,
+	0x0030, 0x0031, 0x0032, 0x0033, 0x0034, 0x0035, 0x0036, 0x0037,
+	0x0038, 0x0039, 0x003A, 0x003B, 0x0020, 0x0D2A, 0x0D2B, 0x003F,
+	0x0D2C, 0x0D2D, 0x0D2E, 0x0D2F, 0x0D30, 0x0D31, 0x0D32, 0x0D33,
+	0x0D34, 0x0D35, 0x0D36, 0x0D37, 0x0D38, 0x0D39, 0x0020, 0x0D3D,
+	0x0D3E, 0x0D3F, 0x0D40, 0x0D41, 0x0D42, 0x0D43, 0x0D44, 0x0020,
+	0x0D46, 0x0D47, 0x0D48, 0x0020, 0x0D4A, 0x0D4B, 0x0D4C, 0x0D4D,
+	0x0D57, 0x0061, 0x0062, 0x0063, 0x0064, 0x0065, 0x0066, 0x0067,
+	0x0068, 0x0069, 0x006A, 0x006B, 0x006C, 0x006D, 0x006E, 0x006F,
+	0x0070, 0x0071, 0x0072, 0x0073, 0x0074, 0x0075, 0x0076, 0x0077,
+	0x0078, 0x0079, 0x007A, 0x0D60, 0x0D61, 0x0D62, 0x0D63, 0x0D79
+};
+
+static const struct codepoint mal_unicode[] = {
+	{ 0x000A, 0x0A }, { 0x000D, 0x0D }, { 0x0020, 0x20 }, { 0x0021, 0x21 },
+	{ 0x0028, 0x29 }, { 0x0029, 0x28 }, { 0x002C, 0x2C }, { 0x002E, 0x2E },
+	{ 0x0030, 0x30 }, { 0x0031, 0x31 }, { 0x0032, 0x32 }, { 0x0033, 0x33 },
+	{ 0x0034, 0x34 }, { 0x0035, 0x35 }, { 0x0036, 0x36 }, { 0x0037, 0x37 },
+	{ 0x0038, 0x38 }, { 0x0039, 0x39 }, { 0x003A, 0x3A }, { 0x003B, 0x3B },
+	{ 0x003F, 0x3F }, { 0x0061, 0x61 }, { 0x0062, 0x62 }, { 0x0063, 0x63 },
+	{ 0x0064, 0x64 }, { 0x0065, 0x65 }, { 0x0066, 0x66 }, { 0x0067, 0x67 },
+	{ 0x0068, 0x68 }, { 0x0069, 0x69 }, { 0x006A, 0x6A }, { 0x006B, 0x6B },
+	{ 0x006C, 0x6C }, { 0x006D, 0x6D }, { 0x006E, 0x6E }, { 0x006F, 0x6F },
+	{ 0x0070, 0x70 }, { 0x0071, 0x71 }, { 0x0072, 0x72 }, { 0x0073, 0x73 },
+	{ 0x0074, 0x74 }, { 0x0075, 0x75 }, { 0x0076, 0x76 }, { 0x0077, 0x77 },
+	{ 0x0078, 0x78 }, { 0x0079, 0x79 }, { 0x007A, 0x7A }, { 0x00A0, 0x20 },
+	{ 0x0D02, 0x01 }, { 0x0D03, 0x02 }, { 0x0D05, 0x03 }, { 0x0D06, 0x04 },
+	{ 0x0D07, 0x05 }, { 0x0D08, 0x06 }, { 0x0D09, 0x07 }, { 0x0D0A, 0x08 },
+	{ 0x0D0B, 0x09 }, { 0x0D0C, 0x0B }, { 0x0D0E, 0x0E }, { 0x0D0F, 0x0F },
+	{ 0x0D10, 0x10 }, { 0x0D12, 0x12 }, { 0x0D13, 0x13 }, { 0x0D14, 0x14 },
+	{ 0x0D15, 0x15 }, { 0x0D16, 0x16 }, { 0x0D17, 0x17 }, { 0x0D18, 0x18 },
+	{ 0x0D19, 0x19 }, { 0x0D1A, 0x1A }, { 0x0D1B, 0x1C }, { 0x0D1C, 0x1D },
+	{ 0x0D1D, 0x1E }, { 0x0D1E, 0x1F }, { 0x0D1F, 0x22 }, { 0x0D20, 0x23 },
+	{ 0x0D21, 0x24 }, { 0x0D22, 0x25 }, { 0x0D23, 0x26 }, { 0x0D24, 0x27 },
+	{ 0x0D25, 0x2A }, { 0x0D26, 0x2B }, { 0x0D27, 0x2D }, { 0x0D28, 0x2F },
+	{ 0x0D2A, 0x3D }, { 0x0D2B, 0x3E }, { 0x0D2C, 0x40 }, { 0x0D2D, 0x41 },
+	{ 0x0D2E, 0x42 }, { 0x0D2F, 0x43 }, { 0x0D30, 0x44 }, { 0x0D31, 0x45 },
+	{ 0x0D32, 0x46 }, { 0x0D33, 0x47 }, { 0x0D34, 0x48 }, { 0x0D35, 0x49 },
+	{ 0x0D36, 0x4A }, { 0x0D37, 0x4B }, { 0x0D38, 0x4C }, { 0x0D39, 0x4D },
+	{ 0x0D3D, 0x4F }, { 0x0D3E, 0x50 }, { 0x0D3F, 0x51 }, { 0x0D40, 0x52 },
+	{ 0x0D41, 0x53 }, { 0x0D42, 0x54 }, { 0x0D43, 0x55 }, { 0x0D44, 0x56 },
+	{ 0x0D46, 0x58 }, { 0x0D47, 0x59 }, { 0x0D48, 0x5A }, { 0x0D4A, 0x5C },
+	{ 0x0D4B, 0x5D }, { 0x0D4C, 0x5E }, { 0x0D4D, 0x5F }, { 0x0D57, 0x60 },
+	{ 0x0D60, 0x7B }, { 0x0D61, 0x7C }, { 0x0D62, 0x7D }, { 0x0D63, 0x7E },
+	{ 0x0D79, 0x7F }
+};
+
+/* Appendix A.3.9 in 3GPP TS23.038 */
+static const unsigned short ori_gsm[] = {
+	0x0B01, 0x0B02, 0x0B03, 0x0B05, 0x0B06, 0x0B07, 0x0B08, 0x0B09,
+	0x0B0A, 0x0B0B, 0x000A, 0x0B0C, 0x0020, 0x000D, 0x0020, 0x0B0F,
+	0x0B10, 0x0020, 0x0020, 0x0B13, 0x0B14, 0x0B15, 0x0B16, 0x0B17,
+	0x0B18, 0x0B19, 0x0B1A, 0x00A0, 0x0B1B, 0x0B1C, 0x0B1D, 0x0B1E,
+	0x0020, 0x0021, 0x0B1F, 0x0B20, 0x0B21, 0x0B22, 0x0B23, 0x0B24,
+	0x0029, 0x0028, 0x0B25, 0x0B26, 0x002C, 0x0B27, 0x002E, 0x0B28,
+	0x0030, 0x0031, 0x0032, 0x0033, 0x0034, 0x0035, 0x0036, 0x0037,
+	0x0038, 0x0039, 0x003A, 0x003B, 0x0020, 0x0B2A, 0x0B2B, 0x003F,
+	0x0B2C, 0x0B2D, 0x0B2E, 0x0B2F, 0x0B30, 0x0020, 0x0B32, 0x0B33,
+	0x0020, 0x0B35, 0x0B36, 0x0B37, 0x0B38, 0x0B39, 0x0B3C, 0x0B3D,
+	0x0B3E, 0x0B3F, 0x0B40, 0x0B41, 0x0B42, 0x0B43, 0x0B44, 0x0020,
+	0x0020, 0x0B47, 0x0B48, 0x0020, 0x0020, 0x0B4B, 0x0B4C, 0x0B4D,
+	0x0B56, 0x0061, 0x0062, 0x0063, 0x0064, 0x0065, 0x0066, 0x0067,
+	0x0068, 0x0069, 0x006A, 0x006B, 0x006C, 0x006D, 0x006E, 0x006F,
+	0x0070, 0x0071, 0x0072, 0x0073, 0x0074, 0x0075, 0x0076, 0x0077,
+	0x0078, 0x0079, 0x007A, 0x0B57, 0x0B60, 0x0B61, 0x0B62, 0x0B63
+};
+
+static const struct codepoint ori_unicode[] = {
+	{ 0x000A, 0x0A }, { 0x000D, 0x0D }, { 0x0020, 0x20 }, { 0x0021, 0x21 },
+	{ 0x0028, 0x29 }, { 0x0029, 0x28 }, { 0x002C, 0x2C }, { 0x002E, 0x2E },
+	{ 0x0030, 0x30 }, { 0x0031, 0x31 }, { 0x0032, 0x32 }, { 0x0033, 0x33 },
+	{ 0x0034, 0x34 }, { 0x0035, 0x35 }, { 0x0036, 0x36 }, { 0x0037, 0x37 },
+	{ 0x0038, 0x38 }, { 0x0039, 0x39 }, { 0x003A, 0x3A }, { 0x003B, 0x3B },
+	{ 0x003F, 0x3F }, { 0x0061, 0x61 }, { 0x0062, 0x62 }, { 0x0063, 0x63 },
+	{ 0x0064, 0x64 }, { 0x0065, 0x65 }, { 0x0066, 0x66 }, { 0x0067, 0x67 },
+	{ 0x0068, 0x68 }, { 0x0069, 0x69 }, { 0x006A, 0x6A }, { 0x006B, 0x6B },
+	{ 0x006C, 0x6C }, { 0x006D, 0x6D }, { 0x006E, 0x6E }, { 0x006F, 0x6F },
+	{ 0x0070, 0x70 }, { 0x0071, 0x71 }, { 0x0072, 0x72 }, { 0x0073, 0x73 },
+	{ 0x0074, 0x74 }, { 0x0075, 0x75 }, { 0x0076, 0x76 }, { 0x0077, 0x77 },
+	{ 0x0078, 0x78 }, { 0x0079, 0x79 }, { 0x007A, 0x7A }, { 0x00A0, 0x20 },
+	{ 0x0B01, 0x00 }, { 0x0B02, 0x01 }, { 0x0B03, 0x02 }, { 0x0B05, 0x03 },
+	{ 0x0B06, 0x04 }, { 0x0B07, 0x05 }, { 0x0B08, 0x06 }, { 0x0B09, 0x07 },
+	{ 0x0B0A, 0x08 }, { 0x0B0B, 0x09 }, { 0x0B0C, 0x0B }, { 0x0B0F, 0x0F },
+	{ 0x0B10, 0x10 }, { 0x0B13, 0x13 }, { 0x0B14, 0x14 }, { 0x0B15, 0x15 },
+	{ 0x0B16, 0x16 }, { 0x0B17, 0x17 }, { 0x0B18, 0x18 }, { 0x0B19, 0x19 },
+	{ 0x0B1A, 0x1A }, { 0x0B1B, 0x1C }, { 0x0B1C, 0x1D }, { 0x0B1D, 0x1E },
+	{ 0x0B1E, 0x1F }, { 0x0B1F, 0x22 }, { 0x0B20, 0x23 }, { 0x0B21, 0x24 },
+	{ 0x0B22, 0x25 }, { 0x0B23, 0x26 }, { 0x0B24, 0x27 }, { 0x0B25, 0x2A },
+	{ 0x0B26, 0x2B }, { 0x0B27, 0x2D }, { 0x0B28, 0x2F }, { 0x0B2A, 0x3D },
+	{ 0x0B2B, 0x3E }, { 0x0B2C, 0x40 }, { 0x0B2D, 0x41 }, { 0x0B2E, 0x42 },
+	{ 0x0B2F, 0x43 }, { 0x0B30, 0x44 }, { 0x0B32, 0x46 }, { 0x0B33, 0x47 },
+	{ 0x0B35, 0x49 }, { 0x0B36, 0x4A }, { 0x0B37, 0x4B }, { 0x0B38, 0x4C },
+	{ 0x0B39, 0x4D }, { 0x0B3C, 0x4E }, { 0x0B3D, 0x4F }, { 0x0B3E, 0x50 },
+	{ 0x0B3F, 0x51 }, { 0x0B40, 0x52 }, { 0x0B41, 0x53 }, { 0x0B42, 0x54 },
+	{ 0x0B43, 0x55 }, { 0x0B44, 0x56 }, { 0x0B47, 0x59 }, { 0x0B48, 0x5A },
+	{ 0x0B4B, 0x5D }, { 0x0B4C, 0x5E }, { 0x0B4D, 0x5F }, { 0x0B56, 0x60 },
+	{ 0x0B57, 0x7B }, { 0x0B60, 0x7C }, { 0x0B61, 0x7D }, { 0x0B62, 0x7E },
+	{ 0x0B63, 0x7F }
+};
+
+/* Appendix A.3.10 in 3GPP TS23.038 */
+static const unsigned short pun_gsm[] = {
+	0x0A01, 0x0A02, 0x0A03, 0x0A05, 0x0A06, 0x0A07, 0x0A08, 0x0A09,
+	0x0A0A, 0x0020, 0x000A, 0x0020, 0x0020, 0x000D, 0x0020, 0x0A0F,
+	0x0A10, 0x0020, 0x0020, 0x0A13, 0x0A14, 0x0A15, 0x0A16, 0x0A17,
+	0x0A18, 0x0A19, 0x0A1A, 0x00A0, 0x0A1B, 0x0A1C, 0x0A1D, 0x0A1E,
+	0x0020, 0x0021, 0x0A1F, 0x0A20, 0x0A21, 0x0A22, 0x0A23, 0x0A24,
+	0x0029, 0x0028, 0x0A25, 0x0A26, 0x002C, 0x0A27, 0x002E, 0x0A28,
+	0x0030, 0x0031, 0x0032, 0x0033, 0x0034, 0x0035, 0x0036, 0x0037,
+	0x0038, 0x0039, 0x003A, 0x003B, 0x0020, 0x0A2A, 0x0A2B, 0x003F,
+	0x0A2C, 0x0A2D, 0x0A2E, 0x0A2F, 0x0A30, 0x0020, 0x0A32, 0x0A33,
+	0x0020, 0x0A35, 0x0A36, 0x0020, 0x0A38, 0x0A39, 0x0A3C, 0x0020,
+	0x0A3E, 0x0A3F, 0x0A40, 0x0A41, 0x0A42, 0x0020, 0x0020, 0x0020,
+	0x0020, 0x0A47, 0x0A48, 0x0020, 0x0020, 0x0A4B, 0x0A4C, 0x0A4D,
+	0x0A70, 0x0061, 0x0062, 0x0063, 0x0064, 0x0065, 0x0066, 0x0067,
+	0x0068, 0x0069, 0x006A, 0x006B, 0x006C, 0x006D, 0x006E, 0x006F,
+	0x0070, 0x0071, 0x0072, 0x0073, 0x0074, 0x0075, 0x0076, 0x0077,
+	0x0078, 0x0079, 0x007A, 0x0A71, 0x0A72, 0x0A73, 0x0A74, 0x0020
+};
+
+static const struct codepoint pun_unicode[] = {
+	{ 0x000A, 0x0A }, { 0x000D, 0x0D }, { 0x0020, 0x20 }, { 0x0021, 0x21 },
+	{ 0x0028, 0x29 }, { 0x0029, 0x28 }, { 0x002C, 0x2C }, { 0x002E, 0x2E },
+	{ 0x0030, 0x30 }, { 0x0031, 0x31 }, { 0x0032, 0x32 }, { 0x0033, 0x33 },
+	{ 0x0034, 0x34 }, { 0x0035, 0x35 }, { 0x0036, 0x36 }, { 0x0037, 0x37 },
+	{ 0x0038, 0x38 }, { 0x0039, 0x39 }, { 0x003A, 0x3A }, { 0x003B, 0x3B },
+	{ 0x003F, 0x3F }, { 0x0061, 0x61 }, { 0x0062, 0x62 }, { 0x0063, 0x63 },
+	{ 0x0064, 0x64 }, { 0x0065, 0x65 }, { 0x0066, 0x66 }, { 0x0067, 0x67 },
+	{ 0x0068, 0x68 }, { 0x0069, 0x69 }, { 0x006A, 0x6A }, { 0x006B, 0x6B },
+	{ 0x006C, 0x6C }, { 0x006D, 0x6D }, { 0x006E, 0x6E }, { 0x006F, 0x6F },
+	{ 0x0070, 0x70 }, { 0x0071, 0x71 }, { 0x0072, 0x72 }, { 0x0073, 0x73 },
+	{ 0x0074, 0x74 }, { 0x0075, 0x75 }, { 0x0076, 0x76 }, { 0x0077, 0x77 },
+	{ 0x0078, 0x78 }, { 0x0079, 0x79 }, { 0x007A, 0x7A }, { 0x00A0, 0x20 },
+	{ 0x0A01, 0x00 }, { 0x0A02, 0x01 }, { 0x0A03, 0x02 }, { 0x0A05, 0x03 },
+	{ 0x0A06, 0x04 }, { 0x0A07, 0x05 }, { 0x0A08, 0x06 }, { 0x0A09, 0x07 },
+	{ 0x0A0A, 0x08 }, { 0x0A0F, 0x0F }, { 0x0A10, 0x10 }, { 0x0A13, 0x13 },
+	{ 0x0A14, 0x14 }, { 0x0A15, 0x15 }, { 0x0A16, 0x16 }, { 0x0A17, 0x17 },
+	{ 0x0A18, 0x18 }, { 0x0A19, 0x19 }, { 0x0A1A, 0x1A }, { 0x0A1B, 0x1C },
+	{ 0x0A1C, 0x1D }, { 0x0A1D, 0x1E }, { 0x0A1E, 0x1F }, { 0x0A1F, 0x22 },
+	{ 0x0A20, 0x23 }, { 0x0A21, 0x24 }, { 0x0A22, 0x25 }, { 0x0A23, 0x26 },
+	{ 0x0A24, 0x27 }, { 0x0A25, 0x2A }, { 0x0A26, 0x2B }, { 0x0A27, 0x2D },
+	{ 0x0A28, 0x2F }, { 0x0A2A, 0x3D }, { 0x0A2B, 0x3E }, { 0x0A2C, 0x40 },
+	{ 0x0A2D, 0x41 }, { 0x0A2E, 0x42 }, { 0x0A2F, 0x43 }, { 0x0A30, 0x44 },
+	{ 0x0A32, 0x46 }, { 0x0A33, 0x47 }, { 0x0A35, 0x49 }, { 0x0A36, 0x4A },
+	{ 0x0A38, 0x4C }, { 0x0A39, 0x4D }, { 0x0A3C, 0x4E }, { 0x0A3E, 0x50 },
+	{ 0x0A3F, 0x51 }, { 0x0A40, 0x52 }, { 0x0A41, 0x53 }, { 0x0A42, 0x54 },
+	{ 0x0A47, 0x59 }, { 0x0A48, 0x5A }, { 0x0A4B, 0x5D }, { 0x0A4C, 0x5E },
+	{ 0x0A4D, 0x5F }, { 0x0A70, 0x60 }, { 0x0A71, 0x7B }, { 0x0A72, 0x7C },
+	{ 0x0A73, 0x7D }, { 0x0A74, 0x7E }
+};
+
+/* Appendix A.3.11 in 3GPP TS23.038 */
+static const unsigned short tam_gsm[] = {
+	0x0020, 0x0B82, 0x0B83, 0x0B85, 0x0B86, 0x0B87, 0x0B88, 0x0B89,
+	0x0B8A, 0x0020, 0x000A, 0x0020, 0x0020, 0x000D, 0x0B8E, 0x0B8F,
+	0x0B90, 0x0020, 0x0B92, 0x0B93, 0x0B94, 0x0B95, 0x0020, 0x0020,
+	0x0020, 0x0B99, 0x0B9A, 0x00A0, 0x0020, 0x0B9C, 0x0020, 0x0B9E,
+	0x0020, 0x0021, 0x0B9F, 0x0020, 0x0020, 0x0020, 0x0BA3, 0x0BA4,
+	0x0029, 0x0028, 0x0020, 0x0020, 0x002C, 0x0020, 0x002E, 0x0BA8,
+	0x0030, 0x0031, 0x0032, 0x0033, 0x0034, 0x0035, 0x0036, 0x0037,
+	0x0038, 0x0039, 0x003A, 0x003B, 0x0BA9, 0x0BAA, 0x0020, 0x003F,
+	0x0020, 0x0020, 0x0BAE, 0x0BAF, 0x0BB0, 0x0BB1, 0x0BB2, 0x0BB3,
+	0x0BB4, 0x0BB5, 0x0BB6, 0x0BB7, 0x0BB8, 0x0BB9, 0x0020, 0x0020,
+	0x0BBE, 0x0BBF, 0x0BC0, 0x0BC1, 0x0BC2, 0x0020, 0x0020, 0x0020,
+	0x0BC6, 0x0BC7, 0x0BC8, 0x0020, 0x0BCA, 0x0BCB, 0x0BCC, 0x0BCD,
+	0x0BD0, 0x0061, 0x0062, 0x0063, 0x0064, 0x0065, 0x0066, 0x0067,
+	0x0068, 0x0069, 0x006A, 0x006B, 0x006C, 0x006D, 0x006E, 0x006F,
+	0x0070, 0x0071, 0x0072, 0x0073, 0x0074, 0x0075, 0x0076, 0x0077,
+	0x0078, 0x0079, 0x007A, 0x0BD7, 0x0BF0, 0x0BF1, 0x0BF2, 0x0BF9
+};
+
+static const struct codepoint tam_unicode[] = {
+	{ 0x000A, 0x0A }, { 0x000D, 0x0D }, { 0x0020, 0x20 }, { 0x0021, 0x21 },
+	{ 0x0028, 0x29 }, { 0x0029, 0x28 }, { 0x002C, 0x2C }, { 0x002E, 0x2E },
+	{ 0x0030, 0x30 }, { 0x0031, 0x31 }, { 0x0032, 0x32 }, { 0x0033, 0x33 },
+	{ 0x0034, 0x34 }, { 0x0035, 0x35 }, { 0x0036, 0x36 }, { 0x0037, 0x37 },
+	{ 0x0038, 0x38 }, { 0x0039, 0x39 }, { 0x003A, 0x3A }, { 0x003B, 0x3B },
+	{ 0x003F, 0x3F }, { 0x0061, 0x61 }, { 0x0062, 0x62 }, { 0x0063, 0x63 },
+	{ 0x0064, 0x64 }, { 0x0065, 0x65 }, { 0x0066, 0x66 }, { 0x0067, 0x67 },
+	{ 0x0068, 0x68 }, { 0x0069, 0x69 }, { 0x006A, 0x6A }, { 0x006B, 0x6B },
+	{ 0x006C, 0x6C }, { 0x006D, 0x6D }, { 0x006E, 0x6E }, { 0x006F, 0x6F },
+	{ 0x0070, 0x70 }, { 0x0071, 0x71 }, { 0x0072, 0x72 }, { 0x0073, 0x73 },
+	{ 0x0074, 0x74 }, { 0x0075, 0x75 }, { 0x0076, 0x76 }, { 0x0077, 0x77 },
+	{ 0x0078, 0x78 }, { 0x0079, 0x79 }, { 0x007A, 0x7A }, { 0x00A0, 0x20 },
+	{ 0x0B82, 0x01 }, { 0x0B83, 0x02 }, { 0x0B85, 0x03 }, { 0x0B86, 0x04 },
+	{ 0x0B87, 0x05 }, { 0x0B88, 0x06 }, { 0x0B89, 0x07 }, { 0x0B8A, 0x08 },
+	{ 0x0B8E, 0x0E }, { 0x0B8F, 0x0F }, { 0x0B90, 0x10 }, { 0x0B92, 0x12 },
+	{ 0x0B93, 0x13 }, { 0x0B94, 0x14 }, { 0x0B95, 0x15 }, { 0x0B99, 0x19 },
+	{ 0x0B9A, 0x1A }, { 0x0B9C, 0x1D }, { 0x0B9E, 0x1F }, { 0x0B9F, 0x22 },
+	{ 0x0BA3, 0x26 }, { 0x0BA4, 0x27 }, { 0x0BA8, 0x2F }, { 0x0BA9, 0x3C },
+	{ 0x0BAA, 0x3D }, { 0x0BAE, 0x42 }, { 0x0BAF, 0x43 }, { 0x0BB0, 0x44 },
+	{ 0x0BB1, 0x45 }, { 0x0BB2, 0x46 }, { 0x0BB3, 0x47 }, { 0x0BB4, 0x48 },
+	{ 0x0BB5, 0x49 }, { 0x0BB6, 0x4A }, { 0x0BB7, 0x4B }, { 0x0BB8, 0x4C },
+	{ 0x0BB9, 0x4D }, { 0x0BBE, 0x50 }, { 0x0BBF, 0x51 }, { 0x0BC0, 0x52 },
+	{ 0x0BC1, 0x53 }, { 0x0BC2, 0x54 }, { 0x0BC6, 0x58 }, { 0x0BC7, 0x59 },
+	{ 0x0BC8, 0x5A }, { 0x0BCA, 0x5C }, { 0x0BCB, 0x5D }, { 0x0BCC, 0x5E },
+	{ 0x0BCD, 0x5F }, { 0x0BD0, 0x60 }, { 0x0BD7, 0x7B }, { 0x0BF0, 0x7C },
+	{ 0x0BF1, 0x7D }, { 0x0BF2, 0x7E }, { 0x0BF9, 0x7F }
+};
+
+/* Appendix A.3.12 in 3GPP TS23.038 */
+static const unsigned short tel_gsm[] = {
+	0x0C01, 0x0C02, 0x0C03, 0x0C05, 0x0C06, 0x0C07, 0x0C08, 0x0C09,
+	0x0C0A, 0x0C0B, 0x000A, 0x0C0C, 0x0020, 0x000D, 0x0C0E, 0x0C0F,
+	0x0C10, 0x0020, 0x0C12, 0x0C13, 0x0C14, 0x0C15, 0x0C16, 0x0C17,
+	0x0C18, 0x0C19, 0x0C1A, 0x00A0, 0x0C1B, 0x0C1C, 0x0C1D, 0x0C1E,
+	0x0020, 0x0021, 0x0C1F, 0x0C20, 0x0C21, 0x0C22, 0x0C23, 0x0C24,
+	0x0029, 0x0028, 0x0C25, 0x0C26, 0x002C, 0x0C27, 0x002E, 0x0C28,
+	0x0030, 0x0031, 0x0032, 0x0033, 0x0034, 0x0035, 0x0036, 0x0037,
+	0x0038, 0x0039, 0x003A, 0x003B, 0x0020, 0x0C2A, 0x0C2B, 0x003F,
+	0x0C2C, 0x0C2D, 0x0C2E, 0x0C2F, 0x0C30, 0x0C31, 0x0C32, 0x0C33,
+	0x0020, 0x0C35, 0x0C36, 0x0C37, 0x0C38, 0x0C39, 0x0020, 0x0C3D,
+	0x0C3E, 0x0C3F, 0x0C40, 0x0C41, 0x0C42, 0x0C43, 0x0C44, 0x0020,
+	0x0C46, 0x0C47, 0x0C48, 0x0020, 0x0C4A, 0x0C4B, 0x0C4C, 0x0C4D,
+	0x0020, 0x0061, 0x0062, 0x0063, 0x0064, 0x0065, 0x0066, 0x0067,
+	0x0068, 0x0069, 0x006A, 0x006B, 0x006C, 0x006D, 0x006E, 0x006F,
+	0x0070, 0x0071, 0x0072, 0x0073, 0x0074, 0x0075, 0x0076, 0x0077,
+	0x0078, 0x0079, 0x007A, 0x0C55, 0x0C56, 0x0C60, 0x0C61, 0x0C62
+};
+
+static const struct codepoint tel_unicode[] = {
+	{ 0x000A, 0x0A }, { 0x000D, 0x0D }, { 0x0020, 0x20 }, { 0x0021, 0x21 },
+	{ 0x0028, 0x29 }, { 0x0029, 0x28 }, { 0x002C, 0x2C }, { 0x002E, 0x2E },
+	{ 0x0030, 0x30 }, { 0x0031, 0x31 }, { 0x0032, 0x32 }, { 0x0033, 0x33 },
+	{ 0x0034, 0x34 }, { 0x0035, 0x35 }, { 0x0036, 0x36 }, { 0x0037, 0x37 },
+	{ 0x0038, 0x38 }, { 0x0039, 0x39 }, { 0x003A, 0x3A }, { 0x003B, 0x3B },
+	{ 0x003F, 0x3F }, { 0x0061, 0x61 }, { 0x0062, 0x62 }, { 0x0063, 0x63 },
+	{ 0x0064, 0x64 }, { 0x0065, 0x65 }, { 0x0066, 0x66 }, { 0x0067, 0x67 },
+	{ 0x0068, 0x68 }, { 0x0069, 0x69 }, { 0x006A, 0x6A }, { 0x006B, 0x6B },
+	{ 0x006C, 0x6C }, { 0x006D, 0x6D }, { 0x006E, 0x6E }, { 0x006F, 0x6F },
+	{ 0x0070, 0x70 }, { 0x0071, 0x71 }, { 0x0072, 0x72 }, { 0x0073, 0x73 },
+	{ 0x0074, 0x74 }, { 0x0075, 0x75 }, { 0x0076, 0x76 }, { 0x0077, 0x77 },
+	{ 0x0078, 0x78 }, { 0x0079, 0x79 }, { 0x007A, 0x7A }, { 0x00A0, 0x20 },
+	{ 0x0C01, 0x00 }, { 0x0C02, 0x01 }, { 0x0C03, 0x02 }, { 0x0C05, 0x03 },
+	{ 0x0C06, 0x04 }, { 0x0C07, 0x05 }, { 0x0C08, 0x06 }, { 0x0C09, 0x07 },
+	{ 0x0C0A, 0x08 }, { 0x0C0B, 0x09 }, { 0x0C0C, 0x0B }, { 0x0C0E, 0x0E },
+	{ 0x0C0F, 0x0F }, { 0x0C10, 0x10 }, { 0x0C12, 0x12 }, { 0x0C13, 0x13 },
+	{ 0x0C14, 0x14 }, { 0x0C15, 0x15 }, { 0x0C16, 0x16 }, { 0x0C17, 0x17 },
+	{ 0x0C18, 0x18 }, { 0x0C19, 0x19 }, { 0x0C1A, 0x1A }, { 0x0C1B, 0x1C },
+	{ 0x0C1C, 0x1D }, { 0x0C1D, 0x1E }, { 0x0C1E, 0x1F }, { 0x0C1F, 0x22 },
+	{ 0x0C20, 0x23 }, { 0x0C21, 0x24 }, { 0x0C22, 0x25 }, { 0x0C23, 0x26 },
+	{ 0x0C24, 0x27 }, { 0x0C25, 0x2A }, { 0x0C26, 0x2B }, { 0x0C27, 0x2D },
+	{ 0x0C28, 0x2F }, { 0x0C2A, 0x3D }, { 0x0C2B, 0x3E }, { 0x0C2C, 0x40 },
+	{ 0x0C2D, 0x41 }, { 0x0C2E, 0x42 }, { 0x0C2F, 0x43 }, { 0x0C30, 0x44 },
+	{ 0x0C31, 0x45 }, { 0x0C32, 0x46 }, { 0x0C33, 0x47 }, { 0x0C35, 0x49 },
+	{ 0x0C36, 0x4A }, { 0x0C37, 0x4B }, { 0x0C38, 0x4C }, { 0x0C39, 0x4D },
+	{ 0x0C3D, 0x4F }, { 0x0C3E, 0x50 }, { 0x0C3F, 0x51 }, { 0x0C40, 0x52 },
+	{ 0x0C41, 0x53 }, { 0x0C42, 0x54 }, { 0x0C43, 0x55 }, { 0x0C44, 0x56 },
+	{ 0x0C46, 0x58 }, { 0x0C47, 0x59 }, { 0x0C48, 0x5A }, { 0x0C4A, 0x5C },
+	{ 0x0C4B, 0x5D }, { 0x0C4C, 0x5E }, { 0x0C4D, 0x5F }, { 0x0C55, 0x7B },
+	{ 0x0C56, 0x7C }, { 0x0C60, 0x7D }, { 0x0C61, 0x7E }, { 0x0C62, 0x7F }
+};
+
+/* Appendix A.3.13 in 3GPP TS23.038 */
+static const unsigned short urd_gsm[] = {
+	0x0627, 0x0622, 0x0628, 0x067B, 0x0680, 0x067E, 0x06A6, 0x062A,
+	0x06C2, 0x067F, 0x000A, 0x0679, 0x067D, 0x000D, 0x067A, 0x067C,
+	0x062B, 0x062C, 0x0681, 0x0684, 0x0683, 0x0685, 0x0686, 0x0687,
+	0x062D, 0x062E, 0x062F, 0x00A0, 0x068C, 0x0688, 0x0689, 0x068A,
+	0x0020, 0x0021, 0x068F, 0x068D, 0x0630, 0x0631, 0x0691, 0x0693,
+	0x0029, 0x0028, 0x0699, 0x0632, 0x002C, 0x0696, 0x002E, 0x0698,
+	0x0030, 0x0031, 0x0032, 0x0033, 0x0034, 0x0035, 0x0036, 0x0037,
+	0x0038, 0x0039, 0x003A, 0x003B, 0x069A, 0x0633, 0x0634, 0x003F,
+	0x0635, 0x0636, 0x0637, 0x0638, 0x0639, 0x0641, 0x0642, 0x06A9,
+	0x06AA, 0x06AB, 0x06AF, 0x06B3, 0x06B1, 0x0644, 0x0645, 0x0646,
+	0x06BA, 0x06BB, 0x06BC, 0x0648, 0x06C4, 0x06D5, 0x06C1, 0x06BE,
+	0x0621, 0x06CC, 0x06D0, 0x06D2, 0x064D, 0x0650, 0x064F, 0x0657,
+	0x0654, 0x0061, 0x0062, 0x0063, 0x0064, 0x0065, 0x0066, 0x0067,
+	0x0068, 0x0069, 0x006A, 0x006B, 0x006C, 0x006D, 0x006E, 0x006F,
+	0x0070, 0x0071, 0x0072, 0x0073, 0x0074, 0x0075, 0x0076, 0x0077,
+	0x0078, 0x0079, 0x007A, 0x0655, 0x0651, 0x0653, 0x0656, 0x0670
 };
 
-static const struct codepoint por_unicode[] = {
+static const struct codepoint urd_unicode[] = {
 	{ 0x000A, 0x0A }, { 0x000D, 0x0D }, { 0x0020, 0x20 }, { 0x0021, 0x21 },
-	{ 0x0022, 0x22 }, { 0x0023, 0x23 }, { 0x0024, 0x02 }, { 0x0025, 0x25 },
-	{ 0x0026, 0x26 }, { 0x0027, 0x27 }, { 0x0028, 0x28 }, { 0x0029, 0x29 },
-	{ 0x002A, 0x2A }, { 0x002B, 0x2B }, { 0x002C, 0x2C }, { 0x002D, 0x2D },
-	{ 0x002E, 0x2E }, { 0x002F, 0x2F }, { 0x0030, 0x30 }, { 0x0031, 0x31 },
-	{ 0x0032, 0x32 }, { 0x0033, 0x33 }, { 0x0034, 0x34 }, { 0x0035, 0x35 },
-	{ 0x0036, 0x36 }, { 0x0037, 0x37 }, { 0x0038, 0x38 }, { 0x0039, 0x39 },
-	{ 0x003A, 0x3A }, { 0x003B, 0x3B }, { 0x003C, 0x3C }, { 0x003D, 0x3D },
-	{ 0x003E, 0x3E }, { 0x003F, 0x3F }, { 0x0040, 0x00 }, { 0x0041, 0x41 },
-	{ 0x0042, 0x42 }, { 0x0043, 0x43 }, { 0x0044, 0x44 }, { 0x0045, 0x45 },
-	{ 0x0046, 0x46 }, { 0x0047, 0x47 }, { 0x0048, 0x48 }, { 0x0049, 0x49 },
-	{ 0x004A, 0x4A }, { 0x004B, 0x4B }, { 0x004C, 0x4C }, { 0x004D, 0x4D },
-	{ 0x004E, 0x4E }, { 0x004F, 0x4F }, { 0x0050, 0x50 }, { 0x0051, 0x51 },
-	{ 0x0052, 0x52 }, { 0x0053, 0x53 }, { 0x0054, 0x54 }, { 0x0055, 0x55 },
-	{ 0x0056, 0x56 }, { 0x0057, 0x57 }, { 0x0058, 0x58 }, { 0x0059, 0x59 },
-	{ 0x005A, 0x5A }, { 0x005C, 0x17 }, { 0x005E, 0x16 }, { 0x005F, 0x11 },
-	{ 0x0060, 0x7D }, { 0x0061, 0x61 }, { 0x0062, 0x62 }, { 0x0063, 0x63 },
+	{ 0x0028, 0x29 }, { 0x0029, 0x28 }, { 0x002C, 0x2C }, { 0x002E, 0x2E },
+	{ 0x0030, 0x30 }, { 0x0031, 0x31 }, { 0x0032, 0x32 }, { 0x0033, 0x33 },
+	{ 0x0034, 0x34 }, { 0x0035, 0x35 }, { 0x0036, 0x36 }, { 0x0037, 0x37 },
+	{ 0x0038, 0x38 }, { 0x0039, 0x39 }, { 0x003A, 0x3A }, { 0x003B, 0x3B },
+	{ 0x003F, 0x3F }, { 0x0061, 0x61 }, { 0x0062, 0x62 }, { 0x0063, 0x63 },
 	{ 0x0064, 0x64 }, { 0x0065, 0x65 }, { 0x0066, 0x66 }, { 0x0067, 0x67 },
 	{ 0x0068, 0x68 }, { 0x0069, 0x69 }, { 0x006A, 0x6A }, { 0x006B, 0x6B },
 	{ 0x006C, 0x6C }, { 0x006D, 0x6D }, { 0x006E, 0x6E }, { 0x006F, 0x6F },
 	{ 0x0070, 0x70 }, { 0x0071, 0x71 }, { 0x0072, 0x72 }, { 0x0073, 0x73 },
 	{ 0x0074, 0x74 }, { 0x0075, 0x75 }, { 0x0076, 0x76 }, { 0x0077, 0x77 },
-	{ 0x0078, 0x78 }, { 0x0079, 0x79 }, { 0x007A, 0x7A }, { 0x007C, 0x1A },
-	{ 0x007E, 0x60 }, { 0x00A0, 0x20 }, { 0x00A3, 0x01 }, { 0x00A5, 0x03 },
-	{ 0x00A7, 0x5F }, { 0x00AA, 0x12 }, { 0x00BA, 0x24 }, { 0x00C0, 0x14 },
-	{ 0x00C1, 0x0E }, { 0x00C2, 0x1C }, { 0x00C3, 0x5B }, { 0x00C7, 0x13 },
-	{ 0x00C9, 0x1F }, { 0x00CA, 0x1E }, { 0x00CD, 0x40 }, { 0x00D3, 0x19 },
-	{ 0x00D4, 0x0B }, { 0x00D5, 0x5C }, { 0x00DA, 0x5D }, { 0x00DC, 0x5E },
-	{ 0x00E0, 0x7F }, { 0x00E1, 0x0F }, { 0x00E2, 0x1D }, { 0x00E3, 0x7B },
-	{ 0x00E7, 0x09 }, { 0x00E9, 0x05 }, { 0x00EA, 0x04 }, { 0x00ED, 0x07 },
-	{ 0x00F3, 0x08 }, { 0x00F4, 0x0C }, { 0x00F5, 0x7C }, { 0x00FA, 0x06 },
-	{ 0x00FC, 0x7E }, { 0x0394, 0x10 }, { 0x20AC, 0x18 }, { 0x221E, 0x15 }
+	{ 0x0078, 0x78 }, { 0x0079, 0x79 }, { 0x007A, 0x7A }, { 0x00A0, 0x20 },
+	{ 0x0621, 0x58 }, { 0x0622, 0x01 }, { 0x0627, 0x00 }, { 0x0628, 0x02 },
+	{ 0x062A, 0x07 }, { 0x062B, 0x10 }, { 0x062C, 0x11 }, { 0x062D, 0x18 },
+	{ 0x062E, 0x19 }, { 0x062F, 0x1A }, { 0x0630, 0x24 }, { 0x0631, 0x25 },
+	{ 0x0632, 0x2B }, { 0x0633, 0x3D }, { 0x0634, 0x3E }, { 0x0635, 0x40 },
+	{ 0x0636, 0x41 }, { 0x0637, 0x42 }, { 0x0638, 0x43 }, { 0x0639, 0x44 },
+	{ 0x0641, 0x45 }, { 0x0642, 0x46 }, { 0x0644, 0x4D }, { 0x0645, 0x4E },
+	{ 0x0646, 0x4F }, { 0x0648, 0x53 }, { 0x064D, 0x5C }, { 0x064F, 0x5E },
+	{ 0x0650, 0x5D }, { 0x0651, 0x7C }, { 0x0653, 0x7D }, { 0x0654, 0x60 },
+	{ 0x0655, 0x7B }, { 0x0656, 0x7E }, { 0x0657, 0x5F }, { 0x0670, 0x7F },
+	{ 0x0679, 0x0B }, { 0x067A, 0x0E }, { 0x067B, 0x03 }, { 0x067C, 0x0F },
+	{ 0x067D, 0x0C }, { 0x067E, 0x05 }, { 0x067F, 0x09 }, { 0x0680, 0x04 },
+	{ 0x0681, 0x12 }, { 0x0683, 0x14 }, { 0x0684, 0x13 }, { 0x0685, 0x15 },
+	{ 0x0686, 0x16 }, { 0x0687, 0x17 }, { 0x0688, 0x1D }, { 0x0689, 0x1E },
+	{ 0x068A, 0x1F }, { 0x068C, 0x1C }, { 0x068D, 0x23 }, { 0x068F, 0x22 },
+	{ 0x0691, 0x26 }, { 0x0693, 0x27 }, { 0x0696, 0x2D }, { 0x0698, 0x2F },
+	{ 0x0699, 0x2A }, { 0x069A, 0x3C }, { 0x06A6, 0x06 }, { 0x06A9, 0x47 },
+	{ 0x06AA, 0x48 }, { 0x06AB, 0x49 }, { 0x06AF, 0x4A }, { 0x06B1, 0x4C },
+	{ 0x06B3, 0x4B }, { 0x06BA, 0x50 }, { 0x06BB, 0x51 }, { 0x06BC, 0x52 },
+	{ 0x06BE, 0x57 }, { 0x06C1, 0x56 }, { 0x06C2, 0x08 }, { 0x06C4, 0x54 },
+	{ 0x06CC, 0x59 }, { 0x06D0, 0x5A }, { 0x06D2, 0x5B }, { 0x06D5, 0x55 }
+};
+
+/*
+ * Number of pages shared by all unicode_index tables.  Every locking and
+ * single shift table populates at most a handful of BMP pages, bump this
+ * if a new dialect table needs more.
+ */
+#define INDEX_POOL_SIZE 80
+
+static unsigned short gund_page[256];
+static unsigned short index_pool[INDEX_POOL_SIZE][256];
+static unsigned int index_pool_used;
+
+struct unicode_table {
+	gboolean built;
+	struct unicode_index index;
+};
+
+struct gsm_table {
+	gboolean built;
+	unsigned short chars[128];
 };
 
-static int compare_codepoints(const void *a, const void *b)
+static struct unicode_table def_locking_index;
+static struct unicode_table tur_locking_index;
+static struct unicode_table por_locking_index;
+static struct unicode_table ben_locking_index;
+static struct unicode_table guj_locking_index;
+static struct unicode_table hin_locking_index;
+static struct unicode_table kan_locking_index;
+static struct unicode_table mal_locking_index;
+static struct unicode_table ori_locking_index;
+static struct unicode_table pun_locking_index;
+static struct unicode_table tam_locking_index;
+static struct unicode_table tel_locking_index;
+static struct unicode_table urd_locking_index;
+static struct unicode_table def_single_index;
+static struct unicode_table tur_single_index;
+static struct unicode_table spa_single_index;
+static struct unicode_table por_single_index;
+static struct unicode_table ben_single_index;
+static struct unicode_table guj_single_index;
+static struct unicode_table hin_single_index;
+static struct unicode_table kan_single_index;
+static struct unicode_table mal_single_index;
+static struct unicode_table ori_single_index;
+static struct unicode_table pun_single_index;
+static struct unicode_table tam_single_index;
+static struct unicode_table tel_single_index;
+static struct unicode_table urd_single_index;
+
+static struct gsm_table def_ext_index;
+static struct gsm_table tur_ext_index;
+static struct gsm_table spa_ext_index;
+static struct gsm_table por_ext_index;
+static struct gsm_table ben_ext_index;
+static struct gsm_table guj_ext_index;
+static struct gsm_table hin_ext_index;
+static struct gsm_table kan_ext_index;
+static struct gsm_table mal_ext_index;
+static struct gsm_table ori_ext_index;
+static struct gsm_table pun_ext_index;
+static struct gsm_table tam_ext_index;
+static struct gsm_table tel_ext_index;
+static struct gsm_table urd_ext_index;
+
+static const struct unicode_index *unicode_index_get(struct unicode_table *u,
+						const struct codepoint *table,
+						unsigned int len)
 {
-	const struct codepoint *ca = (const struct codepoint *) a;
-	const struct codepoint *cb = (const struct codepoint *) b;
+	unsigned short *pages[256];
+	unsigned int i;
+
+	if (u->built)
+		return &u->index;
+
+	if (gund_page[0] != GUND)
+		for (i = 0; i < 256; i++)
+			gund_page[i] = GUND;
+
+	for (i = 0; i < 256; i++)
+		pages[i] = gund_page;
+
+	for (i = 0; i < len; i++) {
+		unsigned char page = table[i].from >> 8;
+
+		if (pages[page] == gund_page) {
+			if (index_pool_used == INDEX_POOL_SIZE)
+				return NULL;
 
-	return (ca->from > cb->from) - (ca->from < cb->from);
+			pages[page] = index_pool[index_pool_used++];
+			memcpy(pages[page], gund_page, sizeof(gund_page));
+		}
+
+		pages[page][table[i].from & 0xff] = table[i].to;
+	}
+
+	for (i = 0; i < 256; i++)
+		u->index.pages[i] = pages[i];
+
+	u->built = TRUE;
+
+	return &u->index;
 }
 
-static unsigned short codepoint_lookup(struct codepoint *key,
-					const struct codepoint *table,
-					unsigned int len)
+static const unsigned short *gsm_index_get(struct gsm_table *g,
+						const struct codepoint *table,
+						unsigned int len)
 {
-	struct codepoint *result = NULL;
+	unsigned int i;
+
+	if (g->built)
+		return g->chars;
+
+	for (i = 0; i < 128; i++)
+		g->chars[i] = GUND;
 
-	result = bsearch(key, table, len, sizeof(struct codepoint),
-				compare_codepoints);
+	for (i = 0; i < len; i++)
+		g->chars[table[i].from & 0x7f] = table[i].to;
 
-	return result ? result->to : GUND;
+	g->built = TRUE;
+
+	return g->chars;
 }
 
 static unsigned short gsm_locking_shift_lookup(struct conversion_table *t,
@@ -483,22 +2767,22 @@ static unsigned short gsm_locking_shift_lookup(struct conversion_table *t,
 static unsigned short gsm_single_shift_lookup(struct conversion_table *t,
 						unsigned char k)
 {
-	struct codepoint key = { k, 0 };
-	return codepoint_lookup(&key, t->single_g, t->single_len_g);
+	if (k > 0x7f)
+		return GUND;
+
+	return t->single_g[k];
 }
 
 static unsigned short unicode_locking_shift_lookup(struct conversion_table *t,
 							unsigned short k)
 {
-	struct codepoint key = { k, 0 };
-	return codepoint_lookup(&key, t->locking_u, t->locking_len_u);
+	return t->locking_u->pages[k >> 8][k & 0xff];
 }
 
 static unsigned short unicode_single_shift_lookup(struct conversion_table *t,
 							unsigned short k)
 {
-	struct codepoint key = { k, 0 };
-	return codepoint_lookup(&key, t->single_u, t->single_len_u);
+	return t->single_u->pages[k >> 8][k & 0xff];
 }
 
 static gboolean populate_locking_shift(struct conversion_table *t,
@@ -508,24 +2792,100 @@ static gboolean populate_locking_shift(struct conversion_table *t,
 	case GSM_DIALECT_DEFAULT:
 	case GSM_DIALECT_SPANISH:
 		t->locking_g = def_gsm;
-		t->locking_u = def_unicode;
-		t->locking_len_u = TABLE_SIZE(def_unicode);
-		return TRUE;
+		t->locking_u = unicode_index_get(&def_locking_index,
+						def_unicode,
+						TABLE_SIZE(def_unicode));
+		break;
 
 	case GSM_DIALECT_TURKISH:
 		t->locking_g = tur_gsm;
-		t->locking_u = tur_unicode;
-		t->locking_len_u = TABLE_SIZE(tur_unicode);
-		return TRUE;
+		t->locking_u = unicode_index_get(&tur_locking_index,
+						tur_unicode,
+						TABLE_SIZE(tur_unicode));
+		break;
 
 	case GSM_DIALECT_PORTUGUESE:
 		t->locking_g = por_gsm;
-		t->locking_u = por_unicode;
-		t->locking_len_u = TABLE_SIZE(por_unicode);
-		return TRUE;
+		t->locking_u = unicode_index_get(&por_locking_index,
+						por_unicode,
+						TABLE_SIZE(por_unicode));
+		break;
+
+	case GSM_DIALECT_BENGALI:
+		t->locking_g = ben_gsm;
+		t->locking_u = unicode_index_get(&ben_locking_index,
+						ben_unicode,
+						TABLE_SIZE(ben_unicode));
+		break;
+
+	case GSM_DIALECT_GUJARATI:
+		t->locking_g = guj_gsm;
+		t->locking_u = unicode_index_get(&guj_locking_index,
+						guj_unicode,
+						TABLE_SIZE(guj_unicode));
+		break;
+
+	case GSM_DIALECT_HINDI:
+		t->locking_g = hin_gsm;
+		t->locking_u = unicode_index_get(&hin_locking_index,
+						hin_unicode,
+						TABLE_SIZE(hin_unicode));
+		break;
+
+	case GSM_DIALECT_KANNADA:
+		t->locking_g = kan_gsm;
+		t->locking_u = unicode_index_get(&kan_locking_index,
+						kan_unicode,
+						TABLE_SIZE(kan_unicode));
+		break;
+
+	case GSM_DIALECT_MALAYALAM:
+		t->locking_g = mal_gsm;
+		t->locking_u = unicode_index_get(&mal_locking_index,
+						mal_unicode,
+						TABLE_SIZE(mal_unicode));
+		break;
+
+	case GSM_DIALECT_ORIYA:
+		t->locking_g = ori_gsm;
+		t->locking_u = unicode_index_get(&ori_locking_index,
+						ori_unicode,
+						TABLE_SIZE(ori_unicode));
+		break;
+
+	case GSM_DIALECT_PUNJABI:
+		t->locking_g = pun_gsm;
+		t->locking_u = unicode_index_get(&pun_locking_index,
+						pun_unicode,
+						TABLE_SIZE(pun_unicode));
+		break;
+
+	case GSM_DIALECT_TAMIL:
+		t->locking_g = tam_gsm;
+		t->locking_u = unicode_index_get(&tam_locking_index,
+						tam_unicode,
+						TABLE_SIZE(tam_unicode));
+		break;
+
+	case GSM_DIALECT_TELUGU:
+		t->locking_g = tel_gsm;
+		t->locking_u = unicode_index_get(&tel_locking_index,
+						tel_unicode,
+						TABLE_SIZE(tel_unicode));
+		break;
+
+	case GSM_DIALECT_URDU:
+		t->locking_g = urd_gsm;
+		t->locking_u = unicode_index_get(&urd_locking_index,
+						urd_unicode,
+						TABLE_SIZE(urd_unicode));
+		break;
+
+	default:
+		return FALSE;
 	}
 
-	return FALSE;
+	return t->locking_u != NULL;
 }
 
 static gboolean populate_single_shift(struct conversion_table *t,
@@ -533,35 +2893,122 @@ static gboolean populate_single_shift(struct conversion_table *t,
 {
 	switch (lang) {
 	case GSM_DIALECT_DEFAULT:
-		t->single_g = def_ext_gsm;
-		t->single_len_g = TABLE_SIZE(def_ext_gsm);
-		t->single_u = def_ext_unicode;
-		t->single_len_u = TABLE_SIZE(def_ext_unicode);
-		return TRUE;
+		t->single_g = gsm_index_get(&def_ext_index, def_ext_gsm,
+						TABLE_SIZE(def_ext_gsm));
+		t->single_u = unicode_index_get(&def_single_index,
+						def_ext_unicode,
+						TABLE_SIZE(def_ext_unicode));
+		break;
 
 	case GSM_DIALECT_TURKISH:
-		t->single_g = tur_ext_gsm;
-		t->single_len_g = TABLE_SIZE(tur_ext_gsm);
-		t->single_u = tur_ext_unicode;
-		t->single_len_u = TABLE_SIZE(tur_ext_unicode);
-		return TRUE;
+		t->single_g = gsm_index_get(&tur_ext_index, tur_ext_gsm,
+						TABLE_SIZE(tur_ext_gsm));
+		t->single_u = unicode_index_get(&tur_single_index,
+						tur_ext_unicode,
+						TABLE_SIZE(tur_ext_unicode));
+		break;
 
 	case GSM_DIALECT_SPANISH:
-		t->single_g = spa_ext_gsm;
-		t->single_len_g = TABLE_SIZE(spa_ext_gsm);
-		t->single_u = spa_ext_unicode;
-		t->single_len_u = TABLE_SIZE(spa_ext_unicode);
-		return TRUE;
+		t->single_g = gsm_index_get(&spa_ext_index, spa_ext_gsm,
+						TABLE_SIZE(spa_ext_gsm));
+		t->single_u = unicode_index_get(&spa_single_index,
+						spa_ext_unicode,
+						TABLE_SIZE(spa_ext_unicode));
+		break;
 
 	case GSM_DIALECT_PORTUGUESE:
-		t->single_g = por_ext_gsm;
-		t->single_len_g = TABLE_SIZE(por_ext_gsm);
-		t->single_u = por_ext_unicode;
-		t->single_len_u = TABLE_SIZE(por_ext_unicode);
-		return TRUE;
+		t->single_g = gsm_index_get(&por_ext_index, por_ext_gsm,
+						TABLE_SIZE(por_ext_gsm));
+		t->single_u = unicode_index_get(&por_single_index,
+						por_ext_unicode,
+						TABLE_SIZE(por_ext_unicode));
+		break;
+
+	case GSM_DIALECT_BENGALI:
+		t->single_g = gsm_index_get(&ben_ext_index, ben_ext_gsm,
+						TABLE_SIZE(ben_ext_gsm));
+		t->single_u = unicode_index_get(&ben_single_index,
+						ben_ext_unicode,
+						TABLE_SIZE(ben_ext_unicode));
+		break;
+
+	case GSM_DIALECT_GUJARATI:
+		t->single_g = gsm_index_get(&guj_ext_index, guj_ext_gsm,
+						TABLE_SIZE(guj_ext_gsm));
+		t->single_u = unicode_index_get(&guj_single_index,
+						guj_ext_unicode,
+						TABLE_SIZE(guj_ext_unicode));
+		break;
+
+	case GSM_DIALECT_HINDI:
+		t->single_g = gsm_index_get(&hin_ext_index, hin_ext_gsm,
+						TABLE_SIZE(hin_ext_gsm));
+		t->single_u = unicode_index_get(&hin_single_index,
+						hin_ext_unicode,
+						TABLE_SIZE(hin_ext_unicode));
+		break;
+
+	case GSM_DIALECT_KANNADA:
+		t->single_g = gsm_index_get(&kan_ext_index, kan_ext_gsm,
+						TABLE_SIZE(kan_ext_gsm));
+		t->single_u = unicode_index_get(&kan_single_index,
+						kan_ext_unicode,
+						TABLE_SIZE(kan_ext_unicode));
+		break;
+
+	case GSM_DIALECT_MALAYALAM:
+		t->single_g = gsm_index_get(&mal_ext_index, mal_ext_gsm,
+						TABLE_SIZE(mal_ext_gsm));
+		t->single_u = unicode_index_get(&mal_single_index,
+						mal_ext_unicode,
+						TABLE_SIZE(mal_ext_unicode));
+		break;
+
+	case GSM_DIALECT_ORIYA:
+		t->single_g = gsm_index_get(&ori_ext_index, ori_ext_gsm,
+						TABLE_SIZE(ori_ext_gsm));
+		t->single_u = unicode_index_get(&ori_single_index,
+						ori_ext_unicode,
+						TABLE_SIZE(ori_ext_unicode));
+		break;
+
+	case GSM_DIALECT_PUNJABI:
+		t->single_g = gsm_index_get(&pun_ext_index, pun_ext_gsm,
+						TABLE_SIZE(pun_ext_gsm));
+		t->single_u = unicode_index_get(&pun_single_index,
+						pun_ext_unicode,
+						TABLE_SIZE(pun_ext_unicode));
+		break;
+
+	case GSM_DIALECT_TAMIL:
+		t->single_g = gsm_index_get(&tam_ext_index, tam_ext_gsm,
+						TABLE_SIZE(tam_ext_gsm));
+		t->single_u = unicode_index_get(&tam_single_index,
+						tam_ext_unicode,
+						TABLE_SIZE(tam_ext_unicode));
+		break;
+
+	case GSM_DIALECT_TELUGU:
+		t->single_g = gsm_index_get(&tel_ext_index, tel_ext_gsm,
+						TABLE_SIZE(tel_ext_gsm));
+		t->single_u = unicode_index_get(&tel_single_index,
+						tel_ext_unicode,
+						TABLE_SIZE(tel_ext_unicode));
+		break;
+
+	case GSM_DIALECT_URDU:
+		t->single_g = gsm_index_get(&urd_ext_index, urd_ext_gsm,
+						TABLE_SIZE(urd_ext_gsm));
+		t->single_u = unicode_index_get(&urd_single_index,
+						urd_ext_unicode,
+						TABLE_SIZE(urd_ext_unicode));
+		break;
+
+	default:
+		return FALSE;
 	}
 
-	return FALSE;
+	return t->single_u != NULL;
 }
 
 static gboolean conversion_table_init(struct conversion_table *t,
@@ -623,7 +3070,7 @@ char *convert_gsm_to_utf8_with_lang(const unsigned char *text, long len,
 
 		if (text[i] == 0x1b) {
 			++i;
-			if (i >= len)
+			if (i >= len || text[i] > 0x7f)
 				goto error;
 
 			c = gsm_single_shift_lookup(&t, text[i]);
@@ -694,79 +3141,132 @@ char *convert_gsm_to_utf8(const unsigned char *text, long len,
 						GSM_DIALECT_DEFAULT);
 }
 
-/*!
- * Converts UTF-8 encoded text to GSM alphabet.  The result is unpacked,
- * with the 7th bit always 0.  If terminator is not 0, a terminator character
- * is appended to the result.  This should be in the range 0x80-0xf0
+/*
+ * Computes the GSM encoded length of the UTF-8 text for each of the given
+ * conversion tables, walking the text only once.  Tables which can't
+ * represent the text get a length of -1.  The walk stops as soon as no
+ * table is able to encode the text.  Returns the number of characters
+ * examined and sets end to the first byte that was not consumed.
  *
- * Returns the encoded data or NULL if the data could not be encoded.  The
- * data must be freed by the caller.  If items_read is not NULL, it contains
- * the actual number of bytes read.  If items_written is not NULL, contains
- * the number of bytes written.
+ * If chunk_size is not NULL, chunks receives for each table the number
+ * of chunks of at most chunk_size septets the encoded text is split into
+ * without breaking up an escape sequence.
  */
-unsigned char *convert_utf8_to_gsm_with_lang(const char *text, long len,
-					long *items_read, long *items_written,
-					unsigned char terminator,
-					enum gsm_dialect locking_lang,
-					enum gsm_dialect single_lang)
+static long utf8_gsm_measure(const char *text, long len,
+				struct conversion_table *tables,
+				unsigned int ntables, long *lengths,
+				const long *chunk_size, long *chunks,
+				const char **end)
 {
-	struct conversion_table t;
+	const char *in = text;
+	unsigned int remaining = ntables;
 	long nchars = 0;
-	const char *in;
-	unsigned char *out;
-	unsigned char *res = NULL;
-	long res_len;
-	long i;
+	long *fill = NULL;
+	unsigned int i;
 
-	if (conversion_table_init(&t, locking_lang, single_lang) == FALSE)
-		return NULL;
+	for (i = 0; i < ntables; i++)
+		lengths[i] = 0;
 
-	in = text;
-	res_len = 0;
+	if (chunk_size) {
+		fill = g_new0(long, ntables);
+
+		for (i = 0; i < ntables; i++)
+			chunks[i] = 0;
+	}
 
 	while ((len < 0 || text + len - in > 0) && *in) {
 		long max = len < 0 ? 6 : text + len - in;
 		gunichar c = g_utf8_get_char_validated(in, max);
-		unsigned short converted = GUND;
 
-		if (c & 0x80000000)
-			goto err_out;
+		if ((c & 0x80000000) || c > 0xffff) {
+			for (i = 0; i < ntables; i++)
+				lengths[i] = -1;
 
-		if (c > 0xffff)
-			goto err_out;
+			break;
+		}
 
-		converted = unicode_locking_shift_lookup(&t, c);
+		for (i = 0; i < ntables; i++) {
+			unsigned short converted;
+			int septets;
 
-		if (converted == GUND)
-			converted = unicode_single_shift_lookup(&t, c);
+			if (lengths[i] < 0)
+				continue;
 
-		if (converted == GUND)
-			goto err_out;
+			converted = unicode_locking_shift_lookup(&tables[i], c);
 
-		if (converted & 0x1b00)
-			res_len += 2;
-		else
-			res_len += 1;
+			if (converted == GUND)
+				converted = unicode_single_shift_lookup(
+								&tables[i], c);
+
+			if (converted == GUND) {
+				lengths[i] = -1;
+				remaining -= 1;
+				continue;
+			}
+
+			septets = (converted & 0x1b00) ? 2 : 1;
+			lengths[i] += septets;
+
+			if (fill == NULL)
+				continue;
+
+			if (fill[i] + septets > chunk_size[i]) {
+				chunks[i] += 1;
+				fill[i] = 0;
+			}
+
+			fill[i] += septets;
+		}
+
+		if (remaining == 0)
+			break;
 
 		in = g_utf8_next_char(in);
 		nchars += 1;
 	}
 
+	if (fill) {
+		for (i = 0; i < ntables; i++)
+			if (fill[i] > 0)
+				chunks[i] += 1;
+
+		g_free(fill);
+	}
+
+	*end = in;
+
+	return nchars;
+}
+
+/*
+ * Encodes nchars characters of already validated UTF-8 text, res_len must
+ * be the length computed by utf8_gsm_measure() for the same table.
+ */
+static unsigned char *utf8_gsm_encode(struct conversion_table *t,
+					const char *text, long nchars,
+					long res_len, long *items_written,
+					unsigned char terminator)
+{
+	const char *in = text;
+	unsigned char *res;
+	unsigned char *out;
+	long i;
+
 	res = g_try_malloc(res_len + (terminator ? 1 : 0));
 	if (res == NULL)
-		goto err_out;
+		return NULL;
 
-	in = text;
 	out = res;
+
 	for (i = 0; i < nchars; i++) {
 		unsigned short converted;
 
 		gunichar c = g_utf8_get_char(in);
 
-		converted = unicode_locking_shift_lookup(&t, c);
+		converted = unicode_locking_shift_lookup(t, c);
 
 		if (converted == GUND)
-			converted = unicode_single_shift_lookup(&t, c);
+			converted = unicode_single_shift_lookup(t, c);
 
 		if (converted & 0x1b00) {
 			*out = 0x1b;
@@ -785,13 +3285,115 @@ unsigned char *convert_utf8_to_gsm_with_lang(const char *text, long len,
 	if (items_written)
 		*items_written = out - res;
 
-err_out:
+	return res;
+}
+
+/*!
+ * Converts UTF-8 encoded text to GSM alphabet.  The result is unpacked,
+ * with the 7th bit always 0.  If terminator is not 0, a terminator character
+ * is appended to the result.  This should be in the range 0x80-0xf0
+ *
+ * Returns the encoded data or NULL if the data could not be encoded.  The
+ * data must be freed by the caller.  If items_read is not NULL, it contains
+ * the actual number of bytes read.  If items_written is not NULL, contains
+ * the number of bytes written.
+ */
+unsigned char *convert_utf8_to_gsm_with_lang(const char *text, long len,
+					long *items_read, long *items_written,
+					unsigned char terminator,
+					enum gsm_dialect locking_lang,
+					enum gsm_dialect single_lang)
+{
+	struct conversion_table t;
+	unsigned char *res = NULL;
+	const char *end;
+	long nchars;
+	long res_len;
+
+	if (conversion_table_init(&t, locking_lang, single_lang) == FALSE)
+		return NULL;
+
+	nchars = utf8_gsm_measure(text, len, &t, 1, &res_len, NULL, NULL,
+					&end);
+
+	if (res_len >= 0)
+		res = utf8_gsm_encode(&t, text, nchars, res_len,
+					items_written, terminator);
+
 	if (items_read)
-		*items_read = in - text;
+		*items_read = end - text;
 
 	return res;
 }
 
+/*!
+ * Computes the length of UTF-8 encoded text converted to GSM alphabet for
+ * each of the n given combinations of locking and single shift tables,
+ * walking the text only once.  The length of combinations unable to
+ * represent the text is set to -1.
+ *
+ * If chunk_size is not NULL, chunks receives for each combination the
+ * number of chunks of at most chunk_size septets the text is split into
+ * when an escape sequence is never broken up across two chunks.
+ */
+void convert_utf8_to_gsm_lengths(const char *utf8, long len,
+					const enum gsm_dialect *locking,
+					const enum gsm_dialect *single,
+					unsigned int n, long *lengths,
+					const long *chunk_size, long *chunks)
+{
+	struct conversion_table *tables;
+	unsigned int *map;
+	long *measured;
+	long *valid_size = NULL;
+	long *valid_chunks = NULL;
+	unsigned int valid = 0;
+	unsigned int i;
+	const char *end;
+
+	tables = g_new(struct conversion_table, n);
+	map = g_new(unsigned int, n);
+	measured = g_new(long, n);
+
+	if (chunk_size) {
+		valid_size = g_new(long, n);
+		valid_chunks = g_new(long, n);
+	}
+
+	for (i = 0; i < n; i++) {
+		lengths[i] = -1;
+
+		if (chunk_size)
+			chunks[i] = -1;
+
+		if (conversion_table_init(&tables[valid], locking[i],
+						single[i]) == FALSE)
+			continue;
+
+		if (chunk_size)
+			valid_size[valid] = chunk_size[i];
+
+		map[valid++] = i;
+	}
+
+	if (valid > 0)
+		utf8_gsm_measure(utf8, len, tables, valid, measured,
+					valid_size, valid_chunks, &end);
+
+	for (i = 0; i < valid; i++) {
+		lengths[map[i]] = measured[i];
+
+		if (chunk_size && measured[i] >= 0)
+			chunks[map[i]] = valid_chunks[i];
+	}
+
+	g_free(valid_chunks);
+	g_free(valid_size);
+	g_free(measured);
+	g_free(map);
+	g_free(tables);
+}
+
 unsigned char *convert_utf8_to_gsm(const char *text, long len,
 					long *items_read, long *items_written,
 					unsigned char terminator)
@@ -810,7 +3412,8 @@ unsigned char *convert_utf8_to_gsm(const char *text, long len,
  * It first attempts to use the default dialect's single shift and
  * locking shift tables. It then tries with only the single shift
  * table of the hinted dialect, and finally with both the single shift
- * and locking shift tables of the hinted dialect.
+ * and locking shift tables of the hinted dialect.  All candidates are
+ * checked in a single pass over the text.
  *
  * Returns the encoded data or NULL if no suitable encoding could be
  * found. The data must be freed by the caller. If items_read is not
@@ -826,44 +3429,66 @@ unsigned char *convert_utf8_to_gsm_best_lang(const char *utf8, long len,
 					enum gsm_dialect *used_locking,
 					enum gsm_dialect *used_single)
 {
-	enum gsm_dialect locking = GSM_DIALECT_DEFAULT;
-	enum gsm_dialect single = GSM_DIALECT_DEFAULT;
+	struct conversion_table tables[3];
+	enum gsm_dialect locking[3];
+	enum gsm_dialect single[3];
+	long lengths[3];
+	unsigned int n = 0;
+	unsigned int i;
 	unsigned char *encoded;
+	const char *end;
+	long nchars;
+
+	/* Candidates in order of preference, all measured in one pass */
+	locking[n] = GSM_DIALECT_DEFAULT;
+	single[n] = GSM_DIALECT_DEFAULT;
+	n += 1;
+
+	if (hint != GSM_DIALECT_DEFAULT) {
+		locking[n] = GSM_DIALECT_DEFAULT;
+		single[n] = hint;
+		n += 1;
+
+		/* Spanish dialect uses the default locking shift table */
+		if (hint != GSM_DIALECT_SPANISH) {
+			locking[n] = hint;
+			single[n] = hint;
+			n += 1;
+		}
+	}
 
-	encoded = convert_utf8_to_gsm_with_lang(utf8, len, items_read,
-						items_written, terminator,
-						locking, single);
-	if (encoded != NULL)
-		goto out;
+	for (i = 0; i < n; i++)
+		if (conversion_table_init(&tables[i], locking[i],
+						single[i]) == FALSE)
+			break;
 
-	if (hint == GSM_DIALECT_DEFAULT)
+	n = i;
+	if (n == 0)
 		return NULL;
 
-	single = hint;
-	encoded = convert_utf8_to_gsm_with_lang(utf8, len, items_read,
-						items_written, terminator,
-						locking, single);
-	if (encoded != NULL)
-		goto out;
+	nchars = utf8_gsm_measure(utf8, len, tables, n, lengths, NULL, NULL,
+					&end);
 
-	/* Spanish dialect uses the default locking shift table */
-	if (hint == GSM_DIALECT_SPANISH)
-		return NULL;
+	if (items_read)
+		*items_read = end - utf8;
+
+	for (i = 0; i < n; i++)
+		if (lengths[i] >= 0)
+			break;
 
-	locking = hint;
-	encoded = convert_utf8_to_gsm_with_lang(utf8, len, items_read,
-						items_written, terminator,
-						locking, single);
+	if (i == n)
+		return NULL;
 
+	encoded = utf8_gsm_encode(&tables[i], utf8, nchars, lengths[i],
+					items_written, terminator);
 	if (encoded == NULL)
 		return NULL;
 
-out:
 	if (used_locking != NULL)
-		*used_locking = locking;
+		*used_locking = locking[i];
 
 	if (used_single != NULL)
-		*used_single = single;
+		*used_single = single[i];
 
 	return encoded;
 }
@@ -1013,6 +3638,64 @@ char *encode_hex(const unsigned char *in, long len, unsigned char terminator)
 	return encode_hex_own_buf(in, len, terminator, buf);
 }
 
+/*
+ * Unpacks whole groups of 7 octets into 8 septets, one 64-bit word per
+ * group.  Returns the number of groups unpacked.
+ */
+static long unpack_7bit_groups(const unsigned char *in, long len, long max,
+				unsigned char *out)
+{
+	long groups = MIN(len / 7, max / 8);
+	long g;
+
+	for (g = 0; g < groups; g++, in += 7, out += 8) {
+		guint64 w = (guint64) in[0] | (guint64) in[1] << 8 |
+				(guint64) in[2] << 16 | (guint64) in[3] << 24 |
+				(guint64) in[4] << 32 | (guint64) in[5] << 40 |
+				(guint64) in[6] << 48;
+
+		out[0] = w & 0x7f;
+		out[1] = (w >> 7) & 0x7f;
+		out[2] = (w >> 14) & 0x7f;
+		out[3] = (w >> 21) & 0x7f;
+		out[4] = (w >> 28) & 0x7f;
+		out[5] = (w >> 35) & 0x7f;
+		out[6] = (w >> 42) & 0x7f;
+		out[7] = (w >> 49) & 0x7f;
+	}
+
+	return groups;
+}
+
+/*
+ * Packs whole groups of 8 septets into 7 octets, one 64-bit word per
+ * group.  Returns the number of groups packed.
+ */
+static long pack_7bit_groups(const unsigned char *in, long len,
+				unsigned char *out)
+{
+	long groups = len / 8;
+	long g;
+
+	for (g = 0; g < groups; g++, in += 8, out += 7) {
+		guint64 w = (guint64) in[0] | (guint64) in[1] << 7 |
+				(guint64) in[2] << 14 | (guint64) in[3] << 21 |
+				(guint64) in[4] << 28 | (guint64) in[5] << 35 |
+				(guint64) in[6] << 42 |
+				(guint64) (in[7] & 0x7f) << 49;
+
+		out[0] = w;
+		out[1] = w >> 8;
+		out[2] = w >> 16;
+		out[3] = w >> 24;
+		out[4] = w >> 32;
+		out[5] = w >> 40;
+		out[6] = w >> 48;
+	}
+
+	return groups;
+}
+
 unsigned char *unpack_7bit_own_buf(const unsigned char *in, long len,
 					int byte_offset, gboolean ussd,
 					long max_to_unpack, long *items_written,
@@ -1032,6 +3715,19 @@ unsigned char *unpack_7bit_own_buf(const unsigned char *in, long len,
 		max_to_unpack = len * 8 / 7;
 
 	for (i = 0; (i < len) && ((out-buf) < max_to_unpack); i++) {
+		/* On a septet boundary, unpack whole groups at once */
+		if (bits == 7) {
+			long groups = unpack_7bit_groups(in + i, len - i,
+						max_to_unpack - (out - buf),
+						out);
+
+			i += groups * 7;
+			out += groups * 8;
+
+			if (i == len || (out - buf) == max_to_unpack)
+				break;
+		}
+
 		/* Grab what we have in the current octet */
 		*out = (in[i] & ((1 << bits) - 1)) << (7 - bits);
 
@@ -1134,6 +3830,17 @@ unsigned char *pack_7bit_own_buf(const unsigned char *in, long len,
 	}
 
 	for (i = 0; i < len; i++) {
+		/* On an octet boundary, pack whole groups at once */
+		if (bits == 7) {
+			long groups = pack_7bit_groups(in + i, len - i, out);
+
+			i += groups * 8;
+			out += groups * 7;
+
+			if (i == len)
+				break;
+		}
+
 		if (bits != 7) {
 			*out |= (in[i] & ((1 << (7 - bits)) - 1)) <<
 					(bits + 1);
@@ -24,6 +24,16 @@ enum gsm_dialect {
 	GSM_DIALECT_TURKISH,
 	GSM_DIALECT_SPANISH,
 	GSM_DIALECT_PORTUGUESE,
+	GSM_DIALECT_BENGALI,
+	GSM_DIALECT_GUJARATI,
+	GSM_DIALECT_HINDI,
+	GSM_DIALECT_KANNADA,
+	GSM_DIALECT_MALAYALAM,
+	GSM_DIALECT_ORIYA,
+	GSM_DIALECT_PUNJABI,
+	GSM_DIALECT_TAMIL,
+	GSM_DIALECT_TELUGU,
+	GSM_DIALECT_URDU,
 };
 
 char *convert_gsm_to_utf8(const unsigned char *text, long len, long *items_read,
@@ -51,6 +61,12 @@ unsigned char *convert_utf8_to_gsm_best_lang(const char *utf8, long len,
 					enum gsm_dialect *used_locking,
 					enum gsm_dialect *used_single);
 
+void convert_utf8_to_gsm_lengths(const char *utf8, long len,
+					const enum gsm_dialect *locking,
+					const enum gsm_dialect *single,
+					unsigned int n, long *lengths,
+					const long *chunk_size, long *chunks);
+
 unsigned char *decode_hex_own_buf(const char *in, long len, long *items_written,
 					unsigned char terminator,
 					unsigned char *buf);
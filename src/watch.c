@@ -23,25 +23,126 @@
 #include <config.h>
 #endif
 
+#include <string.h>
+
 #include <glib.h>
 #include "ofono.h"
 
+/*
+ * Watches are kept in a slot array.  A watch id carries the slot index
+ * in its low 12 bits and the slot generation in the 14 bits above, so
+ * that adding, looking up and removing a watch are O(1) and a stale id
+ * does not remove a newer watch reusing the same slot.  Free slots are
+ * reused in FIFO order, so an id only comes back after its slot has been
+ * reused 16384 times.  Ids never exceed OFONO_WATCHLIST_ID_BITS bits.
+ *
+ * Live watches are also chained from the newest to the oldest, which is
+ * the order they are notified in.
+ */
+#define WATCHLIST_INDEX_BITS 12
+#define WATCHLIST_MAX_SLOTS ((1 << WATCHLIST_INDEX_BITS) - 1)
+#define WATCHLIST_GENERATION_MASK \
+	((1 << (OFONO_WATCHLIST_ID_BITS - WATCHLIST_INDEX_BITS)) - 1)
+#define WATCHLIST_NO_SLOT ((unsigned int) -1)
+
+struct ofono_watchlist_slot {
+	struct ofono_watchlist_item *item;
+	unsigned int generation;
+	unsigned int serial;
+	unsigned int next_free;
+	unsigned int newer;
+	unsigned int older;
+};
+
 struct ofono_watchlist *__ofono_watchlist_new(ofono_destroy_func destroy)
 {
 	struct ofono_watchlist *watchlist;
 
 	watchlist = g_new0(struct ofono_watchlist, 1);
 	watchlist->destroy = destroy;
+	watchlist->free_head = WATCHLIST_NO_SLOT;
+	watchlist->free_tail = WATCHLIST_NO_SLOT;
+	watchlist->newest = WATCHLIST_NO_SLOT;
 
 	return watchlist;
 }
 
+static unsigned int watchlist_get_slot(struct ofono_watchlist *watchlist)
+{
+	unsigned int index = watchlist->free_head;
+
+	if (index != WATCHLIST_NO_SLOT) {
+		watchlist->free_head = watchlist->slots[index].next_free;
+
+		if (watchlist->free_head == WATCHLIST_NO_SLOT)
+			watchlist->free_tail = WATCHLIST_NO_SLOT;
+
+		return index;
+	}
+
+	if (watchlist->used == WATCHLIST_MAX_SLOTS)
+		return WATCHLIST_NO_SLOT;
+
+	if (watchlist->used == watchlist->size) {
+		watchlist->size = watchlist->size ? watchlist->size * 2 : 4;
+
+		if (watchlist->size > WATCHLIST_MAX_SLOTS)
+			watchlist->size = WATCHLIST_MAX_SLOTS;
+
+		watchlist->slots = g_renew(struct ofono_watchlist_slot,
+						watchlist->slots,
+						watchlist->size);
+	}
+
+	index = watchlist->used++;
+	memset(&watchlist->slots[index], 0, sizeof(watchlist->slots[index]));
+
+	return index;
+}
+
+static struct ofono_watchlist_slot *watchlist_find_slot(
+					struct ofono_watchlist *watchlist,
+					unsigned int id)
+{
+	struct ofono_watchlist_slot *slot;
+	unsigned int index = (id & WATCHLIST_MAX_SLOTS) - 1;
+
+	if (id == 0 || index >= watchlist->used)
+		return NULL;
+
+	slot = &watchlist->slots[index];
+
+	if (slot->item == NULL || slot->item->id != id)
+		return NULL;
+
+	return slot;
+}
+
 unsigned int __ofono_watchlist_add_item(struct ofono_watchlist *watchlist,
 					struct ofono_watchlist_item *item)
 {
-	item->id = ++watchlist->next_id;
+	struct ofono_watchlist_slot *slot;
+	unsigned int index;
+
+	index = watchlist_get_slot(watchlist);
+	if (index == WATCHLIST_NO_SLOT)
+		return 0;
+
+	slot = &watchlist->slots[index];
+	slot->item = item;
+	slot->serial = ++watchlist->serial;
+	slot->newer = WATCHLIST_NO_SLOT;
+	slot->older = watchlist->newest;
+
+	if (watchlist->newest != WATCHLIST_NO_SLOT)
+		watchlist->slots[watchlist->newest].newer = index;
+
+	watchlist->newest = index;
+
+	item->id = (slot->generation & WATCHLIST_GENERATION_MASK) <<
+				WATCHLIST_INDEX_BITS | (index + 1);
 
-	watchlist->items = g_slist_prepend(watchlist->items, item);
+	watchlist->count += 1;
 
 	return item->id;
 }
@@ -49,47 +150,124 @@ unsigned int __ofono_watchlist_add_item(struct ofono_watchlist *watchlist,
 gboolean __ofono_watchlist_remove_item(struct ofono_watchlist *watchlist,
 					unsigned int id)
 {
+	struct ofono_watchlist_slot *slot;
 	struct ofono_watchlist_item *item;
-	GSList *p;
-	GSList *c;
+	unsigned int index;
 
-	p = NULL;
-	c = watchlist->items;
+	slot = watchlist_find_slot(watchlist, id);
+	if (slot == NULL)
+		return FALSE;
 
-	while (c) {
-		item = c->data;
+	item = slot->item;
+	index = slot - watchlist->slots;
 
-		if (item->id != id) {
-			p = c;
-			c = c->next;
+	if (slot->newer != WATCHLIST_NO_SLOT)
+		watchlist->slots[slot->newer].older = slot->older;
+	else
+		watchlist->newest = slot->older;
+
+	if (slot->older != WATCHLIST_NO_SLOT)
+		watchlist->slots[slot->older].newer = slot->newer;
+
+	slot->item = NULL;
+	slot->generation += 1;
+	slot->next_free = WATCHLIST_NO_SLOT;
+
+	if (watchlist->free_tail != WATCHLIST_NO_SLOT)
+		watchlist->slots[watchlist->free_tail].next_free = index;
+	else
+		watchlist->free_head = index;
+
+	watchlist->free_tail = index;
+	watchlist->count -= 1;
+
+	if (item->destroy)
+		item->destroy(item->notify_data);
+
+	if (watchlist->destroy)
+		watchlist->destroy(item);
+
+	return TRUE;
+}
+
+static void watchlist_iter_set(struct ofono_watchlist_iter *iter,
+					unsigned int index)
+{
+	iter->index = index;
+
+	if (index != WATCHLIST_NO_SLOT)
+		iter->serial = iter->watchlist->slots[index].serial;
+}
+
+void __ofono_watchlist_iter_init(struct ofono_watchlist_iter *iter,
+					struct ofono_watchlist *watchlist)
+{
+	iter->watchlist = watchlist;
+	watchlist_iter_set(iter, watchlist->newest);
+}
+
+/* The newest live watch older than the one with @serial */
+static unsigned int watchlist_find_older(struct ofono_watchlist *watchlist,
+						unsigned int serial)
+{
+	unsigned int found = WATCHLIST_NO_SLOT;
+	unsigned int i;
+
+	for (i = 0; i < watchlist->used; i++) {
+		struct ofono_watchlist_slot *slot = &watchlist->slots[i];
+
+		if (slot->item == NULL || slot->serial >= serial)
 			continue;
-		}
 
-		if (p)
-			p->next = c->next;
-		else
-			watchlist->items = c->next;
+		if (found == WATCHLIST_NO_SLOT ||
+				slot->serial > watchlist->slots[found].serial)
+			found = i;
+	}
 
-		if (item->destroy)
-			item->destroy(item->notify_data);
+	return found;
+}
 
-		if (watchlist->destroy)
-			watchlist->destroy(item);
-		g_slist_free_1(c);
+/*
+ * Returns the next watch, newest first, or NULL once all watches have
+ * been visited.  Watches may be added or removed while iterating; those
+ * added after __ofono_watchlist_iter_init() are not returned.
+ */
+struct ofono_watchlist_item *__ofono_watchlist_iter_next(
+					struct ofono_watchlist_iter *iter)
+{
+	struct ofono_watchlist *watchlist = iter->watchlist;
+	struct ofono_watchlist_slot *slot;
+
+	if (iter->index == WATCHLIST_NO_SLOT)
+		return NULL;
+
+	slot = &watchlist->slots[iter->index];
 
-		return TRUE;
+	/* The next watch was removed from a callback, find its successor */
+	if (slot->item == NULL || slot->serial != iter->serial) {
+		watchlist_iter_set(iter,
+				watchlist_find_older(watchlist, iter->serial));
+
+		if (iter->index == WATCHLIST_NO_SLOT)
+			return NULL;
+
+		slot = &watchlist->slots[iter->index];
 	}
 
-	return FALSE;
+	watchlist_iter_set(iter, slot->older);
+
+	return slot->item;
 }
 
 void __ofono_watchlist_free(struct ofono_watchlist *watchlist)
 {
 	struct ofono_watchlist_item *item;
-	GSList *l;
+	unsigned int i;
 
-	for (l = watchlist->items; l; l = l->next) {
-		item = l->data;
+	for (i = 0; i < watchlist->used; i++) {
+		item = watchlist->slots[i].item;
+		if (item == NULL)
+			continue;
 
 		if (item->destroy)
 			item->destroy(item->notify_data);
@@ -98,7 +276,6 @@ void __ofono_watchlist_free(struct ofono_watchlist *watchlist)
 			watchlist->destroy(item);
 	}
 
-	g_slist_free(watchlist->items);
-	watchlist->items = NULL;
+	g_free(watchlist->slots);
 	g_free(watchlist);
 }
@@ -0,0 +1,318 @@
+/*
+ *
+ *  oFono - Open Source Telephony
+ *
+ *  Copyright (C) 2008-2011  Intel Corporation. All rights reserved.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 2 as
+ *  published by the Free Software Foundation.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <glib.h>
+
+#include "gatchat/gattrace.h"
+
+#define PCAP_MAGIC		0xa1b2c3d4
+#define PCAP_LINKTYPE_USER0	147
+
+struct pcap_hdr {
+	guint32 magic;
+	guint16 version_major;
+	guint16 version_minor;
+	gint32 thiszone;
+	guint32 sigfigs;
+	guint32 snaplen;
+	guint32 network;
+} __attribute__ ((packed));
+
+struct pcap_rec {
+	guint32 ts_sec;
+	guint32 ts_usec;
+	guint32 incl_len;
+	guint32 orig_len;
+} __attribute__ ((packed));
+
+/*
+ * Each packet in the pcap output starts with this pseudo header, so that
+ * the transport and direction are not lost
+ */
+struct pcap_pseudo {
+	guint8 transport;
+	guint8 flags;
+	guint16 id;		/* Big endian */
+} __attribute__ ((packed));
+
+static const char *transport_name(guint8 transport)
+{
+	switch (transport) {
+	case G_AT_TRACE_TRANSPORT_IO:
+		return "io";
+	case G_AT_TRACE_TRANSPORT_RIL:
+		return "ril";
+	case G_AT_TRACE_TRANSPORT_QMI:
+		return "qmi";
+	}
+
+	return "unknown";
+}
+
+static void print_hexdump(const unsigned char *buf, guint16 len)
+{
+	guint16 i, j;
+
+	for (i = 0; i < len; i += 16) {
+		g_print("  %04x: ", i);
+
+		for (j = i; j < i + 16; j++) {
+			if (j < len)
+				g_print(" %02x", buf[j]);
+			else
+				g_print("   ");
+		}
+
+		g_print("  ");
+
+		for (j = i; j < i + 16 && j < len; j++)
+			g_print("%c", g_ascii_isprint(buf[j]) ? buf[j] : '.');
+
+		g_print("\n");
+	}
+}
+
+static void print_record(const struct g_at_trace_record *rec,
+				const unsigned char *payload)
+{
+	guint64 timestamp = GUINT64_FROM_LE(rec->timestamp);
+	guint16 length = GUINT16_FROM_LE(rec->length);
+	guint16 orig_length = GUINT16_FROM_LE(rec->orig_length);
+	time_t sec = timestamp / G_USEC_PER_SEC;
+	struct tm tm;
+	char buf[32];
+
+	localtime_r(&sec, &tm);
+	strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &tm);
+
+	g_print("%s.%06u %s/%u %c %u bytes", buf,
+			(unsigned int) (timestamp % G_USEC_PER_SEC),
+			transport_name(rec->transport),
+			GUINT16_FROM_LE(rec->id),
+			rec->flags & G_AT_TRACE_FLAG_IN ? '<' : '>',
+			orig_length);
+
+	if (length < orig_length)
+		g_print(" (%u recorded)", length);
+
+	g_print("\n");
+
+	print_hexdump(payload, length);
+}
+
+static void write_pcap_record(FILE *out,
+				const struct g_at_trace_record *rec,
+				const unsigned char *payload)
+{
+	guint64 timestamp = GUINT64_FROM_LE(rec->timestamp);
+	guint16 length = GUINT16_FROM_LE(rec->length);
+	struct pcap_pseudo pseudo;
+	struct pcap_rec hdr;
+
+	hdr.ts_sec = timestamp / G_USEC_PER_SEC;
+	hdr.ts_usec = timestamp % G_USEC_PER_SEC;
+	hdr.incl_len = sizeof(pseudo) + length;
+	hdr.orig_len = sizeof(pseudo) + GUINT16_FROM_LE(rec->orig_length);
+
+	pseudo.transport = rec->transport;
+	pseudo.flags = rec->flags;
+	pseudo.id = GUINT16_TO_BE(GUINT16_FROM_LE(rec->id));
+
+	fwrite(&hdr, sizeof(hdr), 1, out);
+	fwrite(&pseudo, sizeof(pseudo), 1, out);
+	fwrite(payload, length, 1, out);
+}
+
+static gboolean decode(const char *contents, gsize size, FILE *pcap)
+{
+	const struct g_at_trace_header *header = (const void *) contents;
+	const unsigned char *data;
+	guint64 data_size;
+	guint64 head;
+	guint64 tail;
+	guint32 header_size;
+
+	if (size < sizeof(*header) ||
+			memcmp(header->magic, G_AT_TRACE_MAGIC,
+				sizeof(header->magic)) != 0) {
+		g_printerr("Not a trace file\n");
+		return FALSE;
+	}
+
+	if (GUINT32_FROM_LE(header->version) != G_AT_TRACE_VERSION) {
+		g_printerr("Unsupported trace version %u\n",
+				GUINT32_FROM_LE(header->version));
+		return FALSE;
+	}
+
+	header_size = GUINT32_FROM_LE(header->header_size);
+	data_size = GUINT64_FROM_LE(header->data_size);
+	head = GUINT64_FROM_LE(header->head);
+	tail = GUINT64_FROM_LE(header->tail);
+
+	/* Each term on its own, their sum could wrap */
+	if (header_size < sizeof(*header) || header_size > size ||
+			data_size == 0 || data_size > size - header_size ||
+			tail > head || head - tail > data_size) {
+		g_printerr("Corrupt trace header\n");
+		return FALSE;
+	}
+
+	data = (const unsigned char *) contents + header_size;
+
+	while (tail < head) {
+		guint64 offset = tail % data_size;
+		const struct g_at_trace_record *rec;
+		guint16 length;
+
+		if (data_size - offset < sizeof(*rec)) {
+			g_printerr("Truncated record at %" G_GUINT64_FORMAT
+					"\n", tail);
+			return FALSE;
+		}
+
+		rec = (const void *) (data + offset);
+		length = GUINT16_FROM_LE(rec->length);
+
+		if (data_size - offset - sizeof(*rec) < length) {
+			g_printerr("Truncated record at %" G_GUINT64_FORMAT
+					"\n", tail);
+			return FALSE;
+		}
+
+		if (!(rec->flags & G_AT_TRACE_FLAG_PAD)) {
+			const unsigned char *payload =
+					(const unsigned char *) (rec + 1);
+
+			if (pcap)
+				write_pcap_record(pcap, rec, payload);
+			else
+				print_record(rec, payload);
+		}
+
+		tail += sizeof(*rec) + ((length + G_AT_TRACE_ALIGN - 1) &
+						~(G_AT_TRACE_ALIGN - 1));
+	}
+
+	return TRUE;
+}
+
+static FILE *open_pcap(const char *filename)
+{
+	struct pcap_hdr hdr;
+	FILE *out;
+
+	out = fopen(filename, "wb");
+	if (out == NULL)
+		return NULL;
+
+	hdr.magic = PCAP_MAGIC;
+	hdr.version_major = 2;
+	hdr.version_minor = 4;
+	hdr.thiszone = 0;
+	hdr.sigfigs = 0;
+	hdr.snaplen = G_MAXUINT16 + sizeof(struct pcap_pseudo);
+	hdr.network = PCAP_LINKTYPE_USER0;
+
+	fwrite(&hdr, sizeof(hdr), 1, out);
+
+	return out;
+}
+
+static gboolean option_version = FALSE;
+static gchar *option_pcap = NULL;
+
+static GOptionEntry options[] = {
+	{ "version", 'v', 0, G_OPTION_ARG_NONE, &option_version,
+				"Show version information and exit" },
+	{ "pcap", 'p', 0, G_OPTION_ARG_STRING, &option_pcap,
+				"Write records to a pcap file (DLT_USER0)",
+				"FILE" },
+	{ NULL },
+};
+
+int main(int argc, char **argv)
+{
+	GOptionContext *context;
+	GError *error = NULL;
+	FILE *pcap = NULL;
+	gchar *contents;
+	gsize size;
+	gboolean ok;
+
+	context = g_option_context_new("TRACEFILE");
+	g_option_context_add_main_entries(context, options, NULL);
+
+	if (g_option_context_parse(context, &argc, &argv, &error) == FALSE) {
+		if (error != NULL) {
+			g_printerr("%s\n", error->message);
+			g_error_free(error);
+		} else
+			g_printerr("An unknown error occurred\n");
+		exit(1);
+	}
+
+	g_option_context_free(context);
+
+	if (option_version == TRUE) {
+		g_print("%s\n", VERSION);
+		exit(0);
+	}
+
+	if (argc < 2) {
+		g_printerr("Missing trace file\n");
+		exit(1);
+	}
+
+	if (g_file_get_contents(argv[1], &contents, &size, &error) == FALSE) {
+		g_printerr("%s\n", error->message);
+		g_error_free(error);
+		exit(1);
+	}
+
+	if (option_pcap) {
+		pcap = open_pcap(option_pcap);
+		if (pcap == NULL) {
+			g_printerr("Unable to create %s\n", option_pcap);
+			g_free(contents);
+			exit(1);
+		}
+	}
+
+	ok = decode(contents, size, pcap);
+
+	if (pcap)
+		fclose(pcap);
+
+	g_free(contents);
+	g_free(option_pcap);
+
+	return ok ? 0 : 1;
+}
@@ -385,6 +385,69 @@ static void test_eons(void)
 	sim_eons_free(eons_info);
 }
 
+const unsigned char overlapping_efopl[][8] = {
+	/* 246 81, LAC 100 - 200 */
+	{ 0x42, 0xf6, 0x18, 0x00, 0x64, 0x00, 0xc8, 0x01 },
+	/* 246 81, LAC 150 - 300 */
+	{ 0x42, 0xf6, 0x18, 0x00, 0x96, 0x01, 0x2c, 0x02 },
+	/* 246 8x, any LAC */
+	{ 0x42, 0xf6, 0xd8, 0x00, 0x00, 0xff, 0xfe, 0x02 },
+	/* 246 81, any LAC, hidden by the wildcard record above */
+	{ 0x42, 0xf6, 0x18, 0x00, 0x00, 0xff, 0xfe, 0x01 },
+};
+
+static void test_eons_lac(void)
+{
+	const struct sim_eons_operator_info *op_info;
+	struct sim_eons *eons_info;
+	unsigned int i;
+
+	eons_info = sim_eons_new(2);
+
+	sim_eons_add_pnn_record(eons_info, 1,
+			valid_efpnn[0], sizeof(valid_efpnn[0]));
+	sim_eons_add_pnn_record(eons_info, 2,
+			valid_efpnn[1], sizeof(valid_efpnn[1]));
+
+	for (i = 0; i < G_N_ELEMENTS(overlapping_efopl); i++)
+		sim_eons_add_opl_record(eons_info, overlapping_efopl[i],
+					sizeof(overlapping_efopl[i]));
+
+	sim_eons_optimize(eons_info);
+
+	op_info = sim_eons_lookup_with_lac(eons_info, "246", "81", 120);
+	g_assert(op_info);
+	g_assert(!strcmp(op_info->longname, "Solavei"));
+
+	/* Both ranges match, the first record wins */
+	op_info = sim_eons_lookup_with_lac(eons_info, "246", "81", 160);
+	g_assert(op_info);
+	g_assert(!strcmp(op_info->longname, "Solavei"));
+
+	op_info = sim_eons_lookup_with_lac(eons_info, "246", "81", 250);
+	g_assert(op_info);
+	g_assert(!strcmp(op_info->longname, "T-Mobile"));
+
+	op_info = sim_eons_lookup_with_lac(eons_info, "246", "81", 400);
+	g_assert(op_info);
+	g_assert(!strcmp(op_info->longname, "T-Mobile"));
+
+	op_info = sim_eons_lookup(eons_info, "246", "81");
+	g_assert(op_info);
+	g_assert(!strcmp(op_info->longname, "T-Mobile"));
+
+	op_info = sim_eons_lookup_with_lac(eons_info, "246", "82", 120);
+	g_assert(op_info);
+	g_assert(!strcmp(op_info->longname, "T-Mobile"));
+
+	op_info = sim_eons_lookup(eons_info, "246", "810");
+	g_assert(op_info == NULL);
+	op_info = sim_eons_lookup_with_lac(eons_info, "247", "81", 120);
+	g_assert(op_info == NULL);
+
+	sim_eons_free(eons_info);
+}
+
 static void test_ef_db(void)
 {
 	struct sim_ef_info *info;
@@ -508,6 +571,7 @@ int main(int argc, char **argv)
 	g_test_add_func("/testsimutil/ber tlv encode 3G Status response",
 			test_ber_tlv_builder_3g_status);
 	g_test_add_func("/testsimutil/EONS Handling", test_eons);
+	g_test_add_func("/testsimutil/EONS LAC Handling", test_eons_lac);
 	g_test_add_func("/testsimutil/Elementary File DB", test_ef_db);
 	g_test_add_func("/testsimutil/3G Status response", test_3g_status_data);
 	g_test_add_func("/testsimutil/Application entries decoding",
@@ -1218,6 +1218,77 @@ static void test_prepare_7bit(void)
 	g_slist_free_full(r, g_free);
 }
 
+static void test_prepare_national_language(void)
+{
+	GString *str = g_string_sized_new(300);
+	guint8 locking = GSM_DIALECT_DEFAULT;
+	guint8 single = GSM_DIALECT_DEFAULT;
+	struct sms *sms;
+	GSList *r;
+	int i;
+
+	/*
+	 * 150 times LATIN SMALL LETTER G WITH BREVE, which is in both the
+	 * Turkish locking and single shift tables.  Using the single shift
+	 * table would need 300 septets and three segments, the locking
+	 * shift table alone fits into one.
+	 */
+	for (i = 0; i < 150; i++)
+		g_string_append(str, "\xc4\x9f");
+
+	r = sms_text_prepare_with_alphabet("555", str->str, 0, FALSE, FALSE,
+						SMS_ALPHABET_TURKISH);
+	g_assert(r != NULL);
+	g_assert(g_slist_length(r) == 1);
+
+	sms = r->data;
+	g_assert(sms->submit.dcs == 0x00);
+	g_assert(sms_extract_language_variant(sms, &locking, &single));
+	g_assert(locking == GSM_DIALECT_TURKISH);
+	g_assert(single == GSM_DIALECT_DEFAULT);
+
+	g_slist_free_full(r, g_free);
+	g_string_free(str, TRUE);
+}
+
+static void test_prepare_national_language_escape(void)
+{
+	GString *str = g_string_sized_new(500);
+	guint8 locking = GSM_DIALECT_DEFAULT;
+	guint8 single = GSM_DIALECT_DEFAULT;
+	struct sms *sms;
+	GSList *r;
+	int i;
+
+	/*
+	 * LATIN SMALL LETTER C WITH CEDILLA is escaped in the Turkish single
+	 * shift table and plain in the Turkish locking shift table.  With
+	 * the single shift table both land on a segment boundary, where the
+	 * escape sequence can't be split, so it takes four segments instead
+	 * of the three its length suggests.  The locking shift table takes
+	 * three.
+	 */
+	for (i = 0; i < 2; i++) {
+		g_string_append_printf(str, "%0148d", 0);
+		g_string_append(str, "\xc3\xa7");
+	}
+
+	g_string_append_printf(str, "%0147d", 0);
+
+	r = sms_text_prepare_with_alphabet("555", str->str, 0, FALSE, FALSE,
+						SMS_ALPHABET_TURKISH);
+	g_assert(r != NULL);
+	g_assert(g_slist_length(r) == 3);
+
+	sms = r->data;
+	g_assert(sms_extract_language_variant(sms, &locking, &single));
+	g_assert(locking == GSM_DIALECT_TURKISH);
+	g_assert(single == GSM_DIALECT_DEFAULT);
+
+	g_slist_free_full(r, g_free);
+	g_string_free(str, TRUE);
+}
+
 struct sms_concat_data {
 	const char *str;
 	unsigned int segments;
@@ -1475,14 +1546,14 @@ static void test_cbs_assembly(void)
 	/* Add an initial page to the assembly */
 	l = cbs_assembly_add_page(assembly, &dec1);
 	g_assert(l);
-	g_assert(g_slist_length(assembly->recv_cell) == 1);
+	g_assert(g_hash_table_size(assembly->recv_cell) == 1);
 	g_slist_free_full(l, g_free);
 
 	/* Can we receive new updates ? */
 	dec1.update_number = 8;
 	l = cbs_assembly_add_page(assembly, &dec1);
 	g_assert(l);
-	g_assert(g_slist_length(assembly->recv_cell) == 1);
+	g_assert(g_hash_table_size(assembly->recv_cell) == 1);
 	g_slist_free_full(l, g_free);
 
 	/* Do we ignore old pages ? */
@@ -1495,7 +1566,7 @@ static void test_cbs_assembly(void)
 	g_assert(l == NULL);
 
 	cbs_assembly_location_changed(assembly, TRUE, TRUE, TRUE);
-	g_assert(assembly->recv_cell == NULL);
+	g_assert(g_hash_table_size(assembly->recv_cell) == 0);
 
 	dec1.update_number = 9;
 	dec1.page = 3;
@@ -1624,6 +1695,59 @@ static void test_range_minimizer(void)
 	}
 }
 
+static void test_topic_map(void)
+{
+	static const struct cbs_topic_range extra[] = {
+		{ 4352, 4356 }, { 4370, 4370 }, { 31, 32 }, { 64, 127 },
+		{ 65504, 65535 },
+	};
+	static const char *expected = "0-60,64-127,4352-4356,4370,"
+					"65504-65535";
+	struct cbs_topic_map map;
+	GSList *r = cbs_extract_topic_ranges(ranges[1]);
+	char *str;
+	char *map_str;
+	unsigned int i;
+
+	g_assert(r != NULL);
+
+	cbs_topic_map_clear(&map);
+	cbs_topic_map_add_ranges(&map, r);
+
+	str = cbs_topic_ranges_to_string(r);
+	map_str = cbs_topic_map_to_string(&map);
+	g_assert_cmpstr(str, ==, map_str);
+	g_free(str);
+	g_free(map_str);
+
+	for (i = 0; i < G_N_ELEMENTS(extra); i++) {
+		struct cbs_topic_range *range = g_memdup(&extra[i],
+							sizeof(extra[i]));
+
+		r = g_slist_append(r, range);
+		cbs_topic_map_add_range(&map, range->min, range->max);
+	}
+
+	for (i = 0; i <= 65535; i++)
+		g_assert(cbs_topic_map_contains(&map, i) ==
+				cbs_topic_in_range(i, r));
+
+	map_str = cbs_topic_map_to_string(&map);
+
+	if (g_test_verbose())
+		g_print("map: %s\n", map_str);
+
+	g_assert_cmpstr(map_str, ==, expected);
+	g_free(map_str);
+
+	g_slist_free_full(r, g_free);
+
+	cbs_topic_map_clear(&map);
+	map_str = cbs_topic_map_to_string(&map);
+	g_assert_cmpstr(map_str, ==, "");
+	g_free(map_str);
+}
+
 static void test_sr_assembly(void)
 {
 	const char *sr_pdu1 = "06040D91945152991136F00160124130340A0160124130"
@@ -1854,6 +1978,10 @@ int main(int argc, char **argv)
 
 	g_test_add_func("/testsms/Test Assembly", test_assembly);
 	g_test_add_func("/testsms/Test Prepare 7Bit", test_prepare_7bit);
+	g_test_add_func("/testsms/Test Prepare National Language",
+			test_prepare_national_language);
+	g_test_add_func("/testsms/Test Prepare National Language Escape",
+			test_prepare_national_language_escape);
 
 	g_test_add_data_func("/testsms/Test Prepare Concat",
 			&shakespeare_test, test_prepare_concat);
@@ -1880,6 +2008,7 @@ int main(int argc, char **argv)
 			test_cbs_padding_character);
 
 	g_test_add_func("/testsms/Range minimizer", test_range_minimizer);
+	g_test_add_func("/testsms/Topic map", test_topic_map);
 
 	g_test_add_func("/testsms/Status Report Assembly", test_sr_assembly);
 
@@ -22274,6 +22274,51 @@ static void test_img_to_xpm(gconstpointer data)
 	g_free(xpm);
 }
 
+static const struct {
+	const unsigned char *pdu;
+	unsigned int pdu_len;
+} perf_pdus[] = {
+	{ display_text_111, sizeof(display_text_111) },
+	{ get_inkey_111, sizeof(get_inkey_111) },
+	{ get_input_111, sizeof(get_input_111) },
+	{ setup_menu_111, sizeof(setup_menu_111) },
+	{ select_item_111, sizeof(select_item_111) },
+	{ send_sms_111, sizeof(send_sms_111) },
+	{ send_ussd_111, sizeof(send_ussd_111) },
+	{ setup_call_111, sizeof(setup_call_111) },
+	{ provide_local_info_121, sizeof(provide_local_info_121) },
+	{ setup_event_list_111, sizeof(setup_event_list_111) },
+	{ timer_mgmt_111, sizeof(timer_mgmt_111) },
+	{ setup_idle_mode_text_111, sizeof(setup_idle_mode_text_111) },
+	{ run_at_command_111, sizeof(run_at_command_111) },
+	{ launch_browser_111, sizeof(launch_browser_111) },
+};
+
+static void test_command_parse_perf(void)
+{
+	struct stk_command *command;
+	double elapsed;
+	unsigned int i;
+	int n;
+
+	g_test_timer_start();
+
+	for (n = 0; n < 100000; n++) {
+		for (i = 0; i < G_N_ELEMENTS(perf_pdus); i++) {
+			command = stk_command_new_from_pdu(perf_pdus[i].pdu,
+							perf_pdus[i].pdu_len);
+			g_assert(command);
+			g_assert(command->status == STK_PARSE_RESULT_OK);
+			stk_command_free(command);
+		}
+	}
+
+	elapsed = g_test_timer_elapsed();
+	g_test_minimized_result(elapsed, "parse 100k x %u commands: %6.3fs",
+				(unsigned int) G_N_ELEMENTS(perf_pdus),
+				elapsed);
+}
+
 int main(int argc, char **argv)
 {
 	g_test_init(&argc, &argv, NULL);
@@ -24386,5 +24431,9 @@ int main(int argc, char **argv)
 	g_test_add_data_func("/teststk/IMG to XPM Test 6",
 				&xpm_test_6, test_img_to_xpm);
 
+	if (g_test_perf())
+		g_test_add_func("/teststk/Command Parse Performance",
+				test_command_parse_perf);
+
 	return g_test_run();
 }
@@ -691,6 +691,68 @@ static void test_pack_size(void)
 	g_free(packed);
 }
 
+static void test_pack_unpack_round_trip(void)
+{
+	unsigned char text[256];
+	unsigned char packed[256];
+	unsigned char unpacked[300];
+	long packed_len;
+	long unpacked_len;
+	long len;
+	int offset;
+
+	for (len = 0; len < 256; len++)
+		text[len] = (len * 37 + 11) & 0x7f;
+
+	for (len = 1; len < 256; len++) {
+		for (offset = 0; offset < 7; offset++) {
+			g_assert(pack_7bit_own_buf(text, len, offset, FALSE,
+							&packed_len, 0,
+							packed) != NULL);
+
+			g_assert(unpack_7bit_own_buf(packed, packed_len,
+							offset, FALSE, len,
+							&unpacked_len, 0,
+							unpacked) != NULL);
+
+			g_assert(unpacked_len == len);
+			g_assert(memcmp(text, unpacked, len) == 0);
+		}
+	}
+}
+
+static void test_pack_unpack_perf(void)
+{
+	unsigned char text[160];
+	unsigned char packed[140];
+	unsigned char unpacked[161];
+	long written;
+	double elapsed;
+	int i;
+
+	for (i = 0; i < 160; i++)
+		text[i] = 'A' + i % 26;
+
+	g_test_timer_start();
+
+	for (i = 0; i < 1000000; i++)
+		pack_7bit_own_buf(text, 160, 0, FALSE, &written, 0, packed);
+
+	elapsed = g_test_timer_elapsed();
+	g_test_minimized_result(elapsed, "pack 1M x 160 septets: %6.3fs",
+				elapsed);
+
+	g_test_timer_start();
+
+	for (i = 0; i < 1000000; i++)
+		unpack_7bit_own_buf(packed, 140, 0, FALSE, 160, &written, 0,
+					unpacked);
+
+	elapsed = g_test_timer_elapsed();
+	g_test_minimized_result(elapsed, "unpack 1M x 140 octets: %6.3fs",
+				elapsed);
+}
+
 static void test_cr_handling(void)
 {
 	unsigned char c7[] = { 'a', 'b', 'c', 'd', 'e', 'f', 'g' };
@@ -1012,6 +1074,168 @@ static void test_unicode_to_gsm(void)
 	}
 }
 
+static void test_national_round_trip(void)
+{
+	enum gsm_dialect lang;
+	unsigned char buf[2];
+	unsigned char *back;
+	char *res;
+	char *verify;
+	long nwritten;
+	long size;
+	int i;
+
+	for (lang = GSM_DIALECT_DEFAULT; lang <= GSM_DIALECT_URDU; lang++) {
+		for (i = 0; i < 0x100; i++) {
+			if ((i & 0x7f) == 0x1b)
+				continue;
+
+			if (i & 0x80) {
+				buf[0] = 0x1b;
+				buf[1] = i & 0x7f;
+				size = 2;
+			} else {
+				buf[0] = i;
+				size = 1;
+			}
+
+			res = convert_gsm_to_utf8_with_lang(buf, size, NULL,
+							NULL, 0, lang, lang);
+			g_assert(res);
+
+			/*
+			 * Characters present in both tables, or more than
+			 * once in a table, encode to their first occurrence,
+			 * so only check that the text survives the round trip
+			 */
+			back = convert_utf8_to_gsm_with_lang(res, -1, NULL,
+								&nwritten, 0,
+								lang, lang);
+			g_assert(back);
+
+			verify = convert_gsm_to_utf8_with_lang(back, nwritten,
+								NULL, NULL, 0,
+								lang, lang);
+			g_assert(verify);
+			g_assert(strcmp(res, verify) == 0);
+
+			g_free(verify);
+			g_free(back);
+			g_free(res);
+		}
+	}
+}
+
+struct best_lang_test {
+	const char *utf8;
+	enum gsm_dialect hint;
+	gboolean encodable;
+	enum gsm_dialect locking;
+	enum gsm_dialect single;
+	long nwritten;
+};
+
+static const struct best_lang_test best_lang_ascii = {
+	.utf8 = "Hello World",
+	.hint = GSM_DIALECT_TURKISH,
+	.encodable = TRUE,
+	.locking = GSM_DIALECT_DEFAULT,
+	.single = GSM_DIALECT_DEFAULT,
+	.nwritten = 11,
+};
+
+static const struct best_lang_test best_lang_turkish_single = {
+	.utf8 = "Da\xc4\x9f",
+	.hint = GSM_DIALECT_TURKISH,
+	.encodable = TRUE,
+	.locking = GSM_DIALECT_DEFAULT,
+	.single = GSM_DIALECT_TURKISH,
+	.nwritten = 4,
+};
+
+static const struct best_lang_test best_lang_spanish_single = {
+	.utf8 = "Adi\xc3\xb3s",
+	.hint = GSM_DIALECT_SPANISH,
+	.encodable = TRUE,
+	.locking = GSM_DIALECT_DEFAULT,
+	.single = GSM_DIALECT_SPANISH,
+	.nwritten = 6,
+};
+
+static const struct best_lang_test best_lang_portuguese_locking = {
+	.utf8 = "1\xe2\x88\x9e",
+	.hint = GSM_DIALECT_PORTUGUESE,
+	.encodable = TRUE,
+	.locking = GSM_DIALECT_PORTUGUESE,
+	.single = GSM_DIALECT_PORTUGUESE,
+	.nwritten = 2,
+};
+
+static const struct best_lang_test best_lang_hindi_locking = {
+	.utf8 = "\xe0\xa4\xa8\xe0\xa4\xae\xe0\xa4\xb8\xe0\xa5\x8d"
+		"\xe0\xa4\xa4\xe0\xa5\x87",
+	.hint = GSM_DIALECT_HINDI,
+	.encodable = TRUE,
+	.locking = GSM_DIALECT_HINDI,
+	.single = GSM_DIALECT_HINDI,
+	.nwritten = 6,
+};
+
+static const struct best_lang_test best_lang_urdu_locking = {
+	.utf8 = "\xd8\xb3\xd9\x84\xd8\xa7\xd9\x85",
+	.hint = GSM_DIALECT_URDU,
+	.encodable = TRUE,
+	.locking = GSM_DIALECT_URDU,
+	.single = GSM_DIALECT_URDU,
+	.nwritten = 4,
+};
+
+static const struct best_lang_test best_lang_no_hint = {
+	.utf8 = "Da\xc4\x9f",
+	.hint = GSM_DIALECT_DEFAULT,
+	.encodable = FALSE,
+};
+
+static const struct best_lang_test best_lang_unencodable = {
+	.utf8 = "\xe4\xbd\xa0\xe5\xa5\xbd",
+	.hint = GSM_DIALECT_PORTUGUESE,
+	.encodable = FALSE,
+};
+
+static void test_best_lang(gconstpointer data)
+{
+	const struct best_lang_test *test = data;
+	enum gsm_dialect locking;
+	enum gsm_dialect single;
+	unsigned char *res;
+	unsigned char *expected;
+	long nwritten;
+	long nexpected;
+
+	res = convert_utf8_to_gsm_best_lang(test->utf8, -1, NULL, &nwritten, 0,
+						test->hint, &locking, &single);
+
+	if (test->encodable == FALSE) {
+		g_assert(res == NULL);
+		return;
+	}
+
+	g_assert(res);
+	g_assert(locking == test->locking);
+	g_assert(single == test->single);
+	g_assert(nwritten == test->nwritten);
+
+	expected = convert_utf8_to_gsm_with_lang(test->utf8, -1, NULL,
+							&nexpected, 0,
+							locking, single);
+	g_assert(expected);
+	g_assert(nexpected == nwritten);
+	g_assert(memcmp(res, expected, nwritten) == 0);
+
+	g_free(expected);
+	g_free(res);
+}
+
 int main(int argc, char **argv)
 {
 	g_test_init(&argc, &argv, NULL);
@@ -1022,12 +1246,36 @@ int main(int argc, char **argv)
 			test_valid_turkish);
 	g_test_add_func("/testutil/Decode Encode", test_decode_encode);
 	g_test_add_func("/testutil/Pack Size", test_pack_size);
+	g_test_add_func("/testutil/Pack Unpack Round Trip",
+			test_pack_unpack_round_trip);
 	g_test_add_func("/testutil/CBS CR Handling", test_cr_handling);
 	g_test_add_func("/testutil/SMS Handling", test_sms_handling);
 	g_test_add_func("/testutil/Offset Handling", test_offset_handling);
 	g_test_add_func("/testutil/SIM conversions", test_sim);
 	g_test_add_func("/testutil/Valid Unicode to GSM Conversion",
 			test_unicode_to_gsm);
+	g_test_add_func("/testutil/National Language Round Trip",
+			test_national_round_trip);
+	g_test_add_data_func("/testutil/Best Language ASCII",
+				&best_lang_ascii, test_best_lang);
+	g_test_add_data_func("/testutil/Best Language Turkish Single Shift",
+				&best_lang_turkish_single, test_best_lang);
+	g_test_add_data_func("/testutil/Best Language Spanish Single Shift",
+				&best_lang_spanish_single, test_best_lang);
+	g_test_add_data_func("/testutil/Best Language Portuguese Locking Shift",
+				&best_lang_portuguese_locking, test_best_lang);
+	g_test_add_data_func("/testutil/Best Language Hindi Locking Shift",
+				&best_lang_hindi_locking, test_best_lang);
+	g_test_add_data_func("/testutil/Best Language Urdu Locking Shift",
+				&best_lang_urdu_locking, test_best_lang);
+	g_test_add_data_func("/testutil/Best Language No Hint",
+				&best_lang_no_hint, test_best_lang);
+	g_test_add_data_func("/testutil/Best Language Unencodable",
+				&best_lang_unencodable, test_best_lang);
+
+	if (g_test_perf())
+		g_test_add_func("/testutil/Pack Unpack Performance",
+				test_pack_unpack_perf);
 
 	return g_test_run();
 }
@@ -0,0 +1,223 @@
+/*
+ *
+ *  oFono - Open Source Telephony
+ *
+ *  Copyright (C) 2008-2011  Intel Corporation. All rights reserved.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 2 as
+ *  published by the Free Software Foundation.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <glib.h>
+
+#include "ofono.h"
+
+static int destroyed;
+
+static void item_destroy(void *data)
+{
+	destroyed += 1;
+}
+
+static unsigned int add_item(struct ofono_watchlist *watchlist, int tag)
+{
+	struct ofono_watchlist_item *item;
+
+	item = g_new0(struct ofono_watchlist_item, 1);
+	item->notify_data = GINT_TO_POINTER(tag);
+	item->destroy = item_destroy;
+
+	return __ofono_watchlist_add_item(watchlist, item);
+}
+
+static int next_tag(struct ofono_watchlist_iter *iter)
+{
+	struct ofono_watchlist_item *item = __ofono_watchlist_iter_next(iter);
+
+	if (item == NULL)
+		return 0;
+
+	return GPOINTER_TO_INT(item->notify_data);
+}
+
+static void test_order(void)
+{
+	struct ofono_watchlist *watchlist;
+	struct ofono_watchlist_iter iter;
+	unsigned int id2;
+
+	watchlist = __ofono_watchlist_new(g_free);
+
+	__ofono_watchlist_iter_init(&iter, watchlist);
+	g_assert(next_tag(&iter) == 0);
+
+	add_item(watchlist, 1);
+	id2 = add_item(watchlist, 2);
+	add_item(watchlist, 3);
+
+	/* Watches are notified newest first */
+	__ofono_watchlist_iter_init(&iter, watchlist);
+	g_assert(next_tag(&iter) == 3);
+	g_assert(next_tag(&iter) == 2);
+	g_assert(next_tag(&iter) == 1);
+	g_assert(next_tag(&iter) == 0);
+
+	/* A watch re-using a slot is still the newest */
+	g_assert(__ofono_watchlist_remove_item(watchlist, id2) == TRUE);
+	add_item(watchlist, 4);
+
+	__ofono_watchlist_iter_init(&iter, watchlist);
+	g_assert(next_tag(&iter) == 4);
+	g_assert(next_tag(&iter) == 3);
+	g_assert(next_tag(&iter) == 1);
+	g_assert(next_tag(&iter) == 0);
+
+	destroyed = 0;
+	__ofono_watchlist_free(watchlist);
+	g_assert(destroyed == 3);
+}
+
+static void test_stale_id(void)
+{
+	struct ofono_watchlist *watchlist;
+	struct ofono_watchlist_iter iter;
+	unsigned int id1;
+	unsigned int id2;
+
+	watchlist = __ofono_watchlist_new(g_free);
+
+	id1 = add_item(watchlist, 1);
+	g_assert(id1 != 0);
+
+	destroyed = 0;
+	g_assert(__ofono_watchlist_remove_item(watchlist, id1) == TRUE);
+	g_assert(destroyed == 1);
+
+	/* The only free slot is reused, with a different id */
+	id2 = add_item(watchlist, 2);
+	g_assert(id2 != 0);
+	g_assert(id2 != id1);
+
+	g_assert(__ofono_watchlist_remove_item(watchlist, id1) == FALSE);
+	g_assert(__ofono_watchlist_remove_item(watchlist, 0) == FALSE);
+	g_assert(__ofono_watchlist_remove_item(watchlist, id2 + 1) == FALSE);
+	g_assert(destroyed == 1);
+
+	__ofono_watchlist_iter_init(&iter, watchlist);
+	g_assert(next_tag(&iter) == 2);
+	g_assert(next_tag(&iter) == 0);
+
+	g_assert(__ofono_watchlist_remove_item(watchlist, id2) == TRUE);
+	g_assert(__ofono_watchlist_remove_item(watchlist, id2) == FALSE);
+	g_assert(destroyed == 2);
+
+	__ofono_watchlist_free(watchlist);
+}
+
+static void test_slot_reuse(void)
+{
+	struct ofono_watchlist *watchlist;
+	unsigned int id1;
+	unsigned int id;
+	int i;
+
+	watchlist = __ofono_watchlist_new(g_free);
+
+	id1 = add_item(watchlist, 1);
+	g_assert(__ofono_watchlist_remove_item(watchlist, id1) == TRUE);
+
+	/* Reuse the only slot many times, the first id never comes back */
+	for (i = 0; i < 10000; i++) {
+		id = add_item(watchlist, 2);
+		g_assert(id != 0);
+		g_assert(id != id1);
+		g_assert(id < 1U << OFONO_WATCHLIST_ID_BITS);
+
+		g_assert(__ofono_watchlist_remove_item(watchlist,
+								id1) == FALSE);
+		g_assert(__ofono_watchlist_remove_item(watchlist,
+								id) == TRUE);
+	}
+
+	__ofono_watchlist_free(watchlist);
+}
+
+static void test_modify_while_iterating(void)
+{
+	struct ofono_watchlist *watchlist;
+	struct ofono_watchlist_iter iter;
+	unsigned int id[6];
+	int i;
+
+	watchlist = __ofono_watchlist_new(g_free);
+
+	for (i = 1; i <= 5; i++)
+		id[i] = add_item(watchlist, i);
+
+	__ofono_watchlist_iter_init(&iter, watchlist);
+	g_assert(next_tag(&iter) == 5);
+
+	/* Remove the current and the next watch, then reuse both slots */
+	g_assert(__ofono_watchlist_remove_item(watchlist, id[5]) == TRUE);
+	g_assert(__ofono_watchlist_remove_item(watchlist, id[4]) == TRUE);
+	add_item(watchlist, 6);
+	add_item(watchlist, 7);
+
+	g_assert(next_tag(&iter) == 3);
+
+	/* Remove and re-add the next watch, it is now too new to visit */
+	g_assert(__ofono_watchlist_remove_item(watchlist, id[2]) == TRUE);
+	id[2] = add_item(watchlist, 2);
+
+	g_assert(next_tag(&iter) == 1);
+	g_assert(next_tag(&iter) == 0);
+
+	__ofono_watchlist_iter_init(&iter, watchlist);
+	g_assert(next_tag(&iter) == 2);
+	g_assert(next_tag(&iter) == 7);
+	g_assert(next_tag(&iter) == 6);
+	g_assert(next_tag(&iter) == 3);
+	g_assert(next_tag(&iter) == 1);
+	g_assert(next_tag(&iter) == 0);
+
+	/* Watches removed ahead of the iterator are skipped */
+	__ofono_watchlist_iter_init(&iter, watchlist);
+	g_assert(next_tag(&iter) == 2);
+
+	g_assert(__ofono_watchlist_remove_item(watchlist, id[1]) == TRUE);
+	g_assert(__ofono_watchlist_remove_item(watchlist, id[3]) == TRUE);
+
+	g_assert(next_tag(&iter) == 7);
+	g_assert(next_tag(&iter) == 6);
+	g_assert(next_tag(&iter) == 0);
+
+	__ofono_watchlist_free(watchlist);
+}
+
+int main(int argc, char **argv)
+{
+	g_test_init(&argc, &argv, NULL);
+
+	g_test_add_func("/testwatch/order", test_order);
+	g_test_add_func("/testwatch/stale_id", test_stale_id);
+	g_test_add_func("/testwatch/slot_reuse", test_slot_reuse);
+	g_test_add_func("/testwatch/modify_while_iterating",
+					test_modify_while_iterating);
+
+	return g_test_run();
+}